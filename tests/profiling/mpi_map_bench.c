@@ -0,0 +1,229 @@
+/******************************************************************************
+ * @section DESCRIPTION
+ *
+ * Micro-benchmark of the remap + MPI_Scatterv cost of a single double
+ * precision field in the image driver.
+ *
+ * Two versions of the root side of get_scatter_nc_field_double are timed:
+ *   - two-pass: three buffers are allocated per call, the field is filtered
+ *     to the active cells and then reordered for MPI_Scatterv with two
+ *     element-by-element memcpy passes (the original implementation)
+ *   - one-pass: persistent buffers and a single pass through the composed
+ *     index filter_active_cells[mpi_map_mapping_array[i]] with fixed-width
+ *     copies (map_indexed in vic_mpi_support.c)
+ *
+ * The domain is decomposed round-robin as in mpi_map_decomp_domain and half
+ * of the grid cells are active.
+ *
+ * Build and run with, for example:
+ *   mpicc -O3 -std=c99 -o mpi_map_bench mpi_map_bench.c
+ *   mpirun -np 4 ./mpi_map_bench
+ *
+ * @section LICENSE
+ *
+ * The Variable Infiltration Capacity (VIC) macroscale hydrological model
+ * Copyright (C) 2016 The Computational Hydrology Group, Department of Civil
+ * and Environmental Engineering, University of Washington.
+ *
+ * The VIC model is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *****************************************************************************/
+
+#include <mpi.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define NREPEAT 50
+
+/******************************************************************************
+ * @brief   Type-agnostic to[i] = from[from_map[i]], as in map()
+ *****************************************************************************/
+void
+map_two_pass(size_t  size,
+             size_t  n,
+             size_t *from_map,
+             void   *from,
+             void   *to)
+{
+    size_t i;
+
+    for (i = 0; i < n; i++) {
+        memcpy((void *)((char *)to + i * size),
+               (void *)((char *)from + from_map[i] * size), size);
+    }
+}
+
+/******************************************************************************
+ * @brief   Fixed-width to[i] = from[grid_idx[i]], as in map_indexed()
+ *****************************************************************************/
+void
+map_one_pass(size_t  n,
+             size_t *grid_idx,
+             double *from,
+             double *to)
+{
+    size_t i;
+
+    for (i = 0; i < n; i++) {
+        memcpy(to + i, from + grid_idx[i], sizeof(double));
+    }
+}
+
+int
+main(int   argc,
+     char *argv[])
+{
+    size_t  sizes[] = {1000, 100000, 1000000};
+    size_t  ncells;
+    size_t  ngrid;
+    size_t  nlocal;
+    size_t  i;
+    size_t  s;
+    int     r;
+    int     n;
+    int     mpi_rank;
+    int     mpi_size;
+    int    *counts;
+    int    *displs;
+    size_t *filter;
+    size_t *mapping;
+    size_t *grid_idx;
+    double *grid;
+    double *filtered;
+    double *mapped;
+    double *local;
+    double  t0;
+    double  t_remap[2];
+    double  t_total[2];
+
+    MPI_Init(&argc, &argv);
+    MPI_Comm_rank(MPI_COMM_WORLD, &mpi_rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &mpi_size);
+
+    if (mpi_rank == 0) {
+        printf("%d processes, %d repetitions, time per field in ms\n",
+               mpi_size, NREPEAT);
+        printf("%10s %12s %12s %12s %12s\n", "ncells", "remap 2-pass",
+               "total 2-pass", "remap 1-pass", "total 1-pass");
+    }
+
+    for (s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        ncells = sizes[s];
+        ngrid = 2 * ncells;
+
+        // round-robin decomposition, as in mpi_map_decomp_domain
+        counts = malloc(mpi_size * sizeof(*counts));
+        displs = malloc(mpi_size * sizeof(*displs));
+        for (n = 0; n < mpi_size; n++) {
+            counts[n] = (int) (ncells / mpi_size);
+            if ((size_t) n < ncells % mpi_size) {
+                counts[n]++;
+            }
+            displs[n] = n == 0 ? 0 : displs[n - 1] + counts[n - 1];
+        }
+        nlocal = (size_t) counts[mpi_rank];
+        local = malloc(nlocal * sizeof(*local));
+
+        filter = malloc(ncells * sizeof(*filter));
+        mapping = malloc(ncells * sizeof(*mapping));
+        grid_idx = malloc(ncells * sizeof(*grid_idx));
+        for (i = 0; i < ncells; i++) {
+            filter[i] = 2 * i + (i % 3 == 0);
+        }
+        for (n = 0; n < mpi_size; n++) {
+            for (i = 0; i < (size_t) counts[n]; i++) {
+                mapping[displs[n] + i] = i * mpi_size + n;
+            }
+        }
+        for (i = 0; i < ncells; i++) {
+            grid_idx[i] = filter[mapping[i]];
+        }
+
+        t_remap[0] = t_remap[1] = 0.;
+        t_total[0] = t_total[1] = 0.;
+
+        // two-pass version with buffers allocated per call
+        for (r = 0; r < NREPEAT; r++) {
+            MPI_Barrier(MPI_COMM_WORLD);
+            t0 = MPI_Wtime();
+            mapped = NULL;
+            if (mpi_rank == 0) {
+                grid = malloc(ngrid * sizeof(*grid));
+                filtered = malloc(ncells * sizeof(*filtered));
+                mapped = malloc(ncells * sizeof(*mapped));
+                for (i = 0; i < ngrid; i++) {
+                    grid[i] = (double) i;
+                }
+                map_two_pass(sizeof(double), ncells, filter, grid, filtered);
+                map_two_pass(sizeof(double), ncells, mapping, filtered,
+                             mapped);
+                free(grid);
+                free(filtered);
+                t_remap[0] += MPI_Wtime() - t0;
+            }
+            MPI_Scatterv(mapped, counts, displs, MPI_DOUBLE, local,
+                         (int) nlocal, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+            if (mpi_rank == 0) {
+                free(mapped);
+            }
+            t_total[0] += MPI_Wtime() - t0;
+        }
+
+        // one-pass version with persistent buffers
+        grid = malloc(ngrid * sizeof(*grid));
+        mapped = malloc(ncells * sizeof(*mapped));
+        for (r = 0; r < NREPEAT; r++) {
+            MPI_Barrier(MPI_COMM_WORLD);
+            t0 = MPI_Wtime();
+            if (mpi_rank == 0) {
+                for (i = 0; i < ngrid; i++) {
+                    grid[i] = (double) i;
+                }
+                map_one_pass(ncells, grid_idx, grid, mapped);
+                t_remap[1] += MPI_Wtime() - t0;
+            }
+            MPI_Scatterv(mapped, counts, displs, MPI_DOUBLE, local,
+                         (int) nlocal, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+            t_total[1] += MPI_Wtime() - t0;
+        }
+
+        // check the last scatter
+        for (i = 0; i < nlocal; i++) {
+            if (local[i] != (double) filter[i * mpi_size + mpi_rank]) {
+                fprintf(stderr, "rank %d: wrong value at %zu\n", mpi_rank, i);
+                MPI_Abort(MPI_COMM_WORLD, 1);
+            }
+        }
+
+        if (mpi_rank == 0) {
+            printf("%10zu %12.3f %12.3f %12.3f %12.3f\n", ncells,
+                   1e3 * t_remap[0] / NREPEAT, 1e3 * t_total[0] / NREPEAT,
+                   1e3 * t_remap[1] / NREPEAT, 1e3 * t_total[1] / NREPEAT);
+        }
+
+        free(grid);
+        free(mapped);
+        free(filter);
+        free(mapping);
+        free(grid_idx);
+        free(local);
+        free(counts);
+        free(displs);
+    }
+
+    MPI_Finalize();
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,127 @@
+#!/usr/bin/env python
+'''Benchmark of the netCDF-4 storage options of image driver history files.
+
+Writes one year of a daily (time, y, x) float field one time step at a time,
+as the image driver does, with combinations of CHUNKSIZES, SHUFFLE, COMPRESS
+and QUANTIZE. Reports the write time, the file size, the time to read the
+time series at 20 points and the time to read 10 full maps, reopening the
+file for every read so that nothing is served from the chunk cache.
+
+Requires the netCDF4 python package (built against netCDF >= 4.9.0 for the
+quantization cases).
+
+Usage: python nc_output_bench.py [ny] [nx] [nt]
+'''
+import os
+import sys
+import tempfile
+import time
+
+import numpy as np
+import netCDF4
+
+CASES = [
+    # name, chunksizes, shuffle, compress, quantize
+    ('netcdf4 default', None, False, 0, None),
+    ('deflate 1', None, True, 1, None),
+    ('deflate 1, no shuffle', None, False, 1, None),
+    ('deflate 5', None, True, 5, None),
+    ('deflate 1, chunks 365 16 16', (365, 16, 16), True, 1, None),
+    ('deflate 1, chunks 73 16 16', (73, 16, 16), True, 1, None),
+    ('deflate 1, chunks 1 ny nx', (1, None, None), True, 1, None),
+    ('deflate 1, BitRound 10', None, True, 1, ('BitRound', 10)),
+    ('deflate 1, GranularBR 3', None, True, 1, ('GranularBitRound', 3)),
+    ('deflate 1, chunks 365 16 16, BitRound 10', (365, 16, 16), True, 1,
+     ('BitRound', 10)),
+]
+
+
+def make_data(nt, ny, nx):
+    '''Smooth seasonal field with noise, similar to a temperature output.'''
+    rng = np.random.default_rng(0)
+    y, x = np.meshgrid(np.linspace(0, 1, ny), np.linspace(0, 1, nx),
+                       indexing='ij')
+    base = 280. + 20. * np.cos(np.pi * y) + 5. * np.sin(4. * np.pi * x)
+    t = np.arange(nt)
+    season = 10. * np.sin(2. * np.pi * t / 365.)
+    data = (base[None, :, :] + season[:, None, None] +
+            rng.normal(0., 2., (nt, ny, nx)))
+    return data.astype(np.float32)
+
+
+def run_case(path, data, chunksizes, shuffle, compress, quantize):
+    nt, ny, nx = data.shape
+    kwargs = {'zlib': compress > 0, 'complevel': compress,
+              'shuffle': shuffle}
+    if chunksizes is not None:
+        kwargs['chunksizes'] = (min(chunksizes[0], nt),
+                                min(chunksizes[1] or ny, ny),
+                                min(chunksizes[2] or nx, nx))
+    if quantize is not None:
+        kwargs['quantize_mode'] = quantize[0]
+        kwargs['significant_digits'] = quantize[1]
+
+    t0 = time.perf_counter()
+    with netCDF4.Dataset(path, 'w', format='NETCDF4_CLASSIC') as nc:
+        nc.createDimension('time', None)
+        nc.createDimension('lat', ny)
+        nc.createDimension('lon', nx)
+        var = nc.createVariable('OUT_AIR_TEMP', 'f4', ('time', 'lat', 'lon'),
+                                fill_value=netCDF4.default_fillvals['f4'],
+                                **kwargs)
+        if chunksizes is not None:
+            # hold every chunk touched by one time step, as
+            # set_nc_var_storage does
+            chunks = var.chunking()
+            nchunks = -(-ny // chunks[1]) * -(-nx // chunks[2])
+            var.set_var_chunk_cache(size=nchunks * int(np.prod(chunks)) * 4,
+                                    nelems=2 * nchunks + 1, preemption=0.75)
+        for i in range(nt):
+            var[i, :, :] = data[i]
+    t_write = time.perf_counter() - t0
+    size = os.path.getsize(path)
+
+    rng = np.random.default_rng(1)
+    points = zip(rng.integers(0, ny, 20), rng.integers(0, nx, 20))
+    t0 = time.perf_counter()
+    for j, i in points:
+        with netCDF4.Dataset(path) as nc:
+            nc.variables['OUT_AIR_TEMP'][:, j, i]
+    t_series = time.perf_counter() - t0
+
+    t0 = time.perf_counter()
+    for i in range(0, nt, max(nt // 10, 1)):
+        with netCDF4.Dataset(path) as nc:
+            nc.variables['OUT_AIR_TEMP'][i, :, :]
+    t_maps = time.perf_counter() - t0
+
+    with netCDF4.Dataset(path) as nc:
+        err = np.abs(nc.variables['OUT_AIR_TEMP'][:] - data).max()
+
+    return t_write, size, t_series, t_maps, err
+
+
+def main():
+    ny = int(sys.argv[1]) if len(sys.argv) > 1 else 200
+    nx = int(sys.argv[2]) if len(sys.argv) > 2 else 200
+    nt = int(sys.argv[3]) if len(sys.argv) > 3 else 365
+    data = make_data(nt, ny, nx)
+
+    print('{0} x {1} x {2} float, raw size {3:.1f} MB, netCDF {4}'.format(
+        nt, ny, nx, data.nbytes / 1e6, netCDF4.__netcdf4libversion__))
+    print('| {0:<42} | {1:>9} | {2:>9} | {3:>13} | {4:>11} | {5:>8} |'.format(
+        'case', 'write (s)', 'size (MB)', '20 series (s)', '10 maps (s)',
+        'max err'))
+    with tempfile.TemporaryDirectory() as tmpdir:
+        path = os.path.join(tmpdir, 'bench.nc')
+        for name, chunksizes, shuffle, compress, quantize in CASES:
+            t_write, size, t_series, t_maps, err = run_case(
+                path, data, chunksizes, shuffle, compress, quantize)
+            print('| {0:<42} | {1:9.2f} | {2:9.1f} | {3:13.3f} | {4:11.3f} '
+                  '| {5:8.4f} |'.format(name, t_write, size / 1e6, t_series,
+                                        t_maps, err))
+            os.remove(path)
+
+
+if __name__ == '__main__':
+    main()
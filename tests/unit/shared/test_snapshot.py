@@ -0,0 +1,60 @@
+from vic import lib as vic_lib
+from vic.vic import ffi
+
+
+def make_stream(ngridcells):
+    vic_lib.initialize_options()
+    vic_lib.options.Nlayer = 3
+    vic_lib.set_output_met_data_info()
+    stream = ffi.new('stream_struct *')
+    vic_lib.setup_stream(stream, 2, ngridcells)
+    vic_lib.set_output_var(stream, b'OUT_RUNOFF', 0, b'*',
+                           vic_lib.OUT_TYPE_DEFAULT, 1., vic_lib.AGG_TYPE_AVG)
+    vic_lib.set_output_var(stream, b'OUT_SOIL_MOIST', 1, b'*',
+                           vic_lib.OUT_TYPE_DEFAULT, 1., vic_lib.AGG_TYPE_MAX)
+    vic_lib.alloc_aggdata(stream)
+    return stream
+
+
+def set_stream_state(stream, value):
+    for i in range(stream.ngridcells):
+        for j in range(stream.nvars):
+            nelem = vic_lib.out_metadata[stream.varid[j]].nelem
+            for k in range(nelem):
+                stream.aggdata[i][j][k][0] = value + 100 * i + 10 * j + k
+    stream.time_bounds[0].year = int(value)
+    stream.time_bounds[1].dayseconds = int(value)
+    stream.agg_alarm.count = int(value)
+    stream.write_alarm.next_count = int(value)
+
+
+def get_stream_state(stream):
+    aggdata = []
+    for i in range(stream.ngridcells):
+        for j in range(stream.nvars):
+            nelem = vic_lib.out_metadata[stream.varid[j]].nelem
+            for k in range(nelem):
+                aggdata.append(stream.aggdata[i][j][k][0])
+    return (aggdata, stream.time_bounds[0].year,
+            stream.time_bounds[1].dayseconds, stream.agg_alarm.count,
+            stream.write_alarm.next_count)
+
+
+def test_pack_unpack_stream_state():
+    stream = make_stream(3)
+    set_stream_state(stream, 1000.)
+    expected = get_stream_state(stream)
+
+    nbytes = vic_lib.sizeof_stream_state(stream)
+    buffer = ffi.new('char[]', nbytes)
+    pos = ffi.new('char **', buffer)
+    vic_lib.pack_stream_state(pos, stream)
+    assert pos[0] - buffer == nbytes
+
+    set_stream_state(stream, 2000.)
+    assert get_stream_state(stream) != expected
+
+    pos[0] = buffer
+    vic_lib.unpack_stream_state(pos, stream)
+    assert pos[0] - buffer == nbytes
+    assert get_stream_state(stream) == expected
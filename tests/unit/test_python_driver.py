@@ -1,3 +1,6 @@
+import numpy as np
+import pytest
+
 from vic import VIC_DRIVER
 from vic import lib as vic_lib
 from vic.pycompat import pylong
@@ -25,3 +28,251 @@ def test_globals_are_initialized():
     assert vic_lib.global_param.atmos_dt == -99999.
     assert vic_lib.options.AboveTreelineVeg == -1
     assert vic_lib.param.LAPSE_RATE == -0.0065
+
+
+def test_driver_views():
+    from vic import driver
+    vic_lib.global_param.model_steps_per_day = 24
+    vic_lib.global_param.snow_steps_per_day = 24
+    vic_lib.global_param.runoff_steps_per_day = 24
+    vic_lib.global_param.atmos_steps_per_day = 24
+    driver.vic_alloc([1, 2], nwindow=4)
+
+    air_temp = driver.forcing('air_temp')
+    assert air_temp.shape == (4, 2, vic_lib.NF)
+    air_temp[3, 1, 0] = 12.5
+    offset = (3 * 2 + 1) * (vic_lib.NR + 1)
+    assert vic_lib.force_window.air_temp[offset] == 12.5
+
+    depth = driver.soil_con('depth')
+    assert depth.shape[0] == 2
+    depth[1, 2] = 1.5
+    assert vic_lib.soil_con[1].depth[2] == 1.5
+
+    cv = driver.veg_con(1, 'Cv')
+    assert cv.shape == (3, )
+    cv[2] = 0.25
+    assert vic_lib.veg_con[1][2].Cv == 0.25
+
+    assert driver.out_data('OUT_RUNOFF').shape == (2, 1)
+
+    driver.vic_final()
+    assert vic_lib.domain.ncells == 0
+    vic_lib.initialize_global()
+
+
+def test_driver_snapshot_restore():
+    from vic import driver
+    vic_lib.global_param.model_steps_per_day = 24
+    vic_lib.global_param.snow_steps_per_day = 24
+    vic_lib.global_param.runoff_steps_per_day = 24
+    vic_lib.global_param.atmos_steps_per_day = 24
+    driver.vic_alloc([1, 2])
+
+    moist = driver.state(1, 2, 'cell', 'layer.moist')
+    moist[:] = 10.
+    vic_lib.current = 5
+    snap = driver.snapshot()
+    assert snap.nbytes > 0
+
+    moist[:] = 20.
+    vic_lib.current = 6
+    driver.restore(snap)
+    assert (moist == 10.).all()
+    assert vic_lib.current == 5
+
+    driver.vic_final()
+    vic_lib.initialize_global()
+
+
+def _setup_domain(nwindow):
+    '''Initialize a domain of one cell with a grass and a bare soil tile
+    for a simulation period of 48 hourly steps.'''
+    from vic import driver
+    o = vic_lib.options
+    o.Nlayer = 3
+    o.Nnode = 3
+    o.FULL_ENERGY = False
+    o.FROZEN_SOIL = False
+    o.QUICK_FLUX = True
+    o.IMPLICIT = False
+    o.EXP_TRANS = False
+    o.SNOW_BAND = 1
+    o.ROOT_ZONES = 2
+    o.NVEGTYPES = 2
+    o.BASEFLOW = vic_lib.ARNO
+    o.LAI_SRC = vic_lib.FROM_VEGLIB
+    g = vic_lib.global_param
+    for name in ('model', 'snow', 'runoff', 'atmos'):
+        setattr(g, name + '_steps_per_day', 24)
+    g.startyear = 2001
+    g.startmonth = 1
+    g.startday = 1
+    g.startsec = 0
+    g.endyear = 2001
+    g.endmonth = 1
+    g.endday = 2
+    g.wind_h = 10.
+    driver.vic_alloc([1], nwindow=nwindow)
+
+    soil = vic_lib.soil_con[0]
+    for name, value in (('Ds', 0.001), ('Dsmax', 10.), ('Ws', 0.9),
+                        ('annual_prec', 1000.), ('avg_temp', 5.),
+                        ('b_infilt', 0.2), ('c', 2.), ('dp', 4.),
+                        ('elevation', 1200.), ('lat', 48.19),
+                        ('lng', -120.69), ('time_zone_lng', -120.),
+                        ('rough', 0.001), ('snow_rough', 0.0005),
+                        ('gridcel', 1)):
+        setattr(soil, name, value)
+    depth = (0.1, 0.5, 1.5)
+    init_moist = (30., 100., 200.)
+    for j in range(3):
+        max_moist = depth[j] * (1. - 1500. / 2650.) * 1000.
+        soil.depth[j] = depth[j]
+        soil.Ksat[j] = 300.
+        soil.expt[j] = 13.
+        soil.bubble[j] = 10.
+        soil.bulk_density[j] = 1500.
+        soil.soil_density[j] = 2650.
+        soil.bulk_dens_min[j] = 1500.
+        soil.soil_dens_min[j] = 2650.
+        soil.bulk_dens_org[j] = -99999.
+        soil.soil_dens_org[j] = -99999.
+        soil.porosity[j] = 1. - 1500. / 2650.
+        soil.quartz[j] = 0.5
+        soil.phi_s[j] = -999.
+        soil.max_moist[j] = max_moist
+        soil.Wcr[j] = 0.7 * max_moist
+        soil.Wpwp[j] = 0.5 * max_moist
+        soil.init_moist[j] = init_moist[j]
+    soil.max_infil = (1. + soil.b_infilt) * (soil.max_moist[0] +
+                                             soil.max_moist[1])
+    soil.dz_node[0:3] = [0.1, 0.1, 7.7]
+    soil.Zsum_node[0:3] = [0., 0.1, 4.]
+    soil.frost_fract[0] = 1.
+    soil.AreaFract[0] = 1.
+    soil.BandElev[0] = 1200.
+    soil.Pfactor[0] = 1.
+
+    for cls, (rarc, rmin, lai, rough, disp) in enumerate(
+            ((2., 100., 2., 0.1, 0.5), (100., 0., 0., 0.001, 0.005))):
+        veg_lib = vic_lib.veg_lib[cls]
+        veg_lib.veg_class = cls + 1
+        veg_lib.rarc = rarc
+        veg_lib.rmin = rmin
+        veg_lib.wind_h = 10.
+        veg_lib.RGL = 100.
+        veg_lib.rad_atten = 0.5
+        veg_lib.wind_atten = 0.5
+        veg_lib.trunk_ratio = 0.2
+        for m in range(12):
+            veg_lib.LAI[m] = lai
+            veg_lib.Wdmax[m] = vic_lib.param.VEG_LAI_WATER_FACTOR * lai
+            veg_lib.fcanopy[m] = 1. if lai else 0.0001
+            veg_lib.albedo[m] = 0.2
+            veg_lib.roughness[m] = rough
+            veg_lib.displacement[m] = disp
+        veg_con = vic_lib.veg_con[0][cls]
+        veg_con.Cv = (0.8, 0.2)[cls]
+        veg_con.veg_class = cls
+        for m in range(12):
+            for name in ('LAI', 'Wdmax', 'fcanopy', 'albedo', 'roughness',
+                         'displacement'):
+                getattr(veg_con, name)[m] = getattr(veg_lib, name)[m]
+    veg_con = vic_lib.veg_con[0][0]
+    veg_con.zone_depth[0:2] = [0.3, 1.0]
+    veg_con.zone_fract[0:2] = [0.7, 0.3]
+
+    driver.vic_init()
+
+
+def _set_forcing(first):
+    '''Fill the forcing window with a diurnal cycle, starting at step
+    first.'''
+    from vic import driver
+    hours = (first + np.arange(vic_lib.domain.nwindow)) % 24
+    air_temp = driver.forcing('air_temp')
+    air_temp[:] = (10. + 5. * np.sin(2. * np.pi * hours / 24.))[:, None, None]
+    driver.forcing('prec')[:] = np.where(hours % 6 == 0, 2., 0.)[:, None, None]
+    driver.forcing('shortwave')[:] = np.maximum(
+        0., 600. * np.sin(np.pi * (hours - 6) / 12.))[:, None, None]
+    driver.forcing('longwave')[:] = 300.
+    driver.forcing('pressure')[:] = 90000.
+    driver.forcing('vp')[:] = 800.
+    driver.forcing('wind')[:] = 2.
+
+
+def _run_windows(nwindows, first):
+    '''Run nwindows forcing windows and return the output of each.'''
+    from vic import driver
+    outputs = []
+    for k in range(nwindows):
+        _set_forcing(first + k * vic_lib.domain.nwindow)
+        driver.vic_run(vic_lib.domain.nwindow)
+        outputs.append([driver.out_data(name).copy() for name in
+                        ('OUT_RUNOFF', 'OUT_BASEFLOW', 'OUT_EVAP',
+                         'OUT_SOIL_MOIST', 'OUT_SOIL_TEMP')])
+    return outputs
+
+
+def _final():
+    from vic import driver
+    driver.vic_final()
+    vic_lib.initialize_global()
+    vic_lib.initialize_options()
+
+
+def test_driver_run():
+    from vic import driver
+    _setup_domain(6)
+    assert vic_lib.current == 0
+
+    moist = driver.out_data('OUT_SOIL_MOIST')
+    _set_forcing(0)
+    driver.vic_run(6)
+    assert vic_lib.current == 6
+    first = moist.copy()
+    assert np.isfinite(first).all()
+
+    _set_forcing(6)
+    driver.vic_run(3)
+    assert vic_lib.current == 9
+    assert (moist != first).any()
+    assert np.isfinite(moist).all()
+    _final()
+
+
+def test_driver_run_errors():
+    from vic import driver
+    _setup_domain(6)
+
+    # more steps than the forcing window holds
+    with pytest.raises(RuntimeError):
+        driver.vic_run(7)
+    assert vic_lib.current == 0
+
+    # steps past the end of the simulation period
+    _run_windows(vic_lib.global_param.nrecs // 6, 0)
+    assert vic_lib.current == vic_lib.global_param.nrecs
+    with pytest.raises(RuntimeError):
+        driver.vic_run(1)
+    assert vic_lib.current == vic_lib.global_param.nrecs
+    _final()
+
+
+def test_driver_snapshot_run_restore_run():
+    from vic import driver
+    _setup_domain(6)
+    _run_windows(2, 0)
+
+    snap = driver.snapshot()
+    expected = _run_windows(3, 12)
+    assert vic_lib.current == 30
+
+    driver.restore(snap)
+    assert vic_lib.current == 12
+    actual = _run_windows(3, 12)
+    for window_expected, window_actual in zip(expected, actual):
+        for out_expected, out_actual in zip(window_expected, window_actual):
+            np.testing.assert_array_equal(out_actual, out_expected)
+    _final()
@@ -121,40 +121,58 @@ typedef struct {
 } x2l_data_struct;
 
 /******************************************************************************
- * @brief   This structure is a c type container for the l2x fields.
+ * @brief   l2x fields computed by VIC.  Order is important and any changes
+ *          here must be echoed in vic_cesm_def_mod_f.F90
+ *****************************************************************************/
+enum
+{
+    L2X_SL_T,           /**< temperature */
+    L2X_SL_TREF,        /**< 2m reference temperature */
+    L2X_SL_QREF,        /**< 2m reference specific humidity */
+    L2X_SL_AVSDR,       /**< albedo: direct , visible */
+    L2X_SL_ANIDR,       /**< albedo: direct , near-ir */
+    L2X_SL_AVSDF,       /**< albedo: diffuse, visible */
+    L2X_SL_ANIDF,       /**< albedo: diffuse, near-ir */
+    L2X_SL_SNOWH,       /**< snow height */
+    L2X_SL_U10,         /**< 10m wind */
+    L2X_SL_DDVEL,       /**< dry deposition velocities (optional) */
+    L2X_SL_FV,          /**< friction velocity */
+    L2X_SL_RAM1,        /**< aerodynamical resistance */
+    L2X_SL_LOGZ0,       /**< log z0 */
+    L2X_FALL_TAUX,      /**< wind stress, zonal */
+    L2X_FALL_TAUY,      /**< wind stress, meridional */
+    L2X_FALL_LAT,       /**< latent heat flux */
+    L2X_FALL_SEN,       /**< sensible heat flux */
+    L2X_FALL_LWUP,      /**< upward longwave heat flux */
+    L2X_FALL_EVAP,      /**< evaporation water flux */
+    L2X_FALL_SWNET,     /**< heat flux shortwave net */
+    L2X_FALL_FCO2_LND,  /**< co2 flux **For testing set to 0 */
+    L2X_FALL_FLXDST1,   /**< dust flux size bin 1 */
+    L2X_FALL_FLXDST2,   /**< dust flux size bin 2 */
+    L2X_FALL_FLXDST3,   /**< dust flux size bin 3 */
+    L2X_FALL_FLXDST4,   /**< dust flux size bin 4 */
+    L2X_FALL_FLXVOC,    /**< MEGAN fluxes */
+    L2X_FLRL_ROFLIQ,    /**< lnd->rtm input fluxes */
+    L2X_FLRL_ROFICE,    /**< lnd->rtm input fluxes */
+    // Last value of enum - DO NOT ADD ANYTHING BELOW THIS LINE!!
+    // used as a loop counter and must be >= the largest value in this enum
+    N_L2X_FIELDS        /**< used as a loop counter*/
+};
+
+/******************************************************************************
+ * @brief   This structure is a c type container for the l2x coupling buffer.
+ *          The buffer is the MCT l2x attribute vector itself (rAttr, stored
+ *          [ncells][nflds]); VIC accumulates directly into it so that no
+ *          re-packing is needed on export.
  *          Order is important and any changes here must be echoed in
  *          vic_cesm_def_mod_f.F90
  *****************************************************************************/
 typedef struct {
-    double l2x_Sl_t;  /**< temperature */
-    double l2x_Sl_tref;  /**< 2m reference temperature */
-    double l2x_Sl_qref;  /**< 2m reference specific humidity */
-    double l2x_Sl_avsdr;  /**< albedo: direct , visible */
-    double l2x_Sl_anidr;  /**< albedo: direct , near-ir */
-    double l2x_Sl_avsdf;  /**< albedo: diffuse, visible */
-    double l2x_Sl_anidf;  /**< albedo: diffuse, near-ir */
-    double l2x_Sl_snowh;  /**< snow height */
-    double l2x_Sl_u10;  /**< 10m wind */
-    double l2x_Sl_ddvel;  /**< dry deposition velocities (optional) */
-    double l2x_Sl_fv;  /**< friction velocity */
-    double l2x_Sl_ram1;  /**< aerodynamical resistance */
-    double l2x_Sl_logz0;  /**< log z0 */
-    double l2x_Fall_taux;  /**< wind stress, zonal */
-    double l2x_Fall_tauy;  /**< wind stress, meridional */
-    double l2x_Fall_lat;  /**< latent heat flux */
-    double l2x_Fall_sen;  /**< sensible heat flux */
-    double l2x_Fall_lwup;  /**< upward longwave heat flux */
-    double l2x_Fall_evap;  /**< evaporation water flux */
-    double l2x_Fall_swnet;  /**< heat flux shortwave net */
-    double l2x_Fall_fco2_lnd;  /**< co2 flux **For testing set to 0 */
-    double l2x_Fall_flxdst1;  /**< dust flux size bin 1 */
-    double l2x_Fall_flxdst2;  /**< dust flux size bin 2 */
-    double l2x_Fall_flxdst3;  /**< dust flux size bin 3 */
-    double l2x_Fall_flxdst4;  /**< dust flux size bin 4 */
-    double l2x_Fall_flxvoc;  /**< MEGAN fluxes */
-    double l2x_Flrl_rofliq;  /**< lnd->rtm input fluxes */
-    double l2x_Flrl_rofice;  /**< lnd->rtm input fluxes */
-    bool l2x_vars_set; /** l2x set flag */
+    size_t nflds;  /**< number of fields in the l2x attribute vector */
+    int index[N_L2X_FIELDS];  /**< position of each l2x field in the
+                                 attribute vector, -1 if not exchanged */
+    double *data;  /**< l2x attribute vector data [ncells][nflds] */
+    bool vars_set; /**< l2x set flag */
 } l2x_data_struct;
 
 void advance_time(void);
@@ -33,7 +33,7 @@ size_t             *mpi_map_mapping_array = NULL;
 all_vars_struct    *all_vars = NULL;
 force_data_struct  *force = NULL;
 x2l_data_struct    *x2l_vic = NULL;
-l2x_data_struct    *l2x_vic = NULL;
+l2x_data_struct     l2x_vic;
 dmy_struct          dmy_current;
 filenames_struct    filenames;
 filep_struct        filep;
@@ -51,6 +51,10 @@ MPI_Datatype        mpi_option_struct_type;
 MPI_Datatype        mpi_param_struct_type;
 int                *mpi_map_local_array_sizes = NULL;
 int                *mpi_map_global_array_offsets = NULL;
+mpi_map_buffers_struct mpi_map_buffers;
+veg_lib_share_struct veg_lib_share;
+spinup_struct       spinup;
+state_stage_struct *state_stages = NULL;  // [NMEMBERS]
 int                 mpi_rank;
 int                 mpi_size;
 option_struct       options;
@@ -39,7 +39,7 @@ vic_cesm_put_data()
     extern soil_con_struct    *soil_con;
     extern veg_con_struct    **veg_con;
     extern veg_lib_struct    **veg_lib;
-    extern l2x_data_struct    *l2x_vic;
+    extern l2x_data_struct     l2x_vic;
     extern x2l_data_struct    *x2l_vic;
     extern global_param_struct global_param;
     extern option_struct       options;
@@ -52,6 +52,7 @@ vic_cesm_put_data()
     size_t                     veg;
     size_t                     band;
     size_t                     index;
+    size_t                     j;
     double                     AreaFactor;
     double                     AreaFactorSum;
     double                     TreeAdjustFactor = 1.;
@@ -64,41 +65,61 @@ vic_cesm_put_data()
     double                     wind_stress_x;
     double                     wind_stress_y;
     double                     evap;
-    cell_data_struct           cell;
-    energy_bal_struct          energy;
-    snow_data_struct           snow;
-    veg_var_struct             veg_var;
+    double                    *l2x;
+    double                    *l2x_field[N_L2X_FIELDS];
+    double                     l2x_unused[N_L2X_FIELDS];
+    cell_data_struct          *cell;
+    energy_bal_struct         *energy;
+    snow_data_struct          *snow;
+    veg_var_struct            *veg_var;
+
+    if (l2x_vic.data == NULL) {
+        log_err("l2x coupling buffer has not been set");
+    }
 
     for (i = 0; i < local_domain.ncells_active; i++) {
+        // Point each l2x field at its slot in this cell's row of the
+        // coupling buffer.  Fields the coupler does not exchange are
+        // accumulated into a scratch value and discarded.
+        l2x = &(l2x_vic.data[i * l2x_vic.nflds]);
+        for (j = 0; j < N_L2X_FIELDS; j++) {
+            if (l2x_vic.index[j] >= 0) {
+                l2x_field[j] = &(l2x[l2x_vic.index[j]]);
+            }
+            else {
+                l2x_field[j] = &(l2x_unused[j]);
+            }
+        }
+
         // Zero l2x vars (leave unused fields as MISSING values)
-        l2x_vic[i].l2x_Sl_t = 0;
-        l2x_vic[i].l2x_Sl_tref = 0;
-        l2x_vic[i].l2x_Sl_qref = 0;
-        l2x_vic[i].l2x_Sl_avsdr = 0;
-        l2x_vic[i].l2x_Sl_anidr = 0;
-        l2x_vic[i].l2x_Sl_avsdf = 0;
-        l2x_vic[i].l2x_Sl_anidf = 0;
-        l2x_vic[i].l2x_Sl_snowh = 0;
-        l2x_vic[i].l2x_Sl_u10 = 0;
-        // l2x_vic[i].l2x_Sl_ddvel = 0;
-        l2x_vic[i].l2x_Sl_fv = 0;
-        l2x_vic[i].l2x_Sl_ram1 = 0;
-        l2x_vic[i].l2x_Sl_logz0 = 0;
-        l2x_vic[i].l2x_Fall_taux = 0;
-        l2x_vic[i].l2x_Fall_tauy = 0;
-        l2x_vic[i].l2x_Fall_lat = 0;
-        l2x_vic[i].l2x_Fall_sen = 0;
-        l2x_vic[i].l2x_Fall_lwup = 0;
-        l2x_vic[i].l2x_Fall_evap = 0;
-        l2x_vic[i].l2x_Fall_swnet = 0;
-        // l2x_vic[i].l2x_Fall_fco2_lnd = 0;
-        // l2x_vic[i].l2x_Fall_flxdst1 = 0;
-        // l2x_vic[i].l2x_Fall_flxdst2 = 0;
-        // l2x_vic[i].l2x_Fall_flxdst3 = 0;
-        // l2x_vic[i].l2x_Fall_flxdst4 = 0;
-        // l2x_vic[i].l2x_Fall_flxvoc = 0;
-        l2x_vic[i].l2x_Flrl_rofliq = 0;
-        // l2x_vic[i].l2x_Flrl_rofice = 0;
+        *l2x_field[L2X_SL_T] = 0;
+        *l2x_field[L2X_SL_TREF] = 0;
+        *l2x_field[L2X_SL_QREF] = 0;
+        *l2x_field[L2X_SL_AVSDR] = 0;
+        *l2x_field[L2X_SL_ANIDR] = 0;
+        *l2x_field[L2X_SL_AVSDF] = 0;
+        *l2x_field[L2X_SL_ANIDF] = 0;
+        *l2x_field[L2X_SL_SNOWH] = 0;
+        *l2x_field[L2X_SL_U10] = 0;
+        // *l2x_field[L2X_SL_DDVEL] = 0;
+        *l2x_field[L2X_SL_FV] = 0;
+        *l2x_field[L2X_SL_RAM1] = 0;
+        *l2x_field[L2X_SL_LOGZ0] = 0;
+        *l2x_field[L2X_FALL_TAUX] = 0;
+        *l2x_field[L2X_FALL_TAUY] = 0;
+        *l2x_field[L2X_FALL_LAT] = 0;
+        *l2x_field[L2X_FALL_SEN] = 0;
+        *l2x_field[L2X_FALL_LWUP] = 0;
+        *l2x_field[L2X_FALL_EVAP] = 0;
+        *l2x_field[L2X_FALL_SWNET] = 0;
+        // *l2x_field[L2X_FALL_FCO2_LND] = 0;
+        // *l2x_field[L2X_FALL_FLXDST1] = 0;
+        // *l2x_field[L2X_FALL_FLXDST2] = 0;
+        // *l2x_field[L2X_FALL_FLXDST3] = 0;
+        // *l2x_field[L2X_FALL_FLXDST4] = 0;
+        // *l2x_field[L2X_FALL_FLXVOC] = 0;
+        *l2x_field[L2X_FLRL_ROFLIQ] = 0;
+        // *l2x_field[L2X_FLRL_ROFICE] = 0;
 
         // running sum to make sure we get the full grid cell
         AreaFactorSum = 0;
@@ -113,10 +134,10 @@ vic_cesm_put_data()
             }
 
             for (band = 0; band < options.SNOW_BAND; band++) {
-                cell = all_vars[i].cell[veg][band];
-                energy = all_vars[i].energy[veg][band];
-                snow = all_vars[i].snow[veg][band];
-                veg_var = all_vars[i].veg_var[veg][band];
+                cell = &(all_vars[i].cell[veg][band]);
+                energy = &(all_vars[i].energy[veg][band]);
+                snow = &(all_vars[i].snow[veg][band]);
+                veg_var = &(all_vars[i].veg_var[veg][band]);
 
                 // TODO: Consider treeline and lake factors
                 AreaFactor = (veg_con[i][veg].Cv *
@@ -130,22 +151,22 @@ vic_cesm_put_data()
 
                 // temperature
                 // CESM units: K
-                if (overstory && snow.snow && !(options.LAKES && IsWet)) {
-                    rad_temp = energy.Tfoliage + CONST_TKFRZ;
+                if (overstory && snow->snow && !(options.LAKES && IsWet)) {
+                    rad_temp = energy->Tfoliage + CONST_TKFRZ;
                 }
                 else {
-                    rad_temp = energy.Tsurf + CONST_TKFRZ;
+                    rad_temp = energy->Tsurf + CONST_TKFRZ;
                 }
-                l2x_vic[i].l2x_Sl_t += AreaFactor * rad_temp;
+                *l2x_field[L2X_SL_T] += AreaFactor * rad_temp;
 
                 // 2m reference temperature
                 // CESM units: K
-                l2x_vic[i].l2x_Sl_tref += AreaFactor * force->air_temp[NR];
+                *l2x_field[L2X_SL_TREF] += AreaFactor * force->air_temp[NR];
 
                 // 2m reference specific humidity
                 // CESM units: g/g
-                l2x_vic[i].l2x_Sl_qref += AreaFactor * CONST_EPS *
-                                          force->vp[NR] / force->pressure[NR];
+                *l2x_field[L2X_SL_QREF] += AreaFactor * CONST_EPS *
+                                           force->vp[NR] / force->pressure[NR];
 
                 // Albedo Note: VIC does not partition its albedo, all returned
                 // values will be the same
@@ -154,49 +175,49 @@ vic_cesm_put_data()
                 // CESM units: unitless
                 // force->shortwave is the incoming shortwave (+ down)
                 // force->NetShortAtmos net shortwave flux (+ down)
-                // SWup = force->shortwave[NR] - energy.NetShortAtmos
+                // SWup = force->shortwave[NR] - energy->NetShortAtmos
                 // Set the albedo to zero for the case where there is no shortwave down
                 if (force->shortwave[NR] > 0.) {
                     albedo = AreaFactor *
-                             (force->shortwave[NR] - energy.NetShortAtmos) /
+                             (force->shortwave[NR] - energy->NetShortAtmos) /
                              force->shortwave[NR];
                 }
                 else {
                     albedo = 0.;
                 }
-                l2x_vic[i].l2x_Sl_avsdr += albedo;
+                *l2x_field[L2X_SL_AVSDR] += albedo;
 
                 // albedo: direct , near-ir
                 // CESM units: unitless
-                l2x_vic[i].l2x_Sl_anidr += albedo;
+                *l2x_field[L2X_SL_ANIDR] += albedo;
 
                 // albedo: diffuse, visible
                 // CESM units: unitless
-                l2x_vic[i].l2x_Sl_avsdf += albedo;
+                *l2x_field[L2X_SL_AVSDF] += albedo;
 
                 // albedo: diffuse, near-ir
                 // CESM units: unitless
-                l2x_vic[i].l2x_Sl_anidf += albedo;
+                *l2x_field[L2X_SL_ANIDF] += albedo;
 
                 // snow height
                 // CESM units: m
-                l2x_vic[i].l2x_Sl_snowh += AreaFactor * snow.depth;
+                *l2x_field[L2X_SL_SNOWH] += AreaFactor * snow->depth;
 
                 // 10m wind
                 // CESM units: m/s
-                l2x_vic[i].l2x_Sl_u10 += AreaFactor * force->wind[NR];
+                *l2x_field[L2X_SL_U10] += AreaFactor * force->wind[NR];
 
                 // dry deposition velocities (optional)
                 // CESM units: ?
-                // l2x_vic[i].l2x_Sl_ddvel;
+                // *l2x_field[L2X_SL_DDVEL];
 
                 // aerodynamical resistance
                 // CESM units: s/m
                 if (overstory) {
-                    aero_resist = cell.aero_resist[1];
+                    aero_resist = cell->aero_resist[1];
                 }
                 else {
-                    aero_resist = cell.aero_resist[0];
+                    aero_resist = cell->aero_resist[0];
                 }
 
                 if (aero_resist < DBL_EPSILON) {
@@ -205,11 +226,11 @@ vic_cesm_put_data()
                     aero_resist = param.HUGE_RESIST;
                 }
 
-                l2x_vic[i].l2x_Sl_ram1 += AreaFactor * aero_resist;
+                *l2x_field[L2X_SL_RAM1] += AreaFactor * aero_resist;
 
                 // log z0
                 // CESM units: m
-                if (snow.snow) {
+                if (snow->snow) {
                     // snow roughness
                     roughness = soil_con[i].snow_rough;
                 }
@@ -226,89 +247,88 @@ vic_cesm_put_data()
                     log_warn("roughness (%f) is < %f", roughness, DBL_EPSILON);
                     roughness = DBL_EPSILON;
                 }
-                l2x_vic[i].l2x_Sl_logz0 += AreaFactor * log(roughness);
+                *l2x_field[L2X_SL_LOGZ0] += AreaFactor * log(roughness);
 
                 // wind stress, zonal
                 // CESM units: N m-2
                 wind_stress_x = -1 * force[i].density[NR] *
                                 x2l_vic[i].x2l_Sa_u / aero_resist;
-                l2x_vic[i].l2x_Fall_taux += AreaFactor * wind_stress_x;
+                *l2x_field[L2X_FALL_TAUX] += AreaFactor * wind_stress_x;
 
                 // wind stress, meridional
                 // CESM units: N m-2
                 wind_stress_y = -1 * force[i].density[NR] *
                                 x2l_vic[i].x2l_Sa_v / aero_resist;
-                l2x_vic[i].l2x_Fall_tauy += AreaFactor * wind_stress_y;
+                *l2x_field[L2X_FALL_TAUY] += AreaFactor * wind_stress_y;
 
                 // friction velocity
                 // CESM units: m s-1
                 wind_stress =
                     sqrt(pow(wind_stress_x, 2) + pow(wind_stress_y, 2));
-                l2x_vic[i].l2x_Sl_fv += AreaFactor *
-                                        (wind_stress / force[i].density[NR]);
+                *l2x_field[L2X_SL_FV] += AreaFactor *
+                                         (wind_stress / force[i].density[NR]);
 
                 // latent heat flux
                 // CESM units: W m-2
-                l2x_vic[i].l2x_Fall_lat += -1 * AreaFactor * energy.AtmosLatent;
+                *l2x_field[L2X_FALL_LAT] += -1 * AreaFactor *
+                                            energy->AtmosLatent;
 
                 // sensible heat flux
                 // CESM units: W m-2
-                l2x_vic[i].l2x_Fall_sen += -1 * AreaFactor *
-                                           energy.AtmosSensible;
+                *l2x_field[L2X_FALL_SEN] += -1 * AreaFactor *
+                                            energy->AtmosSensible;
 
                 // upward longwave heat flux
                 // CESM units: W m-2
-                l2x_vic[i].l2x_Fall_lwup += AreaFactor *
-                                            (force->longwave[NR] -
-                                             energy.NetLongAtmos);
+                *l2x_field[L2X_FALL_LWUP] += AreaFactor *
+                                             (force->longwave[NR] -
+                                              energy->NetLongAtmos);
 
                 // evaporation water flux
                 // CESM units: kg m-2 s-1
                 evap = 0.0;
                 for (index = 0; index < options.Nlayer; index++) {
-                    evap += cell.layer[index].evap;
+                    evap += cell->layer[index].evap;
                 }
-                evap += snow.vapor_flux * MM_PER_M;
+                evap += snow->vapor_flux * MM_PER_M;
                 if (HasVeg) {
-                    evap += snow.canopy_vapor_flux * MM_PER_M;
-                    evap += veg_var.canopyevap;
+                    evap += snow->canopy_vapor_flux * MM_PER_M;
+                    evap += veg_var->canopyevap;
                 }
-                l2x_vic[i].l2x_Fall_evap += -1 * AreaFactor * evap /
-                                            global_param.dt;
+                *l2x_field[L2X_FALL_EVAP] += -1 * AreaFactor * evap /
+                                             global_param.dt;
 
                 // heat flux shortwave net
-                l2x_vic[i].l2x_Fall_swnet += AreaFactor *
-                                             (force->shortwave[NR] -
-                                              energy.NetShortAtmos);
+                *l2x_field[L2X_FALL_SWNET] += AreaFactor *
+                                              (force->shortwave[NR] -
+                                               energy->NetShortAtmos);
 
                 // co2 flux **For testing set to 0
-                // l2x_vic[i].l2x_Fall_fco2_lnd;
+                // *l2x_field[L2X_FALL_FCO2_LND];
 
                 // dust flux size bin 1
-                // l2x_vic[i].l2x_Fall_flxdst1;
+                // *l2x_field[L2X_FALL_FLXDST1];
 
                 // dust flux size bin 2
-                // l2x_vic[i].l2x_Fall_flxdst2;
+                // *l2x_field[L2X_FALL_FLXDST2];
 
                 // dust flux size bin 3
-                // l2x_vic[i].l2x_Fall_flxdst3;
+                // *l2x_field[L2X_FALL_FLXDST3];
 
                 // dust flux size bin 4
-                // l2x_vic[i].l2x_Fall_flxdst4;
+                // *l2x_field[L2X_FALL_FLXDST4];
 
                 // MEGAN fluxes
-                // l2x_vic[i].l2x_Fall_flxvoc;
+                // *l2x_field[L2X_FALL_FLXVOC];
 
                 // lnd->rtm input fluxes
-                l2x_vic[i].l2x_Flrl_rofliq += AreaFactor *
-                                              (cell.runoff +
-                                               cell.baseflow) / global_param.dt;
+                *l2x_field[L2X_FLRL_ROFLIQ] += AreaFactor *
+                                               (cell->runoff +
+                                                cell->baseflow) /
+                                               global_param.dt;
 
                 // lnd->rtm input fluxes
-                // l2x_vic[i].l2x_Flrl_rofice;
-
-                // vars set flag
-                l2x_vic[i].l2x_vars_set = true;
+                // *l2x_field[L2X_FLRL_ROFICE];
             }
         }
 
@@ -317,4 +337,7 @@ vic_cesm_put_data()
                      AreaFactorSum);
         }
     }
+
+    // vars set flag
+    l2x_vic.vars_set = true;
 }
@@ -107,33 +107,36 @@ print_x2l_data(x2l_data_struct *x2l)
 void
 print_l2x_data(l2x_data_struct *l2x)
 {
-    fprintf(LOG_DEST, "l2x_data            :\n");
-    fprintf(LOG_DEST, "\tl2x_Sl_t          : %f\n", l2x->l2x_Sl_t);
-    fprintf(LOG_DEST, "\tl2x_Sl_tref       : %f\n", l2x->l2x_Sl_tref);
-    fprintf(LOG_DEST, "\tl2x_Sl_qref       : %f\n", l2x->l2x_Sl_qref);
-    fprintf(LOG_DEST, "\tl2x_Sl_avsdr      : %f\n", l2x->l2x_Sl_avsdr);
-    fprintf(LOG_DEST, "\tl2x_Sl_anidr      : %f\n", l2x->l2x_Sl_anidr);
-    fprintf(LOG_DEST, "\tl2x_Sl_avsdf      : %f\n", l2x->l2x_Sl_avsdf);
-    fprintf(LOG_DEST, "\tl2x_Sl_anidf      : %f\n", l2x->l2x_Sl_anidf);
-    fprintf(LOG_DEST, "\tl2x_Sl_snowh      : %f\n", l2x->l2x_Sl_snowh);
-    fprintf(LOG_DEST, "\tl2x_Sl_u10        : %f\n", l2x->l2x_Sl_u10);
-    fprintf(LOG_DEST, "\tl2x_Sl_ddvel      : %f\n", l2x->l2x_Sl_ddvel);
-    fprintf(LOG_DEST, "\tl2x_Sl_fv         : %f\n", l2x->l2x_Sl_fv);
-    fprintf(LOG_DEST, "\tl2x_Sl_ram1       : %f\n", l2x->l2x_Sl_ram1);
-    fprintf(LOG_DEST, "\tl2x_Sl_logz0      : %f\n", l2x->l2x_Sl_logz0);
-    fprintf(LOG_DEST, "\tl2x_Fall_taux     : %f\n", l2x->l2x_Fall_taux);
-    fprintf(LOG_DEST, "\tl2x_Fall_tauy     : %f\n", l2x->l2x_Fall_tauy);
-    fprintf(LOG_DEST, "\tl2x_Fall_lat      : %f\n", l2x->l2x_Fall_lat);
-    fprintf(LOG_DEST, "\tl2x_Fall_sen      : %f\n", l2x->l2x_Fall_sen);
-    fprintf(LOG_DEST, "\tl2x_Fall_lwup     : %f\n", l2x->l2x_Fall_lwup);
-    fprintf(LOG_DEST, "\tl2x_Fall_evap     : %f\n", l2x->l2x_Fall_evap);
-    fprintf(LOG_DEST, "\tl2x_Fall_swnet    : %f\n", l2x->l2x_Fall_swnet);
-    fprintf(LOG_DEST, "\tl2x_Fall_fco2_lnd : %f\n", l2x->l2x_Fall_fco2_lnd);
-    fprintf(LOG_DEST, "\tl2x_Fall_flxdst1  : %f\n", l2x->l2x_Fall_flxdst1);
-    fprintf(LOG_DEST, "\tl2x_Fall_flxdst2  : %f\n", l2x->l2x_Fall_flxdst2);
-    fprintf(LOG_DEST, "\tl2x_Fall_flxdst3  : %f\n", l2x->l2x_Fall_flxdst3);
-    fprintf(LOG_DEST, "\tl2x_Fall_flxdst4  : %f\n", l2x->l2x_Fall_flxdst4);
-    fprintf(LOG_DEST, "\tl2x_Fall_flxvoc   : %f\n", l2x->l2x_Fall_flxvoc);
-    fprintf(LOG_DEST, "\tl2x_Flrl_rofliq   : %f\n", l2x->l2x_Flrl_rofliq);
-    fprintf(LOG_DEST, "\tl2x_Flrl_rofice   : %f\n", l2x->l2x_Flrl_rofice);
+    fprintf(LOG_DEST, "l2x_data       :\n");
+    fprintf(LOG_DEST, "\tnflds         : %zu\n", l2x->nflds);
+    fprintf(LOG_DEST, "\tdata          : %p\n", (void *) l2x->data);
+    fprintf(LOG_DEST, "\tvars_set      : %d\n", l2x->vars_set);
+    fprintf(LOG_DEST, "\tSl_t          : %d\n", l2x->index[L2X_SL_T]);
+    fprintf(LOG_DEST, "\tSl_tref       : %d\n", l2x->index[L2X_SL_TREF]);
+    fprintf(LOG_DEST, "\tSl_qref       : %d\n", l2x->index[L2X_SL_QREF]);
+    fprintf(LOG_DEST, "\tSl_avsdr      : %d\n", l2x->index[L2X_SL_AVSDR]);
+    fprintf(LOG_DEST, "\tSl_anidr      : %d\n", l2x->index[L2X_SL_ANIDR]);
+    fprintf(LOG_DEST, "\tSl_avsdf      : %d\n", l2x->index[L2X_SL_AVSDF]);
+    fprintf(LOG_DEST, "\tSl_anidf      : %d\n", l2x->index[L2X_SL_ANIDF]);
+    fprintf(LOG_DEST, "\tSl_snowh      : %d\n", l2x->index[L2X_SL_SNOWH]);
+    fprintf(LOG_DEST, "\tSl_u10        : %d\n", l2x->index[L2X_SL_U10]);
+    fprintf(LOG_DEST, "\tSl_ddvel      : %d\n", l2x->index[L2X_SL_DDVEL]);
+    fprintf(LOG_DEST, "\tSl_fv         : %d\n", l2x->index[L2X_SL_FV]);
+    fprintf(LOG_DEST, "\tSl_ram1       : %d\n", l2x->index[L2X_SL_RAM1]);
+    fprintf(LOG_DEST, "\tSl_logz0      : %d\n", l2x->index[L2X_SL_LOGZ0]);
+    fprintf(LOG_DEST, "\tFall_taux     : %d\n", l2x->index[L2X_FALL_TAUX]);
+    fprintf(LOG_DEST, "\tFall_tauy     : %d\n", l2x->index[L2X_FALL_TAUY]);
+    fprintf(LOG_DEST, "\tFall_lat      : %d\n", l2x->index[L2X_FALL_LAT]);
+    fprintf(LOG_DEST, "\tFall_sen      : %d\n", l2x->index[L2X_FALL_SEN]);
+    fprintf(LOG_DEST, "\tFall_lwup     : %d\n", l2x->index[L2X_FALL_LWUP]);
+    fprintf(LOG_DEST, "\tFall_evap     : %d\n", l2x->index[L2X_FALL_EVAP]);
+    fprintf(LOG_DEST, "\tFall_swnet    : %d\n", l2x->index[L2X_FALL_SWNET]);
+    fprintf(LOG_DEST, "\tFall_fco2_lnd : %d\n", l2x->index[L2X_FALL_FCO2_LND]);
+    fprintf(LOG_DEST, "\tFall_flxdst1  : %d\n", l2x->index[L2X_FALL_FLXDST1]);
+    fprintf(LOG_DEST, "\tFall_flxdst2  : %d\n", l2x->index[L2X_FALL_FLXDST2]);
+    fprintf(LOG_DEST, "\tFall_flxdst3  : %d\n", l2x->index[L2X_FALL_FLXDST3]);
+    fprintf(LOG_DEST, "\tFall_flxdst4  : %d\n", l2x->index[L2X_FALL_FLXDST4]);
+    fprintf(LOG_DEST, "\tFall_flxvoc   : %d\n", l2x->index[L2X_FALL_FLXVOC]);
+    fprintf(LOG_DEST, "\tFlrl_rofliq   : %d\n", l2x->index[L2X_FLRL_ROFLIQ]);
+    fprintf(LOG_DEST, "\tFlrl_rofice   : %d\n", l2x->index[L2X_FLRL_ROFICE]);
 }
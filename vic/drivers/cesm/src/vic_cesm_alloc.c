@@ -33,7 +33,6 @@ void
 vic_cesm_alloc(void)
 {
     extern x2l_data_struct *x2l_vic;
-    extern l2x_data_struct *l2x_vic;
     extern domain_struct    local_domain;
 
     debug("In vic_cesm_alloc");
@@ -44,11 +43,8 @@ vic_cesm_alloc(void)
     // initialize x2l data
     initialize_x2l_data();
 
-    // allocate memory for l2x_vic structure
-    l2x_vic = malloc(local_domain.ncells_active * sizeof(*l2x_vic));
-    check_alloc_status(l2x_vic, "Memory allocation error.");
-    // initialize l2x data
-    initialize_l2x_data();
+    // the l2x buffer is the coupler's attribute vector, it is attached in
+    // lnd_comp_mct.F90 and does not need to be allocated here
 
     // allocate the rest of the image mode structures
     vic_alloc();
@@ -33,11 +33,9 @@ void
 vic_cesm_finalize(void)
 {
     extern x2l_data_struct *x2l_vic;
-    extern l2x_data_struct *l2x_vic;
 
     // free VIC/CESM data structures
     free(x2l_vic);
-    free(l2x_vic);
 
     vic_finalize();
 }
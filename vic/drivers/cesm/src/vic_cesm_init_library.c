@@ -78,47 +78,38 @@ initialize_x2l_data(void)
 }
 
 /******************************************************************************
- * @brief    Initialize l2x_data_struct.
+ * @brief    Initialize l2x_data_struct.  The coupling buffer is zeroed and
+ *           every l2x field that VIC exchanges is set to the CESM missing
+ *           value.
  *****************************************************************************/
 void
 initialize_l2x_data(void)
 {
-    extern l2x_data_struct *l2x_vic;
-    extern domain_struct    local_domain;
+    extern l2x_data_struct l2x_vic;
+    extern domain_struct   local_domain;
 
-    size_t                  i;
+    size_t                 i;
+    size_t                 j;
+    double                *l2x;
+
+    l2x_vic.vars_set = false;
+
+    if (l2x_vic.data == NULL) {
+        // the attribute vector has not been handed over by the coupler yet
+        return;
+    }
 
     log_info("Setting all l2x fields to %f", SHR_CONST_SPVAL);
 
     for (i = 0; i < local_domain.ncells_active; i++) {
-        l2x_vic[i].l2x_Sl_t = SHR_CONST_SPVAL;
-        l2x_vic[i].l2x_Sl_tref = SHR_CONST_SPVAL;
-        l2x_vic[i].l2x_Sl_qref = SHR_CONST_SPVAL;
-        l2x_vic[i].l2x_Sl_avsdr = SHR_CONST_SPVAL;
-        l2x_vic[i].l2x_Sl_anidr = SHR_CONST_SPVAL;
-        l2x_vic[i].l2x_Sl_avsdf = SHR_CONST_SPVAL;
-        l2x_vic[i].l2x_Sl_anidf = SHR_CONST_SPVAL;
-        l2x_vic[i].l2x_Sl_snowh = SHR_CONST_SPVAL;
-        l2x_vic[i].l2x_Sl_u10 = SHR_CONST_SPVAL;
-        l2x_vic[i].l2x_Sl_ddvel = SHR_CONST_SPVAL;
-        l2x_vic[i].l2x_Sl_fv = SHR_CONST_SPVAL;
-        l2x_vic[i].l2x_Sl_ram1 = SHR_CONST_SPVAL;
-        l2x_vic[i].l2x_Sl_logz0 = SHR_CONST_SPVAL;
-        l2x_vic[i].l2x_Fall_taux = SHR_CONST_SPVAL;
-        l2x_vic[i].l2x_Fall_tauy = SHR_CONST_SPVAL;
-        l2x_vic[i].l2x_Fall_lat = SHR_CONST_SPVAL;
-        l2x_vic[i].l2x_Fall_sen = SHR_CONST_SPVAL;
-        l2x_vic[i].l2x_Fall_lwup = SHR_CONST_SPVAL;
-        l2x_vic[i].l2x_Fall_evap = SHR_CONST_SPVAL;
-        l2x_vic[i].l2x_Fall_swnet = SHR_CONST_SPVAL;
-        l2x_vic[i].l2x_Fall_fco2_lnd = SHR_CONST_SPVAL;
-        l2x_vic[i].l2x_Fall_flxdst1 = SHR_CONST_SPVAL;
-        l2x_vic[i].l2x_Fall_flxdst2 = SHR_CONST_SPVAL;
-        l2x_vic[i].l2x_Fall_flxdst3 = SHR_CONST_SPVAL;
-        l2x_vic[i].l2x_Fall_flxdst4 = SHR_CONST_SPVAL;
-        l2x_vic[i].l2x_Fall_flxvoc = SHR_CONST_SPVAL;
-        l2x_vic[i].l2x_Flrl_rofliq = SHR_CONST_SPVAL;
-        l2x_vic[i].l2x_Flrl_rofice = SHR_CONST_SPVAL;
-        l2x_vic[i].l2x_vars_set = true;
+        l2x = &(l2x_vic.data[i * l2x_vic.nflds]);
+        for (j = 0; j < l2x_vic.nflds; j++) {
+            l2x[j] = 0.;
+        }
+        for (j = 0; j < N_L2X_FIELDS; j++) {
+            if (l2x_vic.index[j] >= 0) {
+                l2x[l2x_vic.index[j]] = SHR_CONST_SPVAL;
+            }
+        }
     }
 }
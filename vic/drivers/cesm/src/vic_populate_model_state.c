@@ -83,7 +83,7 @@ vic_populate_model_state(char *runtype_str)
         compute_derived_state_vars(&(all_vars[i]), &(soil_con[i]), veg_con[i]);
         if (options.LAKES) {
             compute_derived_lake_dimensions(&(all_vars[i].lake_var),
-                                            lake_con[i]);
+                                            &(lake_con[i]));
         }
     }
 }
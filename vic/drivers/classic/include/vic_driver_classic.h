@@ -34,6 +34,20 @@
 #define BINHEADERSIZE 256
 #define MAX_VEGPARAM_LINE_LENGTH 500
 #define ASCII_STATE_FLOAT_FMT "%.16g"
+#define MAX_CALIB_PARAMS 20
+#define MAX_CALIB_VARS 10
+
+/******************************************************************************
+ * @brief   Soil parameters that can be set by a calibration parameter set
+ *****************************************************************************/
+enum
+{
+    CALIB_INFILT,                /**< b_infilt */
+    CALIB_DS,                    /**< Ds */
+    CALIB_DSMAX,                 /**< Dsmax */
+    CALIB_WS,                    /**< Ws */
+    CALIB_DEPTH                  /**< thickness of a soil layer */
+};
 
 /******************************************************************************
  * @brief   file structures
@@ -69,8 +83,36 @@ typedef struct {
     char veg[MAXSTRING];           /**< vegetation grid coverage file */
     char veglib[MAXSTRING];        /**< vegetation parameter library file */
     char log_path[MAXSTRING];      /**< Location to write log file to*/
+    char calib_params[MAXSTRING];  /**< table of calibration parameter sets */
+    char calib_obs[MAXSTRING];     /**< path and prefix of observed series */
+    char calib_result[MAXSTRING];  /**< calibration result file */
 } filenames_struct;
 
+/******************************************************************************
+ * @brief   Calibration batch mode: the parameter sets that are run for each
+ *          grid cell and the objective metrics computed for each of them.
+ *****************************************************************************/
+typedef struct {
+    size_t nsets;                  /**< number of parameter sets, 0 if not
+                                        calibrating */
+    size_t nparams;                /**< number of parameters of each set */
+    char param_name[MAX_CALIB_PARAMS][MAXSTRING]; /**< parameter names */
+    int param_type[MAX_CALIB_PARAMS]; /**< soil parameter of each column */
+    size_t param_layer[MAX_CALIB_PARAMS]; /**< soil layer (CALIB_DEPTH) */
+    double *values;                /**< parameter values [nsets][nparams] */
+    size_t nvars;                  /**< number of simulated variables */
+    char varname[MAX_CALIB_VARS][MAXSTRING]; /**< names of the simulated
+                                                  output variables */
+    int varid[MAX_CALIB_VARS];     /**< ids of the simulated output
+                                        variables */
+    size_t nsteps;                 /**< model steps per observation */
+    size_t nobs;                   /**< number of observations per cell */
+    bool write_series;             /**< write the simulated series */
+    double *obs;                   /**< observed series of a cell [nobs] */
+    double *sim;                   /**< simulated series of a cell [nobs] */
+    FILE *result;                  /**< calibration result file */
+} calib_struct;
+
 void alloc_atmos(int, force_data_struct **);
 void alloc_veg_hist(int nrecs, int nveg, veg_hist_struct ***veg_hist);
 void calc_netlongwave(double *, double, double, double);
@@ -79,13 +121,16 @@ void check_files(filep_struct *, filenames_struct *);
 bool check_save_state_flag(dmy_struct *, size_t);
 FILE  *check_state_file(char *, size_t, size_t, int *);
 void close_files(filep_struct *filep, stream_struct **streams);
+void compute_calib_metrics(double *sim, double *obs, size_t nobs,
+                           double *nse, double *kge, double *pbias);
 void compute_cell_area(soil_con_struct *);
 void free_atmos(int nrecs, force_data_struct **force);
+void free_calib(void);
 void free_veg_hist(int nrecs, int nveg, veg_hist_struct ***veg_hist);
 void free_veglib(veg_lib_struct **);
-double get_dist(double lat1, double long1, double lat2, double long2);
 void get_force_type(char *, int, int *);
 void get_global_param(FILE *);
+void initialize_calib(void);
 void initialize_filenames(void);
 void initialize_fileps(void);
 void initialize_forcing_files(void);
@@ -98,6 +143,8 @@ void parse_output_info(FILE *gp, stream_struct **output_streams,
                        dmy_struct *dmy_current);
 void read_atmos_data(FILE *, global_param_struct, int, int, double **,
                      double ***);
+void read_calib_obs(soil_con_struct *soil_con);
+void read_calib_params(void);
 double **read_forcing_data(FILE **, global_param_struct, double ****);
 void read_initial_model_state(FILE *, all_vars_struct *, int, int, int,
                               soil_con_struct *, lake_con_struct);
@@ -107,6 +154,13 @@ void read_soilparam(FILE *soilparam, soil_con_struct *temp, bool *RUN_MODEL,
                     bool *MODEL_DONE);
 veg_lib_struct *read_veglib(FILE *, size_t *);
 veg_con_struct *read_vegparam(FILE *, int, size_t);
+void set_calib_soil_con(soil_con_struct *soil_con, soil_con_struct *base,
+                        size_t set);
+void vic_calibrate_cell(all_vars_struct *all_vars, force_data_struct *force,
+                        dmy_struct *dmy, filep_struct *filep, int cellnum,
+                        int startrec, soil_con_struct *soil_con,
+                        veg_con_struct *veg_con, veg_hist_struct **veg_hist,
+                        lake_con_struct *lake_con, double **out_data);
 void vic_force(force_data_struct *, dmy_struct *, FILE **, veg_con_struct *,
                veg_hist_struct **, soil_con_struct *);
 void vic_populate_model_state(all_vars_struct *, filep_struct, size_t,
@@ -38,8 +38,10 @@ display_current_settings(int mode)
     extern param_set_struct    param_set;
     extern global_param_struct global_param;
     extern filenames_struct    filenames;
+    extern calib_struct        calib;
 
     int                        file_num;
+    size_t                     i;
 
     print_version(VIC_DRIVER);
 
@@ -95,6 +97,12 @@ display_current_settings(int mode)
     fprintf(LOG_DEST, "MODEL_DT\t\t%f\n", global_param.dt);
     fprintf(LOG_DEST, "SNOW_DT\t\t%f\n", global_param.snow_dt);
     fprintf(LOG_DEST, "RUNOFF_DT\t\t%f\n", global_param.runoff_dt);
+    if (options.RUNOFF_ADAPTIVE) {
+        fprintf(LOG_DEST, "RUNOFF_ADAPTIVE\t\tTRUE\n");
+    }
+    else {
+        fprintf(LOG_DEST, "RUNOFF_ADAPTIVE\t\tFALSE\n");
+    }
     fprintf(LOG_DEST, "ATMOS_DT\t\t%f\n", global_param.atmos_dt);
     fprintf(LOG_DEST, "STARTYEAR\t\t%d\n", global_param.startyear);
     fprintf(LOG_DEST, "STARTMONTH\t\t%d\n", global_param.startmonth);
@@ -429,6 +437,42 @@ display_current_settings(int mode)
         fprintf(LOG_DEST, "SAVE_STATE\t\tFALSE\n");
     }
 
+    fprintf(LOG_DEST, "\n");
+    fprintf(LOG_DEST, "Spin-up:\n");
+    if (global_param.spinup_cycles > 0) {
+        fprintf(LOG_DEST, "SPINUP_CYCLES\t\t%zu\n", global_param.spinup_cycles);
+        fprintf(LOG_DEST, "SPINUP_TOL_MOIST\t%f\n",
+                global_param.spinup_tol_moist);
+        fprintf(LOG_DEST, "SPINUP_TOL_TEMP\t\t%f\n",
+                global_param.spinup_tol_temp);
+        fprintf(LOG_DEST, "SPINUP_TOL_CARBON\t%f\n",
+                global_param.spinup_tol_carbon);
+    }
+    else {
+        fprintf(LOG_DEST, "SPINUP_CYCLES\t\t0\n");
+    }
+
+    fprintf(LOG_DEST, "\n");
+    fprintf(LOG_DEST, "Calibration:\n");
+    if (strcasecmp(filenames.calib_params, "MISSING") != 0) {
+        fprintf(LOG_DEST, "CALIB_PARAMS\t\t%s\n", filenames.calib_params);
+        fprintf(LOG_DEST, "CALIB_OBS\t\t%s\n", filenames.calib_obs);
+        fprintf(LOG_DEST, "CALIB_RESULT\t\t%s\n", filenames.calib_result);
+        for (i = 0; i < calib.nvars; i++) {
+            fprintf(LOG_DEST, "CALIB_VAR\t\t%s\n", calib.varname[i]);
+        }
+        fprintf(LOG_DEST, "CALIB_STEPS\t\t%zu\n", calib.nsteps);
+        if (calib.write_series) {
+            fprintf(LOG_DEST, "CALIB_SERIES\t\tTRUE\n");
+        }
+        else {
+            fprintf(LOG_DEST, "CALIB_SERIES\t\tFALSE\n");
+        }
+    }
+    else {
+        fprintf(LOG_DEST, "CALIB_PARAMS\t\tFALSE\n");
+    }
+
     fprintf(LOG_DEST, "\n");
     fprintf(LOG_DEST, "Output Data:\n");
     fprintf(LOG_DEST, "Result dir:\t\t%s\n", filenames.result_dir);
@@ -38,6 +38,7 @@ get_global_param(FILE *gp)
     extern global_param_struct global_param;
     extern param_set_struct    param_set;
     extern filenames_struct    filenames;
+    extern calib_struct        calib;
     extern size_t              NF, NR;
 
     char                       cmdstr[MAXSTRING];
@@ -85,6 +86,10 @@ get_global_param(FILE *gp)
             else if (strcasecmp("RUNOFF_STEPS_PER_DAY", optstr) == 0) {
                 sscanf(cmdstr, "%*s %zu", &global_param.runoff_steps_per_day);
             }
+            else if (strcasecmp("RUNOFF_ADAPTIVE", optstr) == 0) {
+                sscanf(cmdstr, "%*s %s", flgstr);
+                options.RUNOFF_ADAPTIVE = str_to_bool(flgstr);
+            }
             else if (strcasecmp("ATMOS_STEPS_PER_DAY", optstr) == 0) {
                 sscanf(cmdstr, "%*s %zu", &global_param.atmos_steps_per_day);
             }
@@ -341,6 +346,50 @@ get_global_param(FILE *gp)
                 }
             }
 
+            /*************************************
+               Define spin-up
+            *************************************/
+            else if (strcasecmp("SPINUP_CYCLES", optstr) == 0) {
+                sscanf(cmdstr, "%*s %zu", &global_param.spinup_cycles);
+            }
+            else if (strcasecmp("SPINUP_TOL_MOIST", optstr) == 0) {
+                sscanf(cmdstr, "%*s %lf", &global_param.spinup_tol_moist);
+            }
+            else if (strcasecmp("SPINUP_TOL_TEMP", optstr) == 0) {
+                sscanf(cmdstr, "%*s %lf", &global_param.spinup_tol_temp);
+            }
+            else if (strcasecmp("SPINUP_TOL_CARBON", optstr) == 0) {
+                sscanf(cmdstr, "%*s %lf", &global_param.spinup_tol_carbon);
+            }
+
+            /*************************************
+               Define calibration batch mode
+            *************************************/
+            else if (strcasecmp("CALIB_PARAMS", optstr) == 0) {
+                sscanf(cmdstr, "%*s %s", filenames.calib_params);
+            }
+            else if (strcasecmp("CALIB_OBS", optstr) == 0) {
+                sscanf(cmdstr, "%*s %s", filenames.calib_obs);
+            }
+            else if (strcasecmp("CALIB_RESULT", optstr) == 0) {
+                sscanf(cmdstr, "%*s %s", filenames.calib_result);
+            }
+            else if (strcasecmp("CALIB_VAR", optstr) == 0) {
+                if (calib.nvars >= MAX_CALIB_VARS) {
+                    log_err("Too many CALIB_VAR entries, the maximum is %d.",
+                            MAX_CALIB_VARS);
+                }
+                sscanf(cmdstr, "%*s %s", calib.varname[calib.nvars]);
+                calib.nvars++;
+            }
+            else if (strcasecmp("CALIB_STEPS", optstr) == 0) {
+                sscanf(cmdstr, "%*s %zu", &calib.nsteps);
+            }
+            else if (strcasecmp("CALIB_SERIES", optstr) == 0) {
+                sscanf(cmdstr, "%*s %s", flgstr);
+                calib.write_series = str_to_bool(flgstr);
+            }
+
             /*************************************
                Define forcing files
             *************************************/
@@ -1235,6 +1284,49 @@ get_global_param(FILE *gp)
                 filenames.statefile, filenames.init_state);
     }
 
+    // Validate the spin-up parameters
+    if (global_param.spinup_cycles > 0) {
+        if (!options.SAVE_STATE) {
+            log_err("SPINUP_CYCLES was specified, but no output state file "
+                    "was defined. The spin-up only writes the final model "
+                    "state, make sure STATENAME is set in the global "
+                    "parameter file.");
+        }
+        if (global_param.spinup_tol_moist < 0 ||
+            global_param.spinup_tol_temp < 0 ||
+            global_param.spinup_tol_carbon < 0) {
+            log_err("SPINUP_TOL_MOIST, SPINUP_TOL_TEMP and "
+                    "SPINUP_TOL_CARBON must be >= 0.");
+        }
+    }
+
+    // Validate the calibration batch mode
+    if (strcasecmp(filenames.calib_params, "MISSING") != 0) {
+        if (strcasecmp(filenames.calib_obs, "MISSING") == 0 ||
+            strcasecmp(filenames.calib_result, "MISSING") == 0) {
+            log_err("CALIB_PARAMS was specified, but CALIB_OBS or "
+                    "CALIB_RESULT was not. Both the observed series and the "
+                    "result file must be given for a calibration run.");
+        }
+        if (calib.nsteps < 1) {
+            log_err("CALIB_STEPS must be >= 1.");
+        }
+        if (global_param.spinup_cycles > 0) {
+            log_err("SPINUP_CYCLES cannot be combined with CALIB_PARAMS. "
+                    "Spin up the model separately and start the calibration "
+                    "run from the resulting INIT_STATE.");
+        }
+        if (options.SAVE_STATE) {
+            log_err("STATENAME cannot be combined with CALIB_PARAMS, no model "
+                    "state is saved in a calibration run.");
+        }
+        // default simulated series: total runoff
+        if (calib.nvars == 0) {
+            strcpy(calib.varname[calib.nvars++], "OUT_RUNOFF");
+            strcpy(calib.varname[calib.nvars++], "OUT_BASEFLOW");
+        }
+    }
+
     // Default file formats (if unset)
     if (options.SAVE_STATE && options.STATE_FORMAT == UNSET_FILE_FORMAT) {
         options.STATE_FORMAT = ASCII;
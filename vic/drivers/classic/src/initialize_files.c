@@ -48,6 +48,9 @@ initialize_filenames()
     strcpy(filenames.lakeparam, "MISSING");
     strcpy(filenames.result_dir, "MISSING");
     strcpy(filenames.log_path, "MISSING");
+    strcpy(filenames.calib_params, "MISSING");
+    strcpy(filenames.calib_obs, "MISSING");
+    strcpy(filenames.calib_result, "MISSING");
     for (i = 0; i < 2; i++) {
         strcpy(filenames.f_path_pfx[i], "MISSING");
     }
@@ -56,6 +56,7 @@ parse_output_info(FILE           *gp,
     int                        freq_n;
     dmy_struct                 freq_dmy;
     unsigned short int         agg_type;
+    double                     aggparam[3];
     int                        found;
     size_t                     nstream_vars[MAX_OUTPUT_STREAMS];
     bool                       default_outputs = false;
@@ -196,8 +197,10 @@ parse_output_info(FILE           *gp,
                     strcpy(typestr, "");
                     strcpy(multstr, "");
                     strcpy(aggstr, "");
-                    found = sscanf(cmdstr, "%*s %s %s %s %s %s", varname,
-                                   format, typestr, multstr, aggstr);
+                    found = sscanf(cmdstr, "%*s %s %s %s %s %s %lf %lf %lf",
+                                   varname, format, typestr, multstr, aggstr,
+                                   &(aggparam[0]), &(aggparam[1]),
+                                   &(aggparam[2]));
                     if (!found) {
                         log_err("OUTVAR specified but no variable was listed");
                     }
@@ -210,6 +213,9 @@ parse_output_info(FILE           *gp,
                     // Add OUTVAR to stream
                     set_output_var(&(*streams)[streamnum], varname, outvarnum,
                                    format, type, mult, agg_type);
+                    // parameters of the aggregation follow the aggregation type
+                    set_output_agg_param(&(*streams)[streamnum], outvarnum,
+                                         aggparam, (size_t) max(found - 5, 0));
                     outvarnum++;
                 }
             }
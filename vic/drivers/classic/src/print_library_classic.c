@@ -150,6 +150,9 @@ print_filenames(filenames_struct *fnames)
     fprintf(LOG_DEST, "\tveg          : %s\n", fnames->veg);
     fprintf(LOG_DEST, "\tveglib       : %s\n", fnames->veglib);
     fprintf(LOG_DEST, "\tlog_path     : %s\n", fnames->log_path);
+    fprintf(LOG_DEST, "\tcalib_params : %s\n", fnames->calib_params);
+    fprintf(LOG_DEST, "\tcalib_obs    : %s\n", fnames->calib_obs);
+    fprintf(LOG_DEST, "\tcalib_result : %s\n", fnames->calib_result);
 }
 
 /******************************************************************************
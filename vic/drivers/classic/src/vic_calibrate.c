@@ -0,0 +1,610 @@
+/******************************************************************************
+ * @section DESCRIPTION
+ *
+ * Calibration batch mode of the classic driver.
+ *
+ * A table of soil parameter sets is run for each grid cell. The forcing of a
+ * cell is read and disaggregated once, after which every parameter set is run
+ * from a copy of the soil parameters of the cell. Instead of the history
+ * files, the objective metrics of each set against an observed series are
+ * written to a single result file.
+ *
+ * @section LICENSE
+ *
+ * The Variable Infiltration Capacity (VIC) macroscale hydrological model
+ * Copyright (C) 2016 The Computational Hydrology Group, Department of Civil
+ * and Environmental Engineering, University of Washington.
+ *
+ * The VIC model is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *****************************************************************************/
+
+#include <vic_driver_classic.h>
+
+/******************************************************************************
+ * @brief    Initialize the calibration settings to their defaults.
+ *****************************************************************************/
+void
+initialize_calib(void)
+{
+    extern calib_struct calib;
+
+    calib.nsets = 0;
+    calib.nparams = 0;
+    calib.values = NULL;
+    calib.nvars = 0;
+    calib.nsteps = 1;
+    calib.nobs = 0;
+    calib.write_series = false;
+    calib.obs = NULL;
+    calib.sim = NULL;
+    calib.result = NULL;
+}
+
+/******************************************************************************
+ * @brief    Read the table of calibration parameter sets and open the result
+ *           file.
+ * @details  The first line of the table holds the names of the parameters
+ *           (INFILT, DS, DSMAX, WS and DEPTH<n> for the thickness of soil
+ *           layer n), each following line one parameter set. Empty lines and
+ *           lines starting with '#' are skipped. Must be called after the
+ *           output metadata has been set.
+ *****************************************************************************/
+void
+read_calib_params(void)
+{
+    extern calib_struct        calib;
+    extern filenames_struct    filenames;
+    extern global_param_struct global_param;
+    extern option_struct       options;
+    extern metadata_struct     out_metadata[N_OUTVAR_TYPES];
+    extern FILE               *open_file(char string[], char type[]);
+
+    FILE                      *fp;
+    char                       line[MAXSTRING];
+    char                      *token;
+    const char                 delimiters[] = " \t\r\n";
+    size_t                     nalloc;
+    size_t                     layer;
+    size_t                     i;
+    size_t                     j;
+    int                        varid;
+
+    fp = open_file(filenames.calib_params, "r");
+
+    // parameter names
+    calib.nparams = 0;
+    while (calib.nparams == 0 && fgets(line, MAXSTRING, fp) != NULL) {
+        token = strtok(line, delimiters);
+        if (token == NULL || token[0] == '#') {
+            continue;
+        }
+        while (token != NULL) {
+            if (calib.nparams >= MAX_CALIB_PARAMS) {
+                log_err("Too many calibration parameters in %s, the maximum "
+                        "is %d.", filenames.calib_params, MAX_CALIB_PARAMS);
+            }
+            i = calib.nparams;
+            strcpy(calib.param_name[i], token);
+            calib.param_layer[i] = 0;
+            if (strcasecmp("INFILT", token) == 0) {
+                calib.param_type[i] = CALIB_INFILT;
+            }
+            else if (strcasecmp("DS", token) == 0) {
+                calib.param_type[i] = CALIB_DS;
+            }
+            else if (strcasecmp("DSMAX", token) == 0) {
+                calib.param_type[i] = CALIB_DSMAX;
+            }
+            else if (strcasecmp("WS", token) == 0) {
+                calib.param_type[i] = CALIB_WS;
+            }
+            else if (strncasecmp("DEPTH", token, 5) == 0 &&
+                     sscanf(token + 5, "%zu", &layer) == 1) {
+                // the top layer also sets the soil thermal node spacing
+                if (layer < 2 || layer > options.Nlayer) {
+                    log_err("Calibration parameter %s in %s: only the "
+                            "thickness of soil layers 2 to %zu can be "
+                            "calibrated.", token, filenames.calib_params,
+                            options.Nlayer);
+                }
+                calib.param_type[i] = CALIB_DEPTH;
+                calib.param_layer[i] = layer - 1;
+            }
+            else {
+                log_err("Unknown calibration parameter %s in %s. Valid "
+                        "names are INFILT, DS, DSMAX, WS and DEPTH<n>.",
+                        token, filenames.calib_params);
+            }
+            // the NIJSSEN2001 baseflow parameters are converted using the
+            // moisture capacity of the bottom layer
+            if (options.BASEFLOW == NIJSSEN2001 &&
+                calib.param_type[i] != CALIB_INFILT &&
+                !(calib.param_type[i] == CALIB_DEPTH &&
+                  calib.param_layer[i] < options.Nlayer - 1)) {
+                log_err("Calibration parameter %s cannot be used with "
+                        "BASEFLOW NIJSSEN2001, use the ARNO baseflow "
+                        "parameters for calibration.", token);
+            }
+            calib.nparams++;
+            token = strtok(NULL, delimiters);
+        }
+    }
+    if (calib.nparams == 0) {
+        log_err("No calibration parameter names found in %s",
+                filenames.calib_params);
+    }
+
+    // parameter sets
+    calib.nsets = 0;
+    nalloc = 0;
+    while (fgets(line, MAXSTRING, fp) != NULL) {
+        token = strtok(line, delimiters);
+        if (token == NULL || token[0] == '#') {
+            continue;
+        }
+        if (calib.nsets == nalloc) {
+            nalloc = nalloc > 0 ? 2 * nalloc : 64;
+            calib.values = realloc(calib.values,
+                                   nalloc * calib.nparams *
+                                   sizeof(*(calib.values)));
+            check_alloc_status(calib.values, "Memory allocation error.");
+        }
+        for (j = 0; j < calib.nparams; j++) {
+            if (token == NULL ||
+                sscanf(token, "%lf",
+                       &(calib.values[calib.nsets * calib.nparams + j])) !=
+                1) {
+                log_err("Parameter set %zu in %s does not have a valid value "
+                        "for each of the %zu parameters.", calib.nsets + 1,
+                        filenames.calib_params, calib.nparams);
+            }
+            token = strtok(NULL, delimiters);
+        }
+        calib.nsets++;
+    }
+    fclose(fp);
+    if (calib.nsets == 0) {
+        log_err("No calibration parameter sets found in %s",
+                filenames.calib_params);
+    }
+
+    // simulated variables
+    for (i = 0; i < calib.nvars; i++) {
+        for (varid = 0; varid < N_OUTVAR_TYPES; varid++) {
+            if (strcmp(out_metadata[varid].varname, calib.varname[i]) == 0) {
+                break;
+            }
+        }
+        if (varid == N_OUTVAR_TYPES) {
+            log_err("CALIB_VAR \"%s\" was not found in the list of supported "
+                    "output variable names.", calib.varname[i]);
+        }
+        calib.varid[i] = varid;
+    }
+
+    // observations cover whole intervals of CALIB_STEPS model steps
+    calib.nobs = global_param.nrecs / calib.nsteps;
+    if (calib.nobs == 0) {
+        log_err("The simulation period (%zu steps) is shorter than "
+                "CALIB_STEPS (%zu).", global_param.nrecs, calib.nsteps);
+    }
+    calib.obs = calloc(calib.nobs, sizeof(*(calib.obs)));
+    check_alloc_status(calib.obs, "Memory allocation error.");
+    calib.sim = calloc(calib.nobs, sizeof(*(calib.sim)));
+    check_alloc_status(calib.sim, "Memory allocation error.");
+
+    calib.result = open_file(filenames.calib_result, "w");
+    fprintf(calib.result, "CELL\tSET");
+    for (i = 0; i < calib.nparams; i++) {
+        fprintf(calib.result, "\t%s", calib.param_name[i]);
+    }
+    fprintf(calib.result, "\tNSE\tKGE\tPBIAS");
+    if (calib.write_series) {
+        for (i = 0; i < calib.nobs; i++) {
+            fprintf(calib.result, "\tSIM_%zu", i + 1);
+        }
+    }
+    fprintf(calib.result, "\n");
+
+    log_info("Calibration: running %zu parameter sets for each grid cell",
+             calib.nsets);
+}
+
+/******************************************************************************
+ * @brief    Read the observed series of a grid cell.
+ * @details  The file name is CALIB_OBS followed by the cell latitude and
+ *           longitude, like the forcing files. The file holds one value per
+ *           interval of CALIB_STEPS model steps, starting at the first step
+ *           of the simulation. Negative values mark missing observations.
+ *****************************************************************************/
+void
+read_calib_obs(soil_con_struct *soil_con)
+{
+    extern calib_struct     calib;
+    extern filenames_struct filenames;
+    extern option_struct    options;
+    extern FILE            *open_file(char string[], char type[]);
+
+    FILE                   *fp;
+    char                    filename[MAXSTRING];
+    char                    latchar[20];
+    char                    lngchar[20];
+    char                    junk[20];
+    size_t                  i;
+
+    snprintf(junk, sizeof(junk), "%%.%if", options.GRID_DECIMAL);
+    snprintf(latchar, sizeof(latchar), junk, soil_con->lat);
+    snprintf(lngchar, sizeof(lngchar), junk, soil_con->lng);
+    if (snprintf(filename, MAXSTRING, "%s%s_%s", filenames.calib_obs,
+                 latchar, lngchar) >= MAXSTRING) {
+        log_err("The name of the calibration observation file %s%s_%s is "
+                "too long", filenames.calib_obs, latchar, lngchar);
+    }
+
+    fp = open_file(filename, "r");
+    for (i = 0; i < calib.nobs; i++) {
+        if (fscanf(fp, "%lf", &(calib.obs[i])) != 1) {
+            log_err("%s holds fewer than the %zu observations of the "
+                    "simulation period.", filename, calib.nobs);
+        }
+        if (!(calib.obs[i] >= 0.)) {
+            calib.obs[i] = MISSING;
+        }
+    }
+    fclose(fp);
+}
+
+/******************************************************************************
+ * @brief    Set the soil parameters of a calibration parameter set.
+ * @details  soil_con is a copy of the soil parameters of the cell (base) with
+ *           the values of the set. Changing the thickness of a layer also
+ *           updates the moisture capacity of the layer, its critical and
+ *           wilting points (which are fractions of the capacity) and the
+ *           soil moisture - water table relationship, as done for the soil
+ *           parameter file.
+ *****************************************************************************/
+void
+set_calib_soil_con(soil_con_struct *soil_con,
+                   soil_con_struct *base,
+                   size_t           set)
+{
+    extern calib_struct  calib;
+    extern option_struct options;
+
+    double              *values;
+    double               ratio;
+    bool                 new_depth;
+    size_t               layer;
+    size_t               i;
+
+    *soil_con = *base;
+
+    values = calib.values + set * calib.nparams;
+    new_depth = false;
+    for (i = 0; i < calib.nparams; i++) {
+        switch (calib.param_type[i]) {
+        case CALIB_INFILT:
+            soil_con->b_infilt = values[i];
+            break;
+        case CALIB_DS:
+            soil_con->Ds = values[i];
+            break;
+        case CALIB_DSMAX:
+            soil_con->Dsmax = values[i];
+            break;
+        case CALIB_WS:
+            soil_con->Ws = values[i];
+            break;
+        case CALIB_DEPTH:
+            // rounded to the nearest mm like the soil parameter file
+            layer = calib.param_layer[i];
+            soil_con->depth[layer] = round(values[i] * MM_PER_M) / MM_PER_M;
+            new_depth = true;
+            break;
+        default:
+            log_err("Unknown calibration parameter type %d",
+                    calib.param_type[i]);
+        }
+    }
+
+    if (soil_con->b_infilt <= 0) {
+        log_err("b_infilt (%f) of calibration parameter set %zu is <= 0; "
+                "b_infilt must be positive", soil_con->b_infilt, set + 1);
+    }
+
+    if (new_depth) {
+        for (layer = 0; layer < options.Nlayer; layer++) {
+            if (soil_con->depth[layer] < MINSOILDEPTH) {
+                log_err("Model will not function with layer %zu depth %f < "
+                        "%f m in calibration parameter set %zu.", layer,
+                        soil_con->depth[layer], MINSOILDEPTH, set + 1);
+            }
+            ratio = soil_con->depth[layer] / base->depth[layer];
+            soil_con->max_moist[layer] = soil_con->depth[layer] *
+                                         soil_con->porosity[layer] *
+                                         MM_PER_M;
+            soil_con->Wcr[layer] = base->Wcr[layer] * ratio;
+            soil_con->Wpwp[layer] = base->Wpwp[layer] * ratio;
+        }
+        if (soil_con->depth[0] > soil_con->depth[1]) {
+            log_err("Model will not function with layer %d depth (%f m) > "
+                    "layer %d depth (%f m) in calibration parameter set "
+                    "%zu.", 0, soil_con->depth[0], 1, soil_con->depth[1],
+                    set + 1);
+        }
+        soil_moisture_from_water_table(soil_con, options.Nlayer);
+    }
+
+    // Maximum infiltration of the upper layers
+    if (options.Nlayer == 2) {
+        soil_con->max_infil = (1.0 + soil_con->b_infilt) *
+                              soil_con->max_moist[0];
+    }
+    else {
+        soil_con->max_infil = (1.0 + soil_con->b_infilt) *
+                              (soil_con->max_moist[0] +
+                               soil_con->max_moist[1]);
+    }
+}
+
+/******************************************************************************
+ * @brief    Compute the objective metrics of a simulated series.
+ * @details  Intervals where the observation or the simulation is MISSING are
+ *           skipped. nse is the Nash-Sutcliffe efficiency, kge the Kling-Gupta
+ *           efficiency (Gupta et al., 2009) and pbias the bias of the
+ *           simulated total in percent of the observed total. A metric that
+ *           is undefined for the series is set to MISSING.
+ *****************************************************************************/
+void
+compute_calib_metrics(double *sim,
+                      double *obs,
+                      size_t  nobs,
+                      double *nse,
+                      double *kge,
+                      double *pbias)
+{
+    double sum_obs;
+    double sum_sim;
+    double mean_obs;
+    double mean_sim;
+    double sse;
+    double var_obs;
+    double var_sim;
+    double cov;
+    double r;
+    double alpha;
+    double beta;
+    size_t n;
+    size_t i;
+
+    *nse = MISSING;
+    *kge = MISSING;
+    *pbias = MISSING;
+
+    n = 0;
+    sum_obs = 0.;
+    sum_sim = 0.;
+    for (i = 0; i < nobs; i++) {
+        if (obs[i] != MISSING && sim[i] != MISSING) {
+            sum_obs += obs[i];
+            sum_sim += sim[i];
+            n++;
+        }
+    }
+    if (n < 2) {
+        return;
+    }
+    mean_obs = sum_obs / n;
+    mean_sim = sum_sim / n;
+
+    sse = 0.;
+    var_obs = 0.;
+    var_sim = 0.;
+    cov = 0.;
+    for (i = 0; i < nobs; i++) {
+        if (obs[i] != MISSING && sim[i] != MISSING) {
+            sse += (sim[i] - obs[i]) * (sim[i] - obs[i]);
+            var_obs += (obs[i] - mean_obs) * (obs[i] - mean_obs);
+            var_sim += (sim[i] - mean_sim) * (sim[i] - mean_sim);
+            cov += (sim[i] - mean_sim) * (obs[i] - mean_obs);
+        }
+    }
+
+    if (var_obs > 0.) {
+        *nse = 1. - sse / var_obs;
+    }
+    if (sum_obs > 0.) {
+        *pbias = 100. * (sum_sim - sum_obs) / sum_obs;
+    }
+    if (var_obs > 0. && var_sim > 0. && mean_obs > 0.) {
+        r = cov / sqrt(var_obs * var_sim);
+        alpha = sqrt(var_sim / var_obs);
+        beta = mean_sim / mean_obs;
+        *kge = 1. - sqrt((r - 1.) * (r - 1.) + (alpha - 1.) * (alpha - 1.) +
+                         (beta - 1.) * (beta - 1.));
+    }
+}
+
+/******************************************************************************
+ * @brief    Run all calibration parameter sets for a grid cell.
+ * @details  The forcing (force, veg_hist) has been read for the cell and is
+ *           shared by all sets. Each set starts from the same initial state:
+ *           the initial state file is read again from the position of the
+ *           cell. The simulated series is the sum of the CALIB_VAR output
+ *           variables over each interval of CALIB_STEPS model steps;
+ *           intervals that are not fully simulated (before startrec, or after
+ *           a failed step with CONTINUEONERROR) are MISSING, and so are the
+ *           metrics of a failed set. soil_con is restored to the parameters
+ *           of the cell on return.
+ *****************************************************************************/
+void
+vic_calibrate_cell(all_vars_struct   *all_vars,
+                   force_data_struct *force,
+                   dmy_struct        *dmy,
+                   filep_struct      *filep,
+                   int                cellnum,
+                   int                startrec,
+                   soil_con_struct   *soil_con,
+                   veg_con_struct    *veg_con,
+                   veg_hist_struct  **veg_hist,
+                   lake_con_struct   *lake_con,
+                   double           **out_data)
+{
+    extern calib_struct        calib;
+    extern global_param_struct global_param;
+    extern option_struct       options;
+    extern veg_lib_struct     *veg_lib;
+
+    char                       dmy_str[256];   // sprint_dmy output
+    double                     nse;
+    double                     kge;
+    double                     pbias;
+    long                       state_pos;
+    size_t                     set;
+    size_t                     rec;
+    size_t                     nrecs;
+    size_t                     i;
+    size_t                     j;
+    int                        ErrorFlag;
+    soil_con_struct            base;
+    save_data_struct           save_data;
+    timer_struct               cell_timer;
+
+    read_calib_obs(soil_con);
+
+    base = *soil_con;
+    state_pos = 0;
+    if (options.INIT_STATE) {
+        state_pos = ftell(filep->init_state);
+    }
+    // only the intervals with observations are run
+    nrecs = calib.nobs * calib.nsteps;
+
+    for (set = 0; set < calib.nsets; set++) {
+        set_calib_soil_con(soil_con, &base, set);
+        // the root fractions of each layer depend on the layer thicknesses;
+        // calc_root_fractions only sets the layers the root zones reach
+        for (j = 0; j < veg_con[0].vegetat_type_num; j++) {
+            for (i = 0; i < options.Nlayer; i++) {
+                veg_con[j].root[i] = 0.;
+            }
+        }
+        calc_root_fractions(veg_con, soil_con);
+
+        if (options.INIT_STATE &&
+            fseek(filep->init_state, state_pos, SEEK_SET) != 0) {
+            log_err("Error repositioning the initial state file");
+        }
+        vic_populate_model_state(all_vars, *filep, soil_con->gridcel,
+                                 soil_con, veg_con, *lake_con);
+        initialize_save_data(all_vars, &force[0], soil_con, veg_con,
+                             veg_lib, lake_con, out_data, &save_data,
+                             &cell_timer);
+
+        for (i = 0; i < calib.nobs; i++) {
+            calib.sim[i] = 0.;
+        }
+        for (i = 0; i < calib.nobs && i * calib.nsteps < (size_t) startrec;
+             i++) {
+            calib.sim[i] = MISSING;
+        }
+
+        ErrorFlag = 0;
+        for (rec = startrec; rec < nrecs; rec++) {
+            sprint_dmy(dmy_str, &(dmy[rec]));
+            snprintf(vic_run_ref_str, MAXSTRING,
+                     "Gridcell cellnum: %i, calibration set: %zu, "
+                     "timestep info: %s", cellnum, set + 1, dmy_str);
+
+            ErrorFlag = update_step_vars(all_vars, veg_con, veg_hist[rec]);
+
+            timer_start(&cell_timer);
+            ErrorFlag = vic_run(&force[rec], all_vars, &(dmy[rec]),
+                                &global_param, lake_con, soil_con, veg_con,
+                                veg_lib);
+            timer_stop(&cell_timer);
+
+            if (ErrorFlag == ERROR) {
+                if (options.CONTINUEONERROR) {
+                    log_warn("ERROR: Grid cell %i failed in record %zu with "
+                             "calibration parameter set %zu, its metrics are "
+                             "set to missing.",
+                             soil_con->gridcel, rec, set + 1);
+                    for (i = rec / calib.nsteps; i < calib.nobs; i++) {
+                        calib.sim[i] = MISSING;
+                    }
+                    break;
+                }
+                else {
+                    log_err("ERROR: Grid cell %i failed in record %zu with "
+                            "calibration parameter set %zu so the "
+                            "simulation has ended. Check your inputs "
+                            "before rerunning the simulation.",
+                            soil_con->gridcel, rec, set + 1);
+                }
+            }
+
+            put_data(all_vars, &force[rec], soil_con, veg_con, veg_lib,
+                     lake_con, out_data, &save_data, &cell_timer);
+
+            i = rec / calib.nsteps;
+            if (calib.sim[i] != MISSING) {
+                for (j = 0; j < calib.nvars; j++) {
+                    calib.sim[i] += out_data[calib.varid[j]][0];
+                }
+            }
+        }
+
+        if (ErrorFlag == ERROR) {
+            nse = MISSING;
+            kge = MISSING;
+            pbias = MISSING;
+        }
+        else {
+            compute_calib_metrics(calib.sim, calib.obs, calib.nobs, &nse,
+                                  &kge, &pbias);
+        }
+        fprintf(calib.result, "%d\t%zu", soil_con->gridcel, set + 1);
+        for (i = 0; i < calib.nparams; i++) {
+            fprintf(calib.result, "\t%g",
+                    calib.values[set * calib.nparams + i]);
+        }
+        fprintf(calib.result, "\t%.6f\t%.6f\t%.6f", nse, kge, pbias);
+        if (calib.write_series) {
+            for (i = 0; i < calib.nobs; i++) {
+                fprintf(calib.result, "\t%.6g", calib.sim[i]);
+            }
+        }
+        fprintf(calib.result, "\n");
+    }
+
+    *soil_con = base;
+}
+
+/******************************************************************************
+ * @brief    Close the result file and free the calibration parameter sets.
+ *****************************************************************************/
+void
+free_calib(void)
+{
+    extern calib_struct calib;
+
+    if (calib.result != NULL) {
+        fclose(calib.result);
+    }
+    free(calib.values);
+    free(calib.obs);
+    free(calib.sim);
+}
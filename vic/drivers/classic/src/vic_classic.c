@@ -42,6 +42,7 @@ parameters_struct   param;
 filenames_struct    filenames;
 filep_struct        filep;
 metadata_struct     out_metadata[N_OUTVAR_TYPES];
+calib_struct        calib;
 
 /******************************************************************************
  * @brief   Classic driver of the VIC model
@@ -60,8 +61,12 @@ main(int   argc,
 
     bool               MODEL_DONE;
     bool               RUN_MODEL;
+    bool               SPINUP_DONE;
     char               dmy_str[MAXSTRING];
     size_t             rec;
+    size_t             i;
+    size_t             spinup_cycle;
+    size_t             spinup_nstorage;
     size_t             Nveg_type;
     int                cellnum;
     int                startrec;
@@ -77,6 +82,7 @@ main(int   argc,
     lake_con_struct    lake_con;
     stream_struct     *streams = NULL;
     double          ***out_data;   // [1, nvars, nelem]
+    double            *spinup_storage;   // [spinup_nstorage]
     save_data_struct   save_data;
     timer_struct       global_timers[N_TIMERS];
     timer_struct       cell_timer;
@@ -97,6 +103,7 @@ main(int   argc,
     initialize_global();
     initialize_parameters();
     initialize_filenames();
+    initialize_calib();
 
     /* Initilize forcing file param structure */
     initialize_forcing_files();
@@ -125,9 +132,17 @@ main(int   argc,
     set_output_met_data_info();
     // out_data is shape [ngridcells (1), N_OUTVAR_TYPES]
     alloc_out_data(1, &out_data);
-    filep.globalparam = open_file(filenames.global, "r");
-    parse_output_info(filep.globalparam, &streams, &(dmy[0]));
-    validate_streams(&streams);
+    if (strcasecmp(filenames.calib_params, "MISSING") != 0) {
+        // a calibration run writes the objective metrics of each parameter
+        // set instead of the history files
+        options.Noutstreams = 0;
+        read_calib_params();
+    }
+    else {
+        filep.globalparam = open_file(filenames.global, "r");
+        parse_output_info(filep.globalparam, &streams, &(dmy[0]));
+        validate_streams(&streams);
+    }
 
     /** Check and Open Files **/
     check_files(&filep, &filenames);
@@ -141,6 +156,11 @@ main(int   argc,
     /** allocate memory for the force_data_struct **/
     alloc_atmos(global_param.nrecs, &force);
 
+    /** storages at the end of the previous spin-up cycle **/
+    spinup_nstorage = get_spinup_nstorage();
+    spinup_storage = calloc(spinup_nstorage, sizeof(*spinup_storage));
+    check_alloc_status(spinup_storage, "Memory allocation error.");
+
     /** Initial state **/
     startrec = 0;
     if (options.INIT_STATE) {
@@ -216,91 +236,149 @@ main(int   argc,
 
             vic_force(force, dmy, filep.forcing, veg_con, veg_hist, &soil_con);
 
-            /**************************************************
-               Initialize Energy Balance and Snow Variables
-            **************************************************/
-
-            vic_populate_model_state(&all_vars, filep, soil_con.gridcel,
-                                     &soil_con, veg_con, lake_con);
-
-            /** Initialize the storage terms in the water and energy balances **/
-            initialize_save_data(&all_vars, &force[0], &soil_con, veg_con,
-                                 veg_lib, &lake_con, out_data[0], &save_data,
-                                 &cell_timer);
-
-            /******************************************
-               Run Model in Grid Cell for all Time Steps
-            ******************************************/
-
-            for (rec = startrec; rec < global_param.nrecs; rec++) {
-                // Set global reference string (for debugging inside vic_run)
-                sprint_dmy(dmy_str, &(dmy[rec]));
-                sprintf(vic_run_ref_str,
-                        "Gridcell cellnum: %i, timestep info: %s",
-                        cellnum, dmy_str);
-
-                /**************************************************
-                   Update data structures for current time step
-                **************************************************/
-                ErrorFlag = update_step_vars(&all_vars, veg_con,
-                                             veg_hist[rec]);
-
+            if (calib.nsets > 0) {
                 /**************************************************
-                   Compute cell physics for 1 timestep
+                   Run all calibration parameter sets
                 **************************************************/
-                timer_start(&cell_timer);
-                ErrorFlag = vic_run(&force[rec], &all_vars,
-                                    &(dmy[rec]), &global_param, &lake_con,
-                                    &soil_con, veg_con, veg_lib);
-                timer_stop(&cell_timer);
-
+                vic_calibrate_cell(&all_vars, force, dmy, &filep, cellnum,
+                                   startrec, &soil_con, veg_con, veg_hist,
+                                   &lake_con, out_data[0]);
+            }
+            else {
                 /**************************************************
-                   Calculate cell average values for current time step
+                   Initialize Energy Balance and Snow Variables
                 **************************************************/
-                put_data(&all_vars, &force[rec], &soil_con, veg_con, veg_lib,
-                         &lake_con, out_data[0], &save_data, &cell_timer);
-
-                for (streamnum = 0;
-                     streamnum < options.Noutstreams;
-                     streamnum++) {
-                    agg_stream_data(&(streams[streamnum]), &(dmy[rec]),
-                                    out_data);
-                }
 
-                // Write cell average values for current time step
-                write_output(&streams, &dmy[rec]);
-
-                /************************************
-                   Save model state at assigned date
-                   (after the final time step of the assigned date)
-                ************************************/
-                if (filep.statefile != NULL &&
-                    check_save_state_flag(dmy, rec)) {
-                    write_model_state(&all_vars, veg_con->vegetat_type_num,
-                                      soil_con.gridcel, &filep, &soil_con);
+                vic_populate_model_state(&all_vars, filep, soil_con.gridcel,
+                                         &soil_con, veg_con, lake_con);
+
+                /** Initialize the storage terms in the water and energy
+                    balances **/
+                initialize_save_data(&all_vars, &force[0], &soil_con, veg_con,
+                                     veg_lib, &lake_con, out_data[0],
+                                     &save_data, &cell_timer);
+
+                /******************************************
+                   Run Model in Grid Cell for all Time Steps
+                   (repeatedly during spin-up, until the cell
+                   has converged)
+                ******************************************/
+                spinup_cycle = 0;
+                for (i = 0; i < spinup_nstorage; i++) {
+                    spinup_storage[i] = MISSING;
                 }
+                do {
+                    for (rec = startrec; rec < global_param.nrecs; rec++) {
+                        // Set global reference string (for debugging inside
+                        // vic_run)
+                        sprint_dmy(dmy_str, &(dmy[rec]));
+                        sprintf(vic_run_ref_str,
+                                "Gridcell cellnum: %i, timestep info: %s",
+                                cellnum, dmy_str);
+
+                        /**************************************************
+                           Update data structures for current time step
+                        **************************************************/
+                        ErrorFlag = update_step_vars(&all_vars, veg_con,
+                                                     veg_hist[rec]);
+
+                        /**************************************************
+                           Compute cell physics for 1 timestep
+                        **************************************************/
+                        timer_start(&cell_timer);
+                        ErrorFlag = vic_run(&force[rec], &all_vars,
+                                            &(dmy[rec]), &global_param,
+                                            &lake_con, &soil_con, veg_con,
+                                            veg_lib);
+                        timer_stop(&cell_timer);
+
+                        /**************************************************
+                           Calculate cell average values for current time step
+                        **************************************************/
+                        put_data(&all_vars, &force[rec], &soil_con, veg_con,
+                                 veg_lib, &lake_con, out_data[0], &save_data,
+                                 &cell_timer);
 
-
-                if (ErrorFlag == ERROR) {
-                    if (options.CONTINUEONERROR) {
-                        // Handle grid cell solution error
-                        log_warn("ERROR: Grid cell %i failed in record %zu "
-                                 "so the simulation has not finished.  An "
-                                 "incomplete output file has been "
-                                 "generated, check your inputs before "
-                                 "rerunning the simulation.",
-                                 soil_con.gridcel, rec);
-                        break;
+                        // No history output or intermediate state during
+                        // spin-up
+                        if (global_param.spinup_cycles == 0) {
+                            for (streamnum = 0;
+                                 streamnum < options.Noutstreams;
+                                 streamnum++) {
+                                agg_stream_data(&(streams[streamnum]),
+                                                &(dmy[rec]), out_data);
+                            }
+
+                            // Write cell average values for current time step
+                            write_output(&streams, &dmy[rec]);
+
+                            /************************************
+                               Save model state at assigned date
+                               (after the final time step of the assigned date)
+                            ************************************/
+                            if (filep.statefile != NULL &&
+                                check_save_state_flag(dmy, rec)) {
+                                write_model_state(&all_vars,
+                                                  veg_con->vegetat_type_num,
+                                                  soil_con.gridcel, &filep,
+                                                  &soil_con);
+                            }
+                        }
+
+                        if (ErrorFlag == ERROR) {
+                            if (options.CONTINUEONERROR) {
+                                // Handle grid cell solution error
+                                log_warn("ERROR: Grid cell %i failed in "
+                                         "record %zu so the simulation has "
+                                         "not finished.  An incomplete "
+                                         "output file has been generated, "
+                                         "check your inputs before "
+                                         "rerunning the simulation.",
+                                         soil_con.gridcel, rec);
+                                break;
+                            }
+                            else {
+                                // Else exit program on cell solution error as
+                                // in previous versions
+                                log_err("ERROR: Grid cell %i failed in "
+                                        "record %zu so the simulation has "
+                                        "ended. Check your inputs before "
+                                        "rerunning the simulation.",
+                                        soil_con.gridcel, rec);
+                            }
+                        }
+                    } /* End Rec Loop */
+
+                    /************************************
+                       Compare the storages with those at the end of the
+                       previous cycle and save the model state once the
+                       cell has converged
+                    ************************************/
+                    SPINUP_DONE = true;
+                    if (global_param.spinup_cycles > 0 && ErrorFlag != ERROR) {
+                        spinup_cycle++;
+                        if (check_spinup_convergence(out_data[0],
+                                                     spinup_storage)) {
+                            log_info("Grid cell %i converged after %zu spin-up "
+                                     "cycles.", soil_con.gridcel, spinup_cycle);
+                        }
+                        else if (spinup_cycle < global_param.spinup_cycles) {
+                            SPINUP_DONE = false;
+                        }
+                        else {
+                            log_warn("Grid cell %i has not converged after %zu "
+                                     "spin-up cycles.", soil_con.gridcel,
+                                     spinup_cycle);
+                        }
+                        if (SPINUP_DONE && filep.statefile != NULL) {
+                            write_model_state(&all_vars,
+                                              veg_con->vegetat_type_num,
+                                              soil_con.gridcel, &filep,
+                                              &soil_con);
+                        }
                     }
-                    else {
-                        // Else exit program on cell solution error as in previous versions
-                        log_err("ERROR: Grid cell %i failed in record %zu "
-                                "so the simulation has ended. Check your "
-                                "inputs before rerunning the simulation.",
-                                soil_con.gridcel, rec);
-                    }
-                }
-            } /* End Rec Loop */
+                } while (!SPINUP_DONE);
+            }
 
             close_files(&filep, &streams);
 
@@ -323,6 +401,8 @@ main(int   argc,
 
     /** cleanup **/
     free_atmos(global_param.nrecs, &force);
+    free(spinup_storage);
+    free_calib();
     free_dmy(&dmy);
     free_streams(&streams);
     free_out_data(1, out_data);  // 1 is for the number of gridcells, 1 in classic driver
@@ -74,7 +74,7 @@ vic_populate_model_state(all_vars_struct *all_vars,
         if (tmp_lake_idx < 0) {
             tmp_lake_idx = 0;
         }
-        initialize_lake(lake, lake_con, soil_con, &(cell[tmp_lake_idx][0]),
+        initialize_lake(lake, &lake_con, soil_con, &(cell[tmp_lake_idx][0]),
                         false);
     }
     initialize_energy(energy, Nveg);
@@ -96,6 +96,6 @@ vic_populate_model_state(all_vars_struct *all_vars,
     // compute those state variables that are derived from the others
     compute_derived_state_vars(all_vars, soil_con, veg_con);
     if (options.LAKES) {
-        compute_derived_lake_dimensions(lake, lake_con);
+        compute_derived_lake_dimensions(lake, &lake_con);
     }
 }
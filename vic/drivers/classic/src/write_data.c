@@ -36,8 +36,11 @@ write_data(stream_struct *stream)
     extern metadata_struct out_metadata[N_OUTVAR_TYPES];
 
     size_t                 n;
+    size_t                 i;
     size_t                 var_idx;
     size_t                 elem_idx;
+    size_t                 bin_idx;
+    size_t                 nbins;
     size_t                 ptr_idx;
     unsigned int           varid;
     char                  *tmp_cptr;
@@ -48,7 +51,12 @@ write_data(stream_struct *stream)
     double                *tmp_dptr;
 
     if (stream->file_format == BINARY) {
+        // large enough for all elements and bins of any variable
         n = N_OUTVAR_TYPES * options.Nlayer * options.SNOW_BAND;
+        for (var_idx = 0; var_idx < stream->nvars; var_idx++) {
+            n = max(n, out_metadata[stream->varid[var_idx]].nelem *
+                    stream->aggparam[var_idx].nbins);
+        }
         // Initialize pointers
         tmp_cptr = calloc(n, sizeof(*tmp_cptr));
         tmp_siptr = calloc(n, sizeof(*tmp_siptr));
@@ -78,65 +86,52 @@ write_data(stream_struct *stream)
         // Loop over this output file's data variables
         for (var_idx = 0; var_idx < stream->nvars; var_idx++) {
             varid = stream->varid[var_idx];
-            // Loop over this variable's elements
+            nbins = stream->aggparam[var_idx].nbins;
+            // Loop over this variable's elements and bins
             ptr_idx = 0;
+            for (elem_idx = 0; elem_idx < out_metadata[varid].nelem;
+                 elem_idx++) {
+                for (bin_idx = 0; bin_idx < nbins; bin_idx++) {
+                    tmp_dptr[ptr_idx++] =
+                        stream->aggdata[0][var_idx][elem_idx][bin_idx];
+                }
+            }
             if (stream->type[var_idx] == OUT_TYPE_CHAR) {
-                for (elem_idx = 0;
-                     elem_idx < out_metadata[varid].nelem;
-                     elem_idx++) {
-                    tmp_cptr[ptr_idx++] =
-                        (char) stream->aggdata[0][var_idx][elem_idx][0];
+                for (i = 0; i < ptr_idx; i++) {
+                    tmp_cptr[i] = (char) tmp_dptr[i];
                 }
                 fwrite(tmp_cptr, sizeof(char), ptr_idx,
                        stream->fh);
             }
             else if (stream->type[var_idx] == OUT_TYPE_SINT) {
-                for (elem_idx = 0; elem_idx < out_metadata[varid].nelem;
-                     elem_idx++) {
-                    tmp_siptr[ptr_idx++] =
-                        (short int) stream->aggdata[0][var_idx][elem_idx][0];
+                for (i = 0; i < ptr_idx; i++) {
+                    tmp_siptr[i] = (short int) tmp_dptr[i];
                 }
                 fwrite(tmp_siptr, sizeof(short int), ptr_idx,
                        stream->fh);
             }
             else if (stream->type[var_idx] == OUT_TYPE_USINT) {
-                for (elem_idx = 0;
-                     elem_idx < out_metadata[varid].nelem;
-                     elem_idx++) {
-                    tmp_usiptr[ptr_idx++] =
-                        (unsigned short int) stream->aggdata[0][var_idx][
-                            elem_idx][0];
+                for (i = 0; i < ptr_idx; i++) {
+                    tmp_usiptr[i] = (unsigned short int) tmp_dptr[i];
                 }
                 fwrite(tmp_usiptr, sizeof(unsigned short int), ptr_idx,
                        stream->fh);
             }
             else if (stream->type[var_idx] == OUT_TYPE_INT) {
-                for (elem_idx = 0;
-                     elem_idx < out_metadata[varid].nelem;
-                     elem_idx++) {
-                    tmp_iptr[ptr_idx++] =
-                        (int) stream->aggdata[0][var_idx][elem_idx][0];
+                for (i = 0; i < ptr_idx; i++) {
+                    tmp_iptr[i] = (int) tmp_dptr[i];
                 }
                 fwrite(tmp_iptr, sizeof(int), ptr_idx,
                        stream->fh);
             }
             else if (stream->type[var_idx] == OUT_TYPE_FLOAT) {
-                for (elem_idx = 0;
-                     elem_idx < out_metadata[varid].nelem;
-                     elem_idx++) {
-                    tmp_fptr[ptr_idx++] =
-                        (float) stream->aggdata[0][var_idx][elem_idx][0];
+                for (i = 0; i < ptr_idx; i++) {
+                    tmp_fptr[i] = (float) tmp_dptr[i];
                 }
                 fwrite(tmp_fptr, sizeof(float), ptr_idx,
                        stream->fh);
             }
             else if (stream->type[var_idx] == OUT_TYPE_DOUBLE) {
-                for (elem_idx = 0;
-                     elem_idx < out_metadata[varid].nelem;
-                     elem_idx++) {
-                    tmp_dptr[ptr_idx++] =
-                        (double) stream->aggdata[0][var_idx][elem_idx][0];
-                }
                 fwrite(tmp_dptr, sizeof(double), ptr_idx,
                        stream->fh);
             }
@@ -171,15 +166,18 @@ write_data(stream_struct *stream)
         // Loop over this output file's data variables
         for (var_idx = 0; var_idx < stream->nvars; var_idx++) {
             varid = stream->varid[var_idx];
-            // Loop over this variable's elements
+            nbins = stream->aggparam[var_idx].nbins;
+            // Loop over this variable's elements and bins
             for (elem_idx = 0; elem_idx < out_metadata[varid].nelem;
                  elem_idx++) {
-                if (!(var_idx == 0 && elem_idx == 0)) {
-                    fprintf(stream->fh, "\t ");
+                for (bin_idx = 0; bin_idx < nbins; bin_idx++) {
+                    if (!(var_idx == 0 && elem_idx == 0 && bin_idx == 0)) {
+                        fprintf(stream->fh, "\t ");
+                    }
+                    fprintf(stream->fh,
+                            stream->format[var_idx],
+                            stream->aggdata[0][var_idx][elem_idx][bin_idx]);
                 }
-                fprintf(stream->fh,
-                        stream->format[var_idx],
-                        stream->aggdata[0][var_idx][elem_idx][0]);
             }
         }
         fprintf(stream->fh, "\n");
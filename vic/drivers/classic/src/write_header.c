@@ -40,6 +40,8 @@ write_header(stream_struct **streams,
     size_t                     stream_idx;
     size_t                     var_idx;
     unsigned                   elem_idx;
+    size_t                     bin_idx;
+    size_t                     nbins;
     size_t                     i;
     unsigned int               varid;
     unsigned short int         Identifier;
@@ -49,6 +51,7 @@ write_header(stream_struct **streams,
     size_t                     nvars;
     char                       tmp_len;
     char                      *tmp_str;
+    char                       name[MAXSTRING];
     char                       tmp_type;
     float                      tmp_mult;
 
@@ -122,20 +125,18 @@ write_header(stream_struct **streams,
             for (var_idx = 0; var_idx < (*streams)[stream_idx].nvars;
                  var_idx++) {
                 varid = (*streams)[stream_idx].varid[var_idx];
-                // Loop over this variable's elements
+                nbins = (*streams)[stream_idx].aggparam[var_idx].nbins;
+                // Loop over this variable's elements and bins
                 for (elem_idx = 0;
                      elem_idx < out_metadata[varid].nelem;
                      elem_idx++) {
-                    if (out_metadata[varid].nelem > 1) {
-                        sprintf(tmp_str, "%s_%d", out_metadata[varid].varname,
-                                elem_idx);
+                    for (bin_idx = 0; bin_idx < nbins; bin_idx++) {
+                        sprint_outvar_name(name, varid, elem_idx, bin_idx,
+                                           nbins);
+                        Nbytes2 += sizeof(char) +
+                                   strlen(name) * sizeof(char) +
+                                   sizeof(char) + sizeof(float);
                     }
-                    else {
-                        strcpy(tmp_str,
-                               out_metadata[varid].varname);
-                    }
-                    Nbytes2 += sizeof(char) + strlen(tmp_str) * sizeof(char) +
-                               sizeof(char) + sizeof(float);
                 }
             }
 
@@ -244,28 +245,26 @@ write_header(stream_struct **streams,
             for (var_idx = 0; var_idx < (*streams)[stream_idx].nvars;
                  var_idx++) {
                 varid = (*streams)[stream_idx].varid[var_idx];
-                // Loop over this variable's elements
+                nbins = (*streams)[stream_idx].aggparam[var_idx].nbins;
+                // Loop over this variable's elements and bins
                 for (elem_idx = 0;
                      elem_idx < out_metadata[varid].nelem;
                      elem_idx++) {
-                    if (out_metadata[varid].nelem > 1) {
-                        sprintf(tmp_str, "%s_%d", out_metadata[varid].varname,
-                                elem_idx);
-                    }
-                    else {
-                        strcpy(tmp_str, out_metadata[varid].varname);
+                    for (bin_idx = 0; bin_idx < nbins; bin_idx++) {
+                        sprint_outvar_name(name, varid, elem_idx, bin_idx,
+                                           nbins);
+                        tmp_len = strlen(name);
+                        fwrite(&tmp_len, sizeof(char), 1,
+                               (*streams)[stream_idx].fh);
+                        fwrite(name, sizeof(char), tmp_len,
+                               (*streams)[stream_idx].fh);
+                        tmp_type = (*streams)[stream_idx].type[var_idx];
+                        fwrite(&tmp_type, sizeof(char), 1,
+                               (*streams)[stream_idx].fh);
+                        tmp_mult = (*streams)[stream_idx].mult[var_idx];
+                        fwrite(&tmp_mult, sizeof(float), 1,
+                               (*streams)[stream_idx].fh);
                     }
-                    tmp_len = strlen(tmp_str);
-                    fwrite(&tmp_len, sizeof(char), 1,
-                           (*streams)[stream_idx].fh);
-                    fwrite(tmp_str, sizeof(char), tmp_len,
-                           (*streams)[stream_idx].fh);
-                    tmp_type = (*streams)[stream_idx].type[var_idx];
-                    fwrite(&tmp_type, sizeof(char), 1,
-                           (*streams)[stream_idx].fh);
-                    tmp_mult = (*streams)[stream_idx].mult[var_idx];
-                    fwrite(&tmp_mult, sizeof(float), 1,
-                           (*streams)[stream_idx].fh);
                 }
             }
         }
@@ -311,18 +310,18 @@ write_header(stream_struct **streams,
             for (var_idx = 0; var_idx < (*streams)[stream_idx].nvars;
                  var_idx++) {
                 varid = (*streams)[stream_idx].varid[var_idx];
-                // Loop over this variable's elements
+                nbins = (*streams)[stream_idx].aggparam[var_idx].nbins;
+                // Loop over this variable's elements and bins
                 for (elem_idx = 0;
                      elem_idx < out_metadata[varid].nelem;
                      elem_idx++) {
-                    if (!(var_idx == 0 && elem_idx == 0)) {
-                        fprintf((*streams)[stream_idx].fh, "\t ");
-                    }
-                    fprintf((*streams)[stream_idx].fh, "%s",
-                            out_metadata[varid].varname);
-                    if (out_metadata[varid].nelem > 1) {
-                        fprintf((*streams)[stream_idx].fh, "_%d",
-                                elem_idx);
+                    for (bin_idx = 0; bin_idx < nbins; bin_idx++) {
+                        if (!(var_idx == 0 && elem_idx == 0 && bin_idx == 0)) {
+                            fprintf((*streams)[stream_idx].fh, "\t ");
+                        }
+                        sprint_outvar_name(name, varid, elem_idx, bin_idx,
+                                           nbins);
+                        fprintf((*streams)[stream_idx].fh, "%s", name);
                     }
                 }
             }
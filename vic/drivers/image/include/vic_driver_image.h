@@ -31,14 +31,88 @@
 
 #define VIC_DRIVER "Image"
 
+#define N_VEG_HIST_FIELDS 5  /**< albedo, displacement, fcanopy, LAI and
+                                 roughness */
+
+#define ROUTE_UH_NSIGMA 8    /**< length of a routing unit hydrograph beyond
+                                 the mean travel time, in standard
+                                 deviations of the travel time */
+#define ROUTE_UH_NSUB 20     /**< samples of the impulse response per time
+                                 step of a routing unit hydrograph */
+
+/******************************************************************************
+ * @brief   Meteorological forcing of one forcing window, read on the master
+ *          process and stored in the order in which it is scattered
+ *****************************************************************************/
+typedef struct {
+    bool ready;                 /**< TRUE: data holds the window below */
+    char filename[MAXSTRING];   /**< forcing file of the window */
+    size_t start;               /**< first record of the window in the file */
+    double *data[N_FORCING_TYPES]; /**< per forcing type, [NF][NMEMBERS]
+                                      [global ncells_active] values in MPI
+                                      order */
+} force_window_struct;
+
+/******************************************************************************
+ * @brief   Inline routing of runoff and baseflow to the outlets of the routing
+ *          file.
+ * @details A source is a local cell together with one of the outlets that
+ *          are downstream of it. Each process convolves the runoff of its
+ *          sources with their unit hydrographs into the flow that reaches
+ *          its outlets in the coming time steps. Only the processes with
+ *          sources take part in the reduction of the outlet flows.
+ *****************************************************************************/
+typedef struct {
+    size_t noutlets;           /**< number of outlets in the routing file */
+    size_t nsources;           /**< number of local sources */
+    size_t *source_cell;       /**< local cell of each source [nsources] */
+    size_t *source_outlet;     /**< local outlet of each source [nsources] */
+    double *source_factor;     /**< conversion of the runoff of each source
+                                    from mm per time step to m3/s
+                                    [nsources] */
+    size_t *uh_start;          /**< first weight of each source in uh
+                                    [nsources + 1] */
+    double *uh;                /**< unit hydrograph weights of all sources */
+    size_t nlocal;             /**< number of outlets downstream of the
+                                    local cells */
+    size_t *local_outlet;      /**< outlet of each local outlet [nlocal] */
+    size_t ring_size;          /**< number of time steps stored in ring */
+    size_t ring_head;          /**< slot of ring of the current time step */
+    double *ring;              /**< flow that reaches the local outlets in the
+                                    coming time steps (m3/s)
+                                    [ring_size][NMEMBERS][nlocal] */
+    double *flow;              /**< local flow at the outlets in the current
+                                    time step (m3/s) [NMEMBERS][noutlets] */
+    double *total;             /**< flow at the outlets on the master node
+                                    [NMEMBERS][noutlets] */
+    MPI_Comm comm;             /**< master node and processes with sources,
+                                    MPI_COMM_NULL on all other processes */
+    char filename[MAXSTRING];  /**< name of the streamflow file */
+    int nc_id;                 /**< streamflow file */
+    int time_varid;            /**< time variable of the streamflow file */
+    int flow_varid;            /**< streamflow variable */
+    size_t time_index;         /**< next record of the streamflow file */
+} route_struct;
+
 bool check_save_state_flag(size_t);
+void compute_route_uh(double distance, size_t nsteps, double *uh);
 void display_current_settings(int);
 void get_forcing_file_info(param_set_struct *param_set, size_t file_num);
 void get_global_param(FILE *);
+size_t get_route_uh_length(double distance);
+void initialize_route_file(dmy_struct *dmy_current, int *outlet_ids,
+                           size_t *outlet_cells, double *upstream_area);
+void read_force_window(force_window_struct *window, char *filename,
+                       size_t start, size_t ntypes, int *types);
+size_t set_force_block(size_t start, size_t *dstart, size_t *dcount);
 void vic_force(void);
 void vic_image_init(void);
 void vic_image_finalize();
+void vic_image_spinup(void);
 void vic_image_start(void);
 void vic_populate_model_state(void);
+void vic_route(dmy_struct *dmy_current);
+void vic_route_finalize(void);
+void vic_route_init(dmy_struct *dmy_current);
 
 #endif
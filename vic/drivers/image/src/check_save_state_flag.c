@@ -30,12 +30,16 @@
 /******************************************************************************
  * @brief   Function to check whether model state should be saved for the
  *          current time step
+ * @details With STATEFREQ the state is saved each time the state alarm is
+ *          raised, and the state date is set to the end of the current time
+ *          step so that it is used in the name of the state file.
  *****************************************************************************/
 bool
 check_save_state_flag(size_t current)
 {
     extern global_param_struct global_param;
     extern dmy_struct         *dmy;
+    extern alarm_struct        state_alarm;
 
     double                     offset;
     double                     time_num;
@@ -52,6 +56,19 @@ check_save_state_flag(size_t current)
              global_param.calendar, TIME_UNITS_DAYS,
              &dmy_offset);
 
+    if (global_param.statefreq != FREQ_NEVER) {
+        state_alarm.count++;
+        if (!raise_alarm(&state_alarm, &(dmy[current]))) {
+            return false;
+        }
+        reset_alarm(&state_alarm, &(dmy[current]));
+        global_param.stateyear = dmy_offset.year;
+        global_param.statemonth = dmy_offset.month;
+        global_param.stateday = dmy_offset.day;
+        global_param.statesec = dmy_offset.dayseconds;
+        return true;
+    }
+
     // Check if the end of the current time step is equal to the state output
     // timestep specified by user
     if (dmy_offset.year == global_param.stateyear &&
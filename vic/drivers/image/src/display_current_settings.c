@@ -97,6 +97,12 @@ display_current_settings(int mode)
     fprintf(LOG_DEST, "MODEL_DT\t\t%f\n", global_param.dt);
     fprintf(LOG_DEST, "SNOW_DT\t\t%f\n", global_param.snow_dt);
     fprintf(LOG_DEST, "RUNOFF_DT\t\t%f\n", global_param.runoff_dt);
+    if (options.RUNOFF_ADAPTIVE) {
+        fprintf(LOG_DEST, "RUNOFF_ADAPTIVE\t\tTRUE\n");
+    }
+    else {
+        fprintf(LOG_DEST, "RUNOFF_ADAPTIVE\t\tFALSE\n");
+    }
     fprintf(LOG_DEST, "STARTYEAR\t\t%d\n", global_param.startyear);
     fprintf(LOG_DEST, "STARTMONTH\t\t%d\n", global_param.startmonth);
     fprintf(LOG_DEST, "STARTDAY\t\t%d\n", global_param.startday);
@@ -262,6 +268,7 @@ display_current_settings(int mode)
             fprintf(LOG_DEST, "FORCE_DT\t\t%f\n", param_set.FORCE_DT[file_num]);
         }
     }
+    fprintf(LOG_DEST, "ENSEMBLE_MEMBERS\t%zu\n", options.NMEMBERS);
 
     fprintf(LOG_DEST, "\n");
     fprintf(LOG_DEST, "Input Domain Data:\n");
@@ -270,6 +277,9 @@ display_current_settings(int mode)
     fprintf(LOG_DEST, "\n");
     fprintf(LOG_DEST, "Constants File\t\t%s\n", filenames.constants);
     fprintf(LOG_DEST, "Parameters file\t\t%s\n", filenames.params);
+    if (strcmp(filenames.param_cache, "MISSING") != 0) {
+        fprintf(LOG_DEST, "Parameter cache\t\t%s\n", filenames.param_cache);
+    }
     if (options.BASEFLOW == ARNO) {
         fprintf(LOG_DEST, "BASEFLOW\t\tARNO\n");
     }
@@ -401,10 +411,16 @@ display_current_settings(int mode)
     if (options.SAVE_STATE) {
         fprintf(LOG_DEST, "SAVE_STATE\t\tTRUE\n");
         fprintf(LOG_DEST, "STATENAME\t\t%s\n", filenames.statefile);
-        fprintf(LOG_DEST, "STATEYEAR\t\t%d\n", global_param.stateyear);
-        fprintf(LOG_DEST, "STATEMONTH\t\t%d\n", global_param.statemonth);
-        fprintf(LOG_DEST, "STATEDAY\t\t%d\n", global_param.stateday);
-        fprintf(LOG_DEST, "STATESEC\t\t%u\n", global_param.statesec);
+        if (global_param.statefreq != FREQ_NEVER) {
+            fprintf(LOG_DEST, "STATEFREQ\t\t%hu %d\n", global_param.statefreq,
+                    global_param.staten);
+        }
+        else {
+            fprintf(LOG_DEST, "STATEYEAR\t\t%d\n", global_param.stateyear);
+            fprintf(LOG_DEST, "STATEMONTH\t\t%d\n", global_param.statemonth);
+            fprintf(LOG_DEST, "STATEDAY\t\t%d\n", global_param.stateday);
+            fprintf(LOG_DEST, "STATESEC\t\t%u\n", global_param.statesec);
+        }
         if (options.STATE_FORMAT == NETCDF3_CLASSIC) {
             fprintf(LOG_DEST, "STATE_FORMAT\t\tNETCDF3_CLASSIC\n");
         }
@@ -417,13 +433,59 @@ display_current_settings(int mode)
         else if (options.STATE_FORMAT == NETCDF4) {
             fprintf(LOG_DEST, "STATE_FORMAT\t\tNETCDF4\n");
         }
+        if (options.STATE_GATHERED) {
+            fprintf(LOG_DEST, "STATE_GATHERED\t\tTRUE\n");
+        }
+        else {
+            fprintf(LOG_DEST, "STATE_GATHERED\t\tFALSE\n");
+        }
+        if (options.STATE_ASYNC) {
+            fprintf(LOG_DEST, "STATE_ASYNC\t\tTRUE\n");
+        }
+        else {
+            fprintf(LOG_DEST, "STATE_ASYNC\t\tFALSE\n");
+        }
     }
     else {
         fprintf(LOG_DEST, "SAVE_STATE\t\tFALSE\n");
     }
 
+    fprintf(LOG_DEST, "\n");
+    fprintf(LOG_DEST, "Spin-up:\n");
+    if (global_param.spinup_cycles > 0) {
+        fprintf(LOG_DEST, "SPINUP_CYCLES\t\t%zu\n", global_param.spinup_cycles);
+        fprintf(LOG_DEST, "SPINUP_TOL_MOIST\t%f\n",
+                global_param.spinup_tol_moist);
+        fprintf(LOG_DEST, "SPINUP_TOL_TEMP\t\t%f\n",
+                global_param.spinup_tol_temp);
+        fprintf(LOG_DEST, "SPINUP_TOL_CARBON\t%f\n",
+                global_param.spinup_tol_carbon);
+    }
+    else {
+        fprintf(LOG_DEST, "SPINUP_CYCLES\t\t0\n");
+    }
+
+    fprintf(LOG_DEST, "\n");
+    fprintf(LOG_DEST, "Routing:\n");
+    if (options.ROUTING) {
+        fprintf(LOG_DEST, "ROUTING\t\t\t%s\n", filenames.routing);
+        fprintf(LOG_DEST, "ROUTING_VELOCITY\t%f\n",
+                global_param.rout_velocity);
+        fprintf(LOG_DEST, "ROUTING_DIFFUSION\t%f\n",
+                global_param.rout_diffusion);
+    }
+    else {
+        fprintf(LOG_DEST, "ROUTING\t\t\tFALSE\n");
+    }
+
     fprintf(LOG_DEST, "\n");
     fprintf(LOG_DEST, "Output Data:\n");
     fprintf(LOG_DEST, "Result dir:\t\t%s\n", filenames.result_dir);
+    if (options.IO_SERVER) {
+        fprintf(LOG_DEST, "IO_SERVER\t\tTRUE\n");
+    }
+    else {
+        fprintf(LOG_DEST, "IO_SERVER\t\tFALSE\n");
+    }
     fprintf(LOG_DEST, "\n");
 }
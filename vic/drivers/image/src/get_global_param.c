@@ -39,12 +39,14 @@ get_global_param(FILE *gp)
     extern param_set_struct    param_set;
     extern filenames_struct    filenames;
     extern size_t              NF, NR;
+    extern int                 mpi_size;
 
     char                       cmdstr[MAXSTRING];
     char                       optstr[MAXSTRING];
     char                       flgstr[MAXSTRING];
     char                       flgstr2[MAXSTRING];
     size_t                     file_num;
+    size_t                     nmembers;
     int                        field;
     unsigned int               tmpstartdate;
     unsigned int               tmpenddate;
@@ -81,6 +83,10 @@ get_global_param(FILE *gp)
             else if (strcasecmp("RUNOFF_STEPS_PER_DAY", optstr) == 0) {
                 sscanf(cmdstr, "%*s %zu", &global_param.runoff_steps_per_day);
             }
+            else if (strcasecmp("RUNOFF_ADAPTIVE", optstr) == 0) {
+                sscanf(cmdstr, "%*s %s", flgstr);
+                options.RUNOFF_ADAPTIVE = str_to_bool(flgstr);
+            }
             else if (strcasecmp("STARTYEAR", optstr) == 0) {
                 sscanf(cmdstr, "%*s %hu", &global_param.startyear);
             }
@@ -334,6 +340,54 @@ get_global_param(FILE *gp)
                             "NETCDF3_64BIT_OFFSET, NETCDF4_CLASSIC, or NETCDF4.");
                 }
             }
+            else if (strcasecmp("STATE_GATHERED", optstr) == 0) {
+                sscanf(cmdstr, "%*s %s", flgstr);
+                options.STATE_GATHERED = str_to_bool(flgstr);
+            }
+            else if (strcasecmp("STATEFREQ", optstr) == 0) {
+                sscanf(cmdstr, "%*s %s %d", flgstr, &global_param.staten);
+                global_param.statefreq = str_to_freq_flag(flgstr);
+            }
+            else if (strcasecmp("STATE_ASYNC", optstr) == 0) {
+                sscanf(cmdstr, "%*s %s", flgstr);
+                options.STATE_ASYNC = str_to_bool(flgstr);
+            }
+
+            /*************************************
+               Define spin-up
+            *************************************/
+            else if (strcasecmp("SPINUP_CYCLES", optstr) == 0) {
+                sscanf(cmdstr, "%*s %zu", &global_param.spinup_cycles);
+            }
+            else if (strcasecmp("SPINUP_TOL_MOIST", optstr) == 0) {
+                sscanf(cmdstr, "%*s %lf", &global_param.spinup_tol_moist);
+            }
+            else if (strcasecmp("SPINUP_TOL_TEMP", optstr) == 0) {
+                sscanf(cmdstr, "%*s %lf", &global_param.spinup_tol_temp);
+            }
+            else if (strcasecmp("SPINUP_TOL_CARBON", optstr) == 0) {
+                sscanf(cmdstr, "%*s %lf", &global_param.spinup_tol_carbon);
+            }
+
+            /*************************************
+               Define routing
+            *************************************/
+            else if (strcasecmp("ROUTING", optstr) == 0) {
+                sscanf(cmdstr, "%*s %s", flgstr);
+                if (strcasecmp("FALSE", flgstr) == 0) {
+                    options.ROUTING = false;
+                }
+                else {
+                    options.ROUTING = true;
+                    strcpy(filenames.routing, flgstr);
+                }
+            }
+            else if (strcasecmp("ROUTING_VELOCITY", optstr) == 0) {
+                sscanf(cmdstr, "%*s %lf", &global_param.rout_velocity);
+            }
+            else if (strcasecmp("ROUTING_DIFFUSION", optstr) == 0) {
+                sscanf(cmdstr, "%*s %lf", &global_param.rout_diffusion);
+            }
 
             /*************************************
                Define forcing files
@@ -366,6 +420,9 @@ get_global_param(FILE *gp)
             else if (strcasecmp("WIND_H", optstr) == 0) {
                 sscanf(cmdstr, "%*s %lf", &global_param.wind_h);
             }
+            else if (strcasecmp("ENSEMBLE_MEMBERS", optstr) == 0) {
+                sscanf(cmdstr, "%*s %zu", &options.NMEMBERS);
+            }
 
             /*************************************
                Define parameter files
@@ -382,6 +439,9 @@ get_global_param(FILE *gp)
             else if (strcasecmp("PARAMETERS", optstr) == 0) {
                 sscanf(cmdstr, "%*s %s", filenames.params);
             }
+            else if (strcasecmp("PARAM_CACHE", optstr) == 0) {
+                sscanf(cmdstr, "%*s %s", filenames.param_cache);
+            }
             else if (strcasecmp("ARNO_PARAMS", optstr) == 0) {
                 sscanf(cmdstr, "%*s %s", flgstr);
                 if (strcasecmp("TRUE", flgstr) == 0) {
@@ -501,6 +561,10 @@ get_global_param(FILE *gp)
             else if (strcasecmp("RESULT_DIR", optstr) == 0) {
                 sscanf(cmdstr, "%*s %s", filenames.result_dir);
             }
+            else if (strcasecmp("IO_SERVER", optstr) == 0) {
+                sscanf(cmdstr, "%*s %s", flgstr);
+                options.IO_SERVER = str_to_bool(flgstr);
+            }
 
             /*************************************
                Define output file contents
@@ -884,31 +948,49 @@ get_global_param(FILE *gp)
                     "file defines the output state file on the line that "
                     "begins with \"SAVE_STATE\".");
         }
-        if (global_param.stateyear == 0 || global_param.statemonth == 0 ||
-            global_param.stateday == 0) {
-            log_err("Incomplete specification of the date to save state "
-                    "for state file (%s).\nSpecified date (yyyy-mm-dd-sssss): "
-                    "%04d-%02d-%02d-%05u\nMake sure STATEYEAR, STATEMONTH, "
-                    "and STATEDAY are set correctly in your global parameter "
-                    "file.", filenames.statefile, global_param.stateyear,
-                    global_param.statemonth, global_param.stateday,
-                    global_param.statesec);
+        if (global_param.statefreq == FREQ_DATE ||
+            global_param.statefreq == FREQ_END) {
+            log_err("STATEFREQ must be one of NSTEPS, NSECONDS, NMINUTES, "
+                    "NHOURS, NDAYS, NMONTHS or NYEARS. Use STATEYEAR, "
+                    "STATEMONTH, STATEDAY and STATESEC to save the state "
+                    "at a single date.");
+        }
+        if (global_param.statefreq != FREQ_NEVER) {
+            if (global_param.staten < 1) {
+                log_err("The number of STATEFREQ units between state files "
+                        "must be >= 1, found %d.", global_param.staten);
+            }
         }
-        // Check for month, day in range
-        make_lastday(global_param.stateyear, global_param.calendar,
-                     lastday);
-        if (global_param.stateday > lastday[global_param.statemonth - 1] ||
-            global_param.statemonth < 1 ||
-            global_param.statemonth > MONTHS_PER_YEAR ||
-            global_param.stateday < 1 || global_param.stateday > 31 ||
-            global_param.statesec > SEC_PER_DAY) {
-            log_err("Unusual specification of the date to save state "
-                    "for state file (%s).\nSpecified date (yyyy-mm-dd-sssss): "
-                    "%04d-%02d-%02d-%05u\nMake sure STATEYEAR, STATEMONTH, "
-                    "STATEDAY and STATESEC are set correctly in your global "
-                    "parameter file.", filenames.statefile,
-                    global_param.stateyear, global_param.statemonth,
-                    global_param.stateday, global_param.statesec);
+        else {
+            if (global_param.stateyear == 0 || global_param.statemonth == 0 ||
+                global_param.stateday == 0) {
+                log_err("Incomplete specification of the date to save "
+                        "state for state file (%s).\nSpecified date "
+                        "(yyyy-mm-dd-sssss): %04d-%02d-%02d-%05u\nMake sure "
+                        "STATEYEAR, STATEMONTH, and STATEDAY are set "
+                        "correctly in your global parameter file.",
+                        filenames.statefile, global_param.stateyear,
+                        global_param.statemonth, global_param.stateday,
+                        global_param.statesec);
+            }
+            // Check for month, day in range
+            make_lastday(global_param.stateyear, global_param.calendar,
+                         lastday);
+            if (global_param.stateday >
+                lastday[global_param.statemonth - 1] ||
+                global_param.statemonth < 1 ||
+                global_param.statemonth > MONTHS_PER_YEAR ||
+                global_param.stateday < 1 || global_param.stateday > 31 ||
+                global_param.statesec > SEC_PER_DAY) {
+                log_err("Unusual specification of the date to save state "
+                        "for state file (%s).\nSpecified date "
+                        "(yyyy-mm-dd-sssss): %04d-%02d-%02d-%05u\nMake sure "
+                        "STATEYEAR, STATEMONTH, STATEDAY and STATESEC are "
+                        "set correctly in your global parameter file.",
+                        filenames.statefile,
+                        global_param.stateyear, global_param.statemonth,
+                        global_param.stateday, global_param.statesec);
+            }
         }
     }
     // Set the statename here temporarily to compare with INIT_STATE name
@@ -926,6 +1008,64 @@ get_global_param(FILE *gp)
                 filenames.statefile, filenames.init_state);
     }
 
+    // Validate the spin-up parameters
+    if (global_param.spinup_cycles > 0) {
+        if (!options.SAVE_STATE) {
+            log_err("SPINUP_CYCLES was specified, but no output state file "
+                    "was defined. The spin-up only writes the final model "
+                    "state, make sure STATENAME is set in the global "
+                    "parameter file.");
+        }
+        if (global_param.statefreq != FREQ_NEVER) {
+            log_err("SPINUP_CYCLES can not be combined with STATEFREQ, the "
+                    "spin-up only writes the final model state.");
+        }
+        if (global_param.spinup_tol_moist < 0 ||
+            global_param.spinup_tol_temp < 0 ||
+            global_param.spinup_tol_carbon < 0) {
+            log_err("SPINUP_TOL_MOIST, SPINUP_TOL_TEMP and "
+                    "SPINUP_TOL_CARBON must be >= 0.");
+        }
+    }
+
+    // Validate the ensemble options
+    if (options.NMEMBERS < 1) {
+        log_err("ENSEMBLE_MEMBERS must be >= 1.");
+    }
+    if (options.NMEMBERS > 1) {
+        if (global_param.spinup_cycles > 0) {
+            log_err("SPINUP_CYCLES can not be combined with "
+                    "ENSEMBLE_MEMBERS > 1.");
+        }
+        // the members are read from the member dimension of FORCING1
+        nmembers = get_nc_dimension(filenames.forcing[0], "member");
+        if (nmembers < options.NMEMBERS) {
+            log_err("ENSEMBLE_MEMBERS is set to %zu, but the member "
+                    "dimension of %s only has %zu members.",
+                    options.NMEMBERS, filenames.forcing[0], nmembers);
+        }
+    }
+
+    // Validate the routing options
+    if (options.ROUTING) {
+        if (global_param.rout_velocity <= 0) {
+            log_err("ROUTING_VELOCITY must be > 0.");
+        }
+        if (global_param.rout_diffusion <= 0) {
+            log_err("ROUTING_DIFFUSION must be > 0.");
+        }
+        if (global_param.spinup_cycles > 0) {
+            log_err("SPINUP_CYCLES can not be combined with ROUTING, the "
+                    "spin-up does not write any output.");
+        }
+    }
+
+    // Validate the I/O server option
+    if (options.IO_SERVER && mpi_size < 2) {
+        log_err("IO_SERVER = TRUE requires at least two MPI processes, "
+                "one for I/O and one or more to run the grid cells.");
+    }
+
     // Validate soil parameter/simulation mode combinations
     if (options.QUICK_FLUX) {
         if (options.Nnode != 3) {
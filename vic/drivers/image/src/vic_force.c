@@ -48,24 +48,35 @@ vic_force(void)
     extern veg_hist_struct   **veg_hist;
     extern parameters_struct   param;
     extern param_set_struct    param_set;
-
-    double                    *t_offset = NULL;
-    double                    *dvar = NULL;
+    extern int                 mpi_rank;
+    extern force_window_struct force_prefetch;
+
+    double                     t_offset;
+    double                    *dblock = NULL;
+    double                    *mapped = NULL;
+    double                    *dest[N_FORCING_TYPES];
+    int                        types[N_FORCING_TYPES];
+    char                       next_file[MAXSTRING];
+    size_t                     next_start;
+    size_t                     ntypes;
+    size_t                     nforce;
+    size_t                     k;
+    int                        nc_id;
+    int                        status;
     size_t                     i;
     size_t                     j;
     size_t                     v;
+    size_t                     c;
+    size_t                     offset;
     size_t                     band;
     int                        vidx;
-    size_t                     d3count[3];
-    size_t                     d3start[3];
+    size_t                     ndims;
+    size_t                     dcount[4];
+    size_t                     dstart[4];
     size_t                     d4count[4];
     size_t                     d4start[4];
     double                    *Tfactor;
 
-    // allocate memory for variables to be read
-    dvar = malloc(local_domain.ncells_active * sizeof(*dvar));
-    check_alloc_status(dvar, "Memory allocation error.");
-
     // for now forcing file is determined by the year
     sprintf(filenames.forcing[0], "%s%4d.nc", filenames.f_path_pfx[0],
             dmy[current].year);
@@ -76,159 +87,117 @@ vic_force(void)
         global_param.forceoffset[0] = 0;
     }
 
-    // only the time slice changes for the met file reads. The rest is constant
-    d3start[1] = 0;
-    d3start[2] = 0;
-    d3count[0] = 1;
-    d3count[1] = global_domain.n_ny;
-    d3count[2] = global_domain.n_nx;
-
-    // Air temperature: tas
-    for (j = 0; j < NF; j++) {
-        d3start[0] = global_param.forceskip[0] + global_param.forceoffset[0] +
-                     j;
-        get_scatter_nc_field_double(filenames.forcing[0],
-                                    param_set.TYPE[AIR_TEMP].varname,
-                                    d3start, d3count, dvar);
-        for (i = 0; i < local_domain.ncells_active; i++) {
-            force[i].air_temp[j] = (double) dvar[i];
-        }
-    }
-
-    // Precipitation: prcp
-    for (j = 0; j < NF; j++) {
-        d3start[0] = global_param.forceskip[0] + global_param.forceoffset[0] +
-                     j;
-        get_scatter_nc_field_double(filenames.forcing[0],
-                                    param_set.TYPE[PREC].varname,
-                                    d3start, d3count, dvar);
-        for (i = 0; i < local_domain.ncells_active; i++) {
-            force[i].prec[j] = (double) dvar[i];
-        }
+    // forcing types in the meteorological forcing file and their local
+    // [cell][NR + 1] storage
+    ntypes = 0;
+    types[ntypes] = AIR_TEMP;
+    dest[ntypes++] = force[0].air_temp;
+    types[ntypes] = PREC;
+    dest[ntypes++] = force[0].prec;
+    types[ntypes] = SWDOWN;
+    dest[ntypes++] = force[0].shortwave;
+    types[ntypes] = LWDOWN;
+    dest[ntypes++] = force[0].longwave;
+    types[ntypes] = WIND;
+    dest[ntypes++] = force[0].wind;
+    types[ntypes] = VP;
+    dest[ntypes++] = force[0].vp;
+    types[ntypes] = PRESSURE;
+    dest[ntypes++] = force[0].pressure;
+    // Optional inputs
+    if (options.LAKES) {
+        types[ntypes] = CHANNEL_IN;
+        dest[ntypes++] = force[0].channel_in;
     }
-
-    // Downward solar radiation: dswrf
-    for (j = 0; j < NF; j++) {
-        d3start[0] = global_param.forceskip[0] + global_param.forceoffset[0] +
-                     j;
-        get_scatter_nc_field_double(filenames.forcing[0],
-                                    param_set.TYPE[SWDOWN].varname,
-                                    d3start, d3count, dvar);
-        for (i = 0; i < local_domain.ncells_active; i++) {
-            force[i].shortwave[j] = (double) dvar[i];
-        }
+    if (options.CARBON) {
+        types[ntypes] = CATM;
+        dest[ntypes++] = force[0].Catm;
+        types[ntypes] = FDIR;
+        dest[ntypes++] = force[0].fdir;
+        types[ntypes] = PAR;
+        dest[ntypes++] = force[0].par;
     }
 
-    // Downward longwave radiation: dlwrf
-    for (j = 0; j < NF; j++) {
-        d3start[0] = global_param.forceskip[0] + global_param.forceoffset[0] +
-                     j;
-        get_scatter_nc_field_double(filenames.forcing[0],
-                                    param_set.TYPE[LWDOWN].varname,
-                                    d3start, d3count, dvar);
-        for (i = 0; i < local_domain.ncells_active; i++) {
-            force[i].longwave[j] = (double) dvar[i];
+    // each variable is read for all NF substeps (and all ensemble members)
+    // at once and scattered straight into the forcing storage of the local
+    // cells
+    ndims = set_force_block(global_param.forceskip[0] +
+                            global_param.forceoffset[0], dstart, dcount);
+
+    if (options.IO_SERVER) {
+        // the window has normally been read ahead during the previous step
+        if (mpi_rank == VIC_MPI_ROOT &&
+            (!force_prefetch.ready ||
+             force_prefetch.start != dstart[0] ||
+             strcmp(force_prefetch.filename, filenames.forcing[0]) != 0)) {
+            read_force_window(&force_prefetch, filenames.forcing[0],
+                              dstart[0], ntypes, types);
         }
-    }
-
-    // Wind speed: wind
-    for (j = 0; j < NF; j++) {
-        d3start[0] = global_param.forceskip[0] + global_param.forceoffset[0] +
-                     j;
-        get_scatter_nc_field_double(filenames.forcing[0],
-                                    param_set.TYPE[WIND].varname,
-                                    d3start, d3count, dvar);
-        for (i = 0; i < local_domain.ncells_active; i++) {
-            force[i].wind[j] = (double) dvar[i];
+        for (k = 0; k < ntypes; k++) {
+            scatter_block_double_interleaved(NF, options.NMEMBERS, NR + 1,
+                                             force_prefetch.data[types[k]],
+                                             dest[k]);
         }
+        force_prefetch.ready = false;
     }
-
-    // vapor pressure: vp
-    for (j = 0; j < NF; j++) {
-        d3start[0] = global_param.forceskip[0] + global_param.forceoffset[0] +
-                     j;
-        get_scatter_nc_field_double(filenames.forcing[0],
-                                    param_set.TYPE[VP].varname,
-                                    d3start, d3count, dvar);
-        for (i = 0; i < local_domain.ncells_active; i++) {
-            force[i].vp[j] = (double) dvar[i];
+    else {
+        if (mpi_rank == VIC_MPI_ROOT) {
+            status = nc_open(filenames.forcing[0], NC_NOWRITE, &nc_id);
+            check_nc_status(status, "Error opening %s", filenames.forcing[0]);
+            mapped = mpi_map_cells_buffer(NF * options.NMEMBERS *
+                                          global_domain.ncells_active *
+                                          sizeof(*mapped));
         }
-    }
-
-    // Pressure: pressure
-    for (j = 0; j < NF; j++) {
-        d3start[0] = global_param.forceskip[0] + global_param.forceoffset[0] +
-                     j;
-        get_scatter_nc_field_double(filenames.forcing[0],
-                                    param_set.TYPE[PRESSURE].varname,
-                                    d3start, d3count, dvar);
-        for (i = 0; i < local_domain.ncells_active; i++) {
-            force[i].pressure[j] = (double) dvar[i];
-        }
-    }
-    // Optional inputs
-    if (options.LAKES) {
-        // Channel inflow to lake
-        d3start[0] = global_param.forceskip[0] + global_param.forceoffset[0] +
-                     j;
-        get_scatter_nc_field_double(filenames.forcing[0],
-                                    param_set.TYPE[CHANNEL_IN].varname,
-                                    d3start, d3count, dvar);
-        for (j = 0; j < NF; j++) {
-            for (i = 0; i < local_domain.ncells_active; i++) {
-                force[i].channel_in[j] = (double) dvar[i];
+        for (k = 0; k < ntypes; k++) {
+            if (mpi_rank == VIC_MPI_ROOT) {
+                get_nc_block_double_mapped(nc_id,
+                                           param_set.TYPE[types[k]].varname,
+                                           ndims, dstart, dcount, mapped);
             }
+            scatter_block_double_interleaved(NF, options.NMEMBERS, NR + 1,
+                                             mapped, dest[k]);
+        }
+        if (mpi_rank == VIC_MPI_ROOT) {
+            status = nc_close(nc_id);
+            check_nc_status(status, "Error closing %s", filenames.forcing[0]);
         }
     }
+
+    // the forcing of member m of cell c is stored in
+    // force[m * ncells_active + c]
+    nforce = local_domain.ncells_active * options.NMEMBERS;
+
     if (options.CARBON) {
-        // Atmospheric CO2 mixing ratio
-        for (j = 0; j < NF; j++) {
-            d3start[0] = global_param.forceskip[0] +
-                         global_param.forceoffset[0] + j;
-            get_scatter_nc_field_double(filenames.forcing[0],
-                                        param_set.TYPE[CATM].varname,
-                                        d3start, d3count, dvar);
-            for (i = 0; i < local_domain.ncells_active; i++) {
-                force[i].Catm[j] = (double) dvar[i];
-            }
-        }
         // Cosine of solar zenith angle
-        for (j = 0; j < NF; j++) {
-            for (i = 0; i < local_domain.ncells_active; i++) {
+        for (i = 0; i < nforce; i++) {
+            c = i % local_domain.ncells_active;
+            for (j = 0; j < NF; j++) {
                 force[i].coszen[j] = compute_coszen(
-                    local_domain.locations[i].latitude,
-                    local_domain.locations[i].longitude,
-                    soil_con[i].time_zone_lng, dmy[current].day_in_year,
+                    local_domain.locations[c].latitude,
+                    local_domain.locations[c].longitude,
+                    soil_con[c].time_zone_lng, dmy[current].day_in_year,
                     dmy[current].dayseconds);
             }
         }
-        // Fraction of shortwave that is direct
-        for (j = 0; j < NF; j++) {
-            d3start[0] = global_param.forceskip[0] +
-                         global_param.forceoffset[0] + j;
-            get_scatter_nc_field_double(filenames.forcing[0],
-                                        param_set.TYPE[FDIR].varname,
-                                        d3start, d3count, dvar);
-            for (i = 0; i < local_domain.ncells_active; i++) {
-                force[i].fdir[j] = (double) dvar[i];
-            }
-        }
-        // Photosynthetically active radiation
-        for (j = 0; j < NF; j++) {
-            d3start[0] = global_param.forceskip[0] +
-                         global_param.forceoffset[0] + j;
-            get_scatter_nc_field_double(filenames.forcing[0],
-                                        param_set.TYPE[PAR].varname,
-                                        d3start, d3count, dvar);
-            for (i = 0; i < local_domain.ncells_active; i++) {
-                force[i].par[j] = (double) dvar[i];
-            }
-        }
     }
 
     // Update the offset counter
     global_param.forceoffset[0] += NF;
 
+    // With an I/O server, the master process has no cells and reads the
+    // next window while the other processes run the current step
+    if (options.IO_SERVER && mpi_rank == VIC_MPI_ROOT &&
+        current + 1 < global_param.nrecs) {
+        sprintf(next_file, "%s%4d.nc", filenames.f_path_pfx[0],
+                dmy[current + 1].year);
+        next_start = global_param.forceskip[0] + global_param.forceoffset[0];
+        if (current + 1 > 1 && dmy[current + 1].year != dmy[current].year) {
+            next_start = global_param.forceskip[0];
+        }
+        read_force_window(&force_prefetch, next_file, next_start, ntypes,
+                          types);
+    }
+
     // Initialize the veg_hist structure with the current climatological
     // vegetation parameters.  This may be overwritten with the historical
     // forcing time series.
@@ -266,27 +235,39 @@ vic_force(void)
             global_param.forceoffset[1] = 0;
         }
 
-        // only the time slice changes for the met file reads. The rest is constant
+        // each variable is read as a single [time][veg_class][y][x] block
+        // covering all NF substeps; only the time offset changes between
+        // calls
+        d4start[0] = global_param.forceskip[1] + global_param.forceoffset[1];
+        d4start[1] = 0;
         d4start[2] = 0;
         d4start[3] = 0;
-        d4count[0] = 1;
-        d4count[1] = 1;
+        d4count[0] = NF;
+        d4count[1] = options.NVEGTYPES;
         d4count[2] = global_domain.n_ny;
         d4count[3] = global_domain.n_nx;
 
+        dblock = malloc(NF * options.NVEGTYPES * local_domain.ncells_active *
+                        sizeof(*dblock));
+        check_alloc_status(dblock, "Memory allocation error.");
+
+        if (mpi_rank == VIC_MPI_ROOT) {
+            status = nc_open(filenames.forcing[1], NC_NOWRITE, &nc_id);
+            check_nc_status(status, "Error opening %s", filenames.forcing[1]);
+        }
+
         // Leaf Area Index: lai
         if (options.LAI_SRC == FROM_VEGHIST) {
+            get_scatter_nc_block_double(nc_id, "lai", 4, d4start, d4count,
+                                        dblock);
             for (j = 0; j < NF; j++) {
-                d4start[0] = global_param.forceskip[1] +
-                             global_param.forceoffset[1] + j;
                 for (v = 0; v < options.NVEGTYPES; v++) {
-                    d4start[1] = v;
-                    get_scatter_nc_field_double(filenames.forcing[1], "lai",
-                                                d4start, d4count, dvar);
+                    offset = (j * options.NVEGTYPES + v) *
+                             local_domain.ncells_active;
                     for (i = 0; i < local_domain.ncells_active; i++) {
                         vidx = veg_con_map[i].vidx[v];
                         if (vidx != NODATA_VEG) {
-                            veg_hist[i][vidx].LAI[j] = (double) dvar[i];
+                            veg_hist[i][vidx].LAI[j] = dblock[offset + i];
                         }
                     }
                 }
@@ -295,17 +276,16 @@ vic_force(void)
 
         // Partial veg cover fraction: fcov
         if (options.FCAN_SRC == FROM_VEGHIST) {
+            get_scatter_nc_block_double(nc_id, "fcov", 4, d4start, d4count,
+                                        dblock);
             for (j = 0; j < NF; j++) {
-                d4start[0] = global_param.forceskip[1] +
-                             global_param.forceoffset[1] + j;
                 for (v = 0; v < options.NVEGTYPES; v++) {
-                    d4start[1] = v;
-                    get_scatter_nc_field_double(filenames.forcing[1], "fcov",
-                                                d4start, d4count, dvar);
+                    offset = (j * options.NVEGTYPES + v) *
+                             local_domain.ncells_active;
                     for (i = 0; i < local_domain.ncells_active; i++) {
                         vidx = veg_con_map[i].vidx[v];
                         if (vidx != NODATA_VEG) {
-                            veg_hist[i][vidx].fcanopy[j] = (double) dvar[i];
+                            veg_hist[i][vidx].fcanopy[j] = dblock[offset + i];
                         }
                     }
                 }
@@ -314,48 +294,49 @@ vic_force(void)
 
         // Albedo: alb
         if (options.ALB_SRC == FROM_VEGHIST) {
+            get_scatter_nc_block_double(nc_id, "alb", 4, d4start, d4count,
+                                        dblock);
             for (j = 0; j < NF; j++) {
-                d4start[0] = global_param.forceskip[1] +
-                             global_param.forceoffset[1] + j;
                 for (v = 0; v < options.NVEGTYPES; v++) {
-                    d4start[1] = v;
-                    get_scatter_nc_field_double(filenames.forcing[1], "alb",
-                                                d4start, d4count, dvar);
+                    offset = (j * options.NVEGTYPES + v) *
+                             local_domain.ncells_active;
                     for (i = 0; i < local_domain.ncells_active; i++) {
                         vidx = veg_con_map[i].vidx[v];
                         if (vidx != NODATA_VEG) {
-                            veg_hist[i][vidx].albedo[j] = (double) dvar[i];
+                            veg_hist[i][vidx].albedo[j] = dblock[offset + i];
                         }
                     }
                 }
             }
         }
 
+        if (mpi_rank == VIC_MPI_ROOT) {
+            status = nc_close(nc_id);
+            check_nc_status(status, "Error closing %s", filenames.forcing[1]);
+        }
+        free(dblock);
+
         // Update the offset counter
         global_param.forceoffset[1] += NF;
     }
 
 
-    // allocate memory for t_offset
-    t_offset = malloc(local_domain.ncells_active * sizeof(*t_offset));
-    check_alloc_status(t_offset, "Memory allocation error.");
-
-    for (i = 0; i < local_domain.ncells_active; i++) {
+    // Convert forcings into what we need and calculate missing ones
+    for (i = 0; i < nforce; i++) {
+        c = i % local_domain.ncells_active;
         if (options.SNOW_BAND > 1) {
-            Tfactor = soil_con[i].Tfactor;
-            t_offset[i] = Tfactor[0];
+            Tfactor = soil_con[c].Tfactor;
+            t_offset = Tfactor[0];
             for (band = 1; band < options.SNOW_BAND; band++) {
-                if (Tfactor[band] < t_offset[i]) {
-                    t_offset[i] = Tfactor[band];
+                if (Tfactor[band] < t_offset) {
+                    t_offset = Tfactor[band];
                 }
             }
         }
         else {
-            t_offset[i] = 0;
+            t_offset = 0;
         }
-    }
-    // Convert forcings into what we need and calculate missing ones
-    for (i = 0; i < local_domain.ncells_active; i++) {
+
         for (j = 0; j < NF; j++) {
             // pressure in Pa
             force[i].pressure[j] *= PA_PER_KPA;
@@ -372,10 +353,45 @@ vic_force(void)
                                               force[i].pressure[j]);
             // snow flag
             force[i].snowflag[j] = will_it_snow(&(force[i].air_temp[j]),
-                                                t_offset[i],
+                                                t_offset,
                                                 param.SNOW_MAX_SNOW_TEMP,
                                                 &(force[i].prec[j]), 1);
         }
+
+        // Put average value in NR field
+        force[i].air_temp[NR] = average(force[i].air_temp, NF);
+        // For precipitation put total
+        force[i].prec[NR] = average(force[i].prec, NF) * NF;
+        force[i].shortwave[NR] = average(force[i].shortwave, NF);
+        force[i].longwave[NR] = average(force[i].longwave, NF);
+        force[i].pressure[NR] = average(force[i].pressure, NF);
+        force[i].wind[NR] = average(force[i].wind, NF);
+        force[i].vp[NR] = average(force[i].vp, NF);
+        force[i].vpd[NR] = (svp(force[i].air_temp[NR]) - force[i].vp[NR]);
+        force[i].density[NR] = air_density(force[i].air_temp[NR],
+                                           force[i].pressure[NR]);
+        force[i].snowflag[NR] = will_it_snow(force[i].air_temp, t_offset,
+                                             param.SNOW_MAX_SNOW_TEMP,
+                                             force[i].prec, NF);
+
+        // Optional inputs
+        if (options.LAKES) {
+            force[i].channel_in[NR] = average(force[i].channel_in, NF) * NF;
+        }
+        if (options.CARBON) {
+            force[i].Catm[NR] = average(force[i].Catm, NF);
+            force[i].fdir[NR] = average(force[i].fdir, NF);
+            force[i].par[NR] = average(force[i].par, NF);
+            // for coszen, use value at noon
+            force[i].coszen[NR] = compute_coszen(
+                local_domain.locations[c].latitude,
+                local_domain.locations[c].longitude, soil_con[c].time_zone_lng,
+                dmy[current].day_in_year, SEC_PER_DAY / 2);
+        }
+    }
+
+    // The vegetation forcing is shared by all members of a cell
+    for (i = 0; i < local_domain.ncells_active; i++) {
         // Check on fcanopy
         for (v = 0; v < options.NVEGTYPES; v++) {
             vidx = veg_con_map[i].vidx[v];
@@ -394,25 +410,6 @@ vic_force(void)
                 }
             }
         }
-    }
-
-
-    // Put average value in NR field
-    for (i = 0; i < local_domain.ncells_active; i++) {
-        force[i].air_temp[NR] = average(force[i].air_temp, NF);
-        // For precipitation put total
-        force[i].prec[NR] = average(force[i].prec, NF) * NF;
-        force[i].shortwave[NR] = average(force[i].shortwave, NF);
-        force[i].longwave[NR] = average(force[i].longwave, NF);
-        force[i].pressure[NR] = average(force[i].pressure, NF);
-        force[i].wind[NR] = average(force[i].wind, NF);
-        force[i].vp[NR] = average(force[i].vp, NF);
-        force[i].vpd[NR] = (svp(force[i].air_temp[NR]) - force[i].vp[NR]);
-        force[i].density[NR] = air_density(force[i].air_temp[NR],
-                                           force[i].pressure[NR]);
-        force[i].snowflag[NR] = will_it_snow(force[i].air_temp, t_offset[i],
-                                             param.SNOW_MAX_SNOW_TEMP,
-                                             force[i].prec, NF);
 
         for (v = 0; v < options.NVEGTYPES; v++) {
             vidx = veg_con_map[i].vidx[v];
@@ -431,26 +428,95 @@ vic_force(void)
                     veg_hist[i][vidx].roughness, NF);
             }
         }
+    }
+}
 
-        // Optional inputs
-        if (options.LAKES) {
-            force[i].channel_in[NR] = average(force[i].channel_in, NF) * NF;
-        }
-        if (options.CARBON) {
-            force[i].Catm[NR] = average(force[i].Catm, NF);
-            force[i].fdir[NR] = average(force[i].fdir, NF);
-            force[i].par[NR] = average(force[i].par, NF);
-            // for coszen, use value at noon
-            force[i].coszen[NR] = compute_coszen(
-                local_domain.locations[i].latitude,
-                local_domain.locations[i].longitude, soil_con[i].time_zone_lng,
-                dmy[current].day_in_year, SEC_PER_DAY / 2);
+/******************************************************************************
+ * @brief    Set the hyperslab of a window of NF meteorological forcing steps.
+ * @details  In ensemble mode (NMEMBERS > 1) the forcing variables have a
+ *           member dimension between time and y, and the window covers the
+ *           first NMEMBERS members, so that all members are read with a
+ *           single call.
+ *
+ * @return   number of dimensions of the hyperslab
+ *****************************************************************************/
+size_t
+set_force_block(size_t  start,
+                size_t *dstart,
+                size_t *dcount)
+{
+    extern size_t        NF;
+    extern domain_struct global_domain;
+    extern option_struct options;
+
+    size_t               ndims;
+
+    ndims = 0;
+    dstart[ndims] = start;
+    dcount[ndims++] = NF;
+    if (options.NMEMBERS > 1) {
+        dstart[ndims] = 0;
+        dcount[ndims++] = options.NMEMBERS;
+    }
+    dstart[ndims] = 0;
+    dcount[ndims++] = global_domain.n_ny;
+    dstart[ndims] = 0;
+    dcount[ndims++] = global_domain.n_nx;
+
+    return ndims;
+}
+
+/******************************************************************************
+ * @brief    Read a window of NF meteorological forcing steps on the master
+ *           process.
+ * @details  Each forcing type in types is read from filename starting at
+ *           record start and stored in window->data in the order in which
+ *           it is scattered, so that it can be handed out later with
+ *           scatter_block_double_interleaved.
+ *****************************************************************************/
+void
+read_force_window(force_window_struct *window,
+                  char                *filename,
+                  size_t               start,
+                  size_t               ntypes,
+                  int                 *types)
+{
+    extern size_t           NF;
+    extern domain_struct    global_domain;
+    extern option_struct    options;
+    extern param_set_struct param_set;
+
+    int                     nc_id;
+    int                     status;
+    size_t                  k;
+    size_t                  ndims;
+    size_t                  dcount[4];
+    size_t                  dstart[4];
+
+    ndims = set_force_block(start, dstart, dcount);
+
+    status = nc_open(filename, NC_NOWRITE, &nc_id);
+    check_nc_status(status, "Error opening %s", filename);
+
+    for (k = 0; k < ntypes; k++) {
+        if (window->data[types[k]] == NULL) {
+            window->data[types[k]] =
+                malloc(NF * options.NMEMBERS * global_domain.ncells_active *
+                       sizeof(*(window->data[types[k]])));
+            check_alloc_status(window->data[types[k]],
+                               "Memory allocation error.");
         }
+        get_nc_block_double_mapped(nc_id, param_set.TYPE[types[k]].varname,
+                                   ndims, dstart, dcount,
+                                   window->data[types[k]]);
     }
 
+    status = nc_close(nc_id);
+    check_nc_status(status, "Error closing %s", filename);
 
-    // cleanup
-    free(dvar);
+    strcpy(window->filename, filename);
+    window->start = start;
+    window->ready = true;
 }
 
 /******************************************************************************
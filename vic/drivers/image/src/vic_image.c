@@ -32,6 +32,7 @@ size_t             *filter_active_cells = NULL;
 size_t             *mpi_map_mapping_array = NULL;
 all_vars_struct    *all_vars = NULL;
 force_data_struct  *force = NULL;
+force_window_struct force_prefetch;
 dmy_struct         *dmy = NULL;
 filenames_struct    filenames;
 filep_struct        filep;
@@ -48,6 +49,12 @@ MPI_Datatype        mpi_option_struct_type;
 MPI_Datatype        mpi_param_struct_type;
 int                *mpi_map_local_array_sizes = NULL;
 int                *mpi_map_global_array_offsets = NULL;
+mpi_map_buffers_struct mpi_map_buffers;
+veg_lib_share_struct veg_lib_share;
+spinup_struct       spinup;
+alarm_struct        state_alarm;
+state_stage_struct *state_stages = NULL;  // [NMEMBERS]
+route_struct        route;
 int                 mpi_rank;
 int                 mpi_size;
 option_struct       options;
@@ -119,6 +126,11 @@ main(int    argc,
     // initialize output structures
     vic_init_output(&(dmy[0]));
 
+    // initialize the inline routing
+    if (options.ROUTING) {
+        vic_route_init(&(dmy[0]));
+    }
+
     // Initialization is complete, print settings
     log_info(
         "Initialization is complete, print global param and options structures");
@@ -130,22 +142,45 @@ main(int    argc,
     // start vic run timer
     timer_start(&(global_timers[TIMER_VIC_RUN]));
 
-    // loop over all timesteps
-    for (current = 0; current < global_param.nrecs; current++) {
-        // read forcing data
-        vic_force();
-
-        // run vic over the domain
-        vic_image_run(&(dmy[current]));
-
-        // Write history files
-        vic_write_output(&(dmy[current]));
-
-        // Write state file
-        if (check_save_state_flag(current)) {
-            debug("writing state file for timestep %zu", current);
-            vic_store(&(dmy[current]), state_filename);
-            debug("finished storing state file: %s", state_filename)
+    if (global_param.spinup_cycles > 0) {
+        // repeat the simulation period until the model state has converged
+        // and only write the final state
+        vic_image_spinup();
+        vic_store(&(dmy[global_param.nrecs - 1]), state_filename);
+        debug("finished storing state file: %s", state_filename)
+    }
+    else {
+        // loop over all timesteps
+        for (current = 0; current < global_param.nrecs; current++) {
+            // read forcing data
+            vic_force();
+
+            // run vic over the domain
+            vic_image_run(&(dmy[current]));
+
+            // route runoff to the outlets
+            if (options.ROUTING) {
+                vic_route(&(dmy[current]));
+            }
+
+            // Write history files
+            vic_write_output(&(dmy[current]));
+
+            // Write state file
+            if (options.STATE_ASYNC) {
+                // write part of the state files that are pending
+                vic_store_progress();
+            }
+            if (check_save_state_flag(current)) {
+                debug("writing state file for timestep %zu", current);
+                if (options.STATE_ASYNC) {
+                    vic_store_async(&(dmy[current]), current, state_filename);
+                }
+                else {
+                    vic_store(&(dmy[current]), state_filename);
+                    debug("finished storing state file: %s", state_filename)
+                }
+            }
         }
     }
     // stop vic run timer
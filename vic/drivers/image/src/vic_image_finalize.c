@@ -32,10 +32,22 @@
 void
 vic_image_finalize(void)
 {
-    extern dmy_struct *dmy;
+    extern dmy_struct         *dmy;
+    extern force_window_struct force_prefetch;
+    extern option_struct       options;
+
+    size_t                     i;
+
+    // close the streamflow file
+    if (options.ROUTING) {
+        vic_route_finalize();
+    }
 
     // free data structures specific to to image driver
     free(dmy);
+    for (i = 0; i < N_FORCING_TYPES; i++) {
+        free(force_prefetch.data[i]);
+    }
 
     vic_finalize();
 }
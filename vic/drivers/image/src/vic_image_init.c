@@ -34,10 +34,15 @@ vic_image_init(void)
 {
     extern dmy_struct         *dmy;
     extern global_param_struct global_param;
+    extern alarm_struct        state_alarm;
 
     // make_dmy()
     initialize_time();
     dmy = make_dmy(&global_param);
 
+    // alarm for periodic state files
+    set_alarm(&(dmy[0]), global_param.statefreq, &(global_param.staten),
+              &state_alarm);
+
     vic_init();
 }
@@ -0,0 +1,232 @@
+/******************************************************************************
+ * @section DESCRIPTION
+ *
+ * Spin-up of the model state in the image driver.
+ *
+ * @section LICENSE
+ *
+ * The Variable Infiltration Capacity (VIC) macroscale hydrological model
+ * Copyright (C) 2016 The Computational Hydrology Group, Department of Civil
+ * and Environmental Engineering, University of Washington.
+ *
+ * The VIC model is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *****************************************************************************/
+
+#include <vic_driver_image.h>
+
+/******************************************************************************
+ * @brief    Spin up the model state by running the simulation period
+ *           repeatedly.
+ * @details  The forcing of the local cells is read during the first cycle
+ *           and kept in memory for the cycles that follow, so the forcing
+ *           files are only read once. At the end of each cycle the storages
+ *           of each cell are compared with those at the end of the previous
+ *           cycle (see check_spinup_convergence). Cells that have converged
+ *           are retired and no longer run by vic_image_run, and the spin-up
+ *           ends when all cells have converged or after
+ *           global_param.spinup_cycles cycles. No history output is written
+ *           during spin-up.
+ *****************************************************************************/
+void
+vic_image_spinup(void)
+{
+    extern size_t              NR;
+    extern size_t              current;
+    extern force_data_struct  *force;
+    extern dmy_struct         *dmy;
+    extern domain_struct       global_domain;
+    extern domain_struct       local_domain;
+    extern global_param_struct global_param;
+    extern option_struct       options;
+    extern veg_con_map_struct *veg_con_map;
+    extern veg_hist_struct   **veg_hist;
+    extern double           ***out_data;
+    extern spinup_struct       spinup;
+    extern int                 mpi_rank;
+    extern MPI_Comm            MPI_COMM_VIC;
+
+    double                    *fields[N_FORCING_TYPES];
+    double                    *veg_fields[N_VEG_HIST_FIELDS];
+    double                    *force_cache;
+    double                    *veg_hist_cache;
+    double                    *dvar;
+    double                     mbytes;
+    double                     max_mbytes;
+    bool                      *snowflag_cache;
+    size_t                     nfields;
+    size_t                     nforce;
+    size_t                     nveg;
+    size_t                     nstorage;
+    size_t                     cycle;
+    size_t                     i;
+    size_t                     j;
+    size_t                     k;
+    int                        nrun_local;
+    int                        nrun;
+    int                        status;
+
+    // The forcing of all local cells is stored per field as [ncells][NR + 1]
+    // and addressed through force[0] (see alloc_force)
+    nfields = 0;
+    fields[nfields++] = force[0].air_temp;
+    fields[nfields++] = force[0].density;
+    fields[nfields++] = force[0].longwave;
+    fields[nfields++] = force[0].prec;
+    fields[nfields++] = force[0].pressure;
+    fields[nfields++] = force[0].shortwave;
+    fields[nfields++] = force[0].vp;
+    fields[nfields++] = force[0].vpd;
+    fields[nfields++] = force[0].wind;
+    if (options.LAKES) {
+        fields[nfields++] = force[0].channel_in;
+    }
+    if (options.CARBON) {
+        fields[nfields++] = force[0].Catm;
+        fields[nfields++] = force[0].coszen;
+        fields[nfields++] = force[0].fdir;
+        fields[nfields++] = force[0].par;
+    }
+    nforce = local_domain.ncells_active * (NR + 1);
+
+    // the veg_hist fields of each active vegetation tile
+    nveg = 0;
+    for (i = 0; i < local_domain.ncells_active; i++) {
+        nveg += veg_con_map[i].nv_active;
+    }
+
+    // report the largest cache of all processes
+    mbytes = global_param.nrecs *
+             (nforce * (nfields * sizeof(double) + sizeof(bool)) +
+              N_VEG_HIST_FIELDS * nveg * (NR + 1) * sizeof(double)) /
+             (1024. * 1024.);
+    status = MPI_Reduce(&mbytes, &max_mbytes, 1, MPI_DOUBLE, MPI_MAX,
+                        VIC_MPI_ROOT, MPI_COMM_VIC);
+    check_mpi_status(status, "MPI error.");
+    if (mpi_rank == VIC_MPI_ROOT) {
+        log_info("Spin-up: keeping up to %.1f MB of forcing in memory per "
+                 "process", max_mbytes);
+    }
+
+    force_cache = malloc((global_param.nrecs * nfields * nforce + 1) *
+                         sizeof(*force_cache));
+    check_alloc_status(force_cache, "Memory allocation error.");
+    snowflag_cache = malloc((global_param.nrecs * nforce + 1) *
+                            sizeof(*snowflag_cache));
+    check_alloc_status(snowflag_cache, "Memory allocation error.");
+    veg_hist_cache = malloc((global_param.nrecs * N_VEG_HIST_FIELDS * nveg *
+                             (NR + 1) + 1) * sizeof(*veg_hist_cache));
+    check_alloc_status(veg_hist_cache, "Memory allocation error.");
+
+    nstorage = get_spinup_nstorage();
+    spinup.retired = calloc(local_domain.ncells_active + 1,
+                            sizeof(*(spinup.retired)));
+    check_alloc_status(spinup.retired, "Memory allocation error.");
+    spinup.storage = malloc((local_domain.ncells_active * nstorage + 1) *
+                            sizeof(*(spinup.storage)));
+    check_alloc_status(spinup.storage, "Memory allocation error.");
+    for (i = 0; i < local_domain.ncells_active * nstorage; i++) {
+        spinup.storage[i] = MISSING;
+    }
+
+    nrun = (int) global_domain.ncells_active;
+    for (cycle = 0; cycle < global_param.spinup_cycles && nrun > 0; cycle++) {
+        for (current = 0; current < global_param.nrecs; current++) {
+            if (cycle == 0) {
+                vic_force();
+            }
+
+            // copy the forcing of this step to (first cycle) or from the
+            // cache
+            for (k = 0; k < nfields; k++) {
+                dvar = force_cache + (current * nfields + k) * nforce;
+                if (cycle == 0) {
+                    memcpy(dvar, fields[k], nforce * sizeof(*dvar));
+                }
+                else {
+                    memcpy(fields[k], dvar, nforce * sizeof(*dvar));
+                }
+            }
+            if (cycle == 0) {
+                memcpy(snowflag_cache + current * nforce, force[0].snowflag,
+                       nforce * sizeof(*snowflag_cache));
+            }
+            else {
+                memcpy(force[0].snowflag, snowflag_cache + current * nforce,
+                       nforce * sizeof(*snowflag_cache));
+            }
+            dvar = veg_hist_cache +
+                   current * N_VEG_HIST_FIELDS * nveg * (NR + 1);
+            for (i = 0; i < local_domain.ncells_active; i++) {
+                for (j = 0; j < veg_con_map[i].nv_active; j++) {
+                    veg_fields[0] = veg_hist[i][j].albedo;
+                    veg_fields[1] = veg_hist[i][j].displacement;
+                    veg_fields[2] = veg_hist[i][j].fcanopy;
+                    veg_fields[3] = veg_hist[i][j].LAI;
+                    veg_fields[4] = veg_hist[i][j].roughness;
+                    for (k = 0; k < N_VEG_HIST_FIELDS; k++) {
+                        if (cycle == 0) {
+                            memcpy(dvar, veg_fields[k],
+                                   (NR + 1) * sizeof(*dvar));
+                        }
+                        else {
+                            memcpy(veg_fields[k], dvar,
+                                   (NR + 1) * sizeof(*dvar));
+                        }
+                        dvar += NR + 1;
+                    }
+                }
+            }
+
+            // run vic over the cells that have not converged yet
+            vic_image_run(&(dmy[current]));
+        }
+
+        // retire the cells whose storages did not change over this cycle
+        nrun_local = 0;
+        for (i = 0; i < local_domain.ncells_active; i++) {
+            if (!spinup.retired[i]) {
+                if (check_spinup_convergence(out_data[i],
+                                             spinup.storage + i * nstorage)) {
+                    spinup.retired[i] = true;
+                }
+                else {
+                    nrun_local++;
+                }
+            }
+        }
+        status = MPI_Allreduce(&nrun_local, &nrun, 1, MPI_INT, MPI_SUM,
+                               MPI_COMM_VIC);
+        check_mpi_status(status, "MPI error.");
+
+        if (mpi_rank == VIC_MPI_ROOT) {
+            log_info("Spin-up cycle %zu: %zu of %zu cells have converged",
+                     cycle + 1, global_domain.ncells_active - (size_t) nrun,
+                     global_domain.ncells_active);
+        }
+    }
+
+    if (nrun > 0 && mpi_rank == VIC_MPI_ROOT) {
+        log_warn("%d cells have not converged after %zu spin-up cycles", nrun,
+                 global_param.spinup_cycles);
+    }
+
+    free(force_cache);
+    free(snowflag_cache);
+    free(veg_hist_cache);
+    free(spinup.retired);
+    free(spinup.storage);
+    spinup.retired = NULL;
+    spinup.storage = NULL;
+}
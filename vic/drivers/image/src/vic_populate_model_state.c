@@ -38,14 +38,16 @@
 void
 vic_populate_model_state(void)
 {
-    extern all_vars_struct *all_vars;
-    extern lake_con_struct *lake_con;
-    extern domain_struct    local_domain;
-    extern option_struct    options;
-    extern soil_con_struct *soil_con;
-    extern veg_con_struct **veg_con;
+    extern all_vars_struct    *all_vars;
+    extern lake_con_struct    *lake_con;
+    extern domain_struct       local_domain;
+    extern option_struct       options;
+    extern soil_con_struct    *soil_con;
+    extern veg_con_struct    **veg_con;
+    extern veg_con_map_struct *veg_con_map;
 
-    size_t                  i;
+    size_t                     i;
+    size_t                     m;
 
     // read the model state from the netcdf file if there is one
     if (options.INIT_STATE) {
@@ -67,7 +69,15 @@ vic_populate_model_state(void)
         compute_derived_state_vars(&(all_vars[i]), &(soil_con[i]), veg_con[i]);
         if (options.LAKES) {
             compute_derived_lake_dimensions(&(all_vars[i].lake_var),
-                                            lake_con[i]);
+                                            &(lake_con[i]));
+        }
+    }
+
+    // all ensemble members start from the same state
+    for (m = 1; m < options.NMEMBERS; m++) {
+        for (i = 0; i < local_domain.ncells_active; i++) {
+            copy_all_vars(&(all_vars[m * local_domain.ncells_active + i]),
+                          &(all_vars[i]), veg_con_map[i].nv_active);
         }
     }
 }
@@ -0,0 +1,753 @@
+/******************************************************************************
+ * @section DESCRIPTION
+ *
+ * Route runoff and baseflow to the outlets of the routing file.
+ *
+ * @section LICENSE
+ *
+ * The Variable Infiltration Capacity (VIC) macroscale hydrological model
+ * Copyright (C) 2016 The Computational Hydrology Group, Department of Civil
+ * and Environmental Engineering, University of Washington.
+ *
+ * The VIC model is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *****************************************************************************/
+
+#include <vic_driver_image.h>
+
+/******************************************************************************
+ * @brief    Set up the inline routing.
+ * @details  The master node reads the flow directions and outlets of the
+ *           routing file and broadcasts the downstream cell, the distance to
+ *           it and the outlet of each grid cell. Each process then follows
+ *           the flow path of its own cells to every outlet downstream of them
+ *           and computes the unit hydrograph of each of these sources.
+ *
+ *           Flow directions are 1 (north) to 8 (northwest) clockwise, all
+ *           other values mark cells without a downstream cell. Grid cells
+ *           with an outlet id > 0 are outlets.
+ *****************************************************************************/
+void
+vic_route_init(dmy_struct *dmy_current)
+{
+    extern MPI_Comm            MPI_COMM_VIC;
+    extern domain_struct       global_domain;
+    extern domain_struct       local_domain;
+    extern filenames_struct    filenames;
+    extern global_param_struct global_param;
+    extern option_struct       options;
+    extern route_struct        route;
+    extern int                 mpi_rank;
+
+    int                        status;
+    int                        color;
+    int                        key;
+    int                        drow[8] = {1, 1, 0, -1, -1, -1, 0, 1};
+    int                        dcol[8] = {0, 1, 1, 1, 0, -1, -1, -1};
+    int                        north = 1;
+    int                       *direction = NULL;
+    int                       *ids = NULL;
+    int                       *outlet_ids = NULL;
+    int                       *sorted_ids = NULL;
+    int                       *downstream = NULL;
+    int                       *outlet = NULL;
+    int                       *local_of = NULL;
+    long                       row;
+    long                       col;
+    size_t                     ncells = 0;
+    size_t                     pass;
+    size_t                     i;
+    size_t                     k;
+    size_t                     g;
+    size_t                     s;
+    size_t                     nsteps;
+    size_t                     start[2];
+    size_t                     count[2];
+    size_t                    *outlet_cells = NULL;
+    double                    *distance = NULL;
+    double                    *source_distance = NULL;
+    double                    *area = NULL;
+    double                    *upstream_area = NULL;
+    double                     x;
+
+    if (mpi_rank == VIC_MPI_ROOT) {
+        compare_ncdomain_with_global_domain(filenames.routing);
+
+        ncells = global_domain.ncells_total;
+        direction = malloc(ncells * sizeof(*direction));
+        check_alloc_status(direction, "Memory allocation error.");
+        ids = malloc(ncells * sizeof(*ids));
+        check_alloc_status(ids, "Memory allocation error.");
+
+        start[0] = 0;
+        start[1] = 0;
+        count[0] = global_domain.n_ny;
+        count[1] = global_domain.n_nx;
+        get_nc_field_int(filenames.routing, "flow_direction", start, count,
+                         direction);
+        get_nc_field_int(filenames.routing, "outlet", start, count, ids);
+
+        // direction of north in the rows of the grid
+        if (global_domain.n_ny > 1 &&
+            global_domain.locations[global_domain.n_nx].latitude <
+            global_domain.locations[0].latitude) {
+            north = -1;
+        }
+
+        // outlets in grid order
+        route.noutlets = 0;
+        for (g = 0; g < ncells; g++) {
+            if (ids[g] > 0) {
+                route.noutlets++;
+            }
+        }
+        if (route.noutlets == 0) {
+            log_err("The outlet variable of %s does not mark any grid cell "
+                    "as an outlet (outlet > 0).", filenames.routing);
+        }
+        outlet_ids = malloc(route.noutlets * sizeof(*outlet_ids));
+        check_alloc_status(outlet_ids, "Memory allocation error.");
+        outlet_cells = malloc(route.noutlets * sizeof(*outlet_cells));
+        check_alloc_status(outlet_cells, "Memory allocation error.");
+        outlet = malloc(ncells * sizeof(*outlet));
+        check_alloc_status(outlet, "Memory allocation error.");
+        for (g = 0, k = 0; g < ncells; g++) {
+            outlet[g] = -1;
+            if (ids[g] > 0) {
+                outlet_ids[k] = ids[g];
+                outlet_cells[k] = g;
+                outlet[g] = (int) k++;
+            }
+        }
+        sorted_ids = malloc(route.noutlets * sizeof(*sorted_ids));
+        check_alloc_status(sorted_ids, "Memory allocation error.");
+        memcpy(sorted_ids, outlet_ids, route.noutlets * sizeof(*sorted_ids));
+        qsort(sorted_ids, route.noutlets, sizeof(*sorted_ids), region_id_cmp);
+        for (k = 1; k < route.noutlets; k++) {
+            if (sorted_ids[k] == sorted_ids[k - 1]) {
+                log_err("Outlet id %d is used for more than one grid cell in "
+                        "%s", sorted_ids[k], filenames.routing);
+            }
+        }
+
+        // downstream cell of each grid cell and the distance to it
+        downstream = malloc(ncells * sizeof(*downstream));
+        check_alloc_status(downstream, "Memory allocation error.");
+        distance = malloc(ncells * sizeof(*distance));
+        check_alloc_status(distance, "Memory allocation error.");
+        for (g = 0; g < ncells; g++) {
+            downstream[g] = -1;
+            distance[g] = 0.;
+            if (direction[g] > 9) {
+                log_err("Invalid flow direction %d of grid cell %zu in %s. "
+                        "Valid flow directions are 1 (north) to 8 "
+                        "(northwest), or 0 or 9 for cells without a "
+                        "downstream cell.", direction[g], g,
+                        filenames.routing);
+            }
+            if (direction[g] < 1 || direction[g] > 8) {
+                continue;
+            }
+            row = (long) (g / global_domain.n_nx) +
+                  north * drow[direction[g] - 1];
+            col = (long) (g % global_domain.n_nx) + dcol[direction[g] - 1];
+            if (row < 0 || row >= (long) global_domain.n_ny ||
+                col < 0 || col >= (long) global_domain.n_nx) {
+                continue;
+            }
+            downstream[g] = (int) (row * global_domain.n_nx + col);
+            distance[g] = get_dist(global_domain.locations[g].latitude,
+                                   global_domain.locations[g].longitude,
+                                   global_domain.locations[downstream[g]].latitude,
+                                   global_domain.locations[downstream[g]].longitude);
+        }
+
+        free(direction);
+        free(ids);
+        free(sorted_ids);
+    }
+
+    status = MPI_Bcast(&ncells, 1, MPI_AINT, VIC_MPI_ROOT, MPI_COMM_VIC);
+    check_mpi_status(status, "MPI error.");
+    status = MPI_Bcast(&(route.noutlets), 1, MPI_AINT, VIC_MPI_ROOT,
+                       MPI_COMM_VIC);
+    check_mpi_status(status, "MPI error.");
+    if (mpi_rank != VIC_MPI_ROOT) {
+        downstream = malloc(ncells * sizeof(*downstream));
+        check_alloc_status(downstream, "Memory allocation error.");
+        distance = malloc(ncells * sizeof(*distance));
+        check_alloc_status(distance, "Memory allocation error.");
+        outlet = malloc(ncells * sizeof(*outlet));
+        check_alloc_status(outlet, "Memory allocation error.");
+    }
+    status = MPI_Bcast(downstream, (int) ncells, MPI_INT, VIC_MPI_ROOT,
+                       MPI_COMM_VIC);
+    check_mpi_status(status, "MPI error.");
+    status = MPI_Bcast(distance, (int) ncells, MPI_DOUBLE, VIC_MPI_ROOT,
+                       MPI_COMM_VIC);
+    check_mpi_status(status, "MPI error.");
+    status = MPI_Bcast(outlet, (int) ncells, MPI_INT, VIC_MPI_ROOT,
+                       MPI_COMM_VIC);
+    check_mpi_status(status, "MPI error.");
+
+    // follow the flow path of each local cell, the sources are counted in
+    // the first pass and stored in the second
+    route.nsources = 0;
+    for (pass = 0; pass < 2; pass++) {
+        s = 0;
+        for (i = 0; i < local_domain.ncells_active; i++) {
+            g = local_domain.locations[i].io_idx;
+            x = 0.;
+            for (k = 0;; k++) {
+                if (outlet[g] >= 0) {
+                    if (pass == 1) {
+                        route.source_cell[s] = i;
+                        route.source_outlet[s] = (size_t) outlet[g];
+                        source_distance[s] = x;
+                    }
+                    s++;
+                }
+                if (downstream[g] < 0) {
+                    break;
+                }
+                if (k >= ncells) {
+                    log_err("The flow directions of %s contain a loop "
+                            "downstream of grid cell %zu",
+                            filenames.routing,
+                            local_domain.locations[i].io_idx);
+                }
+                x += distance[g];
+                g = (size_t) downstream[g];
+            }
+        }
+        if (pass == 0 && s > 0) {
+            route.nsources = s;
+            route.source_cell = malloc(s * sizeof(*(route.source_cell)));
+            check_alloc_status(route.source_cell, "Memory allocation error.");
+            route.source_outlet = malloc(s * sizeof(*(route.source_outlet)));
+            check_alloc_status(route.source_outlet,
+                               "Memory allocation error.");
+            source_distance = malloc(s * sizeof(*source_distance));
+            check_alloc_status(source_distance, "Memory allocation error.");
+        }
+        else if (pass == 0) {
+            break;
+        }
+    }
+
+    // outlets that are downstream of the local cells
+    local_of = malloc(route.noutlets * sizeof(*local_of));
+    check_alloc_status(local_of, "Memory allocation error.");
+    for (k = 0; k < route.noutlets; k++) {
+        local_of[k] = -1;
+    }
+    route.nlocal = 0;
+    for (s = 0; s < route.nsources; s++) {
+        if (local_of[route.source_outlet[s]] < 0) {
+            local_of[route.source_outlet[s]] = (int) route.nlocal++;
+        }
+    }
+    area = calloc(route.noutlets, sizeof(*area));
+    check_alloc_status(area, "Memory allocation error.");
+    if (route.nsources > 0) {
+        route.local_outlet = malloc(route.nlocal *
+                                    sizeof(*(route.local_outlet)));
+        check_alloc_status(route.local_outlet, "Memory allocation error.");
+        route.source_factor = malloc(route.nsources *
+                                     sizeof(*(route.source_factor)));
+        check_alloc_status(route.source_factor, "Memory allocation error.");
+        route.uh_start = malloc((route.nsources + 1) *
+                                sizeof(*(route.uh_start)));
+        check_alloc_status(route.uh_start, "Memory allocation error.");
+
+        route.ring_size = 1;
+        route.uh_start[0] = 0;
+        for (s = 0; s < route.nsources; s++) {
+            i = route.source_cell[s];
+            k = route.source_outlet[s];
+            route.local_outlet[local_of[k]] = k;
+            route.source_outlet[s] = (size_t) local_of[k];
+            area[k] += local_domain.locations[i].area *
+                       local_domain.locations[i].frac;
+            route.source_factor[s] = local_domain.locations[i].area *
+                                     local_domain.locations[i].frac /
+                                     (MM_PER_M * global_param.dt);
+            nsteps = get_route_uh_length(source_distance[s]);
+            route.uh_start[s + 1] = route.uh_start[s] + nsteps;
+            if (nsteps > route.ring_size) {
+                route.ring_size = nsteps;
+            }
+        }
+        route.uh = malloc(route.uh_start[route.nsources] *
+                          sizeof(*(route.uh)));
+        check_alloc_status(route.uh, "Memory allocation error.");
+        for (s = 0; s < route.nsources; s++) {
+            compute_route_uh(source_distance[s],
+                             route.uh_start[s + 1] - route.uh_start[s],
+                             &(route.uh[route.uh_start[s]]));
+        }
+
+        route.ring = calloc(route.ring_size * options.NMEMBERS * route.nlocal,
+                            sizeof(*(route.ring)));
+        check_alloc_status(route.ring, "Memory allocation error.");
+    }
+    route.ring_head = 0;
+
+    // only the master node and the processes with sources exchange outlet
+    // flows. The master node comes first in the routing communicator.
+    if (mpi_rank == VIC_MPI_ROOT || route.nsources > 0) {
+        color = 0;
+    }
+    else {
+        color = MPI_UNDEFINED;
+    }
+    key = (mpi_rank == VIC_MPI_ROOT) ? 0 : mpi_rank + 1;
+    status = MPI_Comm_split(MPI_COMM_VIC, color, key, &(route.comm));
+    check_mpi_status(status, "MPI error.");
+
+    if (route.comm != MPI_COMM_NULL) {
+        route.flow = calloc(options.NMEMBERS * route.noutlets,
+                            sizeof(*(route.flow)));
+        check_alloc_status(route.flow, "Memory allocation error.");
+
+        if (mpi_rank == VIC_MPI_ROOT) {
+            route.total = malloc(options.NMEMBERS * route.noutlets *
+                                 sizeof(*(route.total)));
+            check_alloc_status(route.total, "Memory allocation error.");
+            upstream_area = malloc(route.noutlets * sizeof(*upstream_area));
+            check_alloc_status(upstream_area, "Memory allocation error.");
+        }
+        status = MPI_Reduce(area, upstream_area, (int) route.noutlets,
+                            MPI_DOUBLE, MPI_SUM, VIC_MPI_ROOT, route.comm);
+        check_mpi_status(status, "MPI error.");
+    }
+
+    if (mpi_rank == VIC_MPI_ROOT) {
+        initialize_route_file(dmy_current, outlet_ids, outlet_cells,
+                              upstream_area);
+        log_info("Routing runoff and baseflow to %zu outlets of %s",
+                 route.noutlets, filenames.routing);
+
+        free(outlet_ids);
+        free(outlet_cells);
+        free(upstream_area);
+    }
+
+    free(area);
+    free(local_of);
+    free(source_distance);
+    free(downstream);
+    free(distance);
+    free(outlet);
+}
+
+/******************************************************************************
+ * @brief    Number of time steps of the unit hydrograph of a source.
+ * @details  The travel time over a channel of length distance has a mean of
+ *           distance / velocity and a variance of
+ *           2 * diffusion * distance / velocity^3.
+ *****************************************************************************/
+size_t
+get_route_uh_length(double distance)
+{
+    extern global_param_struct global_param;
+
+    double                     mean;
+    double                     sigma;
+
+    if (distance <= 0.) {
+        return 1;
+    }
+    mean = distance / global_param.rout_velocity;
+    sigma = sqrt(2. * global_param.rout_diffusion * distance /
+                 pow(global_param.rout_velocity, 3));
+
+    return (size_t) ceil((mean + ROUTE_UH_NSIGMA * sigma) /
+                         global_param.dt) + 1;
+}
+
+/******************************************************************************
+ * @brief    Unit hydrograph of a source.
+ * @details  The impulse response of the linearized Saint-Venant equation
+ *           over a channel of length distance (Lohmann et al., 1996) is
+ *           averaged over each time step and normalized to a sum of one.
+ *           A source at the outlet itself drains in the current time step.
+ *****************************************************************************/
+void
+compute_route_uh(double  distance,
+                 size_t  nsteps,
+                 double *uh)
+{
+    extern global_param_struct global_param;
+
+    size_t                     k;
+    size_t                     j;
+    double                     t;
+    double                     sum = 0.;
+
+    for (k = 0; k < nsteps; k++) {
+        uh[k] = 0.;
+    }
+    if (distance <= 0.) {
+        uh[0] = 1.;
+        return;
+    }
+
+    for (k = 0; k < nsteps; k++) {
+        for (j = 0; j < ROUTE_UH_NSUB; j++) {
+            t = (k + (j + 0.5) / ROUTE_UH_NSUB) * global_param.dt;
+            uh[k] += distance /
+                     (2. * t * sqrt(CONST_PI * t *
+                                    global_param.rout_diffusion)) *
+                     exp(-pow(global_param.rout_velocity * t - distance, 2) /
+                         (4. * global_param.rout_diffusion * t));
+        }
+        sum += uh[k];
+    }
+
+    if (sum > 0.) {
+        for (k = 0; k < nsteps; k++) {
+            uh[k] /= sum;
+        }
+    }
+    else {
+        // response is too narrow to be sampled, use the mean travel time
+        k = (size_t) (distance / global_param.rout_velocity /
+                      global_param.dt);
+        if (k >= nsteps) {
+            k = nsteps - 1;
+        }
+        uh[k] = 1.;
+    }
+}
+
+/******************************************************************************
+ * @brief    Create the streamflow file, which stores the hydrographs of the
+ *           outlets. Only called on the master node.
+ *****************************************************************************/
+void
+initialize_route_file(dmy_struct *dmy_current,
+                      int        *outlet_ids,
+                      size_t     *outlet_cells,
+                      double     *upstream_area)
+{
+    extern domain_struct       global_domain;
+    extern filenames_struct    filenames;
+    extern global_param_struct global_param;
+    extern option_struct       options;
+    extern route_struct        route;
+
+    int                        status;
+    int                        time_dimid;
+    int                        outlet_dimid;
+    int                        member_dimid;
+    int                        outlet_varid;
+    int                        lat_varid;
+    int                        lon_varid;
+    int                        area_varid;
+    int                        member_varid = -1;
+    int                        dimids[3];
+    int                        ndims;
+    int                       *ivar;
+    size_t                     k;
+    size_t                     start = 0;
+    double                    *dvar;
+    char                       str[MAXSTRING];
+    char                       unit_str[MAXSTRING];
+    char                       calendar_str[MAXSTRING];
+
+    // filename = result_dir/streamflow.YYYY-MM-DD-SSSSS.nc
+    if (snprintf(route.filename, MAXSTRING,
+                 "%s/streamflow.%04d-%02d-%02d-%05u.nc",
+                 filenames.result_dir, dmy_current->year, dmy_current->month,
+                 dmy_current->day, dmy_current->dayseconds) >= MAXSTRING) {
+        log_err("The name of the streamflow file in %s is too long",
+                filenames.result_dir);
+    }
+
+    status = nc_create(route.filename, get_nc_mode(NETCDF4_CLASSIC),
+                       &(route.nc_id));
+    check_nc_status(status, "Error creating %s", route.filename);
+
+    set_global_nc_attributes(route.nc_id, NC_HISTORY_FILE);
+
+    // define netcdf dimensions
+    status = nc_def_dim(route.nc_id, "time", NC_UNLIMITED, &time_dimid);
+    check_nc_status(status, "Error defining time dimension in %s",
+                    route.filename);
+    status = nc_def_dim(route.nc_id, "outlet", route.noutlets,
+                        &outlet_dimid);
+    check_nc_status(status, "Error defining outlet dimension in %s",
+                    route.filename);
+
+    // define the netcdf variable time
+    status = nc_def_var(route.nc_id, "time", NC_DOUBLE, 1, &time_dimid,
+                        &(route.time_varid));
+    check_nc_status(status, "Error defining time variable in %s",
+                    route.filename);
+    str_from_time_units(global_param.time_units, unit_str);
+    if (snprintf(str, MAXSTRING, "%s since %s", unit_str,
+                 global_param.time_origin_str) >= MAXSTRING) {
+        log_err("The time units of %s are too long", route.filename);
+    }
+    str_from_calendar(global_param.calendar, calendar_str);
+    put_nc_attr(route.nc_id, route.time_varid, "standard_name", "time");
+    put_nc_attr(route.nc_id, route.time_varid, "units", str);
+    put_nc_attr(route.nc_id, route.time_varid, "calendar", calendar_str);
+
+    // outlet coordinates
+    status = nc_def_var(route.nc_id, "outlet", NC_INT, 1, &outlet_dimid,
+                        &outlet_varid);
+    check_nc_status(status, "Error defining outlet variable in %s",
+                    route.filename);
+    put_nc_attr(route.nc_id, outlet_varid, "long_name",
+                "outlet id in the routing file");
+    status = nc_def_var(route.nc_id, "lat", NC_DOUBLE, 1, &outlet_dimid,
+                        &lat_varid);
+    check_nc_status(status, "Error defining lat variable in %s",
+                    route.filename);
+    put_nc_attr(route.nc_id, lat_varid, "standard_name", "latitude");
+    put_nc_attr(route.nc_id, lat_varid, "units", "degrees_north");
+    status = nc_def_var(route.nc_id, "lon", NC_DOUBLE, 1, &outlet_dimid,
+                        &lon_varid);
+    check_nc_status(status, "Error defining lon variable in %s",
+                    route.filename);
+    put_nc_attr(route.nc_id, lon_varid, "standard_name", "longitude");
+    put_nc_attr(route.nc_id, lon_varid, "units", "degrees_east");
+    status = nc_def_var(route.nc_id, "upstream_area", NC_DOUBLE, 1,
+                        &outlet_dimid, &area_varid);
+    check_nc_status(status, "Error defining upstream_area variable in %s",
+                    route.filename);
+    put_nc_attr(route.nc_id, area_varid, "long_name",
+                "area of the active grid cells upstream of the outlet");
+    put_nc_attr(route.nc_id, area_varid, "units", "m2");
+
+    // streamflow of each member in ensemble mode
+    ndims = 0;
+    dimids[ndims++] = time_dimid;
+    if (options.NMEMBERS > 1) {
+        status = nc_def_dim(route.nc_id, "member", options.NMEMBERS,
+                            &member_dimid);
+        check_nc_status(status, "Error defining member dimension in %s",
+                        route.filename);
+        status = nc_def_var(route.nc_id, "member", NC_INT, 1, &member_dimid,
+                            &member_varid);
+        check_nc_status(status, "Error defining member variable in %s",
+                        route.filename);
+        put_nc_attr(route.nc_id, member_varid, "long_name",
+                    "index of ensemble member in the member dimension of the "
+                    "forcing file");
+        dimids[ndims++] = member_dimid;
+    }
+    dimids[ndims++] = outlet_dimid;
+    status = nc_def_var(route.nc_id, "streamflow", NC_DOUBLE, ndims, dimids,
+                        &(route.flow_varid));
+    check_nc_status(status, "Error defining streamflow variable in %s",
+                    route.filename);
+    put_nc_attr(route.nc_id, route.flow_varid, "standard_name",
+                "water_volume_transport_in_river_channel");
+    put_nc_attr(route.nc_id, route.flow_varid, "long_name",
+                "streamflow at the outlet");
+    put_nc_attr(route.nc_id, route.flow_varid, "units", "m3 s-1");
+    put_nc_attr(route.nc_id, route.flow_varid, "cell_methods",
+                "time: mean");
+
+    status = nc_enddef(route.nc_id);
+    check_nc_status(status, "Error leaving define mode for %s",
+                    route.filename);
+
+    // write the outlet coordinates
+    status = nc_put_vara_int(route.nc_id, outlet_varid, &start,
+                             &(route.noutlets), outlet_ids);
+    check_nc_status(status, "Error writing outlet ids in %s",
+                    route.filename);
+    dvar = malloc(route.noutlets * sizeof(*dvar));
+    check_alloc_status(dvar, "Memory allocation error.");
+    for (k = 0; k < route.noutlets; k++) {
+        dvar[k] = global_domain.locations[outlet_cells[k]].latitude;
+    }
+    status = nc_put_vara_double(route.nc_id, lat_varid, &start,
+                                &(route.noutlets), dvar);
+    check_nc_status(status, "Error writing outlet latitudes in %s",
+                    route.filename);
+    for (k = 0; k < route.noutlets; k++) {
+        dvar[k] = global_domain.locations[outlet_cells[k]].longitude;
+    }
+    status = nc_put_vara_double(route.nc_id, lon_varid, &start,
+                                &(route.noutlets), dvar);
+    check_nc_status(status, "Error writing outlet longitudes in %s",
+                    route.filename);
+    status = nc_put_vara_double(route.nc_id, area_varid, &start,
+                                &(route.noutlets), upstream_area);
+    check_nc_status(status, "Error writing upstream areas in %s",
+                    route.filename);
+    free(dvar);
+
+    if (options.NMEMBERS > 1) {
+        ivar = malloc(options.NMEMBERS * sizeof(*ivar));
+        check_alloc_status(ivar, "Memory allocation error.");
+        for (k = 0; k < options.NMEMBERS; k++) {
+            ivar[k] = (int) k;
+        }
+        status = nc_put_vara_int(route.nc_id, member_varid, &start,
+                                 &(options.NMEMBERS), ivar);
+        check_nc_status(status, "Error writing member index in %s",
+                        route.filename);
+        free(ivar);
+    }
+
+    route.time_index = 0;
+}
+
+/******************************************************************************
+ * @brief    Route the runoff and baseflow of the current time step and write
+ *           the flow at the outlets.
+ * @details  The runoff of each source is spread over the coming time steps
+ *           of its local outlet with its unit hydrograph. The flow that
+ *           reaches the local outlets in the current time step is then summed
+ *           over the processes on the master node.
+ *****************************************************************************/
+void
+vic_route(dmy_struct *dmy_current)
+{
+    extern MPI_Comm            MPI_COMM_VIC;
+    extern domain_struct       local_domain;
+    extern global_param_struct global_param;
+    extern option_struct       options;
+    extern double           ***out_data;
+    extern route_struct        route;
+    extern int                 mpi_rank;
+
+    int                        status;
+    size_t                     i;
+    size_t                     s;
+    size_t                     m;
+    size_t                     k;
+    size_t                     o;
+    size_t                     nsteps;
+    size_t                     slot;
+    size_t                     start[3];
+    size_t                     count[3];
+    size_t                     ndims;
+    double                     q;
+    double                    *uh;
+    double                    *ring;
+    double                     dtime;
+
+    // processes without sources do not take part in the routing
+    if (route.comm == MPI_COMM_NULL) {
+        return;
+    }
+
+    for (s = 0; s < route.nsources; s++) {
+        uh = &(route.uh[route.uh_start[s]]);
+        nsteps = route.uh_start[s + 1] - route.uh_start[s];
+        for (m = 0; m < options.NMEMBERS; m++) {
+            i = m * local_domain.ncells_active + route.source_cell[s];
+            q = (out_data[i][OUT_RUNOFF][0] + out_data[i][OUT_BASEFLOW][0]) *
+                route.source_factor[s];
+            if (q == 0.) {
+                continue;
+            }
+            for (k = 0; k < nsteps; k++) {
+                slot = (route.ring_head + k) % route.ring_size;
+                route.ring[(slot * options.NMEMBERS + m) * route.nlocal +
+                           route.source_outlet[s]] += q * uh[k];
+            }
+        }
+    }
+
+    // flow that reaches the local outlets in the current time step
+    for (k = 0; k < options.NMEMBERS * route.noutlets; k++) {
+        route.flow[k] = 0.;
+    }
+    if (route.nsources > 0) {
+        ring = &(route.ring[route.ring_head * options.NMEMBERS *
+                            route.nlocal]);
+        for (m = 0; m < options.NMEMBERS; m++) {
+            for (o = 0; o < route.nlocal; o++) {
+                route.flow[m * route.noutlets + route.local_outlet[o]] =
+                    ring[m * route.nlocal + o];
+                ring[m * route.nlocal + o] = 0.;
+            }
+        }
+        route.ring_head = (route.ring_head + 1) % route.ring_size;
+    }
+
+    status = MPI_Reduce(route.flow, route.total,
+                        (int) (options.NMEMBERS * route.noutlets),
+                        MPI_DOUBLE, MPI_SUM, VIC_MPI_ROOT, route.comm);
+    check_mpi_status(status, "MPI error.");
+
+    if (mpi_rank != VIC_MPI_ROOT) {
+        return;
+    }
+
+    // timestamp is the beginning of the time step
+    dtime = date2num(global_param.time_origin_num, dmy_current, 0.,
+                     global_param.calendar, global_param.time_units);
+    status = nc_put_var1_double(route.nc_id, route.time_varid,
+                                &(route.time_index), &dtime);
+    check_nc_status(status, "Error writing time variable in %s",
+                    route.filename);
+
+    ndims = 0;
+    start[ndims] = route.time_index;
+    count[ndims++] = 1;
+    if (options.NMEMBERS > 1) {
+        start[ndims] = 0;
+        count[ndims++] = options.NMEMBERS;
+    }
+    start[ndims] = 0;
+    count[ndims++] = route.noutlets;
+    status = nc_put_vara_double(route.nc_id, route.flow_varid, start, count,
+                                route.total);
+    check_nc_status(status, "Error writing streamflow in %s",
+                    route.filename);
+
+    route.time_index++;
+}
+
+/******************************************************************************
+ * @brief    Close the streamflow file and free the routing structures.
+ *****************************************************************************/
+void
+vic_route_finalize(void)
+{
+    extern MPI_Comm     MPI_COMM_VIC;
+    extern route_struct route;
+    extern int          mpi_rank;
+
+    int                 status;
+
+    if (mpi_rank == VIC_MPI_ROOT) {
+        status = nc_close(route.nc_id);
+        check_nc_status(status, "Error closing %s", route.filename);
+    }
+
+    if (route.comm != MPI_COMM_NULL) {
+        status = MPI_Comm_free(&(route.comm));
+        check_mpi_status(status, "MPI error.");
+    }
+
+    free(route.source_cell);
+    free(route.source_outlet);
+    free(route.source_factor);
+    free(route.uh_start);
+    free(route.uh);
+    free(route.local_outlet);
+    free(route.ring);
+    free(route.flow);
+    free(route.total);
+}
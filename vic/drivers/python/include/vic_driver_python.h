@@ -31,4 +31,24 @@
 
 #define VIC_DRIVER "Python"
 
+/******************************************************************************
+ * @brief   Grid cells and forcing window of the domain run by the Python
+ *          driver.
+ *****************************************************************************/
+typedef struct {
+    size_t ncells;   /**< number of grid cells */
+    size_t nwindow;  /**< number of model steps held by the forcing buffers */
+    size_t *nveg;    /**< number of vegetation tiles of each cell, without
+                          the bare soil tile */
+} python_domain_struct;
+
+int vic_python_alloc(size_t ncells, size_t *nveg, size_t nwindow);
+int vic_python_final(void);
+void vic_python_finalize(void);
+void vic_python_force(size_t step);
+int vic_python_init(void);
+int vic_python_restore_snapshot(snapshot_struct *snapshot);
+int vic_python_run(size_t nsteps);
+void vic_python_snapshot(snapshot_struct *snapshot);
+
 #endif
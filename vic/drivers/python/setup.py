@@ -120,9 +120,7 @@ def make_cffi_headers():
                  'IceEnergyBalance',
                  'root_brent',
                  'SnowPackEnergyBalance',
-                 'soil_thermal_eqn',
-                 'zwtvmoist_zwt',
-                 'zwtvmoist_moist']
+                 'soil_thermal_eqn']
 
     args = ['gcc', '-std=c99', '-E',
             '-P', os.path.join(vic_root_abs_path, 'vic', 'drivers',
@@ -267,7 +265,7 @@ setup(name='vic',
       author_email='jhamman1@uw.edu',
       cmdclass={'clean': CleanCommand},
       setup_requires=["cffi>=1.0.0"],
-      install_requires=["cffi>=1.0.0"],
+      install_requires=["cffi>=1.0.0", "numpy"],
       tests_require=['pytest'],
       url='https://github.com/UW-Hydro/VIC',
       py_modules=["vic"],
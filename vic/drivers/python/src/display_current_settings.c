@@ -91,6 +91,12 @@ display_current_settings(int mode)
     fprintf(LOG_DEST, "MODEL_DT\t\t%f\n", global_param.dt);
     fprintf(LOG_DEST, "SNOW_DT\t\t%f\n", global_param.snow_dt);
     fprintf(LOG_DEST, "RUNOFF_DT\t\t%f\n", global_param.runoff_dt);
+    if (options.RUNOFF_ADAPTIVE) {
+        fprintf(LOG_DEST, "RUNOFF_ADAPTIVE\t\tTRUE\n");
+    }
+    else {
+        fprintf(LOG_DEST, "RUNOFF_ADAPTIVE\t\tFALSE\n");
+    }
     fprintf(LOG_DEST, "STARTYEAR\t\t%d\n", global_param.startyear);
     fprintf(LOG_DEST, "STARTMONTH\t\t%d\n", global_param.startmonth);
     fprintf(LOG_DEST, "STARTDAY\t\t%d\n", global_param.startday);
@@ -39,3 +39,19 @@ option_struct       options;
 parameters_struct   param;
 param_set_struct    param_set;
 metadata_struct     out_metadata[N_OUTVAR_TYPES];
+
+// domain run through the step API
+size_t               current; /* index of the current model step */
+python_domain_struct domain;
+all_vars_struct     *all_vars;     /* [ncells] */
+dmy_struct          *dmy;          /* [nrecs] */
+force_data_struct   *force;        /* [ncells] */
+force_data_struct    force_window; /* forcing buffers
+                                      [nwindow][ncells][NR + 1] */
+lake_con_struct      lake_con;
+double            ***out_data;     /* [ncells, nvars, nelem] */
+save_data_struct    *save_data;    /* [ncells] */
+soil_con_struct     *soil_con;     /* [ncells] */
+veg_con_struct     **veg_con;      /* [ncells][nveg + 1] */
+veg_hist_struct    **veg_hist;     /* [ncells][nveg + 1] */
+veg_lib_struct      *veg_lib;      /* [NVEGTYPES] */
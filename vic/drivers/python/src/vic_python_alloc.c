@@ -0,0 +1,264 @@
+/******************************************************************************
+ * @section DESCRIPTION
+ *
+ * Allocate the domain run through the Python driver step API.
+ *
+ * @section LICENSE
+ *
+ * The Variable Infiltration Capacity (VIC) macroscale hydrological model
+ * Copyright (C) 2016 The Computational Hydrology Group, Department of Civil
+ * and Environmental Engineering, University of Washington.
+ *
+ * The VIC model is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *****************************************************************************/
+
+#include <vic_driver_python.h>
+
+/******************************************************************************
+ * @brief    Allocate the parameters, forcing, state and output of a domain.
+ * @details  The options, global and model parameters must be set before
+ *           this is called. Each forcing variable is stored in one contiguous
+ *           array laid out as [nwindow][cell][NR + 1] (force_window) and each
+ *           output variable in one contiguous array laid out as
+ *           [cell][nelem], so that they can be read and written from Python
+ *           without copies. force[i] is pointed to the forcing of the
+ *           current step of the window by vic_python_force.
+ *****************************************************************************/
+int
+vic_python_alloc(size_t  ncells,
+                 size_t *nveg,
+                 size_t  nwindow)
+{
+    extern all_vars_struct     *all_vars;
+    extern python_domain_struct domain;
+    extern force_data_struct   *force;
+    extern force_data_struct    force_window;
+    extern global_param_struct  global_param;
+    extern option_struct        options;
+    extern metadata_struct      out_metadata[N_OUTVAR_TYPES];
+    extern double            ***out_data;
+    extern save_data_struct    *save_data;
+    extern soil_con_struct     *soil_con;
+    extern veg_con_struct     **veg_con;
+    extern veg_hist_struct    **veg_hist;
+    extern veg_lib_struct      *veg_lib;
+
+    size_t                      i;
+    size_t                      j;
+    size_t                      nvalues;
+    double                     *store;
+
+    if (ncells == 0 || nwindow == 0) {
+        log_err("The domain must have at least one cell and the forcing "
+                "window at least one step.");
+    }
+    if (options.LAKES) {
+        log_err("LAKES are not supported by the Python driver.");
+    }
+    if (global_param.model_steps_per_day == 0 ||
+        global_param.snow_steps_per_day == 0 ||
+        global_param.runoff_steps_per_day == 0) {
+        log_err("The model, snow and runoff steps per day must be set before "
+                "the domain is allocated.");
+    }
+
+    // time steps in seconds
+    global_param.dt = SEC_PER_DAY / (double) global_param.model_steps_per_day;
+    global_param.snow_dt = SEC_PER_DAY /
+                           (double) global_param.snow_steps_per_day;
+    global_param.runoff_dt = SEC_PER_DAY /
+                             (double) global_param.runoff_steps_per_day;
+
+    // set NR and NF
+    NF = global_param.snow_steps_per_day / global_param.model_steps_per_day;
+    if (NF == 1) {
+        NR = 0;
+    }
+    else {
+        NR = NF;
+    }
+
+    domain.ncells = ncells;
+    domain.nwindow = nwindow;
+    domain.nveg = calloc(ncells, sizeof(*(domain.nveg)));
+    check_alloc_status(domain.nveg, "Memory allocation error.");
+    for (i = 0; i < ncells; i++) {
+        domain.nveg[i] = nveg[i];
+    }
+
+    // forcing buffers of the whole window
+    nvalues = nwindow * ncells * (NR + 1);
+
+    force_window.air_temp = calloc(nvalues, sizeof(*(force_window.air_temp)));
+    check_alloc_status(force_window.air_temp, "Memory allocation error.");
+
+    force_window.density = calloc(nvalues, sizeof(*(force_window.density)));
+    check_alloc_status(force_window.density, "Memory allocation error.");
+
+    force_window.longwave = calloc(nvalues, sizeof(*(force_window.longwave)));
+    check_alloc_status(force_window.longwave, "Memory allocation error.");
+
+    force_window.prec = calloc(nvalues, sizeof(*(force_window.prec)));
+    check_alloc_status(force_window.prec, "Memory allocation error.");
+
+    force_window.pressure = calloc(nvalues, sizeof(*(force_window.pressure)));
+    check_alloc_status(force_window.pressure, "Memory allocation error.");
+
+    force_window.shortwave = calloc(nvalues,
+                                    sizeof(*(force_window.shortwave)));
+    check_alloc_status(force_window.shortwave, "Memory allocation error.");
+
+    force_window.snowflag = calloc(nvalues, sizeof(*(force_window.snowflag)));
+    check_alloc_status(force_window.snowflag, "Memory allocation error.");
+
+    force_window.vp = calloc(nvalues, sizeof(*(force_window.vp)));
+    check_alloc_status(force_window.vp, "Memory allocation error.");
+
+    force_window.vpd = calloc(nvalues, sizeof(*(force_window.vpd)));
+    check_alloc_status(force_window.vpd, "Memory allocation error.");
+
+    force_window.wind = calloc(nvalues, sizeof(*(force_window.wind)));
+    check_alloc_status(force_window.wind, "Memory allocation error.");
+
+    force_window.channel_in = NULL;
+
+    force_window.Catm = NULL;
+    force_window.coszen = NULL;
+    force_window.fdir = NULL;
+    force_window.par = NULL;
+    if (options.CARBON) {
+        force_window.Catm = calloc(nvalues, sizeof(*(force_window.Catm)));
+        check_alloc_status(force_window.Catm, "Memory allocation error.");
+
+        force_window.coszen = calloc(nvalues, sizeof(*(force_window.coszen)));
+        check_alloc_status(force_window.coszen, "Memory allocation error.");
+
+        force_window.fdir = calloc(nvalues, sizeof(*(force_window.fdir)));
+        check_alloc_status(force_window.fdir, "Memory allocation error.");
+
+        force_window.par = calloc(nvalues, sizeof(*(force_window.par)));
+        check_alloc_status(force_window.par, "Memory allocation error.");
+    }
+
+    force = calloc(ncells, sizeof(*force));
+    check_alloc_status(force, "Memory allocation error.");
+
+    soil_con = calloc(ncells, sizeof(*soil_con));
+    check_alloc_status(soil_con, "Memory allocation error.");
+
+    veg_con = calloc(ncells, sizeof(*veg_con));
+    check_alloc_status(veg_con, "Memory allocation error.");
+
+    veg_hist = calloc(ncells, sizeof(*veg_hist));
+    check_alloc_status(veg_hist, "Memory allocation error.");
+
+    // all cells share one vegetation library
+    veg_lib = calloc(options.NVEGTYPES, sizeof(*veg_lib));
+    check_alloc_status(veg_lib, "Memory allocation error.");
+
+    all_vars = calloc(ncells, sizeof(*all_vars));
+    check_alloc_status(all_vars, "Memory allocation error.");
+
+    save_data = calloc(ncells, sizeof(*save_data));
+    check_alloc_status(save_data, "Memory allocation error.");
+
+    // output of all cells, one contiguous array per variable
+    set_output_met_data_info();
+    out_data = calloc(ncells, sizeof(*out_data));
+    check_alloc_status(out_data, "Memory allocation error.");
+    for (i = 0; i < ncells; i++) {
+        out_data[i] = calloc(N_OUTVAR_TYPES, sizeof(*(out_data[i])));
+        check_alloc_status(out_data[i], "Memory allocation error.");
+    }
+    for (j = 0; j < N_OUTVAR_TYPES; j++) {
+        store = calloc(ncells * out_metadata[j].nelem, sizeof(*store));
+        check_alloc_status(store, "Memory allocation error.");
+        for (i = 0; i < ncells; i++) {
+            out_data[i][j] = store + i * out_metadata[j].nelem;
+        }
+    }
+
+    for (i = 0; i < ncells; i++) {
+        // snow band allocation
+        soil_con[i].AreaFract = calloc(options.SNOW_BAND,
+                                       sizeof(*(soil_con[i].AreaFract)));
+        check_alloc_status(soil_con[i].AreaFract, "Memory allocation error.");
+        soil_con[i].BandElev = calloc(options.SNOW_BAND,
+                                      sizeof(*(soil_con[i].BandElev)));
+        check_alloc_status(soil_con[i].BandElev, "Memory allocation error.");
+        soil_con[i].Tfactor = calloc(options.SNOW_BAND,
+                                     sizeof(*(soil_con[i].Tfactor)));
+        check_alloc_status(soil_con[i].Tfactor, "Memory allocation error.");
+        soil_con[i].Pfactor = calloc(options.SNOW_BAND,
+                                     sizeof(*(soil_con[i].Pfactor)));
+        check_alloc_status(soil_con[i].Pfactor, "Memory allocation error.");
+        soil_con[i].AboveTreeLine = calloc(options.SNOW_BAND,
+                                           sizeof(*(soil_con[i].AboveTreeLine)));
+        check_alloc_status(soil_con[i].AboveTreeLine,
+                           "Memory allocation error.");
+        // a single band covers the whole cell
+        if (options.SNOW_BAND == 1) {
+            soil_con[i].AreaFract[0] = 1.;
+            soil_con[i].Pfactor[0] = 1.;
+        }
+
+        // vegetation tiles, the last one is bare soil
+        veg_con[i] = calloc(nveg[i] + 1, sizeof(*(veg_con[i])));
+        check_alloc_status(veg_con[i], "Memory allocation error.");
+        veg_hist[i] = calloc(nveg[i] + 1, sizeof(*(veg_hist[i])));
+        check_alloc_status(veg_hist[i], "Memory allocation error.");
+        for (j = 0; j <= nveg[i]; j++) {
+            veg_con[i][j].vegetat_type_num = nveg[i];
+            veg_con[i][j].zone_depth = calloc(options.ROOT_ZONES,
+                                              sizeof(*(veg_con[i][j].zone_depth)));
+            check_alloc_status(veg_con[i][j].zone_depth,
+                               "Memory allocation error.");
+            veg_con[i][j].zone_fract = calloc(options.ROOT_ZONES,
+                                              sizeof(*(veg_con[i][j].zone_fract)));
+            check_alloc_status(veg_con[i][j].zone_fract,
+                               "Memory allocation error.");
+            if (options.CARBON) {
+                veg_con[i][j].CanopLayerBnd = calloc(options.Ncanopy,
+                                                     sizeof(*(veg_con[i][j].
+                                                              CanopLayerBnd)));
+                check_alloc_status(veg_con[i][j].CanopLayerBnd,
+                                   "Memory allocation error.");
+            }
+
+            veg_hist[i][j].albedo = calloc(NR + 1,
+                                           sizeof(*(veg_hist[i][j].albedo)));
+            check_alloc_status(veg_hist[i][j].albedo,
+                               "Memory allocation error.");
+            veg_hist[i][j].displacement =
+                calloc(NR + 1, sizeof(*(veg_hist[i][j].displacement)));
+            check_alloc_status(veg_hist[i][j].displacement,
+                               "Memory allocation error.");
+            veg_hist[i][j].fcanopy = calloc(NR + 1,
+                                            sizeof(*(veg_hist[i][j].fcanopy)));
+            check_alloc_status(veg_hist[i][j].fcanopy,
+                               "Memory allocation error.");
+            veg_hist[i][j].LAI = calloc(NR + 1, sizeof(*(veg_hist[i][j].LAI)));
+            check_alloc_status(veg_hist[i][j].LAI, "Memory allocation error.");
+            veg_hist[i][j].roughness =
+                calloc(NR + 1, sizeof(*(veg_hist[i][j].roughness)));
+            check_alloc_status(veg_hist[i][j].roughness,
+                               "Memory allocation error.");
+        }
+
+        all_vars[i] = make_all_vars(nveg[i]);
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,110 @@
+/******************************************************************************
+ * @section DESCRIPTION
+ *
+ * Free the domain run through the Python driver step API.
+ *
+ * @section LICENSE
+ *
+ * The Variable Infiltration Capacity (VIC) macroscale hydrological model
+ * Copyright (C) 2016 The Computational Hydrology Group, Department of Civil
+ * and Environmental Engineering, University of Washington.
+ *
+ * The VIC model is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *****************************************************************************/
+
+#include <vic_driver_python.h>
+
+/******************************************************************************
+ * @brief    Free the memory allocated by vic_python_alloc and vic_python_init.
+ *****************************************************************************/
+void
+vic_python_finalize(void)
+{
+    extern all_vars_struct     *all_vars;
+    extern python_domain_struct domain;
+    extern dmy_struct          *dmy;
+    extern force_data_struct   *force;
+    extern force_data_struct    force_window;
+    extern option_struct        options;
+    extern double            ***out_data;
+    extern save_data_struct    *save_data;
+    extern soil_con_struct     *soil_con;
+    extern veg_con_struct     **veg_con;
+    extern veg_hist_struct    **veg_hist;
+    extern veg_lib_struct      *veg_lib;
+
+    size_t                      i;
+    size_t                      j;
+
+    for (i = 0; i < domain.ncells; i++) {
+        free(soil_con[i].AreaFract);
+        free(soil_con[i].BandElev);
+        free(soil_con[i].Tfactor);
+        free(soil_con[i].Pfactor);
+        free(soil_con[i].AboveTreeLine);
+        for (j = 0; j <= domain.nveg[i]; j++) {
+            free(veg_con[i][j].zone_depth);
+            free(veg_con[i][j].zone_fract);
+            if (options.CARBON) {
+                free(veg_con[i][j].CanopLayerBnd);
+            }
+            free(veg_hist[i][j].albedo);
+            free(veg_hist[i][j].displacement);
+            free(veg_hist[i][j].fcanopy);
+            free(veg_hist[i][j].LAI);
+            free(veg_hist[i][j].roughness);
+        }
+        free(veg_con[i]);
+        free(veg_hist[i]);
+        free_all_vars(&(all_vars[i]), domain.nveg[i]);
+    }
+    // the output of all cells is stored from out_data[0][j] on
+    for (j = 0; j < N_OUTVAR_TYPES; j++) {
+        free(out_data[0][j]);
+    }
+    for (i = 0; i < domain.ncells; i++) {
+        free(out_data[i]);
+    }
+    free(out_data);
+
+    free(force_window.air_temp);
+    free(force_window.density);
+    free(force_window.longwave);
+    free(force_window.prec);
+    free(force_window.pressure);
+    free(force_window.shortwave);
+    free(force_window.snowflag);
+    free(force_window.vp);
+    free(force_window.vpd);
+    free(force_window.wind);
+    if (options.CARBON) {
+        free(force_window.Catm);
+        free(force_window.coszen);
+        free(force_window.fdir);
+        free(force_window.par);
+    }
+
+    free(force);
+    free(soil_con);
+    free(veg_con);
+    free(veg_hist);
+    free(veg_lib);
+    free(all_vars);
+    free(save_data);
+    free_dmy(&dmy);
+    free(domain.nveg);
+    domain.ncells = 0;
+    domain.nwindow = 0;
+}
@@ -0,0 +1,163 @@
+/******************************************************************************
+ * @section DESCRIPTION
+ *
+ * Prepare the forcing of a model step of the Python driver.
+ *
+ * @section LICENSE
+ *
+ * The Variable Infiltration Capacity (VIC) macroscale hydrological model
+ * Copyright (C) 2016 The Computational Hydrology Group, Department of Civil
+ * and Environmental Engineering, University of Washington.
+ *
+ * The VIC model is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *****************************************************************************/
+
+#include <vic_driver_python.h>
+
+/******************************************************************************
+ * @brief    Point the forcing of each cell to a step of the forcing window
+ *           and compute the forcing variables that are derived from the
+ *           others.
+ * @details  Pressure and vapor pressure are expected in Pa, the units used
+ *           by vic_run. The vegetation forcing is set to the climatology of
+ *           the current month.
+ *****************************************************************************/
+void
+vic_python_force(size_t step)
+{
+    extern size_t               current;
+    extern python_domain_struct domain;
+    extern dmy_struct          *dmy;
+    extern force_data_struct   *force;
+    extern force_data_struct    force_window;
+    extern option_struct        options;
+    extern parameters_struct    param;
+    extern soil_con_struct     *soil_con;
+    extern veg_con_struct     **veg_con;
+    extern veg_hist_struct    **veg_hist;
+
+    size_t                      i;
+    size_t                      j;
+    size_t                      v;
+    size_t                      band;
+    size_t                      offset;
+    double                      t_offset;
+    double                     *Tfactor;
+
+    for (i = 0; i < domain.ncells; i++) {
+        offset = (step * domain.ncells + i) * (NR + 1);
+        force[i].air_temp = force_window.air_temp + offset;
+        force[i].density = force_window.density + offset;
+        force[i].longwave = force_window.longwave + offset;
+        force[i].prec = force_window.prec + offset;
+        force[i].pressure = force_window.pressure + offset;
+        force[i].shortwave = force_window.shortwave + offset;
+        force[i].snowflag = force_window.snowflag + offset;
+        force[i].vp = force_window.vp + offset;
+        force[i].vpd = force_window.vpd + offset;
+        force[i].wind = force_window.wind + offset;
+        if (options.CARBON) {
+            force[i].Catm = force_window.Catm + offset;
+            force[i].coszen = force_window.coszen + offset;
+            force[i].fdir = force_window.fdir + offset;
+            force[i].par = force_window.par + offset;
+        }
+
+        if (options.SNOW_BAND > 1) {
+            Tfactor = soil_con[i].Tfactor;
+            t_offset = Tfactor[0];
+            for (band = 1; band < options.SNOW_BAND; band++) {
+                if (Tfactor[band] < t_offset) {
+                    t_offset = Tfactor[band];
+                }
+            }
+        }
+        else {
+            t_offset = 0;
+        }
+
+        for (j = 0; j < NF; j++) {
+            // vapor pressure deficit in Pa
+            force[i].vpd[j] = svp(force[i].air_temp[j]) - force[i].vp[j];
+            if (force[i].vpd[j] < 0) {
+                force[i].vpd[j] = 0;
+                force[i].vp[j] = svp(force[i].air_temp[j]);
+            }
+            // air density in kg/m3
+            force[i].density[j] = air_density(force[i].air_temp[j],
+                                              force[i].pressure[j]);
+            // snow flag
+            force[i].snowflag[j] = will_it_snow(&(force[i].air_temp[j]),
+                                                t_offset,
+                                                param.SNOW_MAX_SNOW_TEMP,
+                                                &(force[i].prec[j]), 1);
+            if (options.CARBON) {
+                // Cosine of solar zenith angle
+                force[i].coszen[j] = compute_coszen(
+                    soil_con[i].lat, soil_con[i].lng,
+                    soil_con[i].time_zone_lng, dmy[current].day_in_year,
+                    dmy[current].dayseconds);
+            }
+        }
+
+        if (NR > 0) {
+            // Put average value in NR field
+            force[i].air_temp[NR] = average(force[i].air_temp, NF);
+            // For precipitation put total
+            force[i].prec[NR] = average(force[i].prec, NF) * NF;
+            force[i].shortwave[NR] = average(force[i].shortwave, NF);
+            force[i].longwave[NR] = average(force[i].longwave, NF);
+            force[i].pressure[NR] = average(force[i].pressure, NF);
+            force[i].wind[NR] = average(force[i].wind, NF);
+            force[i].vp[NR] = average(force[i].vp, NF);
+            force[i].vpd[NR] = (svp(force[i].air_temp[NR]) - force[i].vp[NR]);
+            force[i].density[NR] = air_density(force[i].air_temp[NR],
+                                               force[i].pressure[NR]);
+            force[i].snowflag[NR] = will_it_snow(force[i].air_temp, t_offset,
+                                                 param.SNOW_MAX_SNOW_TEMP,
+                                                 force[i].prec, NF);
+            if (options.CARBON) {
+                force[i].Catm[NR] = average(force[i].Catm, NF);
+                force[i].fdir[NR] = average(force[i].fdir, NF);
+                force[i].par[NR] = average(force[i].par, NF);
+                // for coszen, use value at noon
+                force[i].coszen[NR] = compute_coszen(
+                    soil_con[i].lat, soil_con[i].lng,
+                    soil_con[i].time_zone_lng, dmy[current].day_in_year,
+                    SEC_PER_DAY / 2);
+            }
+        }
+
+        // climatological vegetation forcing of the current month
+        for (v = 0; v <= domain.nveg[i]; v++) {
+            for (j = 0; j <= NR; j++) {
+                veg_hist[i][v].albedo[j] =
+                    veg_con[i][v].albedo[dmy[current].month - 1];
+                veg_hist[i][v].displacement[j] =
+                    veg_con[i][v].displacement[dmy[current].month - 1];
+                veg_hist[i][v].fcanopy[j] =
+                    veg_con[i][v].fcanopy[dmy[current].month - 1];
+                veg_hist[i][v].LAI[j] =
+                    veg_con[i][v].LAI[dmy[current].month - 1];
+                veg_hist[i][v].roughness[j] =
+                    veg_con[i][v].roughness[dmy[current].month - 1];
+                if (v < domain.nveg[i] &&
+                    veg_hist[i][v].fcanopy[j] < MIN_FCANOPY) {
+                    veg_hist[i][v].fcanopy[j] = MIN_FCANOPY;
+                }
+            }
+        }
+    }
+}
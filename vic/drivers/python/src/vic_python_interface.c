@@ -0,0 +1,164 @@
+/******************************************************************************
+ * @section DESCRIPTION
+ *
+ * Step API of the Python driver: initialize a domain, run it for a number of
+ * model steps and clean up.
+ *
+ * @section LICENSE
+ *
+ * The Variable Infiltration Capacity (VIC) macroscale hydrological model
+ * Copyright (C) 2016 The Computational Hydrology Group, Department of Civil
+ * and Environmental Engineering, University of Washington.
+ *
+ * The VIC model is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *****************************************************************************/
+
+#include <vic_driver_python.h>
+
+/******************************************************************************
+ * @brief    Initialization function for the Python driver
+ * @details  Called once the domain has been allocated with vic_python_alloc
+ *           and its parameters have been set. Generates the default model
+ *           state of each cell.
+ *****************************************************************************/
+int
+vic_python_init(void)
+{
+    extern all_vars_struct     *all_vars;
+    extern size_t               current;
+    extern python_domain_struct domain;
+    extern dmy_struct          *dmy;
+    extern force_data_struct   *force;
+    extern global_param_struct  global_param;
+    extern lake_con_struct      lake_con;
+    extern double            ***out_data;
+    extern save_data_struct    *save_data;
+    extern soil_con_struct     *soil_con;
+    extern veg_con_struct     **veg_con;
+    extern veg_lib_struct      *veg_lib;
+
+    size_t                      i;
+    timer_struct                timer;
+
+    // Initialize time
+    initialize_time();
+    dmy = make_dmy(&global_param);
+    current = 0;
+
+    vic_python_force(0);
+
+    timer_init(&timer);
+    for (i = 0; i < domain.ncells; i++) {
+        calc_root_fractions(veg_con[i], &(soil_con[i]));
+
+        generate_default_state(&(all_vars[i]), &(soil_con[i]), veg_con[i]);
+        compute_derived_state_vars(&(all_vars[i]), &(soil_con[i]),
+                                   veg_con[i]);
+
+        initialize_save_data(&(all_vars[i]), &(force[i]), &(soil_con[i]),
+                             veg_con[i], veg_lib, &lake_con, out_data[i],
+                             &(save_data[i]), &timer);
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/******************************************************************************
+ * @brief    Run function for the Python driver
+ * @details  Runs nsteps model steps, with the forcing of the first nsteps
+ *           steps of the forcing window. out_data holds the output of the
+ *           last step. Returns EXIT_FAILURE if vic_run failed in a cell or
+ *           the steps do not fit the forcing window or simulation period,
+ *           so that the caller can handle the error.
+ *****************************************************************************/
+int
+vic_python_run(size_t nsteps)
+{
+    extern all_vars_struct     *all_vars;
+    extern size_t               current;
+    extern python_domain_struct domain;
+    extern dmy_struct          *dmy;
+    extern force_data_struct   *force;
+    extern global_param_struct  global_param;
+    extern lake_con_struct      lake_con;
+    extern double            ***out_data;
+    extern save_data_struct    *save_data;
+    extern soil_con_struct     *soil_con;
+    extern veg_con_struct     **veg_con;
+    extern veg_hist_struct    **veg_hist;
+    extern veg_lib_struct      *veg_lib;
+
+    char                        dmy_str[256];   // sprint_dmy output
+    size_t                      step;
+    size_t                      i;
+    int                         ErrorFlag;
+    timer_struct                timer;
+
+    if (nsteps > domain.nwindow) {
+        log_warn("%zu steps do not fit the forcing window of %zu steps.",
+                 nsteps, domain.nwindow);
+        return EXIT_FAILURE;
+    }
+    if (current + nsteps > global_param.nrecs) {
+        log_warn("%zu steps run past the end of the simulation period "
+                 "(step %zu of %zu).", nsteps, current, global_param.nrecs);
+        return EXIT_FAILURE;
+    }
+
+    for (step = 0; step < nsteps; step++) {
+        vic_python_force(step);
+
+        sprint_dmy(dmy_str, &(dmy[current]));
+        debug("Running timestep %zu: %s", current, dmy_str);
+
+        for (i = 0; i < domain.ncells; i++) {
+            // Set global reference string (for debugging inside vic_run)
+            snprintf(vic_run_ref_str, MAXSTRING,
+                     "Gridcell: %zu, timestep info: %s", i, dmy_str);
+
+            update_step_vars(&(all_vars[i]), veg_con[i], veg_hist[i]);
+
+            timer_start(&timer);
+            ErrorFlag = vic_run(&(force[i]), &(all_vars[i]), &(dmy[current]),
+                                &global_param, &lake_con, &(soil_con[i]),
+                                veg_con[i], veg_lib);
+            timer_stop(&timer);
+            if (ErrorFlag == ERROR) {
+                log_warn("vic_run failed in cell %zu at %s.", i, dmy_str);
+                return EXIT_FAILURE;
+            }
+
+            put_data(&(all_vars[i]), &(force[i]), &(soil_con[i]), veg_con[i],
+                     veg_lib, &lake_con, out_data[i], &(save_data[i]),
+                     &timer);
+        }
+
+        current++;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/******************************************************************************
+ * @brief    Finalize function for the Python driver
+ *****************************************************************************/
+int
+vic_python_final(void)
+{
+    // clean up
+    vic_python_finalize();
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,100 @@
+/******************************************************************************
+ * @section DESCRIPTION
+ *
+ * In-memory snapshots of the model state of the domain run by the Python
+ * driver.
+ *
+ * @section LICENSE
+ *
+ * The Variable Infiltration Capacity (VIC) macroscale hydrological model
+ * Copyright (C) 2016 The Computational Hydrology Group, Department of Civil
+ * and Environmental Engineering, University of Washington.
+ *
+ * The VIC model is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *****************************************************************************/
+
+#include <vic_driver_python.h>
+
+/******************************************************************************
+ * @brief    Copy the time step index, the states and fluxes and the water
+ *           balance storages of the domain into a contiguous memory buffer.
+ * @details  The buffer of an earlier snapshot is reused.
+ *****************************************************************************/
+void
+vic_python_snapshot(snapshot_struct *snapshot)
+{
+    extern size_t               current;
+    extern python_domain_struct domain;
+    extern all_vars_struct     *all_vars;
+    extern save_data_struct    *save_data;
+
+    size_t                      i;
+    size_t                      nbytes;
+    char                       *pos;
+
+    nbytes = sizeof(current);
+    for (i = 0; i < domain.ncells; i++) {
+        nbytes += sizeof_all_vars(domain.nveg[i]) + sizeof(save_data[i]);
+    }
+    if (snapshot->data == NULL || snapshot->nbytes != nbytes) {
+        free(snapshot->data);
+        snapshot->data = malloc(nbytes);
+        check_alloc_status(snapshot->data, "Memory allocation error.");
+        snapshot->nbytes = nbytes;
+    }
+
+    pos = snapshot->data;
+    pack_data(&pos, &current, sizeof(current));
+    for (i = 0; i < domain.ncells; i++) {
+        pack_all_vars(&pos, &(all_vars[i]), domain.nveg[i]);
+        pack_data(&pos, &(save_data[i]), sizeof(save_data[i]));
+    }
+}
+
+/******************************************************************************
+ * @brief    Restore the model state of the domain from a snapshot taken with
+ *           vic_python_snapshot.
+ * @return   EXIT_FAILURE if the snapshot was taken from another domain
+ *****************************************************************************/
+int
+vic_python_restore_snapshot(snapshot_struct *snapshot)
+{
+    extern size_t               current;
+    extern python_domain_struct domain;
+    extern all_vars_struct     *all_vars;
+    extern save_data_struct    *save_data;
+
+    size_t                      i;
+    size_t                      nbytes;
+    char                       *pos;
+
+    nbytes = sizeof(current);
+    for (i = 0; i < domain.ncells; i++) {
+        nbytes += sizeof_all_vars(domain.nveg[i]) + sizeof(save_data[i]);
+    }
+    if (snapshot->data == NULL || snapshot->nbytes != nbytes) {
+        log_warn("The snapshot does not match the domain.");
+        return EXIT_FAILURE;
+    }
+
+    pos = snapshot->data;
+    unpack_data(&pos, &current, sizeof(current));
+    for (i = 0; i < domain.ncells; i++) {
+        unpack_all_vars(&pos, &(all_vars[i]), domain.nveg[i]);
+        unpack_data(&pos, &(save_data[i]), sizeof(save_data[i]));
+    }
+
+    return EXIT_SUCCESS;
+}
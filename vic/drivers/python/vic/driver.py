@@ -1,7 +1,8 @@
 """
   @section DESCRIPTION
 
-  Python driver for VIC
+  Python driver for VIC: allocate a domain, run it step by step and access
+  its parameters, forcing, state and output as NumPy views of the C buffers.
 
   @section LICENSE
 
@@ -24,16 +25,175 @@
   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 """
 
-from .vic import lib
+import os
+
+import numpy as np
+
+from .vic import ffi, lib
+
+# NumPy types of the C types of structure members
+_dtypes = {'double': np.float64,
+           'float': np.float32,
+           'int': np.intc,
+           'unsigned int': np.uintc,
+           'short': np.short,
+           'unsigned short': np.ushort,
+           'size_t': np.uintp,
+           'char': np.byte,
+           '_Bool': np.bool_}
+
+
+def _array(ptr, n):
+    '''View of the n elements starting at the C pointer ptr'''
+    ctype = ffi.typeof(ptr).item
+    buf = ffi.buffer(ptr, n * ffi.sizeof(ctype))
+    return np.frombuffer(buf, dtype=_dtypes[ctype.cname])
+
+
+def _member_view(ptr, n, name):
+    '''View of a numeric member of the n structures starting at ptr.
+
+    Members of nested structures are named with dots, e.g. 'layer.moist'.
+    Array members add their dimensions to the view.
+    '''
+    ctype = ffi.typeof(ptr).item
+    buf = ffi.buffer(ptr, n * ffi.sizeof(ctype))
+    shape = [n]
+    strides = [ffi.sizeof(ctype)]
+    offset = 0
+    for member in name.split('.'):
+        if ctype.kind != 'struct':
+            raise TypeError('{0} is not a structure'.format(ctype.cname))
+        fields = dict(ctype.fields)
+        if member not in fields:
+            raise KeyError('{0} has no member {1}'.format(ctype.cname,
+                                                          member))
+        offset += fields[member].offset
+        ctype = fields[member].type
+        while ctype.kind == 'array':
+            shape.append(ctype.length)
+            ctype = ctype.item
+            strides.append(ffi.sizeof(ctype))
+    if ctype.kind != 'primitive' or ctype.cname not in _dtypes:
+        raise TypeError('{0} is not a numeric member'.format(name))
+    return np.ndarray(shape, dtype=_dtypes[ctype.cname], buffer=buf,
+                      offset=offset, strides=strides)
+
+
+def _check(status, what):
+    if status != 0:
+        raise RuntimeError('{0} failed, see the VIC log'.format(what))
+
+
+def vic_alloc(nveg, nwindow=1):
+    '''Allocate a domain of len(nveg) grid cells.
+
+    nveg[i] is the number of vegetation tiles of cell i, without the bare
+    soil tile that is added as the last tile. The forcing buffers hold
+    nwindow model steps. The options, global parameters and model
+    parameters must be set through lib before the domain is allocated.
+    '''
+    nveg = ffi.new('size_t[]', [int(n) for n in nveg])
+    _check(lib.vic_python_alloc(len(nveg), nveg, nwindow), 'vic_alloc')
 
 
 def vic_init():
-    pass
+    '''Initialize the domain once its parameters have been set.'''
+    _check(lib.vic_python_init(), 'vic_init')
 
 
-def vic_run():
-    pass
+def vic_run(nsteps=1):
+    '''Run the domain for nsteps model steps.
+
+    The forcing of step k is read from forcing(name)[k]. The GIL is released
+    while the C time loop runs.
+    '''
+    _check(lib.vic_python_run(nsteps), 'vic_run')
 
 
 def vic_final():
-    pass
+    '''Free the domain.'''
+    lib.vic_python_final()
+
+
+def snapshot(snap=None):
+    '''Copy the model state of the domain into memory.
+
+    The state can be restored with restore(). The buffer of snap, an earlier
+    snapshot of the same domain, is reused if it is given.
+    '''
+    if snap is None:
+        snap = ffi.gc(ffi.new('snapshot_struct *'), lib.free_snapshot)
+    lib.vic_python_snapshot(snap)
+    return snap
+
+
+def restore(snap):
+    '''Restore the model state, including the time step, from a snapshot.'''
+    _check(lib.vic_python_restore_snapshot(snap), 'restore')
+
+
+def fork(nmembers):
+    '''Fork the process into nmembers processes that share the initialized
+    domain copy-on-write.
+
+    Returns (member, pids): the member index of this process (0 in the
+    parent) and, in the parent, the process ids of the other members.
+    '''
+    pids = []
+    for member in range(1, nmembers):
+        pid = os.fork()
+        if pid == 0:
+            return member, []
+        pids.append(pid)
+    return 0, pids
+
+
+def forcing(name):
+    '''Forcing window of a force_data_struct member, e.g. 'air_temp'.
+
+    Returns a [nwindow, ncells, NF] view. Pressure and vapor pressure are in
+    Pa. vpd, density and snowflag are computed from the other members.
+    '''
+    ptr = getattr(lib.force_window, name)
+    if ptr == ffi.NULL:
+        raise ValueError('forcing {0} is not used by the current '
+                         'options'.format(name))
+    shape = (lib.domain.nwindow, lib.domain.ncells, lib.NR + 1)
+    return _array(ptr, np.prod(shape)).reshape(shape)[:, :, :lib.NF]
+
+
+def out_data(name):
+    '''Output of the last step of an output variable, e.g. 'OUT_RUNOFF'.
+
+    Returns a [ncells, nelem] view.
+    '''
+    varid = getattr(lib, name)
+    nelem = lib.out_metadata[varid].nelem
+    return _array(lib.out_data[0][varid],
+                  lib.domain.ncells * nelem).reshape(lib.domain.ncells, nelem)
+
+
+def soil_con(name):
+    '''[ncells, ...] view of a soil_con_struct member, e.g. 'depth'.'''
+    return _member_view(lib.soil_con, lib.domain.ncells, name)
+
+
+def veg_con(cell, name):
+    '''[nveg + 1, ...] view of a veg_con_struct member of a cell.'''
+    return _member_view(lib.veg_con[cell], lib.domain.nveg[cell] + 1, name)
+
+
+def veg_lib(name):
+    '''[NVEGTYPES, ...] view of a veg_lib_struct member, e.g. 'rmin'.'''
+    return _member_view(lib.veg_lib, lib.options.NVEGTYPES, name)
+
+
+def state(cell, veg, group, name):
+    '''[SNOW_BAND, ...] view of a state variable of a vegetation tile.
+
+    group is one of 'cell', 'snow', 'energy' or 'veg_var' and name a member
+    of the corresponding structure, e.g. state(0, 1, 'cell', 'layer.moist').
+    '''
+    tiles = getattr(lib.all_vars[cell], group)
+    return _member_view(tiles[veg], lib.options.SNOW_BAND, name)
@@ -42,6 +42,9 @@
 #define OUT_MULT_DEFAULT 0  // Why is this not 1?
 #define OUT_ASCII_FORMAT_DEFAULT "%.4f"
 
+// Number of markers of the P-square quantile estimator
+#define P2_NMARKERS 5
+
 // Default snow band setting
 #define SNOW_BAND_TRUE_BUT_UNSET 99999
 
@@ -59,6 +62,38 @@ enum
     NETCDF4
 };
 
+/******************************************************************************
+ * @brief   Quantization of floating point output (netCDF-4 only)
+ *****************************************************************************/
+enum
+{
+    QUANTIZE_NONE,
+    QUANTIZE_BITGROOM,
+    QUANTIZE_GRANULARBR,
+    QUANTIZE_BITROUND
+};
+
+/******************************************************************************
+ * @brief   Spatial subset of an output stream
+ *****************************************************************************/
+enum
+{
+    SUBSET_NONE,
+    SUBSET_BBOX,
+    SUBSET_MASK,
+    SUBSET_CELLS
+};
+
+/******************************************************************************
+ * @brief   Spatial reduction of an output stream over regions
+ *****************************************************************************/
+enum
+{
+    REGION_NONE,
+    REGION_MEAN,
+    REGION_SUM
+};
+
 /******************************************************************************
  * @brief   endian flags
  *****************************************************************************/
@@ -282,6 +317,8 @@ enum
     // Timing and Profiling Terms
     OUT_TIME_VICRUN_WALL, /**< Wall time spent inside vic_run [seconds] */
     OUT_TIME_VICRUN_CPU,  /**< Wall time spent inside vic_run [seconds] */
+    OUT_RUNOFF_STEPS,     /**< number of runoff sub-steps, averaged over the
+                             tiles [-] */
     // Last value of enum - DO NOT ADD ANYTHING BELOW THIS LINE!!
     // used as a loop counter and must be >= the largest value in this enum
     N_OUTVAR_TYPES        /**< used as a loop counter*/
@@ -379,13 +416,20 @@ enum
  *****************************************************************************/
 enum
 {
-    AGG_TYPE_DEFAULT, /**< Default aggregation type */
-    AGG_TYPE_AVG,     /**< average over agg interval */
-    AGG_TYPE_BEG,     /**< value at beginning of agg interval */
-    AGG_TYPE_END,     /**< value at end of agg interval */
-    AGG_TYPE_MAX,     /**< maximum value over agg interval */
-    AGG_TYPE_MIN,     /**< minimum value over agg interval */
-    AGG_TYPE_SUM      /**< sum over agg interval */
+    AGG_TYPE_DEFAULT,  /**< Default aggregation type */
+    AGG_TYPE_AVG,      /**< average over agg interval */
+    AGG_TYPE_BEG,      /**< value at beginning of agg interval */
+    AGG_TYPE_END,      /**< value at end of agg interval */
+    AGG_TYPE_MAX,      /**< maximum value over agg interval */
+    AGG_TYPE_MIN,      /**< minimum value over agg interval */
+    AGG_TYPE_SUM,      /**< sum over agg interval */
+    AGG_TYPE_VAR,      /**< sample variance over agg interval */
+    AGG_TYPE_STDEV,    /**< sample standard deviation over agg interval */
+    AGG_TYPE_QUANTILE, /**< estimate of a quantile over agg interval */
+    AGG_TYPE_HIST,     /**< fraction of agg interval in each of a set of
+                            fixed bins */
+    AGG_TYPE_CLIM_MON, /**< mean of each calendar month over agg interval */
+    AGG_TYPE_CLIM_DOY  /**< mean of each day of the year over agg interval */
 };
 
 /******************************************************************************
@@ -494,18 +538,54 @@ typedef struct {
     bool is_subdaily;    /**< flag denoting if alarm will be raised more than once per day */
 } alarm_struct;
 
+/******************************************************************************
+ * @brief   This structure stores the parameters of the aggregation of one
+ *          output variable.
+ *****************************************************************************/
+typedef struct {
+    double quantile;  /**< quantile to estimate (AGG_TYPE_QUANTILE) */
+    double lower;     /**< lower edge of the first bin (AGG_TYPE_HIST) */
+    double upper;     /**< upper edge of the last bin (AGG_TYPE_HIST) */
+    size_t nbins;     /**< number of values written for each element */
+    size_t nacc;      /**< number of accumulators of each element in
+                           aggdata */
+} agg_param_struct;
+
 /******************************************************************************
  * @brief   This structure stores output information for one output stream.
  *****************************************************************************/
 typedef struct {
     size_t nvars;                    /**< number of variables to store in the file */
     size_t ngridcells;               /**< number of grid cells in aggdata */
+    size_t *cell_idx;                /**< index into out_data of each grid
+                                          cell in aggdata; NULL if aggdata
+                                          holds all cells in order */
+    unsigned short int subset;       /**< spatial subset of the stream */
+    double subset_bounds[4];         /**< south, north, west and east bounds
+                                          of SUBSET_BBOX */
+    char subset_file[MAXSTRING];     /**< mask (SUBSET_MASK) or cell list
+                                          (SUBSET_CELLS) file */
+    char subset_var[MAXSTRING];      /**< mask variable (SUBSET_MASK) */
+    unsigned short int region;       /**< area weighted reduction of the
+                                          stream over regions */
+    char region_file[MAXSTRING];     /**< file with the region ids */
+    char region_var[MAXSTRING];      /**< region id variable */
     dmy_struct time_bounds[2];       /**< timestep bounds of stream */
     char prefix[MAXSTRING];          /**< prefix of the file name, e.g. "fluxes" */
     char filename[MAXSTRING];        /**< complete file name */
     FILE *fh;                        /**< filehandle */
     unsigned short int file_format;  /**< output file format */
     short int compress;              /**< Compress output files in stream*/
+    bool shuffle;                    /**< shuffle before deflate (netCDF-4) */
+    size_t chunksizes[3];            /**< chunk lengths along time, y and x
+                                          (netCDF-4); 0 = library default */
+    unsigned short int quantize;     /**< quantization of floating point
+                                          variables (netCDF-4) */
+    int quantize_nsd;                /**< significant digits (BITGROOM,
+                                          GRANULARBR) or bits (BITROUND)
+                                          to keep */
+    bool gathered;                   /**< store only the active cells along a
+                                          single cell dimension (netCDF) */
     unsigned short int *type;        /**< type, when written to a binary file;
                                           OUT_TYPE_USINT  = unsigned short int
                                           OUT_TYPE_SINT   = short int
@@ -518,7 +598,8 @@ typedef struct {
                                           The order of the id numbers in the varid array
                                           is the order in which the variables will be written. */
     unsigned short int *aggtype;     /**< type of aggregation to use [shape=(nvars, )] */
-    double ****aggdata;              /**< array of aggregated data values [shape=(ngridcells, nvars, nelem, nbins)] */
+    agg_param_struct *aggparam;      /**< parameters of the aggregation [shape=(nvars, )] */
+    double ****aggdata;              /**< array of aggregated data values [shape=(ngridcells, nvars, nelem, nacc)] */
     alarm_struct agg_alarm;          /**< alaram for stream aggregation */
     alarm_struct write_alarm;        /**< alaram for controlling stream write */
 } stream_struct;
@@ -576,9 +657,27 @@ typedef struct {
     double delta_cpu;
 } timer_struct;
 
+/******************************************************************************
+ * @brief   This structure holds an in-memory copy of the prognostic state of
+ *          a process, see pack_all_vars and pack_stream_state.
+ *****************************************************************************/
+typedef struct {
+    size_t nbytes;    /**< size of data in bytes */
+    char *data;       /**< packed model state */
+} snapshot_struct;
+
 double air_density(double t, double p);
+void agg_clim(double *acc, size_t nbins, size_t bin, double value);
+void agg_clim_final(double *acc, size_t nbins);
+void agg_hist(double *acc, agg_param_struct *param, double value);
+void agg_hist_final(double *acc, size_t nbins, unsigned int count);
+void agg_quantile(double *acc, double quantile, unsigned int count,
+                  double value);
+void agg_quantile_final(double *acc, double quantile, unsigned int count);
 void agg_stream_data(stream_struct *stream, dmy_struct *dmy_current,
                      double ***out_data);
+void agg_variance(double *acc, unsigned int count, double value);
+void agg_variance_final(double *acc, unsigned int count);
 double all_30_day_from_dmy(dmy_struct *dmy);
 double all_leap_from_dmy(dmy_struct *dmy);
 void alloc_aggdata(stream_struct *stream);
@@ -588,6 +687,7 @@ double calc_energy_balance_error(double, double, double, double, double);
 void calc_root_fractions(veg_con_struct *veg_con, soil_con_struct *soil_con);
 double calc_water_balance_error(double, double, double, double);
 bool cell_method_from_agg_type(unsigned short int aggtype, char cell_method[]);
+bool check_spinup_convergence(double **out_data, double *storage);
 bool check_write_flag(int rec);
 void collect_eb_terms(energy_bal_struct, snow_data_struct, cell_data_struct,
                       double, double, double, bool, bool, double, bool, int,
@@ -601,6 +701,8 @@ void compute_lake_params(lake_con_struct *, soil_con_struct);
 void compute_treeline(force_data_struct *, dmy_struct *, double, double *,
                       bool *);
 size_t count_force_vars(FILE *gp);
+void copy_all_vars(all_vars_struct *dest, all_vars_struct *src, size_t nveg);
+void copy_veg_var(veg_var_struct *dest, const void *src);
 void count_nstreams_nvars(FILE *gp, size_t *nstreams, size_t nvars[]);
 void cmd_proc(int argc, char **argv, char *globalfilename);
 void compress_files(char string[], short int level);
@@ -623,6 +725,7 @@ double fractional_day_from_dmy(dmy_struct *dmy);
 void free_all_vars(all_vars_struct *all_vars, int Nveg);
 void free_dmy(dmy_struct **dmy);
 void free_out_data(size_t ngridcells, double ***out_data);
+void free_snapshot(snapshot_struct *snapshot);
 void free_streams(stream_struct **streams);
 void free_vegcon(veg_con_struct **veg_con);
 void generate_default_state(all_vars_struct *, soil_con_struct *,
@@ -630,7 +733,9 @@ void generate_default_state(all_vars_struct *, soil_con_struct *,
 void generate_default_lake_state(all_vars_struct *, soil_con_struct *,
                                  lake_con_struct);
 void get_default_nstreams_nvars(size_t *nstreams, size_t nvars[]);
+double get_dist(double lat1, double long1, double lat2, double long2);
 void get_parameters(FILE *paramfile);
+size_t get_spinup_nstorage(void);
 void init_output_list(double **out_data, int write, char *format, int type,
                       double mult);
 void initialize_energy(energy_bal_struct **energy, size_t nveg);
@@ -660,6 +765,9 @@ double no_leap_day_from_dmy(dmy_struct *dmy);
 void num2date(double origin, double time_value, double tzoffset,
               unsigned short int calendar, unsigned short int time_units,
               dmy_struct *date);
+void pack_all_vars(char **pos, all_vars_struct *all_vars, size_t nveg);
+void pack_data(char **pos, void *src, size_t nbytes);
+void pack_stream_state(char **pos, stream_struct *stream);
 FILE *open_file(char string[], char type[]);
 void parse_nc_time_units(char *nc_unit_chars, unsigned short int *units,
                          dmy_struct *dmy);
@@ -705,13 +813,19 @@ void set_output_var(stream_struct *stream, char *varname, size_t varnum,
 unsigned int get_default_outvar_aggtype(unsigned int varid);
 void set_alarm(dmy_struct *dmy_current, unsigned int freq, void *value,
                alarm_struct *alarm);
+void set_output_agg_param(stream_struct *stream, size_t varnum,
+                          double *values, size_t nvalues);
 void set_output_defaults(stream_struct **output_streams,
                          dmy_struct     *dmy_current,
                          unsigned short  default_file_format);
 void set_output_met_data_info();
 void setup_stream(stream_struct *stream, size_t nvars, size_t ngridcells);
+size_t sizeof_all_vars(size_t nveg);
+size_t sizeof_stream_state(stream_struct *stream);
 void soil_moisture_from_water_table(soil_con_struct *soil_con, size_t nlayers);
 void sprint_dmy(char *str, dmy_struct *dmy);
+void sprint_outvar_name(char *str, unsigned int varid, size_t elem_idx,
+                        size_t bin_idx, size_t nbins);
 void str_from_calendar(unsigned short int calendar, char *calendar_str);
 void str_from_time_units(unsigned short int time_units, char *unit_str);
 unsigned short int str_to_agg_type(char aggstr[]);
@@ -728,6 +842,10 @@ void timer_continue(timer_struct *t);
 void timer_init(timer_struct *t);
 void timer_start(timer_struct *t);
 void timer_stop(timer_struct *t);
+void unpack_all_vars(char **pos, all_vars_struct *all_vars, size_t nveg);
+void unpack_data(char **pos, void *dest, size_t nbytes);
+void unpack_stream_state(char **pos, stream_struct *stream);
+bool update_spinup_storage(double value, double tol, double *storage);
 int update_step_vars(all_vars_struct *, veg_con_struct *, veg_hist_struct *);
 int invalid_date(unsigned short int calendar, dmy_struct *dmy);
 void validate_parameters(void);
@@ -43,6 +43,8 @@ agg_stream_data(stream_struct *stream,
     size_t                 nelem;
     unsigned int           varid;
     bool                   alarm_now;
+    double               **cell_data;
+    agg_param_struct      *param;
 
     alarm = &(stream->agg_alarm);
     alarm->count++;
@@ -57,50 +59,355 @@ agg_stream_data(stream_struct *stream,
     }
 
     for (i = 0; i < stream->ngridcells; i++) {
+        // spatially subset streams only hold the selected cells
+        if (stream->cell_idx != NULL) {
+            cell_data = out_data[stream->cell_idx[i]];
+        }
+        else {
+            cell_data = out_data[i];
+        }
         for (j = 0; j < stream->nvars; j++) {
             varid = stream->varid[j];
             nelem = out_metadata[varid].nelem;
+            param = &(stream->aggparam[j]);
 
             // Instantaneous at the beginning of the period
             if ((stream->aggtype[j] == AGG_TYPE_END) && (alarm_now)) {
                 for (k = 0; k < nelem; k++) {
-                    stream->aggdata[i][j][k][0] = out_data[i][varid][k];
+                    stream->aggdata[i][j][k][0] = cell_data[varid][k];
                 }
             }
             // Instantaneous at the end of the period
             else if ((stream->aggtype[j] == AGG_TYPE_BEG) &&
                      (alarm->count == 1)) {
                 for (k = 0; k < nelem; k++) {
-                    stream->aggdata[i][j][k][0] = out_data[i][varid][k];
+                    stream->aggdata[i][j][k][0] = cell_data[varid][k];
                 }
             }
             // Sum over the period
             else if ((stream->aggtype[j] == AGG_TYPE_SUM) ||
                      (stream->aggtype[j] == AGG_TYPE_AVG)) {
                 for (k = 0; k < nelem; k++) {
-                    stream->aggdata[i][j][k][0] += out_data[i][varid][k];
+                    stream->aggdata[i][j][k][0] += cell_data[varid][k];
                 }
             }
             // Maximum over the period
             else if (stream->aggtype[j] == AGG_TYPE_MAX) {
                 for (k = 0; k < nelem; k++) {
                     stream->aggdata[i][j][k][0] =
-                        max(stream->aggdata[i][j][k][0], out_data[i][varid][k]);
+                        max(stream->aggdata[i][j][k][0], cell_data[varid][k]);
                 }
             }
             // Minimum over the period
             else if (stream->aggtype[j] == AGG_TYPE_MIN) {
                 for (k = 0; k < nelem; k++) {
                     stream->aggdata[i][j][k][0] =
-                        min(stream->aggdata[i][j][k][0], out_data[i][varid][k]);
+                        min(stream->aggdata[i][j][k][0], cell_data[varid][k]);
+                }
+            }
+            // Running mean and sum of squared deviations over the period
+            else if ((stream->aggtype[j] == AGG_TYPE_VAR) ||
+                     (stream->aggtype[j] == AGG_TYPE_STDEV)) {
+                for (k = 0; k < nelem; k++) {
+                    agg_variance(stream->aggdata[i][j][k], alarm->count,
+                                 cell_data[varid][k]);
+                }
+            }
+            // Quantile estimate over the period
+            else if (stream->aggtype[j] == AGG_TYPE_QUANTILE) {
+                for (k = 0; k < nelem; k++) {
+                    agg_quantile(stream->aggdata[i][j][k], param->quantile,
+                                 alarm->count, cell_data[varid][k]);
                 }
             }
+            // Histogram over the period
+            else if (stream->aggtype[j] == AGG_TYPE_HIST) {
+                for (k = 0; k < nelem; k++) {
+                    agg_hist(stream->aggdata[i][j][k], param,
+                             cell_data[varid][k]);
+                }
+            }
+            // Climatology of calendar months over the period
+            else if (stream->aggtype[j] == AGG_TYPE_CLIM_MON) {
+                for (k = 0; k < nelem; k++) {
+                    agg_clim(stream->aggdata[i][j][k], param->nbins,
+                             dmy_current->month - 1, cell_data[varid][k]);
+                }
+            }
+            // Climatology of days of the year over the period
+            else if (stream->aggtype[j] == AGG_TYPE_CLIM_DOY) {
+                for (k = 0; k < nelem; k++) {
+                    agg_clim(stream->aggdata[i][j][k], param->nbins,
+                             dmy_current->day_in_year - 1,
+                             cell_data[varid][k]);
+                }
+            }
+
+            if (!alarm_now) {
+                continue;
+            }
             // Average over the period if counter is full
-            if ((stream->aggtype[j] == AGG_TYPE_AVG) && (alarm_now)) {
+            if (stream->aggtype[j] == AGG_TYPE_AVG) {
                 for (k = 0; k < nelem; k++) {
                     stream->aggdata[i][j][k][0] /= (double) alarm->count;
                 }
             }
+            // Statistics of the period if counter is full
+            else if ((stream->aggtype[j] == AGG_TYPE_VAR) ||
+                     (stream->aggtype[j] == AGG_TYPE_STDEV)) {
+                for (k = 0; k < nelem; k++) {
+                    agg_variance_final(stream->aggdata[i][j][k],
+                                       alarm->count);
+                    if (stream->aggtype[j] == AGG_TYPE_STDEV) {
+                        stream->aggdata[i][j][k][0] =
+                            sqrt(stream->aggdata[i][j][k][0]);
+                    }
+                }
+            }
+            else if (stream->aggtype[j] == AGG_TYPE_QUANTILE) {
+                for (k = 0; k < nelem; k++) {
+                    agg_quantile_final(stream->aggdata[i][j][k],
+                                       param->quantile, alarm->count);
+                }
+            }
+            else if (stream->aggtype[j] == AGG_TYPE_HIST) {
+                for (k = 0; k < nelem; k++) {
+                    agg_hist_final(stream->aggdata[i][j][k], param->nbins,
+                                   alarm->count);
+                }
+            }
+            else if ((stream->aggtype[j] == AGG_TYPE_CLIM_MON) ||
+                     (stream->aggtype[j] == AGG_TYPE_CLIM_DOY)) {
+                for (k = 0; k < nelem; k++) {
+                    agg_clim_final(stream->aggdata[i][j][k], param->nbins);
+                }
+            }
+        }
+    }
+}
+
+/******************************************************************************
+ * @brief    Add a value to the running mean and sum of squared deviations
+ *           from the mean (Welford's algorithm).
+ * @details  acc[0] holds the mean and acc[1] the sum of squared deviations
+ *           of the count values of the period so far.
+ *****************************************************************************/
+void
+agg_variance(double      *acc,
+             unsigned int count,
+             double       value)
+{
+    double delta;
+
+    delta = value - acc[0];
+    acc[0] += delta / (double) count;
+    acc[1] += delta * (value - acc[0]);
+}
+
+/******************************************************************************
+ * @brief    Replace the running sums of agg_variance by the sample variance.
+ *****************************************************************************/
+void
+agg_variance_final(double      *acc,
+                   unsigned int count)
+{
+    if (count > 1) {
+        acc[0] = acc[1] / (double) (count - 1);
+    }
+    else {
+        acc[0] = 0.;
+    }
+}
+
+/******************************************************************************
+ * @brief    Add a value to the P-square estimate of a quantile.
+ * @details  Jain, R. and I. Chlamtac (1985), The P2 algorithm for dynamic
+ *           calculation of quantiles and histograms without storing
+ *           observations, Commun. ACM, 28(10), 1076-1085.
+ *
+ *           acc[0:P2_NMARKERS] holds the marker heights and
+ *           acc[P2_NMARKERS:2 * P2_NMARKERS] their (one-based) positions.
+ *           The first P2_NMARKERS values of the period are kept in sorted
+ *           order.
+ *****************************************************************************/
+void
+agg_quantile(double      *acc,
+             double       quantile,
+             unsigned int count,
+             double       value)
+{
+    double *q = acc;
+    double *n = acc + P2_NMARKERS;
+    double  dn[P2_NMARKERS];
+    double  d;
+    double  ds;
+    double  qp;
+    size_t  i;
+    size_t  k;
+
+    // keep the first values in sorted order
+    if (count <= P2_NMARKERS) {
+        for (i = count - 1; i > 0 && q[i - 1] > value; i--) {
+            q[i] = q[i - 1];
+        }
+        q[i] = value;
+        if (count == P2_NMARKERS) {
+            for (i = 0; i < P2_NMARKERS; i++) {
+                n[i] = (double) (i + 1);
+            }
+        }
+        return;
+    }
+
+    // find the cell of the value and adjust the extreme markers
+    if (value < q[0]) {
+        q[0] = value;
+        k = 0;
+    }
+    else if (value >= q[P2_NMARKERS - 1]) {
+        q[P2_NMARKERS - 1] = value;
+        k = P2_NMARKERS - 2;
+    }
+    else {
+        for (k = 0; value >= q[k + 1]; k++) {
+            ;
+        }
+    }
+    for (i = k + 1; i < P2_NMARKERS; i++) {
+        n[i] += 1.;
+    }
+
+    // desired marker positions
+    dn[0] = 0.;
+    dn[1] = quantile / 2.;
+    dn[2] = quantile;
+    dn[3] = (1. + quantile) / 2.;
+    dn[4] = 1.;
+
+    // adjust the heights of the middle markers if necessary
+    for (i = 1; i < P2_NMARKERS - 1; i++) {
+        d = 1. + (double) (count - 1) * dn[i] - n[i];
+        if ((d >= 1. && n[i + 1] - n[i] > 1.) ||
+            (d <= -1. && n[i - 1] - n[i] < -1.)) {
+            ds = (d > 0.) ? 1. : -1.;
+            // piecewise parabolic prediction
+            qp = q[i] + ds / (n[i + 1] - n[i - 1]) *
+                 ((n[i] - n[i - 1] + ds) * (q[i + 1] - q[i]) /
+                  (n[i + 1] - n[i]) +
+                  (n[i + 1] - n[i] - ds) * (q[i] - q[i - 1]) /
+                  (n[i] - n[i - 1]));
+            if (q[i - 1] < qp && qp < q[i + 1]) {
+                q[i] = qp;
+            }
+            // linear prediction
+            else if (ds > 0.) {
+                q[i] += (q[i + 1] - q[i]) / (n[i + 1] - n[i]);
+            }
+            else {
+                q[i] -= (q[i - 1] - q[i]) / (n[i - 1] - n[i]);
+            }
+            n[i] += ds;
+        }
+    }
+}
+
+/******************************************************************************
+ * @brief    Replace the markers of agg_quantile by the quantile estimate.
+ * @details  As long as all values of the period are stored, the quantile is
+ *           interpolated between them.
+ *****************************************************************************/
+void
+agg_quantile_final(double      *acc,
+                   double       quantile,
+                   unsigned int count)
+{
+    double pos;
+    size_t i;
+
+    if (count > P2_NMARKERS) {
+        acc[0] = acc[2];
+    }
+    else if (count > 1) {
+        pos = quantile * (double) (count - 1);
+        i = min((size_t) pos, (size_t) count - 2);
+        acc[0] = acc[i] + (pos - (double) i) * (acc[i + 1] - acc[i]);
+    }
+}
+
+/******************************************************************************
+ * @brief    Count a value in a histogram with fixed bins.
+ * @details  acc[0:nbins] holds the count of each bin. Values below the first
+ *           bin and above the last bin are counted in the first and last bin.
+ *****************************************************************************/
+void
+agg_hist(double           *acc,
+         agg_param_struct *param,
+         double            value)
+{
+    double x;
+    size_t bin;
+
+    x = (value - param->lower) / (param->upper - param->lower) *
+        (double) param->nbins;
+    if (!(x > 0.)) {
+        bin = 0;
+    }
+    else if (x >= (double) param->nbins) {
+        bin = param->nbins - 1;
+    }
+    else {
+        bin = (size_t) x;
+    }
+    acc[bin] += 1.;
+}
+
+/******************************************************************************
+ * @brief    Replace the counts of agg_hist by the fraction of the period in
+ *           each bin.
+ *****************************************************************************/
+void
+agg_hist_final(double      *acc,
+               size_t       nbins,
+               unsigned int count)
+{
+    size_t i;
+
+    for (i = 0; i < nbins; i++) {
+        acc[i] /= (double) count;
+    }
+}
+
+/******************************************************************************
+ * @brief    Add a value to the sum of a climatology bin (e.g. the month).
+ * @details  acc[0:nbins] holds the sum and acc[nbins:2 * nbins] the number of
+ *           values of each bin.
+ *****************************************************************************/
+void
+agg_clim(double *acc,
+         size_t  nbins,
+         size_t  bin,
+         double  value)
+{
+    acc[bin] += value;
+    acc[nbins + bin] += 1.;
+}
+
+/******************************************************************************
+ * @brief    Replace the sums of agg_clim by the mean of each bin. Bins
+ *           without values are set to MISSING.
+ *****************************************************************************/
+void
+agg_clim_final(double *acc,
+               size_t  nbins)
+{
+    size_t i;
+
+    for (i = 0; i < nbins; i++) {
+        if (acc[nbins + i] > 0.) {
+            acc[i] /= acc[nbins + i];
+        }
+        else {
+            acc[i] = MISSING;
         }
     }
 }
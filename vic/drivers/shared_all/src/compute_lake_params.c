@@ -78,15 +78,13 @@ compute_lake_params(lake_con_struct *lake_con,
         }
     }
 
-    // compute max volume
-    lake_con->maxvolume = 0.0;
-    for (i = 1; i <= lake_con->numnod; i++) {
-        lake_con->maxvolume += (lake_con->basin[i] + lake_con->basin[i - 1]) *
-                               (lake_con->z[i - 1] - lake_con->z[i]) / 2.;
-    }
+    // compute cumulative volume below each node (hypsometry table used by
+    // get_volume() and get_depth()), integrating up from the lake bottom
+    compute_lake_volume_table(lake_con);
+    lake_con->maxvolume = lake_con->volume[0];
 
     // compute volume corresponding to mindepth
-    ErrFlag = get_volume(*lake_con, lake_con->mindepth, &(lake_con->minvolume));
+    ErrFlag = get_volume(lake_con, lake_con->mindepth, &(lake_con->minvolume));
     if (ErrFlag == ERROR) {
         log_err("Error calculating depth: depth %f volume %f",
                 lake_con->mindepth, lake_con->minvolume);
@@ -0,0 +1,99 @@
+/******************************************************************************
+ * @section DESCRIPTION
+ *
+ * This routine copies all grid cell specific variables (soil, vegetation,
+ * energy, snow, lake) of one all_vars data structure into another, and a
+ * single vegetation tile from a structure or a packed buffer.
+ *
+ * @section LICENSE
+ *
+ * The Variable Infiltration Capacity (VIC) macroscale hydrological model
+ * Copyright (C) 2016 The Computational Hydrology Group, Department of Civil
+ * and Environmental Engineering, University of Washington.
+ *
+ * The VIC model is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *****************************************************************************/
+
+#include <vic_driver_shared_all.h>
+
+/******************************************************************************
+ * @brief    Copy the states and fluxes of a cell into another set of
+ *           structures that was created with make_all_vars for the same
+ *           number of vegetation types.
+ *****************************************************************************/
+void
+copy_all_vars(all_vars_struct *dest,
+              all_vars_struct *src,
+              size_t           nveg)
+{
+    extern option_struct options;
+
+    size_t               i;
+    size_t               j;
+    size_t               Nitems;
+    veg_var_struct      *veg_var;
+
+    Nitems = nveg + 1;
+
+    for (i = 0; i < Nitems; i++) {
+        memcpy(dest->cell[i], src->cell[i],
+               options.SNOW_BAND * sizeof(*(dest->cell[i])));
+        memcpy(dest->energy[i], src->energy[i],
+               options.SNOW_BAND * sizeof(*(dest->energy[i])));
+        memcpy(dest->snow[i], src->snow[i],
+               options.SNOW_BAND * sizeof(*(dest->snow[i])));
+        for (j = 0; j < options.SNOW_BAND; j++) {
+            veg_var = &(dest->veg_var[i][j]);
+            copy_veg_var(veg_var, &(src->veg_var[i][j]));
+            if (options.CARBON) {
+                memcpy(veg_var->NscaleFactor, src->veg_var[i][j].NscaleFactor,
+                       options.Ncanopy * sizeof(*(veg_var->NscaleFactor)));
+                memcpy(veg_var->aPARLayer, src->veg_var[i][j].aPARLayer,
+                       options.Ncanopy * sizeof(*(veg_var->aPARLayer)));
+                memcpy(veg_var->CiLayer, src->veg_var[i][j].CiLayer,
+                       options.Ncanopy * sizeof(*(veg_var->CiLayer)));
+                memcpy(veg_var->rsLayer, src->veg_var[i][j].rsLayer,
+                       options.Ncanopy * sizeof(*(veg_var->rsLayer)));
+            }
+        }
+    }
+    dest->lake_var = src->lake_var;
+}
+
+/******************************************************************************
+ * @brief    Copy the states and fluxes of a vegetation tile from src, which
+ *           need not be aligned, into dest.
+ * @details  The canopy layer arrays are owned by each cell, so dest keeps its
+ *           own NscaleFactor, aPARLayer, CiLayer and rsLayer pointers.
+ *****************************************************************************/
+void
+copy_veg_var(veg_var_struct *dest,
+             const void     *src)
+{
+    double *NscaleFactor;
+    double *aPARLayer;
+    double *CiLayer;
+    double *rsLayer;
+
+    NscaleFactor = dest->NscaleFactor;
+    aPARLayer = dest->aPARLayer;
+    CiLayer = dest->CiLayer;
+    rsLayer = dest->rsLayer;
+    memcpy(dest, src, sizeof(*dest));
+    dest->NscaleFactor = NscaleFactor;
+    dest->aPARLayer = aPARLayer;
+    dest->CiLayer = CiLayer;
+    dest->rsLayer = rsLayer;
+}
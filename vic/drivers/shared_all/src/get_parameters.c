@@ -91,6 +91,9 @@ get_parameters(FILE *paramfile)
             else if (strcasecmp("SOIL_RESID_MOIST", optstr) == 0) {
                 sscanf(cmdstr, "%*s %lf", &param.SOIL_RESID_MOIST);
             }
+            else if (strcasecmp("SOIL_RUNOFF_FLUX_FRACT", optstr) == 0) {
+                sscanf(cmdstr, "%*s %lf", &param.SOIL_RUNOFF_FLUX_FRACT);
+            }
             else if (strcasecmp("SOIL_SLAB_MOIST_FRACT", optstr) == 0) {
                 sscanf(cmdstr, "%*s %lf", &param.SOIL_SLAB_MOIST_FRACT);
             }
@@ -576,6 +579,11 @@ validate_parameters()
     if (!(param.SOIL_RESID_MOIST >= 0.)) {
         log_err("SOIL_RESID_MOIST must be defined on the interval [0, inf)");
     }
+    if (!(param.SOIL_RUNOFF_FLUX_FRACT > 0 &&
+          param.SOIL_RUNOFF_FLUX_FRACT <= 1)) {
+        log_err(
+            "SOIL_RUNOFF_FLUX_FRACT must be defined on the interval (0,1] (-)")
+    }
     if (!(param.SOIL_SLAB_MOIST_FRACT >= 0 && param.SOIL_SLAB_MOIST_FRACT <=
           1)) {
         log_err(
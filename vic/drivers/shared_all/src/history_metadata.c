@@ -1476,6 +1476,16 @@ set_output_met_data_info()
     strcpy(out_metadata[OUT_TIME_VICRUN_CPU].description,
            "CPU time spent inside vic_run");
 
+    /* number of runoff sub-steps [-] */
+    strcpy(out_metadata[OUT_RUNOFF_STEPS].varname, "OUT_RUNOFF_STEPS");
+    strcpy(out_metadata[OUT_RUNOFF_STEPS].long_name, "runoff_steps");
+    strcpy(out_metadata[OUT_RUNOFF_STEPS].standard_name,
+           "number_of_runoff_sub_steps");
+    strcpy(out_metadata[OUT_RUNOFF_STEPS].units, "1");
+    strcpy(out_metadata[OUT_RUNOFF_STEPS].description,
+           "number of runoff sub-steps per time step, averaged over the "
+           "tiles of the grid cell");
+
     if (options.FROZEN_SOIL) {
         out_metadata[OUT_FDEPTH].nelem = MAX_FRONTS;
         out_metadata[OUT_TDEPTH].nelem = MAX_FRONTS;
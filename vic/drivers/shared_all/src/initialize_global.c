@@ -68,6 +68,14 @@ initialize_global()
     global_param.statemonth = 0;
     global_param.stateday = 0;
     global_param.statesec = 0;
+    global_param.statefreq = FREQ_NEVER;
+    global_param.staten = 1;
+    global_param.spinup_cycles = 0;
+    global_param.spinup_tol_moist = 0.1;
+    global_param.spinup_tol_temp = 0.01;
+    global_param.spinup_tol_carbon = 1.0;
+    global_param.rout_velocity = 1.5;
+    global_param.rout_diffusion = 800.;
     global_param.calendar = CALENDAR_STANDARD;
     global_param.time_units = TIME_UNITS_DAYS;
     global_param.time_origin_num = MISSING;
@@ -64,6 +64,7 @@ initialize_options()
     options.QUICK_FLUX = true;
     options.QUICK_SOLVE = false;
     options.RC_MODE = RC_JARVIS;
+    options.RUNOFF_ADAPTIVE = false;
     options.SHARE_LAYER_MOIST = true;
     options.SNOW_DENSITY = DENS_BRAS;
     options.SPATIAL_FROST = false;
@@ -93,6 +94,12 @@ initialize_options()
     options.STATE_FORMAT = UNSET_FILE_FORMAT;
     options.INIT_STATE = false;
     options.SAVE_STATE = false;
+    options.STATE_GATHERED = false;
+    options.STATE_ASYNC = false;
     // output options
     options.Noutstreams = 2;
+    options.ROUTING = false;
+    // parallel options
+    options.IO_SERVER = false;
+    options.NMEMBERS = 1;
 }
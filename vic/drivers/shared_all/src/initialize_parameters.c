@@ -57,6 +57,7 @@ initialize_parameters()
     // Soil Constraints
     param.SOIL_RARC = 100.0;
     param.SOIL_RESID_MOIST = 0.0;
+    param.SOIL_RUNOFF_FLUX_FRACT = 0.25;
     param.SOIL_SLAB_MOIST_FRACT = 1.0;
     param.SOIL_WINDH = 10.0;
 
@@ -128,6 +128,24 @@ str_to_agg_type(char aggstr[])
         else if (strcasecmp("AGG_TYPE_SUM", aggstr) == 0) {
             return AGG_TYPE_SUM;
         }
+        else if (strcasecmp("AGG_TYPE_VAR", aggstr) == 0) {
+            return AGG_TYPE_VAR;
+        }
+        else if (strcasecmp("AGG_TYPE_STDEV", aggstr) == 0) {
+            return AGG_TYPE_STDEV;
+        }
+        else if (strcasecmp("AGG_TYPE_QUANTILE", aggstr) == 0) {
+            return AGG_TYPE_QUANTILE;
+        }
+        else if (strcasecmp("AGG_TYPE_HIST", aggstr) == 0) {
+            return AGG_TYPE_HIST;
+        }
+        else if (strcasecmp("AGG_TYPE_CLIM_MON", aggstr) == 0) {
+            return AGG_TYPE_CLIM_MON;
+        }
+        else if (strcasecmp("AGG_TYPE_CLIM_DOY", aggstr) == 0) {
+            return AGG_TYPE_CLIM_DOY;
+        }
         else {
             log_err("Unknown aggregation type found: %s", aggstr);
         }
@@ -390,6 +408,14 @@ cell_method_from_agg_type(unsigned short int aggtype,
         strcpy(cell_method, "time: beg");
         return true;
     }
+    else if (aggtype == AGG_TYPE_VAR) {
+        strcpy(cell_method, "time: variance");
+        return true;
+    }
+    else if (aggtype == AGG_TYPE_STDEV) {
+        strcpy(cell_method, "time: standard_deviation");
+        return true;
+    }
     else {
         return false;
     }
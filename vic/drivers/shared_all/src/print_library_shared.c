@@ -283,6 +283,16 @@ print_global_param(global_param_struct *gp)
     fprintf(LOG_DEST, "\tstatemonth          : %hu\n", gp->statemonth);
     fprintf(LOG_DEST, "\tstateyear           : %hu\n", gp->stateyear);
     fprintf(LOG_DEST, "\tstatesec            : %u\n", gp->statesec);
+    fprintf(LOG_DEST, "\tstatefreq           : %hu\n", gp->statefreq);
+    fprintf(LOG_DEST, "\tstaten              : %d\n", gp->staten);
+    fprintf(LOG_DEST, "\tspinup_cycles       : %zu\n", gp->spinup_cycles);
+    fprintf(LOG_DEST, "\tspinup_tol_moist    : %.4f\n",
+            gp->spinup_tol_moist);
+    fprintf(LOG_DEST, "\tspinup_tol_temp     : %.4f\n", gp->spinup_tol_temp);
+    fprintf(LOG_DEST, "\tspinup_tol_carbon   : %.4f\n",
+            gp->spinup_tol_carbon);
+    fprintf(LOG_DEST, "\trout_velocity       : %.4f\n", gp->rout_velocity);
+    fprintf(LOG_DEST, "\trout_diffusion      : %.4f\n", gp->rout_diffusion);
 }
 
 /******************************************************************************
@@ -311,6 +321,11 @@ print_lake_con(lake_con_struct *lcon,
         fprintf(LOG_DEST, "\t%.4f", lcon->Cl[i]);
     }
     fprintf(LOG_DEST, "\n");
+    fprintf(LOG_DEST, "\tvolume   :");
+    for (i = 0; i < nlnodes; i++) {
+        fprintf(LOG_DEST, "\t%.4f", lcon->volume[i]);
+    }
+    fprintf(LOG_DEST, "\n");
     fprintf(LOG_DEST, "\tb        : %.4f\n", lcon->b);
     fprintf(LOG_DEST, "\tmaxdepth : %.4f\n", lcon->maxdepth);
     fprintf(LOG_DEST, "\tmindepth : %.4f\n", lcon->mindepth);
@@ -469,6 +484,8 @@ print_option(option_struct *option)
     fprintf(LOG_DEST, "\tROOT_ZONES           : %zu\n", option->ROOT_ZONES);
     fprintf(LOG_DEST, "\tQUICK_FLUX           : %d\n", option->QUICK_FLUX);
     fprintf(LOG_DEST, "\tQUICK_SOLVE          : %d\n", option->QUICK_SOLVE);
+    fprintf(LOG_DEST, "\tRUNOFF_ADAPTIVE      : %d\n",
+            option->RUNOFF_ADAPTIVE);
     fprintf(LOG_DEST, "\tSHARE_LAYER_MOIST    : %d\n",
             option->SHARE_LAYER_MOIST);
     fprintf(LOG_DEST, "\tSNOW_DENSITY         : %d\n", option->SNOW_DENSITY);
@@ -492,7 +509,13 @@ print_option(option_struct *option)
     fprintf(LOG_DEST, "\tSTATE_FORMAT         : %d\n", option->STATE_FORMAT);
     fprintf(LOG_DEST, "\tINIT_STATE           : %d\n", option->INIT_STATE);
     fprintf(LOG_DEST, "\tSAVE_STATE           : %d\n", option->SAVE_STATE);
+    fprintf(LOG_DEST, "\tSTATE_GATHERED       : %d\n",
+            option->STATE_GATHERED);
+    fprintf(LOG_DEST, "\tSTATE_ASYNC          : %d\n", option->STATE_ASYNC);
     fprintf(LOG_DEST, "\tNoutstreams          : %zu\n", option->Noutstreams);
+    fprintf(LOG_DEST, "\tROUTING              : %d\n", option->ROUTING);
+    fprintf(LOG_DEST, "\tIO_SERVER            : %d\n", option->IO_SERVER);
+    fprintf(LOG_DEST, "\tNMEMBERS             : %zu\n", option->NMEMBERS);
 }
 
 /******************************************************************************
@@ -535,20 +558,38 @@ print_stream(stream_struct   *stream,
     fprintf(LOG_DEST, "\tfilename: %s\n", stream->filename);
     fprintf(LOG_DEST, "\tfh: %p\n", stream->fh);
     fprintf(LOG_DEST, "\tfile_format: %hu\n", stream->file_format);
+    fprintf(LOG_DEST, "\tcompress: %hd\n", stream->compress);
+    fprintf(LOG_DEST, "\tshuffle: %d\n", stream->shuffle);
+    fprintf(LOG_DEST, "\tchunksizes: %zu %zu %zu\n", stream->chunksizes[0],
+            stream->chunksizes[1], stream->chunksizes[2]);
+    fprintf(LOG_DEST, "\tquantize: %hu %d\n", stream->quantize,
+            stream->quantize_nsd);
+    fprintf(LOG_DEST, "\tgathered: %d\n", stream->gathered);
     fprintf(LOG_DEST, "\tnvars: %zu\n", stream->nvars);
     fprintf(LOG_DEST, "\tngridcells: %zu\n", stream->ngridcells);
+    fprintf(LOG_DEST, "\tsubset: %hu\n", stream->subset);
+    fprintf(LOG_DEST, "\tsubset_bounds: %f %f %f %f\n",
+            stream->subset_bounds[0], stream->subset_bounds[1],
+            stream->subset_bounds[2], stream->subset_bounds[3]);
+    fprintf(LOG_DEST, "\tsubset_file: %s\n", stream->subset_file);
+    fprintf(LOG_DEST, "\tsubset_var: %s\n", stream->subset_var);
+    fprintf(LOG_DEST, "\tregion: %hu\n", stream->region);
+    fprintf(LOG_DEST, "\tregion_file: %s\n", stream->region_file);
+    fprintf(LOG_DEST, "\tregion_var: %s\n", stream->region_var);
     fprintf(LOG_DEST, "\tagg_alarm:\n    ");
     print_alarm(&(stream->agg_alarm));
     fprintf(LOG_DEST,
-            "\t# \tVARID        \tVARNAME \tTYPE \tMULT \tFORMAT        \tAGGTYPE\n");
+            "\t# \tVARID        \tVARNAME \tTYPE \tMULT \tFORMAT        \tAGGTYPE \tNBINS \tNACC\n");
     for (i = 0; i < stream->nvars; i++) {
         varid = stream->varid[i];
-        fprintf(LOG_DEST, "\t%zu \t%u \t%20s \t%hu \t%f \t%10s \t%hu\n",
+        fprintf(LOG_DEST,
+                "\t%zu \t%u \t%20s \t%hu \t%f \t%10s \t%hu \t%zu \t%zu\n",
                 i, varid, metadata[varid].varname,
                 stream->type[i], stream->mult[i], stream->format[i],
-                stream->aggtype[i]);
+                stream->aggtype[i], stream->aggparam[i].nbins,
+                stream->aggparam[i].nacc);
     }
-    fprintf(LOG_DEST, "\taggdata shape: (%zu, %zu, nelem, 1)\n",
+    fprintf(LOG_DEST, "\taggdata shape: (%zu, %zu, nelem, nacc)\n",
             stream->ngridcells, stream->nvars);
 
     fprintf(LOG_DEST, "\n");
@@ -638,6 +679,8 @@ print_parameters(parameters_struct *param)
     fprintf(LOG_DEST, "\tEMISS_SNOW: %.4f\n", param->EMISS_SNOW);
     fprintf(LOG_DEST, "\tEMISS_H2O: %.4f\n", param->EMISS_H2O);
     fprintf(LOG_DEST, "\tSOIL_RESID_MOIST: %.4f\n", param->SOIL_RESID_MOIST);
+    fprintf(LOG_DEST, "\tSOIL_RUNOFF_FLUX_FRACT: %.4f\n",
+            param->SOIL_RUNOFF_FLUX_FRACT);
     fprintf(LOG_DEST, "\tSOIL_SLAB_MOIST_FRACT: %.4f\n",
             param->SOIL_SLAB_MOIST_FRACT);
     fprintf(LOG_DEST, "\tVEG_LAI_SNOW_MULTIPLIER: %.4f\n",
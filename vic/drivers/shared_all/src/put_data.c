@@ -652,6 +652,9 @@ collect_wb_terms(cell_data_struct cell,
     /** record baseflow **/
     out_data[OUT_BASEFLOW][0] += cell.baseflow * AreaFactor;
 
+    /** record number of runoff sub-steps **/
+    out_data[OUT_RUNOFF_STEPS][0] += cell.runoff_steps * AreaFactor;
+
     /** record inflow **/
     out_data[OUT_INFLOW][0] += (cell.inflow) * AreaFactor;
 
@@ -0,0 +1,245 @@
+/******************************************************************************
+ * @section DESCRIPTION
+ *
+ * Routines that pack the prognostic state of a process (the states and fluxes
+ * of the grid cells and the aggregation state of the output streams) into a
+ * contiguous memory buffer and unpack it again.
+ *
+ * @section LICENSE
+ *
+ * The Variable Infiltration Capacity (VIC) macroscale hydrological model
+ * Copyright (C) 2016 The Computational Hydrology Group, Department of Civil
+ * and Environmental Engineering, University of Washington.
+ *
+ * The VIC model is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *****************************************************************************/
+
+#include <vic_driver_shared_all.h>
+
+/******************************************************************************
+ * @brief    Copy nbytes from src to the buffer position pos and advance pos.
+ *****************************************************************************/
+void
+pack_data(char  **pos,
+          void   *src,
+          size_t  nbytes)
+{
+    memcpy(*pos, src, nbytes);
+    *pos += nbytes;
+}
+
+/******************************************************************************
+ * @brief    Copy nbytes from the buffer position pos to dest and advance pos.
+ *****************************************************************************/
+void
+unpack_data(char  **pos,
+            void   *dest,
+            size_t  nbytes)
+{
+    memcpy(dest, *pos, nbytes);
+    *pos += nbytes;
+}
+
+/******************************************************************************
+ * @brief    Number of bytes pack_all_vars writes for a cell with nveg
+ *           vegetation types.
+ *****************************************************************************/
+size_t
+sizeof_all_vars(size_t nveg)
+{
+    extern option_struct options;
+
+    size_t               nbytes;
+
+    nbytes = sizeof(cell_data_struct) + sizeof(energy_bal_struct) +
+             sizeof(snow_data_struct) + sizeof(veg_var_struct);
+    if (options.CARBON) {
+        nbytes += 4 * options.Ncanopy * sizeof(double);
+    }
+
+    return (nveg + 1) * options.SNOW_BAND * nbytes + sizeof(lake_var_struct);
+}
+
+/******************************************************************************
+ * @brief    Pack the states and fluxes of a cell that was created with
+ *           make_all_vars(nveg) at the buffer position pos.
+ *****************************************************************************/
+void
+pack_all_vars(char            **pos,
+              all_vars_struct  *all_vars,
+              size_t            nveg)
+{
+    extern option_struct options;
+
+    size_t               i;
+    size_t               j;
+    size_t               nbytes;
+    veg_var_struct      *veg_var;
+
+    for (i = 0; i <= nveg; i++) {
+        pack_data(pos, all_vars->cell[i],
+                  options.SNOW_BAND * sizeof(*(all_vars->cell[i])));
+        pack_data(pos, all_vars->energy[i],
+                  options.SNOW_BAND * sizeof(*(all_vars->energy[i])));
+        pack_data(pos, all_vars->snow[i],
+                  options.SNOW_BAND * sizeof(*(all_vars->snow[i])));
+        pack_data(pos, all_vars->veg_var[i],
+                  options.SNOW_BAND * sizeof(*(all_vars->veg_var[i])));
+        if (options.CARBON) {
+            nbytes = options.Ncanopy * sizeof(double);
+            for (j = 0; j < options.SNOW_BAND; j++) {
+                veg_var = &(all_vars->veg_var[i][j]);
+                pack_data(pos, veg_var->NscaleFactor, nbytes);
+                pack_data(pos, veg_var->aPARLayer, nbytes);
+                pack_data(pos, veg_var->CiLayer, nbytes);
+                pack_data(pos, veg_var->rsLayer, nbytes);
+            }
+        }
+    }
+    pack_data(pos, &(all_vars->lake_var), sizeof(all_vars->lake_var));
+}
+
+/******************************************************************************
+ * @brief    Unpack the states and fluxes of a cell that were packed with
+ *           pack_all_vars for the same number of vegetation types.
+ *****************************************************************************/
+void
+unpack_all_vars(char            **pos,
+                all_vars_struct  *all_vars,
+                size_t            nveg)
+{
+    extern option_struct options;
+
+    size_t               i;
+    size_t               j;
+    size_t               nbytes;
+    veg_var_struct      *veg_var;
+
+    for (i = 0; i <= nveg; i++) {
+        unpack_data(pos, all_vars->cell[i],
+                    options.SNOW_BAND * sizeof(*(all_vars->cell[i])));
+        unpack_data(pos, all_vars->energy[i],
+                    options.SNOW_BAND * sizeof(*(all_vars->energy[i])));
+        unpack_data(pos, all_vars->snow[i],
+                    options.SNOW_BAND * sizeof(*(all_vars->snow[i])));
+        for (j = 0; j < options.SNOW_BAND; j++) {
+            copy_veg_var(&(all_vars->veg_var[i][j]), *pos);
+            *pos += sizeof(all_vars->veg_var[i][j]);
+        }
+        if (options.CARBON) {
+            nbytes = options.Ncanopy * sizeof(double);
+            for (j = 0; j < options.SNOW_BAND; j++) {
+                veg_var = &(all_vars->veg_var[i][j]);
+                unpack_data(pos, veg_var->NscaleFactor, nbytes);
+                unpack_data(pos, veg_var->aPARLayer, nbytes);
+                unpack_data(pos, veg_var->CiLayer, nbytes);
+                unpack_data(pos, veg_var->rsLayer, nbytes);
+            }
+        }
+    }
+    unpack_data(pos, &(all_vars->lake_var), sizeof(all_vars->lake_var));
+}
+
+/******************************************************************************
+ * @brief    Number of bytes pack_stream_state writes for an output stream.
+ *****************************************************************************/
+size_t
+sizeof_stream_state(stream_struct *stream)
+{
+    extern metadata_struct out_metadata[N_OUTVAR_TYPES];
+
+    size_t                 j;
+    size_t                 nvalues;
+
+    nvalues = 0;
+    for (j = 0; j < stream->nvars; j++) {
+        nvalues += out_metadata[stream->varid[j]].nelem *
+                   stream->aggparam[j].nacc;
+    }
+
+    return stream->ngridcells * nvalues * sizeof(double) +
+           sizeof(stream->time_bounds) + sizeof(stream->agg_alarm) +
+           sizeof(stream->write_alarm);
+}
+
+/******************************************************************************
+ * @brief    Pack the aggregation state of an output stream: the accumulated
+ *           values, the bounds of the current aggregation window and the
+ *           alarms.
+ *****************************************************************************/
+void
+pack_stream_state(char          **pos,
+                  stream_struct  *stream)
+{
+    extern metadata_struct out_metadata[N_OUTVAR_TYPES];
+
+    size_t                 i;
+    size_t                 j;
+    size_t                 k;
+    size_t                 nelem;
+
+    for (i = 0; i < stream->ngridcells; i++) {
+        for (j = 0; j < stream->nvars; j++) {
+            nelem = out_metadata[stream->varid[j]].nelem;
+            for (k = 0; k < nelem; k++) {
+                pack_data(pos, stream->aggdata[i][j][k],
+                          stream->aggparam[j].nacc * sizeof(double));
+            }
+        }
+    }
+    pack_data(pos, stream->time_bounds, sizeof(stream->time_bounds));
+    pack_data(pos, &(stream->agg_alarm), sizeof(stream->agg_alarm));
+    pack_data(pos, &(stream->write_alarm), sizeof(stream->write_alarm));
+}
+
+/******************************************************************************
+ * @brief    Unpack the aggregation state of an output stream that was packed
+ *           with pack_stream_state.
+ *****************************************************************************/
+void
+unpack_stream_state(char          **pos,
+                    stream_struct  *stream)
+{
+    extern metadata_struct out_metadata[N_OUTVAR_TYPES];
+
+    size_t                 i;
+    size_t                 j;
+    size_t                 k;
+    size_t                 nelem;
+
+    for (i = 0; i < stream->ngridcells; i++) {
+        for (j = 0; j < stream->nvars; j++) {
+            nelem = out_metadata[stream->varid[j]].nelem;
+            for (k = 0; k < nelem; k++) {
+                unpack_data(pos, stream->aggdata[i][j][k],
+                            stream->aggparam[j].nacc * sizeof(double));
+            }
+        }
+    }
+    unpack_data(pos, stream->time_bounds, sizeof(stream->time_bounds));
+    unpack_data(pos, &(stream->agg_alarm), sizeof(stream->agg_alarm));
+    unpack_data(pos, &(stream->write_alarm), sizeof(stream->write_alarm));
+}
+
+/******************************************************************************
+ * @brief    Free the buffer of a snapshot.
+ *****************************************************************************/
+void
+free_snapshot(snapshot_struct *snapshot)
+{
+    free(snapshot->data);
+    snapshot->data = NULL;
+    snapshot->nbytes = 0;
+}
@@ -0,0 +1,125 @@
+/******************************************************************************
+ * @section DESCRIPTION
+ *
+ * Spin-up convergence test of a single grid cell.
+ *
+ * During spin-up the simulation period is run repeatedly. At the end of each
+ * cycle the storages of a cell are compared with those at the end of the
+ * previous cycle, and the cell has converged once none of them has changed by
+ * more than the spin-up tolerances.
+ *
+ * @section LICENSE
+ *
+ * The Variable Infiltration Capacity (VIC) macroscale hydrological model
+ * Copyright (C) 2016 The Computational Hydrology Group, Department of Civil
+ * and Environmental Engineering, University of Washington.
+ *
+ * The VIC model is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *****************************************************************************/
+
+#include <vic_driver_shared_all.h>
+
+/******************************************************************************
+ * @brief    Number of storages of a cell that are compared between spin-up
+ *           cycles.
+ * @details  Soil moisture of each layer, SWE, soil temperature of each node
+ *           and, with CARBON, the litter, intermediate and slow carbon pools.
+ *****************************************************************************/
+size_t
+get_spinup_nstorage(void)
+{
+    extern option_struct options;
+
+    size_t               nstorage;
+
+    nstorage = options.Nlayer + 1 + options.Nnode;
+    if (options.CARBON) {
+        nstorage += 3;
+    }
+
+    return nstorage;
+}
+
+/******************************************************************************
+ * @brief    Replace a storage of the previous spin-up cycle with its current
+ *           value.
+ *
+ * @return   true if the storage has not changed by more than tol
+ *****************************************************************************/
+bool
+update_spinup_storage(double  value,
+                      double  tol,
+                      double *storage)
+{
+    bool converged;
+
+    converged = (*storage != MISSING && fabs(value - *storage) <= tol);
+    *storage = value;
+
+    return converged;
+}
+
+/******************************************************************************
+ * @brief    Compare the end of cycle storages of a cell with those of the
+ *           previous spin-up cycle.
+ * @details  The storages are taken from the cell average output of the last
+ *           time step of the cycle (out_data), so they are weighted over
+ *           vegetation tiles and snow bands like the history output.
+ *           storage holds the get_spinup_nstorage() values of the previous
+ *           cycle (MISSING before the first cycle) and is overwritten with the
+ *           current values.
+ *
+ * @return   true if no storage has changed by more than its tolerance
+ *****************************************************************************/
+bool
+check_spinup_convergence(double **out_data,
+                         double  *storage)
+{
+    extern global_param_struct global_param;
+    extern option_struct       options;
+
+    bool                       converged;
+    size_t                     i;
+    size_t                     j;
+
+    converged = true;
+    i = 0;
+    for (j = 0; j < options.Nlayer; j++) {
+        converged &= update_spinup_storage(out_data[OUT_SOIL_MOIST][j],
+                                           global_param.spinup_tol_moist,
+                                           &(storage[i++]));
+    }
+    converged &= update_spinup_storage(out_data[OUT_SWE][0],
+                                       global_param.spinup_tol_moist,
+                                       &(storage[i++]));
+    for (j = 0; j < options.Nnode; j++) {
+        converged &= update_spinup_storage(out_data[OUT_SOIL_TNODE][j],
+                                           global_param.spinup_tol_temp,
+                                           &(storage[i++]));
+    }
+    if (options.CARBON) {
+        converged &= update_spinup_storage(out_data[OUT_CLITTER][0],
+                                           global_param.spinup_tol_carbon,
+                                           &(storage[i++]));
+        converged &= update_spinup_storage(out_data[OUT_CINTER][0],
+                                           global_param.spinup_tol_carbon,
+                                           &(storage[i++]));
+        converged &= update_spinup_storage(out_data[OUT_CSLOW][0],
+                                           global_param.spinup_tol_carbon,
+                                           &(storage[i++]));
+    }
+
+    return converged;
+}
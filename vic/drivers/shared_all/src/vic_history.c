@@ -74,8 +74,25 @@ setup_stream(stream_struct *stream,
     // Set stream scalars
     stream->nvars = nvars;
     stream->ngridcells = ngridcells;
+    stream->cell_idx = NULL;
+    stream->subset = SUBSET_NONE;
+    for (i = 0; i < 4; i++) {
+        stream->subset_bounds[i] = 0.;
+    }
+    stream->subset_file[0] = '\0';
+    stream->subset_var[0] = '\0';
+    stream->region = REGION_NONE;
+    stream->region_file[0] = '\0';
+    stream->region_var[0] = '\0';
     stream->file_format = UNSET_FILE_FORMAT;
     stream->compress = false;
+    stream->shuffle = true;
+    stream->chunksizes[0] = 0;
+    stream->chunksizes[1] = 0;
+    stream->chunksizes[2] = 0;
+    stream->quantize = QUANTIZE_NONE;
+    stream->quantize_nsd = 0;
+    stream->gathered = false;
 
     // Initialize dmy_junk - this step is to avoid time-related error caused
     // by junk dmy; the date set here does not matter and will be overwritten
@@ -99,6 +116,9 @@ setup_stream(stream_struct *stream,
     stream->aggtype = calloc(nvars, sizeof(*(stream->aggtype)));
     check_alloc_status(stream->aggtype, "Memory allocation error.");
 
+    stream->aggparam = calloc(nvars, sizeof(*(stream->aggparam)));
+    check_alloc_status(stream->aggparam, "Memory allocation error.");
+
     stream->type = calloc(nvars, sizeof(*(stream->type)));
     check_alloc_status(stream->type, "Memory allocation error.");
 
@@ -119,6 +139,8 @@ setup_stream(stream_struct *stream,
         stream->type[i] = OUT_TYPE_DEFAULT;
         stream->mult[i] = OUT_MULT_DEFAULT;
         stream->aggtype[i] = AGG_TYPE_DEFAULT;
+        stream->aggparam[i].nbins = 1;
+        stream->aggparam[i].nacc = 1;
     }
 }
 
@@ -134,9 +156,6 @@ validate_streams(stream_struct **streams)
 
     // validate stream settings
     for (streamnum = 0; streamnum < options.Noutstreams; streamnum++) {
-        if ((*streams)[streamnum].ngridcells < 1) {
-            log_err("Number of gridcells in stream is less than 1");
-        }
         if ((*streams)[streamnum].nvars < 1) {
             log_err("Number of variables in stream is less than 1");
         }
@@ -158,7 +177,8 @@ validate_streams(stream_struct **streams)
         if ((*streams)[streamnum].aggtype == NULL) {
             log_err("Stream aggtype array not allocated");
         }
-        if ((*streams)[streamnum].aggdata == NULL) {
+        if ((*streams)[streamnum].aggdata == NULL &&
+            (*streams)[streamnum].ngridcells > 0) {
             log_err("Stream agg_data array not allocated");
         }
     }
@@ -178,6 +198,12 @@ alloc_aggdata(stream_struct *stream)
     size_t                 k;
     size_t                 nelem;
 
+    // a process may hold none of the cells of a spatially subset stream
+    if (stream->ngridcells == 0) {
+        stream->aggdata = NULL;
+        return;
+    }
+
     stream->aggdata = calloc(stream->ngridcells, sizeof(*(stream->aggdata)));
     check_alloc_status(stream->aggdata, "Memory allocation error.");
 
@@ -193,9 +219,9 @@ alloc_aggdata(stream_struct *stream)
                                "Memory allocation error.");
 
             for (k = 0; k < nelem; k++) {
-                // TODO: Also allocate for nbins, for now just setting to size 1
                 stream->aggdata[i][j][k] =
-                    calloc(1, sizeof(*(stream->aggdata[i][j][k])));
+                    calloc(stream->aggparam[j].nacc,
+                           sizeof(*(stream->aggdata[i][j][k])));
                 check_alloc_status(stream->aggdata[i][j][k],
                                    "Memory allocation error.");
             }
@@ -215,6 +241,7 @@ reset_stream(stream_struct *stream,
     size_t                 i;
     size_t                 j;
     size_t                 k;
+    size_t                 n;
     size_t                 varid;
 
     // Reset alarm to next agg period
@@ -225,7 +252,9 @@ reset_stream(stream_struct *stream,
         for (j = 0; j < stream->nvars; j++) {
             varid = stream->varid[j];
             for (k = 0; k < out_metadata[varid].nelem; k++) {
-                stream->aggdata[i][j][k][0] = 0.;
+                for (n = 0; n < stream->aggparam[j].nacc; n++) {
+                    stream->aggdata[i][j][k][n] = 0.;
+                }
             }
         }
     }
@@ -396,6 +425,108 @@ set_output_var(stream_struct     *stream,
     else {
         stream->aggtype[varnum] = get_default_outvar_aggtype(varid);
     }
+    // Aggregation parameters, see set_output_agg_param
+    stream->aggparam[varnum].nbins = 1;
+    stream->aggparam[varnum].nacc = 1;
+    if (stream->aggtype[varnum] == AGG_TYPE_VAR ||
+        stream->aggtype[varnum] == AGG_TYPE_STDEV) {
+        stream->aggparam[varnum].nacc = 2;
+    }
+}
+
+/******************************************************************************
+ * @brief    This routine sets the parameters of the aggregation of an output
+ *           variable (the values that follow the aggregation type of an
+ *           OUTVAR entry) and the number of values that are kept and written
+ *           for each element. Must be called after set_output_var.
+ *****************************************************************************/
+void
+set_output_agg_param(stream_struct *stream,
+                     size_t         varnum,
+                     double        *values,
+                     size_t         nvalues)
+{
+    extern metadata_struct out_metadata[N_OUTVAR_TYPES];
+
+    agg_param_struct      *param;
+    char                  *varname;
+
+    param = &(stream->aggparam[varnum]);
+    varname = out_metadata[stream->varid[varnum]].varname;
+
+    param->quantile = 0.;
+    param->lower = 0.;
+    param->upper = 0.;
+    param->nbins = 1;
+    param->nacc = 1;
+
+    switch (stream->aggtype[varnum]) {
+    case AGG_TYPE_VAR:
+    case AGG_TYPE_STDEV:
+        // running mean and sum of squared deviations
+        param->nacc = 2;
+        break;
+    case AGG_TYPE_QUANTILE:
+        if (nvalues != 1 || !(values[0] > 0. && values[0] < 1.)) {
+            log_err("AGG_TYPE_QUANTILE of %s must be followed by the "
+                    "quantile to estimate (between 0 and 1)", varname);
+        }
+        param->quantile = values[0];
+        // heights and positions of the markers
+        param->nacc = 2 * P2_NMARKERS;
+        break;
+    case AGG_TYPE_HIST:
+        if (nvalues != 3 || !(values[0] >= 1.) ||
+            !(values[2] > values[1])) {
+            log_err("AGG_TYPE_HIST of %s must be followed by the number of "
+                    "bins and the lower edge of the first and upper edge "
+                    "of the last bin", varname);
+        }
+        param->nbins = (size_t) values[0];
+        param->lower = values[1];
+        param->upper = values[2];
+        param->nacc = param->nbins;
+        break;
+    case AGG_TYPE_CLIM_MON:
+        param->nbins = MONTHS_PER_YEAR;
+        // sums and counts of each bin
+        param->nacc = 2 * param->nbins;
+        break;
+    case AGG_TYPE_CLIM_DOY:
+        param->nbins = DAYS_PER_LYEAR;
+        param->nacc = 2 * param->nbins;
+        break;
+    default:
+        break;
+    }
+
+    if (nvalues > 0 && stream->aggtype[varnum] != AGG_TYPE_QUANTILE &&
+        stream->aggtype[varnum] != AGG_TYPE_HIST) {
+        log_err("The aggregation type of %s does not take any parameters",
+                varname);
+    }
+}
+
+/******************************************************************************
+ * @brief    This routine prints the name of a column of an output file, i.e.
+ *           of one element and bin of an output variable.
+ *****************************************************************************/
+void
+sprint_outvar_name(char        *str,
+                   unsigned int varid,
+                   size_t       elem_idx,
+                   size_t       bin_idx,
+                   size_t       nbins)
+{
+    extern metadata_struct out_metadata[N_OUTVAR_TYPES];
+
+    strcpy(str, out_metadata[varid].varname);
+    if (out_metadata[varid].nelem > 1) {
+        sprintf(str + strlen(str), "_%zu", elem_idx);
+    }
+    if (nbins > 1) {
+        sprintf(str + strlen(str), "_b%zu", bin_idx);
+    }
 }
 
 /******************************************************************************
@@ -436,6 +567,8 @@ free_streams(stream_struct **streams)
         free((*streams)[streamnum].format);
         free((*streams)[streamnum].varid);
         free((*streams)[streamnum].aggtype);
+        free((*streams)[streamnum].aggparam);
+        free((*streams)[streamnum].cell_idx);
     }
     free(*streams);
 }
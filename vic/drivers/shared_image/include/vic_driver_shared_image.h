@@ -31,9 +31,16 @@
 #include <vic_image_log.h>
 #include <vic_mpi.h>
 
+#include <limits.h>
 #include <netcdf.h>
+#include <stdint.h>
 
 #define MAXDIMS 10
+#define NHISTRECORDS 2
+#define PARAM_CACHE_MAGIC "VICPCACH"
+#define PARAM_CACHE_VERSION 1
+#define FNV_OFFSET_BASIS 14695981039346656037ULL
+#define FNV_PRIME 1099511628211ULL
 
 /******************************************************************************
  * @brief   NetCDF file types
@@ -101,6 +108,29 @@ typedef struct {
     size_t nc_dims;                 /**< number of dimensions */
 } nc_var_struct;
 
+/******************************************************************************
+ * @brief    Structure for a history record that has been handed off for
+ *           writing.
+ * @details  The values of all variables and elements of an output stream are
+ *           copied into a single send buffer and gathered to the master node
+ *           with one non-blocking collective. The record is written to the
+ *           history file later, while the model continues with the next
+ *           timesteps.
+ *****************************************************************************/
+typedef struct {
+    bool pending;              /**< TRUE: record has not been written yet */
+    bool close_file;           /**< TRUE: close history file after writing */
+    size_t time_index;         /**< position in the time dimension */
+    dmy_struct dmy;            /**< timestep at which the record was taken */
+    dmy_struct time_bounds[2]; /**< aggregation window of the record */
+    double *send;              /**< local values [nvalues][ncells_active],
+                                    or region sums and areas
+                                    [2][nvalues][nregions] */
+    double *recv;              /**< gathered values on the master node,
+                                    ordered by process and then as in send */
+    MPI_Request request;       /**< outstanding gather */
+} hist_record_struct;
+
 /******************************************************************************
  * @brief    Structure for netcdf file information. Initially to store
  *           information for the output files (state and history)
@@ -113,10 +143,12 @@ typedef struct {
     short int s_fillvalue;
     int nc_id;
     int band_dimid;
+    int cell_dimid;
     int front_dimid;
     int frost_dimid;
     int lake_node_dimid;
     int layer_dimid;
+    int member_dimid;
     int ni_dimid;
     int nj_dimid;
     int node_dimid;
@@ -126,11 +158,15 @@ typedef struct {
     int veg_dimid;
     int time_varid;
     int time_bounds_varid;
+    int cell_varid;
+    int member_varid;
     size_t band_size;
+    size_t cell_size;
     size_t front_size;
     size_t frost_size;
     size_t lake_node_size;
     size_t layer_size;
+    size_t member_size;
     size_t ni_size;
     size_t nj_size;
     size_t node_size;
@@ -138,9 +174,76 @@ typedef struct {
     size_t time_size;
     size_t veg_size;
     bool open;
+    bool gathered;               /**< TRUE: the active cells are stored along
+                                      a single cell dimension instead of the
+                                      y and x dimensions (CF compression by
+                                      gathering) */
+    size_t *cell_grid_idx;       /**< grid index of each cell of the file
+                                      [cell_size] */
+    size_t *cell_map;            /**< index in the file of each gathered
+                                      cell, in MPI order [cell_size] */
+    int *cell_counts;            /**< number of cells gathered from each
+                                      process [mpi_size] */
+    int *cell_offsets;           /**< offsets of the cells of each process
+                                      in cell_map [mpi_size] */
+    size_t *cell_region;         /**< region of each grid cell in aggdata of
+                                      a region stream [ngridcells] */
+    double *cell_area;           /**< area of each grid cell in aggdata of a
+                                      region stream [ngridcells] */
+    int *region_ids;             /**< id of each region of a region stream,
+                                      the cells of the file [cell_size] */
+    double *region_area;         /**< area of each region [cell_size] */
     nc_var_struct *nc_vars;
+    size_t nvalues;              /**< number of values per cell in a record */
+    size_t next_record;          /**< record buffer that is filled next */
+    hist_record_struct *records; /**< history record buffers [NHISTRECORDS] */
+    int *gather_counts;          /**< number of record values gathered from
+                                      each process [mpi_size] */
+    int *gather_offsets;         /**< offsets of the record values of each
+                                      process in recv [mpi_size] */
+    double *remapped;            /**< values of one variable in file cell
+                                      order [member_size][nelem]
+                                      [cell_size] */
+    double *d_grid;              /**< full grid (or cell) buffer for
+                                      NC_DOUBLE */
+    float *f_grid;               /**< full grid (or cell) buffer for
+                                      NC_FLOAT */
+    int *i_grid;                 /**< full grid (or cell) buffer for NC_INT */
+    short int *s_grid;           /**< full grid (or cell) buffer for
+                                      NC_SHORT */
+    signed char *c_grid;         /**< full grid (or cell) buffer for
+                                      NC_CHAR */
 } nc_file_struct;
 
+/******************************************************************************
+ * @brief    State file of one ensemble member that is written in the
+ *           background (STATE_ASYNC). The state is copied into send when it
+ *           is saved and gathered on the master node, which then writes a
+ *           few variables of the file each time step.
+ *****************************************************************************/
+typedef struct {
+    bool pending;              /**< TRUE: state file has not been completed */
+    char filename[MAXSTRING];  /**< name of the state file */
+    dmy_struct dmy;            /**< timestep at which the state was saved */
+    nc_file_struct nc;         /**< state file */
+    size_t step;               /**< time step at which the state was saved */
+    size_t nvars;              /**< number of staged variables */
+    size_t next_var;           /**< staged variable that is written next */
+    size_t nvars_step;         /**< staged variables written per time step */
+    int varid[N_STATE_VARS];   /**< state variable of each staged variable */
+    size_t offset[N_STATE_VARS]; /**< first block of each staged variable */
+    size_t nblock;             /**< number of staged blocks */
+    double *send;              /**< local values [nblock][ncells_active],
+                                    integer variables are stored as double */
+    double *recv;              /**< gathered values on the master node,
+                                    ordered by process and then as in send */
+    int *counts;               /**< number of values gathered from each
+                                    process [mpi_size] */
+    int *displs;               /**< offsets of the values of each process in
+                                    recv [mpi_size] */
+    MPI_Request request;       /**< outstanding gather */
+} state_stage_struct;
+
 /******************************************************************************
  * @brief    Structure for mapping the vegetation types for each grid cell as
  *           stored in VIC's veg_con_struct to a regular array.
@@ -180,27 +283,70 @@ typedef struct {
     char domain[MAXSTRING];        /**< domain file name */
     char constants[MAXSTRING];     /**< model constants file name */
     char params[MAXSTRING];        /**< model parameters file name */
+    char param_cache[MAXSTRING];   /**< prefix of the per-process parameter cache files */
     char init_state[MAXSTRING];    /**< initial model state file name */
+    char routing[MAXSTRING];       /**< flow direction and outlet file name */
     char result_dir[MAXSTRING];    /**< directory where results will be written */
     char statefile[MAXSTRING];     /**< name of file in which to store model state */
     char log_path[MAXSTRING];      /**< Location to write log file to */
 } filenames_struct;
 
+/******************************************************************************
+ * @brief   Header of a per-process parameter cache file. A cache file is only
+ *          used when every field matches the current run.
+ *****************************************************************************/
+typedef struct {
+    char magic[8];               /**< PARAM_CACHE_MAGIC (not nul-terminated) */
+    int version;                 /**< PARAM_CACHE_VERSION */
+    int mpi_size;                /**< number of processes in the decomposition */
+    int mpi_rank;                /**< process that wrote the file */
+    size_t ncells_active;        /**< number of active cells on this process */
+    size_t global_ncells_active; /**< number of active cells in the domain */
+    uint64_t params_hash;        /**< hash of the parameter file contents */
+    uint64_t domain_hash;        /**< hash of the domain file contents */
+    uint64_t setup_hash;         /**< hash of the options, model constants
+                                    and parameter structure layouts */
+} param_cache_header_struct;
+
+/******************************************************************************
+ * @brief   Spin-up state of the local cells. retired is NULL outside of a
+ *          spin-up run.
+ *****************************************************************************/
+typedef struct {
+    bool *retired;               /**< TRUE: the cell has converged and is no
+                                    longer run [ncells] */
+    double *storage;             /**< storages at the end of the previous
+                                    cycle [ncells][nstorage] */
+} spinup_struct;
+
 void add_nveg_to_global_domain(char *nc_name, domain_struct *global_domain);
-void alloc_force(force_data_struct *force);
+void alloc_force(force_data_struct *force, size_t ncells);
 void alloc_veg_hist(veg_hist_struct *veg_hist);
 double air_density(double t, double p);
 double average(double *ar, size_t n);
 void check_init_state_file(void);
 void compare_ncdomain_with_global_domain(char *ncfile);
-void free_force(force_data_struct *force);
+void def_nc_cell_dim(nc_file_struct *nc, char *filename);
+void def_nc_member_dim(nc_file_struct *nc, char *filename);
+void def_nc_region_dim(nc_file_struct *nc, stream_struct *stream);
+void def_nc_var_bin_dim(nc_file_struct *nc, stream_struct *stream,
+                        size_t varnum);
+void free_force(force_data_struct *force, size_t ncells);
 void free_veg_hist(veg_hist_struct *veg_hist);
+void gather_put_nc_var_double(nc_file_struct *nc, nc_var_struct *nc_var,
+                              double *var);
+void gather_put_nc_var_int(nc_file_struct *nc, nc_var_struct *nc_var,
+                           int *var);
 void get_domain_type(char *cmdstr);
 size_t get_global_domain(char *fname, domain_struct *global_domain,
                          bool coords_only);
+void get_nc_bin_dim_name(stream_struct *stream, size_t varnum, char *name);
+void get_nc_cell_layout(nc_file_struct *nc, char *filename);
 size_t get_nc_dimension(char *nc_name, char *dim_name);
 void get_nc_var_attr(char *nc_name, char *var_name, char *attr_name,
                      char **attr);
+size_t get_nc_var_file_dimids(nc_file_struct *nc, nc_var_struct *nc_var,
+                              int *dimids);
 int get_nc_varndimensions(char *nc_name, char *var_name);
 int get_nc_field_double(char *nc_name, char *var_name, size_t *start,
                         size_t *count, double *var);
@@ -210,6 +356,13 @@ int get_nc_field_int(char *nc_name, char *var_name, size_t *start,
                      size_t *count, int *var);
 int get_nc_dtype(unsigned short int dtype);
 int get_nc_mode(unsigned short int format);
+void get_param_cache_header(param_cache_header_struct *header);
+void get_scatter_nc_var_double(nc_file_struct *nc, char *var_name,
+                               nc_var_struct *nc_var, double *var);
+void get_scatter_nc_var_int(nc_file_struct *nc, char *var_name,
+                            nc_var_struct *nc_var, int *var);
+uint64_t hash_bytes(const void *data, size_t nbytes, uint64_t hash);
+uint64_t hash_file(char *filename);
 void initialize_domain(domain_struct *domain);
 void initialize_domain_info(domain_info_struct *info);
 void initialize_filenames(void);
@@ -217,8 +370,11 @@ void initialize_fileps(void);
 void initialize_global_structures(void);
 void initialize_history_file(nc_file_struct *nc, stream_struct *stream,
                              dmy_struct *dmy_current);
+void initialize_history_records(nc_file_struct *nc, stream_struct *stream);
 void initialize_state_file(char *filename, nc_file_struct *nc_state_file,
                            dmy_struct *dmy_current);
+void initialize_stream_region(stream_struct *stream, nc_file_struct *nc);
+void initialize_stream_subset(stream_struct *stream, nc_file_struct *nc);
 void initialize_location(location_struct *location);
 int initialize_model_state(all_vars_struct *all_vars, size_t Nveg,
                            size_t Nnodes, double surf_temp,
@@ -227,6 +383,9 @@ void initialize_nc_file(nc_file_struct *nc_file, size_t nvars,
                         unsigned int *varids, unsigned short int *dtypes);
 void initialize_soil_con(soil_con_struct *soil_con);
 void initialize_veg_con(veg_con_struct *veg_con);
+bool param_cache_block(void *data, size_t size, size_t nitems, FILE *fp,
+                       bool to_file);
+bool param_cache_cells(FILE *fp, bool to_file);
 void parse_output_info(FILE *gp, stream_struct **output_streams,
                        dmy_struct *dmy_current);
 void print_force_data(force_data_struct *force);
@@ -235,14 +394,27 @@ void print_location(location_struct *location);
 void print_nc_file(nc_file_struct *nc);
 void print_nc_var(nc_var_struct *nc_var);
 void print_veg_con_map(veg_con_map_struct *veg_con_map);
+void put_nc_cell_index(nc_file_struct *nc, char *filename);
+void put_nc_member_index(nc_file_struct *nc, char *filename);
+void put_nc_region_coords(nc_file_struct *nc, char *filename);
+void put_nc_bin_coords(nc_file_struct *nc, stream_struct *stream);
 void put_nc_attr(int nc_id, int var_id, const char *name, const char *value);
+void put_nc_var_double_mapped(nc_file_struct *nc, nc_var_struct *nc_var,
+                              double *mapped);
+void put_nc_var_int_mapped(nc_file_struct *nc, nc_var_struct *nc_var,
+                           int *mapped);
+bool read_param_cache(void);
+int region_id_cmp(const void *a, const void *b);
 void set_force_type(char *cmdstr, int file_num, int *field);
 void set_global_nc_attributes(int ncid, unsigned short int file_type);
 void set_state_meta_data_info();
+void set_nc_var_bins(nc_file_struct *nc, stream_struct *stream);
 void set_nc_var_dimids(unsigned int varid, nc_file_struct *nc_hist_file,
                        nc_var_struct *nc_var);
 void set_nc_var_info(unsigned int varid, unsigned short int dtype,
                      nc_file_struct *nc_hist_file, nc_var_struct *nc_var);
+void set_nc_var_storage(stream_struct *stream, nc_file_struct *nc,
+                        nc_var_struct *nc_var, char *varname);
 void set_nc_state_file_info(nc_file_struct *nc_state_file);
 void set_nc_state_var_info(nc_file_struct *nc_state_file);
 void sprint_location(char *str, location_struct *loc);
@@ -251,11 +423,30 @@ void vic_finalize(void);
 void vic_image_run(dmy_struct *dmy_current);
 void vic_init(void);
 void vic_init_output(dmy_struct *dmy_current);
+void vic_init_params(void);
 void vic_restore(void);
+void vic_restore_snapshot(snapshot_struct *snapshot);
+void vic_snapshot(snapshot_struct *snapshot);
+size_t vic_snapshot_size(void);
 void vic_start(void);
+void store_nc_var_double(nc_file_struct *nc, nc_var_struct *nc_var,
+                         double *var, state_stage_struct *stage);
+void store_nc_var_int(nc_file_struct *nc, nc_var_struct *nc_var, int *var,
+                      state_stage_struct *stage);
 void vic_store(dmy_struct *dmy_current, char *state_filename);
+void vic_store_async(dmy_struct *dmy_current, size_t current,
+                     char *state_filename);
+void vic_store_flush(void);
+void vic_store_member(dmy_struct *dmy_current, size_t member,
+                      char *state_filename, state_stage_struct *stage);
+void vic_store_progress(void);
+void write_stage_vars(state_stage_struct *stage, size_t nvars);
 void vic_write(stream_struct *stream, nc_file_struct *nc_hist_file,
                dmy_struct *dmy_current);
+void vic_write_flush(void);
 void vic_write_output(dmy_struct *dmy);
+void vic_write_record(stream_struct *stream, nc_file_struct *nc_hist_file,
+                      hist_record_struct *record);
+void write_param_cache(void);
 void write_vic_timing_table(timer_struct *timers, char *driver);
 #endif
@@ -27,17 +27,65 @@
 #ifndef VIC_MPI_H
 #define VIC_MPI_H
 
+#include <stdint.h>
 #include <vic_def.h>
 #include <mpi.h>
 
 #define VIC_MPI_ROOT 0
 
+/******************************************************************************
+ * @brief   Persistent work space of the gather and scatter routines. Only
+ *          used on the master process.
+ *****************************************************************************/
+typedef struct {
+    size_t *grid_idx;    /**< grid index of each cell in MPI order, i.e.
+                            filter_active_cells[mpi_map_mapping_array[i]] */
+    int *counts;         /**< per process counts of a block */
+    int *displs;         /**< per process displacements of a block */
+    void *grid;          /**< buffer for blocks of full grid slices */
+    size_t grid_bytes;   /**< allocated size of grid */
+    void *cells;         /**< buffer for blocks of active cells in MPI order */
+    size_t cells_bytes;  /**< allocated size of cells */
+} mpi_map_buffers_struct;
+
+/******************************************************************************
+ * @brief   Hash and owner of a distinct vegetation library.
+ *****************************************************************************/
+typedef struct {
+    uint64_t hash;       /**< hash of the library */
+    int rank;            /**< process (on the node) that holds the library */
+    size_t idx;          /**< index of the library on that process */
+} veg_lib_key_struct;
+
+/******************************************************************************
+ * @brief   Storage of the distinct vegetation libraries of a process.
+ *****************************************************************************/
+typedef struct {
+    MPI_Comm node_comm;      /**< processes that share memory with this one */
+    MPI_Win win;             /**< shared memory window with the libraries
+                                  of all processes on the node */
+    veg_lib_struct *base;    /**< segment of this process in win */
+    size_t nlibs;            /**< number of libraries kept in private memory
+                                  (hash collisions) */
+    veg_lib_struct **libs;   /**< libraries kept in private memory [nlibs] */
+} veg_lib_share_struct;
+
 void create_MPI_filenames_struct_type(MPI_Datatype *mpi_type);
 void create_MPI_global_struct_type(MPI_Datatype *mpi_type);
 void create_MPI_location_struct_type(MPI_Datatype *mpi_type);
 void create_MPI_alarm_struct_type(MPI_Datatype *mpi_type);
 void create_MPI_option_struct_type(MPI_Datatype *mpi_type);
 void create_MPI_param_struct_type(MPI_Datatype *mpi_type);
+void free_veg_lib(void);
+void gather_put_nc_block_double(int nc_id, int var_id, double fillval,
+                                size_t ndims, size_t *start, size_t *count,
+                                double *var);
+void gather_put_nc_block_int(int nc_id, int var_id, int fillval, size_t ndims,
+                             size_t *start, size_t *count, int *var);
+void gather_put_nc_cells_double(int nc_id, int var_id, size_t ndims,
+                                size_t *start, size_t *count, double *var);
+void gather_put_nc_cells_int(int nc_id, int var_id, size_t ndims,
+                             size_t *start, size_t *count, int *var);
 void gather_put_nc_field_double(int nc_id, int var_id, double fillval,
                                 size_t *start, size_t *count, double *var);
 void gather_put_nc_field_float(int nc_id, int var_id, float fillval,
@@ -48,6 +96,19 @@ void gather_put_nc_field_short(int nc_id, int var_id, short int fillval,
                                size_t *start, size_t *count, short int *var);
 void gather_put_nc_field_schar(int nc_id, int var_id, char fillval,
                                size_t *start, size_t *count, char *var);
+void get_nc_block_double_mapped(int nc_id, char *var_name, size_t ndims,
+                                size_t *start, size_t *count, double *mapped);
+size_t get_nc_block_size(size_t ndims, size_t *count);
+size_t get_nc_cells_hyperslab(size_t ndims, size_t *start, size_t *count,
+                              size_t *cells_start, size_t *cells_count);
+void get_scatter_nc_block_double(int nc_id, char *var_name, size_t ndims,
+                                 size_t *start, size_t *count, double *var);
+void get_scatter_nc_block_int(int nc_id, char *var_name, size_t ndims,
+                              size_t *start, size_t *count, int *var);
+void get_scatter_nc_cells_double(int nc_id, char *var_name, size_t ndims,
+                                 size_t *start, size_t *count, double *var);
+void get_scatter_nc_cells_int(int nc_id, char *var_name, size_t ndims,
+                              size_t *start, size_t *count, int *var);
 void get_scatter_nc_field_double(char *nc_name, char *var_name, size_t *start,
                                  size_t *count, double *var);
 void get_scatter_nc_field_float(char *nc_name, char *var_name, size_t *start,
@@ -57,10 +118,36 @@ void get_scatter_nc_field_int(char *nc_name, char *var_name, size_t *start,
 void initialize_mpi(void);
 void map(size_t size, size_t n, size_t *from_map, size_t *to_map, void *from,
          void *to);
-void mpi_map_decomp_domain(size_t ncells, size_t mpi_size,
+void map_block(size_t size, size_t nblock, size_t grid_size, void *grid,
+               void *mpi_vals, bool to_grid);
+void map_cells_block(size_t size, size_t nblock, void *cells, void *mpi_vals,
+                     bool to_cells);
+void map_indexed(size_t size, size_t n, size_t *grid_idx, void *grid,
+                 void *mpi_vals, bool to_grid);
+int mpi_map_block_count(size_t nblock, size_t ncells);
+void mpi_map_block_counts(size_t nblock, int **counts, int **displs);
+void *mpi_map_cells_buffer(size_t nbytes);
+void mpi_map_decomp_domain(size_t ncells, size_t mpi_size, size_t first_rank,
                            int **mpi_map_local_array_sizes,
                            int **mpi_map_global_array_offsets,
                            size_t **mpi_map_mapping_array);
+void mpi_map_free_buffers(void);
+void *mpi_map_grid_buffer(size_t nbytes);
+void mpi_map_init_buffers(void);
 void print_mpi_error_str(int error_code);
+void put_nc_block_double_mapped(int nc_id, int var_id, double fillval,
+                                size_t ndims, size_t *start, size_t *count,
+                                double *mapped);
+void put_nc_block_int_mapped(int nc_id, int var_id, int fillval, size_t ndims,
+                             size_t *start, size_t *count, int *mapped);
+void put_nc_cells_double_mapped(int nc_id, int var_id, size_t ndims,
+                                size_t *start, size_t *count, double *mapped);
+void put_nc_cells_int_mapped(int nc_id, int var_id, size_t ndims,
+                             size_t *start, size_t *count, int *mapped);
+void scatter_block_double_interleaved(size_t nblock, size_t nmembers,
+                                      size_t stride, double *mapped,
+                                      double *var);
+void share_veg_lib(void);
+int veg_lib_key_cmp(const void *a, const void *b);
 
 #endif
@@ -27,91 +27,138 @@
 #include <vic_driver_shared_image.h>
 
 /******************************************************************************
- * @brief    Allocate memory for the force data structure.
+ * @brief    Allocate memory for the force data structures of all local cells.
+ * @details  Each forcing variable is stored in one contiguous array laid out
+ *           as [cell][NR + 1]. The arrays of force[i] are views into that
+ *           storage, so the forcing of all cells can be scattered into place
+ *           directly while vic_run keeps reading force[i].air_temp[j] etc.
  *****************************************************************************/
 void
-alloc_force(force_data_struct *force)
+alloc_force(force_data_struct *force,
+            size_t             ncells)
 {
     extern option_struct options;
 
-    force->air_temp = calloc(NR + 1, sizeof(*(force->air_temp)));
-    check_alloc_status(force->air_temp, "Memory allocation error.");
+    size_t               i;
+    size_t               nvalues;
+    force_data_struct    store;
 
-    force->density = calloc(NR + 1, sizeof(*(force->density)));
-    check_alloc_status(force->density, "Memory allocation error.");
+    if (ncells == 0) {
+        return;
+    }
+
+    nvalues = ncells * (NR + 1);
+
+    store.air_temp = calloc(nvalues, sizeof(*(store.air_temp)));
+    check_alloc_status(store.air_temp, "Memory allocation error.");
 
-    force->longwave = calloc(NR + 1, sizeof(*(force->longwave)));
-    check_alloc_status(force->longwave, "Memory allocation error.");
+    store.density = calloc(nvalues, sizeof(*(store.density)));
+    check_alloc_status(store.density, "Memory allocation error.");
 
-    force->prec = calloc(NR + 1, sizeof(*(force->prec)));
-    check_alloc_status(force->prec, "Memory allocation error.");
+    store.longwave = calloc(nvalues, sizeof(*(store.longwave)));
+    check_alloc_status(store.longwave, "Memory allocation error.");
 
-    force->pressure = calloc(NR + 1, sizeof(*(force->pressure)));
-    check_alloc_status(force->pressure, "Memory allocation error.");
+    store.prec = calloc(nvalues, sizeof(*(store.prec)));
+    check_alloc_status(store.prec, "Memory allocation error.");
 
-    force->shortwave = calloc(NR + 1, sizeof(*(force->shortwave)));
-    check_alloc_status(force->shortwave, "Memory allocation error.");
+    store.pressure = calloc(nvalues, sizeof(*(store.pressure)));
+    check_alloc_status(store.pressure, "Memory allocation error.");
 
-    force->snowflag = calloc(NR + 1, sizeof(*(force->snowflag)));
-    check_alloc_status(force->snowflag, "Memory allocation error.");
+    store.shortwave = calloc(nvalues, sizeof(*(store.shortwave)));
+    check_alloc_status(store.shortwave, "Memory allocation error.");
 
-    force->vp = calloc(NR + 1, sizeof(*(force->vp)));
-    check_alloc_status(force->vp, "Memory allocation error.");
+    store.snowflag = calloc(nvalues, sizeof(*(store.snowflag)));
+    check_alloc_status(store.snowflag, "Memory allocation error.");
 
-    force->vpd = calloc(NR + 1, sizeof(*(force->vpd)));
-    check_alloc_status(force->vpd, "Memory allocation error.");
+    store.vp = calloc(nvalues, sizeof(*(store.vp)));
+    check_alloc_status(store.vp, "Memory allocation error.");
 
-    force->wind = calloc(NR + 1, sizeof(*(force->wind)));
-    check_alloc_status(force->wind, "Memory allocation error.");
+    store.vpd = calloc(nvalues, sizeof(*(store.vpd)));
+    check_alloc_status(store.vpd, "Memory allocation error.");
 
+    store.wind = calloc(nvalues, sizeof(*(store.wind)));
+    check_alloc_status(store.wind, "Memory allocation error.");
+
+    store.channel_in = NULL;
     if (options.LAKES) {
-        force->channel_in = calloc(NR + 1, sizeof(*(force->channel_in)));
-        check_alloc_status(force->channel_in, "Memory allocation error.");
+        store.channel_in = calloc(nvalues, sizeof(*(store.channel_in)));
+        check_alloc_status(store.channel_in, "Memory allocation error.");
     }
+
+    store.Catm = NULL;
+    store.coszen = NULL;
+    store.fdir = NULL;
+    store.par = NULL;
     if (options.CARBON) {
-        force->Catm = calloc(NR + 1, sizeof(*(force->Catm)));
-        check_alloc_status(force->Catm, "Memory allocation error.");
+        store.Catm = calloc(nvalues, sizeof(*(store.Catm)));
+        check_alloc_status(store.Catm, "Memory allocation error.");
 
-        force->coszen = calloc(NR + 1, sizeof(*(force->coszen)));
-        check_alloc_status(force->coszen, "Memory allocation error.");
+        store.coszen = calloc(nvalues, sizeof(*(store.coszen)));
+        check_alloc_status(store.coszen, "Memory allocation error.");
 
-        force->fdir = calloc(NR + 1, sizeof(*(force->fdir)));
-        check_alloc_status(force->fdir, "Memory allocation error.");
+        store.fdir = calloc(nvalues, sizeof(*(store.fdir)));
+        check_alloc_status(store.fdir, "Memory allocation error.");
+
+        store.par = calloc(nvalues, sizeof(*(store.par)));
+        check_alloc_status(store.par, "Memory allocation error.");
+    }
 
-        force->par = calloc(NR + 1, sizeof(*(force->par)));
-        check_alloc_status(force->par, "Memory allocation error.");
+    // set up the per-cell views
+    for (i = 0; i < ncells; i++) {
+        force[i].air_temp = store.air_temp + i * (NR + 1);
+        force[i].density = store.density + i * (NR + 1);
+        force[i].longwave = store.longwave + i * (NR + 1);
+        force[i].prec = store.prec + i * (NR + 1);
+        force[i].pressure = store.pressure + i * (NR + 1);
+        force[i].shortwave = store.shortwave + i * (NR + 1);
+        force[i].snowflag = store.snowflag + i * (NR + 1);
+        force[i].vp = store.vp + i * (NR + 1);
+        force[i].vpd = store.vpd + i * (NR + 1);
+        force[i].wind = store.wind + i * (NR + 1);
+        if (options.LAKES) {
+            force[i].channel_in = store.channel_in + i * (NR + 1);
+        }
+        if (options.CARBON) {
+            force[i].Catm = store.Catm + i * (NR + 1);
+            force[i].coszen = store.coszen + i * (NR + 1);
+            force[i].fdir = store.fdir + i * (NR + 1);
+            force[i].par = store.par + i * (NR + 1);
+        }
     }
 }
 
 /******************************************************************************
- * @brief    Free memory for the force data structure.
+ * @brief    Free memory for the force data structures of all local cells.
+ * @details  The views of the first cell point to the start of the shared
+ *           storage allocated by alloc_force.
  *****************************************************************************/
 void
-free_force(force_data_struct *force)
+free_force(force_data_struct *force,
+           size_t             ncells)
 {
     extern option_struct options;
 
-    if (force == NULL) {
+    if (force == NULL || ncells == 0) {
         return;
     }
 
-    free(force->air_temp);
-    free(force->density);
-    free(force->longwave);
-    free(force->prec);
-    free(force->pressure);
-    free(force->shortwave);
-    free(force->snowflag);
-    free(force->vp);
-    free(force->vpd);
-    free(force->wind);
+    free(force[0].air_temp);
+    free(force[0].density);
+    free(force[0].longwave);
+    free(force[0].prec);
+    free(force[0].pressure);
+    free(force[0].shortwave);
+    free(force[0].snowflag);
+    free(force[0].vp);
+    free(force[0].vpd);
+    free(force[0].wind);
     if (options.LAKES) {
-        free(force->channel_in);
+        free(force[0].channel_in);
     }
     if (options.CARBON) {
-        free(force->Catm);
-        free(force->coszen);
-        free(force->fdir);
-        free(force->par);
+        free(force[0].Catm);
+        free(force[0].coszen);
+        free(force[0].fdir);
+        free(force[0].par);
     }
 }
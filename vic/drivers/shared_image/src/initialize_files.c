@@ -42,6 +42,8 @@ initialize_filenames()
     strcpy(filenames.statefile, "MISSING");
     strcpy(filenames.constants, "MISSING");
     strcpy(filenames.params, "MISSING");
+    strcpy(filenames.param_cache, "MISSING");
+    strcpy(filenames.routing, "MISSING");
     strcpy(filenames.result_dir, "MISSING");
     strcpy(filenames.log_path, "MISSING");
     for (i = 0; i < 2; i++) {
@@ -55,6 +55,7 @@ parse_output_info(FILE           *gp,
     int                        freq_n;
     dmy_struct                 freq_dmy;
     unsigned short int         agg_type;
+    double                     aggparam[3];
     int                        found;
 
     streamnum = -1;
@@ -184,6 +185,148 @@ parse_output_info(FILE           *gp,
                     (*streams)[streamnum].compress = atoi(flgstr);
                 }
             }
+            else if (strcasecmp("SHUFFLE", optstr) == 0) {
+                if (streamnum < 0) {
+                    log_err("Error in global param file: \"OUTFILE\" must be "
+                            "specified before you can specify \"SHUFFLE\".");
+                }
+                sscanf(cmdstr, "%*s %s", flgstr);
+                (*streams)[streamnum].shuffle = str_to_bool(flgstr);
+            }
+            else if (strcasecmp("GATHERED", optstr) == 0) {
+                if (streamnum < 0) {
+                    log_err("Error in global param file: \"OUTFILE\" must be "
+                            "specified before you can specify \"GATHERED\".");
+                }
+                sscanf(cmdstr, "%*s %s", flgstr);
+                (*streams)[streamnum].gathered = str_to_bool(flgstr);
+            }
+            else if (strcasecmp("SUBSET", optstr) == 0) {
+                if (streamnum < 0) {
+                    log_err("Error in global param file: \"OUTFILE\" must be "
+                            "specified before you can specify \"SUBSET\".");
+                }
+                found = sscanf(cmdstr, "%*s %s", flgstr);
+                if (found != 1 || strcasecmp("FALSE", flgstr) == 0) {
+                    (*streams)[streamnum].subset = SUBSET_NONE;
+                }
+                else if (strcasecmp("BBOX", flgstr) == 0) {
+                    (*streams)[streamnum].subset = SUBSET_BBOX;
+                    found = sscanf(cmdstr, "%*s %*s %lf %lf %lf %lf",
+                                   &((*streams)[streamnum].subset_bounds[0]),
+                                   &((*streams)[streamnum].subset_bounds[1]),
+                                   &((*streams)[streamnum].subset_bounds[2]),
+                                   &((*streams)[streamnum].subset_bounds[3]));
+                    if (found != 4 ||
+                        (*streams)[streamnum].subset_bounds[0] >
+                        (*streams)[streamnum].subset_bounds[1] ||
+                        (*streams)[streamnum].subset_bounds[2] >
+                        (*streams)[streamnum].subset_bounds[3]) {
+                        log_err("SUBSET BBOX must be followed by the south, "
+                                "north, west and east bounds");
+                    }
+                }
+                else if (strcasecmp("MASK", flgstr) == 0) {
+                    (*streams)[streamnum].subset = SUBSET_MASK;
+                    found = sscanf(cmdstr, "%*s %*s %s %s",
+                                   (*streams)[streamnum].subset_file,
+                                   (*streams)[streamnum].subset_var);
+                    if (found != 2) {
+                        log_err("SUBSET MASK must be followed by a netCDF "
+                                "file and a mask variable");
+                    }
+                }
+                else if (strcasecmp("CELLS", flgstr) == 0) {
+                    (*streams)[streamnum].subset = SUBSET_CELLS;
+                    found = sscanf(cmdstr, "%*s %*s %s",
+                                   (*streams)[streamnum].subset_file);
+                    if (found != 1) {
+                        log_err("SUBSET CELLS must be followed by a file "
+                                "with a list of grid cell indices");
+                    }
+                }
+                else {
+                    log_err("Unknown SUBSET type: %s. Valid options are "
+                            "BBOX, MASK, CELLS and FALSE", flgstr);
+                }
+            }
+            else if (strcasecmp("REGION", optstr) == 0) {
+                if (streamnum < 0) {
+                    log_err("Error in global param file: \"OUTFILE\" must be "
+                            "specified before you can specify \"REGION\".");
+                }
+                found = sscanf(cmdstr, "%*s %s", flgstr);
+                if (found != 1 || strcasecmp("FALSE", flgstr) == 0) {
+                    (*streams)[streamnum].region = REGION_NONE;
+                }
+                else if (strcasecmp("MEAN", flgstr) == 0 ||
+                         strcasecmp("SUM", flgstr) == 0) {
+                    if (strcasecmp("MEAN", flgstr) == 0) {
+                        (*streams)[streamnum].region = REGION_MEAN;
+                    }
+                    else {
+                        (*streams)[streamnum].region = REGION_SUM;
+                    }
+                    found = sscanf(cmdstr, "%*s %*s %s %s",
+                                   (*streams)[streamnum].region_file,
+                                   (*streams)[streamnum].region_var);
+                    if (found != 2) {
+                        log_err("REGION %s must be followed by a netCDF file "
+                                "and a region id variable", flgstr);
+                    }
+                }
+                else {
+                    log_err("Unknown REGION type: %s. Valid options are "
+                            "MEAN, SUM and FALSE", flgstr);
+                }
+            }
+            else if (strcasecmp("CHUNKSIZES", optstr) == 0) {
+                if (streamnum < 0) {
+                    log_err("Error in global param file: \"OUTFILE\" must be "
+                            "specified before you can specify "
+                            "\"CHUNKSIZES\".");
+                }
+                found = sscanf(cmdstr, "%*s %zu %zu %zu",
+                               &((*streams)[streamnum].chunksizes[0]),
+                               &((*streams)[streamnum].chunksizes[1]),
+                               &((*streams)[streamnum].chunksizes[2]));
+                if (found != 3 ||
+                    (*streams)[streamnum].chunksizes[0] == 0 ||
+                    (*streams)[streamnum].chunksizes[1] == 0 ||
+                    (*streams)[streamnum].chunksizes[2] == 0) {
+                    log_err("CHUNKSIZES must be followed by three positive "
+                            "chunk lengths along time, y and x");
+                }
+            }
+            else if (strcasecmp("QUANTIZE", optstr) == 0) {
+                if (streamnum < 0) {
+                    log_err("Error in global param file: \"OUTFILE\" must be "
+                            "specified before you can specify \"QUANTIZE\".");
+                }
+                found = sscanf(cmdstr, "%*s %s %d", flgstr,
+                               &((*streams)[streamnum].quantize_nsd));
+                if (found >= 1 && strcasecmp("FALSE", flgstr) == 0) {
+                    (*streams)[streamnum].quantize = QUANTIZE_NONE;
+                }
+                else if (found != 2 ||
+                         (*streams)[streamnum].quantize_nsd <= 0) {
+                    log_err("QUANTIZE must be followed by a method and a "
+                            "positive number of significant digits or bits");
+                }
+                else if (strcasecmp("BITGROOM", flgstr) == 0) {
+                    (*streams)[streamnum].quantize = QUANTIZE_BITGROOM;
+                }
+                else if (strcasecmp("GRANULARBR", flgstr) == 0) {
+                    (*streams)[streamnum].quantize = QUANTIZE_GRANULARBR;
+                }
+                else if (strcasecmp("BITROUND", flgstr) == 0) {
+                    (*streams)[streamnum].quantize = QUANTIZE_BITROUND;
+                }
+                else {
+                    log_err("Unknown QUANTIZE method: %s. Valid options are "
+                            "BITGROOM, GRANULARBR and BITROUND", flgstr);
+                }
+            }
             else if (strcasecmp("OUT_FORMAT", optstr) == 0) {
                 if (streamnum < 0) {
                     log_err("Error in global param file: \"OUTFILE\" must be "
@@ -219,8 +362,10 @@ parse_output_info(FILE           *gp,
                 strcpy(typestr, "");
                 strcpy(multstr, "");
                 strcpy(aggstr, "");
-                found = sscanf(cmdstr, "%*s %s %s %s %s %s", varname,
-                               format, typestr, multstr, aggstr);
+                found = sscanf(cmdstr, "%*s %s %s %s %s %s %lf %lf %lf",
+                               varname, format, typestr, multstr, aggstr,
+                               &(aggparam[0]), &(aggparam[1]),
+                               &(aggparam[2]));
                 if (!found) {
                     log_err("OUTVAR specified but no variable was listed");
                 }
@@ -233,9 +378,45 @@ parse_output_info(FILE           *gp,
                 // Add OUTVAR to stream
                 set_output_var(&((*streams)[streamnum]), varname, outvarnum,
                                format, type, mult, agg_type);
+                // parameters of the aggregation follow the aggregation type
+                set_output_agg_param(&((*streams)[streamnum]), outvarnum,
+                                     aggparam, (size_t) max(found - 5, 0));
                 outvarnum++;
             }
         }
         fgets(cmdstr, MAXSTRING, gp);
     }
+
+    // chunking, filters and quantization need the HDF5 based file formats
+    for (streamnum = 0; streamnum < (short int) options.Noutstreams;
+         streamnum++) {
+        if ((*streams)[streamnum].file_format != NETCDF4_CLASSIC &&
+            (*streams)[streamnum].file_format != NETCDF4 &&
+            ((*streams)[streamnum].chunksizes[0] > 0 ||
+             (*streams)[streamnum].quantize != QUANTIZE_NONE)) {
+            log_warn("CHUNKSIZES and QUANTIZE are ignored for stream %s, "
+                     "they require OUT_FORMAT NETCDF4_CLASSIC or NETCDF4",
+                     (*streams)[streamnum].prefix);
+            (*streams)[streamnum].chunksizes[0] = 0;
+            (*streams)[streamnum].chunksizes[1] = 0;
+            (*streams)[streamnum].chunksizes[2] = 0;
+            (*streams)[streamnum].quantize = QUANTIZE_NONE;
+        }
+        // subset streams only store the selected cells and region streams
+        // only the regions
+        if ((*streams)[streamnum].subset != SUBSET_NONE &&
+            (*streams)[streamnum].region != REGION_NONE) {
+            log_err("SUBSET and REGION can not both be set for stream %s",
+                    (*streams)[streamnum].prefix);
+        }
+        if ((*streams)[streamnum].region != REGION_NONE &&
+            options.NMEMBERS > 1) {
+            log_err("REGION can not be set for stream %s in ensemble mode "
+                    "(ENSEMBLE_MEMBERS > 1)", (*streams)[streamnum].prefix);
+        }
+        if ((*streams)[streamnum].subset != SUBSET_NONE ||
+            (*streams)[streamnum].region != REGION_NONE) {
+            (*streams)[streamnum].gathered = true;
+        }
+    }
 }
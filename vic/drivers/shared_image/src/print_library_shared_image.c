@@ -134,6 +134,7 @@ print_nc_file(nc_file_struct *nc)
     fprintf(LOG_DEST, "\tfront_dimid    : %d\n", nc->front_dimid);
     fprintf(LOG_DEST, "\tfrost_dimid    : %d\n", nc->frost_dimid);
     fprintf(LOG_DEST, "\tlayer_dimid    : %d\n", nc->layer_dimid);
+    fprintf(LOG_DEST, "\tmember_dimid   : %d\n", nc->member_dimid);
     fprintf(LOG_DEST, "\tni_dimid       : %d\n", nc->ni_dimid);
     fprintf(LOG_DEST, "\tnj_dimid       : %d\n", nc->nj_dimid);
     fprintf(LOG_DEST, "\tnode_dimid     : %d\n", nc->node_dimid);
@@ -144,6 +145,7 @@ print_nc_file(nc_file_struct *nc)
     fprintf(LOG_DEST, "\tfront_size     : %zd\n", nc->front_size);
     fprintf(LOG_DEST, "\tfrost_size     : %zd\n", nc->frost_size);
     fprintf(LOG_DEST, "\tlayer_size     : %zd\n", nc->layer_size);
+    fprintf(LOG_DEST, "\tmember_size    : %zd\n", nc->member_size);
     fprintf(LOG_DEST, "\tni_size        : %zd\n", nc->ni_size);
     fprintf(LOG_DEST, "\tnj_size        : %zd\n", nc->nj_size);
     fprintf(LOG_DEST, "\tnode_size      : %zd\n", nc->node_size);
@@ -151,6 +153,8 @@ print_nc_file(nc_file_struct *nc)
     fprintf(LOG_DEST, "\ttime_size      : %zd\n", nc->time_size);
     fprintf(LOG_DEST, "\tveg_size       : %zd\n", nc->veg_size);
     fprintf(LOG_DEST, "\topen           : %d\n", nc->open);
+    fprintf(LOG_DEST, "\tnvalues        : %zd\n", nc->nvalues);
+    fprintf(LOG_DEST, "\tnext_record    : %zd\n", nc->next_record);
 }
 
 /******************************************************************************
@@ -46,9 +46,17 @@ vic_alloc(void)
     extern lake_con_struct    *lake_con;
     size_t                     i;
     size_t                     j;
+    size_t                     nstates;
 
-    // allocate memory for force structure
-    force = malloc(local_domain.ncells_active * sizeof(*force));
+    // The forcing, state and output of each ensemble member are kept apart,
+    // member m of cell i at m * ncells_active + i. The parameters are
+    // shared by all members of a cell.
+    nstates = local_domain.ncells_active * options.NMEMBERS;
+
+    // allocate memory for force structure. The forcing of all cells is
+    // addressed through force[0], so keep one element even if this process
+    // has no cells (e.g. the master process with IO_SERVER = TRUE)
+    force = calloc(nstates > 0 ? nstates : 1, sizeof(*force));
     check_alloc_status(force, "Memory allocation error.");
 
     // allocate memory for veg_hist structure
@@ -78,22 +86,22 @@ vic_alloc(void)
     }
 
     // all_vars allocation
-    all_vars = malloc(local_domain.ncells_active * sizeof(*all_vars));
+    all_vars = malloc(nstates * sizeof(*all_vars));
     check_alloc_status(all_vars, "Memory allocation error.");
 
     // out_data allocation
-    out_data = malloc(local_domain.ncells_active * sizeof(*out_data));
+    out_data = malloc(nstates * sizeof(*out_data));
     check_alloc_status(out_data, "Memory allocation error.");
 
     // save_data allocation
-    save_data = malloc(local_domain.ncells_active * sizeof(*save_data));
+    save_data = malloc(nstates * sizeof(*save_data));
     check_alloc_status(save_data, "Memory allocation error.");
 
+    // force allocation - allocate enough memory for NR+1 steps
+    alloc_force(force, nstates);
+
     // allocate memory for individual grid cells
     for (i = 0; i < local_domain.ncells_active; i++) {
-        // force allocation - allocate enough memory for NR+1 steps
-        alloc_force(&(force[i]));
-
         // snow band allocation
         soil_con[i].AreaFract = calloc(options.SNOW_BAND,
                                        sizeof(*(soil_con[i].AreaFract)));
@@ -158,7 +166,10 @@ vic_alloc(void)
         veg_lib[i] = calloc(options.NVEGTYPES, sizeof(*(veg_lib[i])));
         check_alloc_status(veg_lib[i], "Memory allocation error.");
 
-        all_vars[i] = make_all_vars(veg_con_map[i].nv_active);
+        for (j = 0; j < options.NMEMBERS; j++) {
+            all_vars[j * local_domain.ncells_active + i] =
+                make_all_vars(veg_con_map[i].nv_active);
+        }
 
         // allocate memory for veg_hist
         veg_hist[i] = calloc(veg_con_map[i].nv_active, sizeof(*(veg_hist[i])));
@@ -47,11 +47,11 @@ vic_finalize(void)
     extern double           ***out_data;
     extern stream_struct      *output_streams;
     extern save_data_struct   *save_data;
+    extern state_stage_struct *state_stages;
     extern soil_con_struct    *soil_con;
     extern veg_con_map_struct *veg_con_map;
     extern veg_con_struct    **veg_con;
     extern veg_hist_struct   **veg_hist;
-    extern veg_lib_struct    **veg_lib;
     extern MPI_Datatype        mpi_global_struct_type;
     extern MPI_Datatype        mpi_filenames_struct_type;
     extern MPI_Datatype        mpi_location_struct_type;
@@ -61,8 +61,49 @@ vic_finalize(void)
 
     size_t                     i;
     size_t                     j;
+    size_t                     nstates;
     int                        status;
 
+    // write history records and state files that are still pending
+    vic_write_flush();
+    vic_store_flush();
+
+    if (state_stages != NULL) {
+        for (i = 0; i < options.NMEMBERS; i++) {
+            free(state_stages[i].send);
+            free(state_stages[i].recv);
+            free(state_stages[i].counts);
+            free(state_stages[i].displs);
+        }
+        free(state_stages);
+    }
+
+    for (i = 0; i < options.Noutstreams; i++) {
+        for (j = 0; j < NHISTRECORDS; j++) {
+            free(nc_hist_files[i].records[j].send);
+            free(nc_hist_files[i].records[j].recv);
+        }
+        free(nc_hist_files[i].records);
+        free(nc_hist_files[i].gather_counts);
+        free(nc_hist_files[i].gather_offsets);
+        free(nc_hist_files[i].remapped);
+        free(nc_hist_files[i].d_grid);
+        free(nc_hist_files[i].f_grid);
+        free(nc_hist_files[i].i_grid);
+        free(nc_hist_files[i].s_grid);
+        free(nc_hist_files[i].c_grid);
+        free(nc_hist_files[i].cell_region);
+        free(nc_hist_files[i].cell_area);
+        free(nc_hist_files[i].region_ids);
+        free(nc_hist_files[i].region_area);
+        if (mpi_rank == VIC_MPI_ROOT &&
+            output_streams[i].subset != SUBSET_NONE) {
+            free(nc_hist_files[i].cell_grid_idx);
+            free(nc_hist_files[i].cell_map);
+            free(nc_hist_files[i].cell_counts);
+            free(nc_hist_files[i].cell_offsets);
+        }
+    }
 
     if (mpi_rank == VIC_MPI_ROOT) {
         // close the global parameter file
@@ -79,8 +120,10 @@ vic_finalize(void)
         free(nc_hist_files);
     }
 
+    nstates = local_domain.ncells_active * options.NMEMBERS;
+
+    free_force(force, nstates);
     for (i = 0; i < local_domain.ncells_active; i++) {
-        free_force(&(force[i]));
         free(soil_con[i].AreaFract);
         free(soil_con[i].BandElev);
         free(soil_con[i].Tfactor);
@@ -94,22 +137,24 @@ vic_finalize(void)
             }
             free_veg_hist(&(veg_hist[i][j]));
         }
-        free_all_vars(&(all_vars[i]), veg_con_map[i].nv_active);
+        for (j = 0; j < options.NMEMBERS; j++) {
+            free_all_vars(&(all_vars[j * local_domain.ncells_active + i]),
+                          veg_con_map[i].nv_active);
+        }
         free(veg_con_map[i].vidx);
         free(veg_con_map[i].Cv);
         free(veg_con[i]);
         free(veg_hist[i]);
-        free(veg_lib[i]);
     }
 
     free_streams(&output_streams);
-    free_out_data(local_domain.ncells_active, out_data);
+    free_out_data(nstates, out_data);
     free(force);
     free(soil_con);
     free(veg_con_map);
     free(veg_con);
     free(veg_hist);
-    free(veg_lib);
+    free_veg_lib();
     free(all_vars);
     free(save_data);
     free(local_domain.locations);
@@ -119,6 +164,7 @@ vic_finalize(void)
         free(mpi_map_local_array_sizes);
         free(mpi_map_global_array_offsets);
         free(mpi_map_mapping_array);
+        mpi_map_free_buffers();
     }
 
     MPI_Type_free(&mpi_global_struct_type);
@@ -46,32 +46,47 @@ vic_image_run(dmy_struct *dmy_current)
     extern veg_con_struct    **veg_con;
     extern veg_hist_struct   **veg_hist;
     extern veg_lib_struct    **veg_lib;
+    extern spinup_struct       spinup;
 
     char                       dmy_str[MAXSTRING];
     size_t                     i;
+    size_t                     c;
     timer_struct               timer;
 
     // Print the current timestep info before running vic_run
     sprint_dmy(dmy_str, dmy_current);
     debug("Running timestep %zu: %s", current, dmy_str);
 
-    for (i = 0; i < local_domain.ncells_active; i++) {
+    // the members of an ensemble share the parameters of a cell: member m
+    // of cell c is run as i = m * ncells_active + c
+    for (i = 0; i < local_domain.ncells_active * options.NMEMBERS; i++) {
+        c = i % local_domain.ncells_active;
+
+        // cells that have converged during spin-up are no longer run
+        if (spinup.retired != NULL && spinup.retired[i]) {
+            continue;
+        }
+
         // Set global reference string (for debugging inside vic_run)
-        sprintf(vic_run_ref_str, "Gridcell io_idx: %zu, timestep info: %s",
-                local_domain.locations[i].io_idx, dmy_str);
+        sprintf(vic_run_ref_str, "Gridcell io_idx: %zu, member: %zu, "
+                "timestep info: %s", local_domain.locations[c].io_idx,
+                i / local_domain.ncells_active, dmy_str);
 
-        update_step_vars(&(all_vars[i]), veg_con[i], veg_hist[i]);
+        update_step_vars(&(all_vars[i]), veg_con[c], veg_hist[c]);
 
         timer_start(&timer);
         vic_run(&(force[i]), &(all_vars[i]), dmy_current, &global_param,
-                &lake_con, &(soil_con[i]), veg_con[i], veg_lib[i]);
+                &lake_con, &(soil_con[c]), veg_con[c], veg_lib[c]);
         timer_stop(&timer);
 
-        put_data(&(all_vars[i]), &(force[i]), &(soil_con[i]), veg_con[i],
-                 veg_lib[i], &lake_con, out_data[i], &(save_data[i]),
+        put_data(&(all_vars[i]), &(force[i]), &(soil_con[c]), veg_con[c],
+                 veg_lib[c], &lake_con, out_data[i], &(save_data[i]),
                  &timer);
     }
-    for (i = 0; i < options.Noutstreams; i++) {
-        agg_stream_data(&(output_streams[i]), dmy_current, out_data);
+    // no history output is aggregated during spin-up
+    if (spinup.retired == NULL) {
+        for (i = 0; i < options.Noutstreams; i++) {
+            agg_stream_data(&(output_streams[i]), dmy_current, out_data);
+        }
     }
 }
@@ -28,12 +28,65 @@
 
 /******************************************************************************
  * @brief    Initialize model parameters
+ * @details  Model parameters are taken from the parameter cache when it
+ *           matches the current setup. Otherwise they are read from the
+ *           parameter file and the cache is (re)written if one is configured.
  *****************************************************************************/
 void
 vic_init(void)
 {
-    extern all_vars_struct    *all_vars;
-    extern size_t              current;
+    extern all_vars_struct *all_vars;
+    extern size_t           current;
+    extern domain_struct    local_domain;
+    extern option_struct    options;
+    extern soil_con_struct *soil_con;
+    extern veg_con_struct **veg_con;
+    extern lake_con_struct *lake_con;
+
+    size_t                  i;
+    size_t                  nveg;
+    int                     tmp_lake_idx;
+
+    // start the clock
+    current = 0;
+
+    if (!read_param_cache()) {
+        vic_init_params();
+        write_param_cache();
+    }
+
+    // the vegetation libraries are read-only from here on
+    share_veg_lib();
+
+    // initialize state variables with default values
+    for (i = 0; i < local_domain.ncells_active; i++) {
+        nveg = veg_con[i][0].vegetat_type_num;
+        initialize_snow(all_vars[i].snow, nveg);
+        initialize_soil(all_vars[i].cell, nveg);
+        initialize_veg(all_vars[i].veg_var, nveg);
+        if (options.LAKES) {
+            tmp_lake_idx = (int)lake_con[i].lake_idx;
+            if (tmp_lake_idx < 0) {
+                tmp_lake_idx = 0;
+            }
+            initialize_lake(&(all_vars[i].lake_var), &(lake_con[i]),
+                            &(soil_con[i]),
+                            &(all_vars[i].cell[tmp_lake_idx][0]), false);
+        }
+        initialize_energy(all_vars[i].energy, nveg);
+    }
+
+    // set state metadata structure
+    set_state_meta_data_info();
+}
+
+/******************************************************************************
+ * @brief    Read model parameters from the parameter file and derive the
+ *           dependent soil, vegetation and lake parameters
+ *****************************************************************************/
+void
+vic_init_params(void)
+{
     extern domain_struct       global_domain;
     extern domain_struct       local_domain;
     extern option_struct       options;
@@ -44,20 +97,26 @@ vic_init(void)
     extern veg_lib_struct    **veg_lib;
     extern lake_con_struct    *lake_con;
     extern parameters_struct   param;
+    extern int                 mpi_rank;
 
     bool                       found;
     char                       locstr[MAXSTRING];
     double                     mean;
     double                     sum;
     double                    *Cv_sum = NULL;
+    double                    *dblock = NULL;
     double                    *dvar = NULL;
+    int                       *iblock = NULL;
     int                       *ivar = NULL;
+    int                        nc_id;
+    int                        status;
     size_t                     i;
     size_t                     j;
     size_t                     k;
     size_t                     m;
     size_t                     nveg;
     size_t                     max_numnod;
+    size_t                     max_nblock;
     size_t                     Nnodes;
     int                        vidx;
     size_t                     d2count[2];
@@ -66,7 +125,6 @@ vic_init(void)
     size_t                     d3start[3];
     size_t                     d4count[4];
     size_t                     d4start[4];
-    int                        tmp_lake_idx;
     double                     Zsum, dp;
     double                     tmpdp, tmpadj, Bexp;
 
@@ -74,15 +132,29 @@ vic_init(void)
     Cv_sum = malloc(local_domain.ncells_active * sizeof(*Cv_sum));
     check_alloc_status(Cv_sum, "Memory allocation error.");
 
-    // allocate memory for variables to be read
-    dvar = malloc(local_domain.ncells_active * sizeof(*dvar));
-    check_alloc_status(dvar, "Memory allocation error.");
-    ivar = malloc(local_domain.ncells_active * sizeof(*ivar));
-    check_alloc_status(ivar, "Memory allocation error.");
-
-    // The method used to convert the NetCDF fields to VIC structures for
-    // individual grid cells is to read a 2D slice and then loop over the
-    // domain cells to assign the values to the VIC structures
+    // allocate memory for variables to be read. Each parameter is read as a
+    // single block covering all of its leading dimensions (veg class, month,
+    // layer, ...), so the buffers are sized for the largest such block.
+    max_nblock = options.NVEGTYPES * MONTHS_PER_YEAR;
+    max_nblock = max(max_nblock, options.NVEGTYPES * options.ROOT_ZONES);
+    max_nblock = max(max_nblock, options.Nlayer);
+    max_nblock = max(max_nblock, options.SNOW_BAND);
+    max_nblock = max(max_nblock, options.NLAKENODES);
+    dblock = malloc(max_nblock * local_domain.ncells_active *
+                    sizeof(*dblock));
+    check_alloc_status(dblock, "Memory allocation error.");
+    iblock = malloc(max_nblock * local_domain.ncells_active *
+                    sizeof(*iblock));
+    check_alloc_status(iblock, "Memory allocation error.");
+
+    // The parameter file is opened once on the root process. Each NetCDF
+    // variable is read as one hyperslab and distributed with one scatter;
+    // dvar and ivar then point at the [cell] slice for the current leading
+    // indices while the values are assigned to the VIC structures
+    if (mpi_rank == VIC_MPI_ROOT) {
+        status = nc_open(filenames.params, NC_NOWRITE, &nc_id);
+        check_nc_status(status, "Error opening %s", filenames.params);
+    }
 
     d2start[0] = 0;
     d2start[1] = 0;
@@ -92,7 +164,7 @@ vic_init(void)
     d3start[0] = 0;
     d3start[1] = 0;
     d3start[2] = 0;
-    d3count[0] = 1;
+    d3count[0] = options.NVEGTYPES;
     d3count[1] = global_domain.n_ny;
     d3count[2] = global_domain.n_nx;
 
@@ -100,14 +172,11 @@ vic_init(void)
     d4start[1] = 0;
     d4start[2] = 0;
     d4start[3] = 0;
-    d4count[0] = 1;
-    d4count[1] = 1;
+    d4count[0] = options.NVEGTYPES;
+    d4count[1] = MONTHS_PER_YEAR;
     d4count[2] = global_domain.n_ny;
     d4count[3] = global_domain.n_nx;
 
-    // start the clock
-    current = 0;
-
     // read_veglib()
 
     // Assign veg class ids
@@ -121,80 +190,83 @@ vic_init(void)
     }
 
     // overstory
+    d3count[0] = options.NVEGTYPES;
+    get_scatter_nc_block_int(nc_id, "overstory", 3, d3start, d3count, iblock);
     for (j = 0; j < options.NVEGTYPES; j++) {
-        d3start[0] = j;
-        get_scatter_nc_field_int(filenames.params, "overstory",
-                                 d3start, d3count, ivar);
+        ivar = iblock + j * local_domain.ncells_active;
         for (i = 0; i < local_domain.ncells_active; i++) {
             veg_lib[i][j].overstory = ivar[i];
         }
     }
 
     // rarc
+    d3count[0] = options.NVEGTYPES;
+    get_scatter_nc_block_double(nc_id, "rarc", 3, d3start, d3count, dblock);
     for (j = 0; j < options.NVEGTYPES; j++) {
-        d3start[0] = j;
-        get_scatter_nc_field_double(filenames.params, "rarc",
-                                    d3start, d3count, dvar);
+        dvar = dblock + j * local_domain.ncells_active;
         for (i = 0; i < local_domain.ncells_active; i++) {
             veg_lib[i][j].rarc = (double) dvar[i];
         }
     }
 
     // rmin
+    d3count[0] = options.NVEGTYPES;
+    get_scatter_nc_block_double(nc_id, "rmin", 3, d3start, d3count, dblock);
     for (j = 0; j < options.NVEGTYPES; j++) {
-        d3start[0] = j;
-        get_scatter_nc_field_double(filenames.params, "rmin",
-                                    d3start, d3count, dvar);
+        dvar = dblock + j * local_domain.ncells_active;
         for (i = 0; i < local_domain.ncells_active; i++) {
             veg_lib[i][j].rmin = (double) dvar[i];
         }
     }
 
     // wind height
+    d3count[0] = options.NVEGTYPES;
+    get_scatter_nc_block_double(nc_id, "wind_h", 3, d3start, d3count, dblock);
     for (j = 0; j < options.NVEGTYPES; j++) {
-        d3start[0] = j;
-        get_scatter_nc_field_double(filenames.params, "wind_h",
-                                    d3start, d3count, dvar);
+        dvar = dblock + j * local_domain.ncells_active;
         for (i = 0; i < local_domain.ncells_active; i++) {
             veg_lib[i][j].wind_h = (double) dvar[i];
         }
     }
 
     // RGL
+    d3count[0] = options.NVEGTYPES;
+    get_scatter_nc_block_double(nc_id, "RGL", 3, d3start, d3count, dblock);
     for (j = 0; j < options.NVEGTYPES; j++) {
-        d3start[0] = j;
-        get_scatter_nc_field_double(filenames.params, "RGL",
-                                    d3start, d3count, dvar);
+        dvar = dblock + j * local_domain.ncells_active;
         for (i = 0; i < local_domain.ncells_active; i++) {
             veg_lib[i][j].RGL = (double)dvar[i];
         }
     }
 
     // rad_atten
+    d3count[0] = options.NVEGTYPES;
+    get_scatter_nc_block_double(nc_id, "rad_atten", 3, d3start, d3count,
+                                dblock);
     for (j = 0; j < options.NVEGTYPES; j++) {
-        d3start[0] = j;
-        get_scatter_nc_field_double(filenames.params, "rad_atten",
-                                    d3start, d3count, dvar);
+        dvar = dblock + j * local_domain.ncells_active;
         for (i = 0; i < local_domain.ncells_active; i++) {
             veg_lib[i][j].rad_atten = (double) dvar[i];
         }
     }
 
     // wind_atten
+    d3count[0] = options.NVEGTYPES;
+    get_scatter_nc_block_double(nc_id, "wind_atten", 3, d3start, d3count,
+                                dblock);
     for (j = 0; j < options.NVEGTYPES; j++) {
-        d3start[0] = j;
-        get_scatter_nc_field_double(filenames.params, "wind_atten",
-                                    d3start, d3count, dvar);
+        dvar = dblock + j * local_domain.ncells_active;
         for (i = 0; i < local_domain.ncells_active; i++) {
             veg_lib[i][j].wind_atten = (double) dvar[i];
         }
     }
 
     // trunk_ratio
+    d3count[0] = options.NVEGTYPES;
+    get_scatter_nc_block_double(nc_id, "trunk_ratio", 3, d3start, d3count,
+                                dblock);
     for (j = 0; j < options.NVEGTYPES; j++) {
-        d3start[0] = j;
-        get_scatter_nc_field_double(filenames.params, "trunk_ratio",
-                                    d3start, d3count, dvar);
+        dvar = dblock + j * local_domain.ncells_active;
         for (i = 0; i < local_domain.ncells_active; i++) {
             veg_lib[i][j].trunk_ratio = (double) dvar[i];
         }
@@ -202,12 +274,13 @@ vic_init(void)
 
     // LAI and Wdmax
     if (options.LAI_SRC == FROM_VEGLIB || options.LAI_SRC == FROM_VEGPARAM) {
+        d4count[1] = MONTHS_PER_YEAR;
+        get_scatter_nc_block_double(nc_id, "LAI", 4, d4start, d4count,
+                                    dblock);
         for (j = 0; j < options.NVEGTYPES; j++) {
-            d4start[0] = j;
             for (k = 0; k < MONTHS_PER_YEAR; k++) {
-                d4start[1] = k;
-                get_scatter_nc_field_double(filenames.params, "LAI",
-                                            d4start, d4count, dvar);
+                dvar = dblock + (j * MONTHS_PER_YEAR + k) *
+                       local_domain.ncells_active;
                 for (i = 0; i < local_domain.ncells_active; i++) {
                     veg_lib[i][j].LAI[k] = (double) dvar[i];
                     veg_lib[i][j].Wdmax[k] = param.VEG_LAI_WATER_FACTOR *
@@ -219,12 +292,13 @@ vic_init(void)
 
     // albedo
     if (options.ALB_SRC == FROM_VEGLIB || options.ALB_SRC == FROM_VEGPARAM) {
+        d4count[1] = MONTHS_PER_YEAR;
+        get_scatter_nc_block_double(nc_id, "albedo", 4, d4start, d4count,
+                                    dblock);
         for (j = 0; j < options.NVEGTYPES; j++) {
-            d4start[0] = j;
             for (k = 0; k < MONTHS_PER_YEAR; k++) {
-                d4start[1] = k;
-                get_scatter_nc_field_double(filenames.params, "albedo",
-                                            d4start, d4count, dvar);
+                dvar = dblock + (j * MONTHS_PER_YEAR + k) *
+                       local_domain.ncells_active;
                 for (i = 0; i < local_domain.ncells_active; i++) {
                     veg_lib[i][j].albedo[k] = (double) dvar[i];
                 }
@@ -233,12 +307,13 @@ vic_init(void)
     }
 
     // veg_rough
+    d4count[1] = MONTHS_PER_YEAR;
+    get_scatter_nc_block_double(nc_id, "veg_rough", 4, d4start, d4count,
+                                dblock);
     for (j = 0; j < options.NVEGTYPES; j++) {
-        d4start[0] = j;
         for (k = 0; k < MONTHS_PER_YEAR; k++) {
-            d4start[1] = k;
-            get_scatter_nc_field_double(filenames.params, "veg_rough",
-                                        d4start, d4count, dvar);
+            dvar = dblock + (j * MONTHS_PER_YEAR + k) *
+                   local_domain.ncells_active;
             for (i = 0; i < local_domain.ncells_active; i++) {
                 veg_lib[i][j].roughness[k] = (double) dvar[i];
             }
@@ -246,12 +321,13 @@ vic_init(void)
     }
 
     // displacement
+    d4count[1] = MONTHS_PER_YEAR;
+    get_scatter_nc_block_double(nc_id, "displacement", 4, d4start, d4count,
+                                dblock);
     for (j = 0; j < options.NVEGTYPES; j++) {
-        d4start[0] = j;
         for (k = 0; k < MONTHS_PER_YEAR; k++) {
-            d4start[1] = k;
-            get_scatter_nc_field_double(filenames.params, "displacement",
-                                        d4start, d4count, dvar);
+            dvar = dblock + (j * MONTHS_PER_YEAR + k) *
+                   local_domain.ncells_active;
             for (i = 0; i < local_domain.ncells_active; i++) {
                 veg_lib[i][j].displacement[k] = (double) dvar[i];
             }
@@ -259,6 +335,11 @@ vic_init(void)
     }
 
     // default value for fcanopy
+    if (options.FCAN_SRC == FROM_VEGLIB || options.FCAN_SRC == FROM_VEGPARAM) {
+        d4count[1] = MONTHS_PER_YEAR;
+        get_scatter_nc_block_double(nc_id, "fcanopy", 4, d4start, d4count,
+                                    dblock);
+    }
     for (j = 0; j < options.NVEGTYPES; j++) {
         if (options.FCAN_SRC == FROM_DEFAULT) {
             for (k = 0; k < MONTHS_PER_YEAR; k++) {
@@ -275,11 +356,9 @@ vic_init(void)
         }
         else if (options.FCAN_SRC == FROM_VEGLIB ||
                  options.FCAN_SRC == FROM_VEGPARAM) {
-            d4start[0] = j;
             for (k = 0; k < MONTHS_PER_YEAR; k++) {
-                d4start[1] = k;
-                get_scatter_nc_field_double(filenames.params, "fcanopy",
-                                            d4start, d4count, dvar);
+                dvar = dblock + (j * MONTHS_PER_YEAR + k) *
+                       local_domain.ncells_active;
                 for (i = 0; i < local_domain.ncells_active; i++) {
                     veg_lib[i][j].fcanopy[k] = (double) dvar[i];
                 }
@@ -290,10 +369,10 @@ vic_init(void)
     // read carbon cycle parameters
     if (options.CARBON) {
         // Ctype
+        d3count[0] = options.NVEGTYPES;
+        get_scatter_nc_block_int(nc_id, "Ctype", 3, d3start, d3count, iblock);
         for (j = 0; j < options.NVEGTYPES; j++) {
-            d3start[0] = j;
-            get_scatter_nc_field_int(filenames.params, "Ctype",
-                                     d3start, d3count, ivar);
+            ivar = iblock + j * local_domain.ncells_active;
             for (i = 0; i < local_domain.ncells_active; i++) {
                 veg_lib[i][j].Ctype = ivar[i];
                 if (veg_lib[i][j].Ctype != PHOTO_C3 &&
@@ -306,10 +385,11 @@ vic_init(void)
             }
         }
         // MaxCarboxRate
+        d3count[0] = options.NVEGTYPES;
+        get_scatter_nc_block_double(nc_id, "MaxCarboxRate", 3, d3start, d3count,
+                                    dblock);
         for (j = 0; j < options.NVEGTYPES; j++) {
-            d3start[0] = j;
-            get_scatter_nc_field_double(filenames.params, "MaxCarboxRate",
-                                        d3start, d3count, dvar);
+            dvar = dblock + j * local_domain.ncells_active;
             for (i = 0; i < local_domain.ncells_active; i++) {
                 veg_lib[i][j].MaxCarboxRate = (double) dvar[i];
                 if (veg_lib[i][j].MaxCarboxRate < 0) {
@@ -320,10 +400,11 @@ vic_init(void)
             }
         }
         // MaxETransport or CO2Specificity
+        d3count[0] = options.NVEGTYPES;
+        get_scatter_nc_block_double(nc_id, "MaxiE_or_CO2Spec", 3, d3start,
+                                    d3count, dblock);
         for (j = 0; j < options.NVEGTYPES; j++) {
-            d3start[0] = j;
-            get_scatter_nc_field_double(filenames.params, "MaxiE_or_CO2Spec",
-                                        d3start, d3count, dvar);
+            dvar = dblock + j * local_domain.ncells_active;
             for (i = 0; i < local_domain.ncells_active; i++) {
                 if (dvar[i] < 0) {
                     log_err("cell %zu veg %zu: MaxE_of_CO2Spec is %f "
@@ -340,10 +421,10 @@ vic_init(void)
             }
         }
         // LightUseEff
+        d3count[0] = options.NVEGTYPES;
+        get_scatter_nc_block_double(nc_id, "LUE", 3, d3start, d3count, dblock);
         for (j = 0; j < options.NVEGTYPES; j++) {
-            d3start[0] = j;
-            get_scatter_nc_field_double(filenames.params, "LUE",
-                                        d3start, d3count, dvar);
+            dvar = dblock + j * local_domain.ncells_active;
             for (i = 0; i < local_domain.ncells_active; i++) {
                 veg_lib[i][j].LightUseEff = (double) dvar[i];
                 if (veg_lib[i][j].LightUseEff < 0 ||
@@ -355,10 +436,10 @@ vic_init(void)
             }
         }
         // Nscale flag
+        d3count[0] = options.NVEGTYPES;
+        get_scatter_nc_block_int(nc_id, "Nscale", 3, d3start, d3count, iblock);
         for (j = 0; j < options.NVEGTYPES; j++) {
-            d3start[0] = j;
-            get_scatter_nc_field_int(filenames.params, "Nscale",
-                                     d3start, d3count, ivar);
+            ivar = iblock + j * local_domain.ncells_active;
             for (i = 0; i < local_domain.ncells_active; i++) {
                 veg_lib[i][j].NscaleFlag = ivar[i];
                 if (veg_lib[i][j].NscaleFlag != 0 &&
@@ -370,10 +451,11 @@ vic_init(void)
             }
         }
         // Wnpp_inhib
+        d3count[0] = options.NVEGTYPES;
+        get_scatter_nc_block_double(nc_id, "Wnpp_inhib", 3, d3start, d3count,
+                                    dblock);
         for (j = 0; j < options.NVEGTYPES; j++) {
-            d3start[0] = j;
-            get_scatter_nc_field_double(filenames.params, "Wnpp_inhib",
-                                        d3start, d3count, dvar);
+            dvar = dblock + j * local_domain.ncells_active;
             for (i = 0; i < local_domain.ncells_active; i++) {
                 veg_lib[i][j].Wnpp_inhib = (double) dvar[i];
                 if (veg_lib[i][j].Wnpp_inhib < 0 ||
@@ -385,10 +467,11 @@ vic_init(void)
             }
         }
         // NPPfactor_sat
+        d3count[0] = options.NVEGTYPES;
+        get_scatter_nc_block_double(nc_id, "NPPfactor_sat", 3, d3start, d3count,
+                                    dblock);
         for (j = 0; j < options.NVEGTYPES; j++) {
-            d3start[0] = j;
-            get_scatter_nc_field_double(filenames.params, "NPPfactor_sat",
-                                        d3start, d3count, dvar);
+            dvar = dblock + j * local_domain.ncells_active;
             for (i = 0; i < local_domain.ncells_active; i++) {
                 veg_lib[i][j].NPPfactor_sat = (double) dvar[i];
                 if (veg_lib[i][j].NPPfactor_sat < 0 ||
@@ -429,146 +512,141 @@ vic_init(void)
     }
 
     // b_infilt
-    get_scatter_nc_field_double(filenames.params, "infilt",
-                                d2start, d2count, dvar);
+    get_scatter_nc_block_double(nc_id, "infilt", 2, d2start, d2count, dblock);
     for (i = 0; i < local_domain.ncells_active; i++) {
-        soil_con[i].b_infilt = (double) dvar[i];
+        soil_con[i].b_infilt = (double) dblock[i];
     }
 
     // Ds
-    get_scatter_nc_field_double(filenames.params, "Ds",
-                                d2start, d2count, dvar);
+    get_scatter_nc_block_double(nc_id, "Ds", 2, d2start, d2count, dblock);
     for (i = 0; i < local_domain.ncells_active; i++) {
-        soil_con[i].Ds = (double) dvar[i];
+        soil_con[i].Ds = (double) dblock[i];
     }
 
     // Dsmax
-    get_scatter_nc_field_double(filenames.params, "Dsmax",
-                                d2start, d2count, dvar);
+    get_scatter_nc_block_double(nc_id, "Dsmax", 2, d2start, d2count, dblock);
     for (i = 0; i < local_domain.ncells_active; i++) {
-        soil_con[i].Dsmax = (double) dvar[i];
+        soil_con[i].Dsmax = (double) dblock[i];
     }
 
     // Ws
-    get_scatter_nc_field_double(filenames.params, "Ws",
-                                d2start, d2count, dvar);
+    get_scatter_nc_block_double(nc_id, "Ws", 2, d2start, d2count, dblock);
     for (i = 0; i < local_domain.ncells_active; i++) {
-        soil_con[i].Ws = (double) dvar[i];
+        soil_con[i].Ws = (double) dblock[i];
     }
 
     // c
-    get_scatter_nc_field_double(filenames.params, "c",
-                                d2start, d2count, dvar);
+    get_scatter_nc_block_double(nc_id, "c", 2, d2start, d2count, dblock);
     for (i = 0; i < local_domain.ncells_active; i++) {
-        soil_con[i].c = (double) dvar[i];
+        soil_con[i].c = (double) dblock[i];
     }
 
     // expt: unsaturated hydraulic conductivity exponent for each layer
+    d3count[0] = options.Nlayer;
+    get_scatter_nc_block_double(nc_id, "expt", 3, d3start, d3count, dblock);
     for (j = 0; j < options.Nlayer; j++) {
-        d3start[0] = j;
-        get_scatter_nc_field_double(filenames.params, "expt",
-                                    d3start, d3count, dvar);
+        dvar = dblock + j * local_domain.ncells_active;
         for (i = 0; i < local_domain.ncells_active; i++) {
             soil_con[i].expt[j] = (double) dvar[i];
         }
     }
 
     // Ksat: saturated hydraulic conductivity for each layer
+    d3count[0] = options.Nlayer;
+    get_scatter_nc_block_double(nc_id, "Ksat", 3, d3start, d3count, dblock);
     for (j = 0; j < options.Nlayer; j++) {
-        d3start[0] = j;
-        get_scatter_nc_field_double(filenames.params, "Ksat",
-                                    d3start, d3count, dvar);
+        dvar = dblock + j * local_domain.ncells_active;
         for (i = 0; i < local_domain.ncells_active; i++) {
             soil_con[i].Ksat[j] = (double) dvar[i];
         }
     }
 
     // init_moist: initial soil moisture for cold start
+    d3count[0] = options.Nlayer;
+    get_scatter_nc_block_double(nc_id, "init_moist", 3, d3start, d3count,
+                                dblock);
     for (j = 0; j < options.Nlayer; j++) {
-        d3start[0] = j;
-        get_scatter_nc_field_double(filenames.params, "init_moist",
-                                    d3start, d3count, dvar);
+        dvar = dblock + j * local_domain.ncells_active;
         for (i = 0; i < local_domain.ncells_active; i++) {
             soil_con[i].init_moist[j] = (double) dvar[i];
         }
     }
 
     // phi_s
+    d3count[0] = options.Nlayer;
+    get_scatter_nc_block_double(nc_id, "phi_s", 3, d3start, d3count, dblock);
     for (j = 0; j < options.Nlayer; j++) {
-        d3start[0] = j;
-        get_scatter_nc_field_double(filenames.params, "phi_s",
-                                    d3start, d3count, dvar);
+        dvar = dblock + j * local_domain.ncells_active;
         for (i = 0; i < local_domain.ncells_active; i++) {
             soil_con[i].phi_s[j] = (double) dvar[i];
         }
     }
 
     // elevation: mean grid cell elevation
-    get_scatter_nc_field_double(filenames.params, "elev",
-                                d2start, d2count, dvar);
+    get_scatter_nc_block_double(nc_id, "elev", 2, d2start, d2count, dblock);
     for (i = 0; i < local_domain.ncells_active; i++) {
-        soil_con[i].elevation = (double) dvar[i];
+        soil_con[i].elevation = (double) dblock[i];
     }
 
     // depth: thickness for each soil layer
+    d3count[0] = options.Nlayer;
+    get_scatter_nc_block_double(nc_id, "depth", 3, d3start, d3count, dblock);
     for (j = 0; j < options.Nlayer; j++) {
-        d3start[0] = j;
-        get_scatter_nc_field_double(filenames.params, "depth",
-                                    d3start, d3count, dvar);
+        dvar = dblock + j * local_domain.ncells_active;
         for (i = 0; i < local_domain.ncells_active; i++) {
             soil_con[i].depth[j] = (double) dvar[i];
         }
     }
 
     // avg_temp: mean grid temperature
-    get_scatter_nc_field_double(filenames.params, "avg_T",
-                                d2start, d2count, dvar);
+    get_scatter_nc_block_double(nc_id, "avg_T", 2, d2start, d2count, dblock);
     for (i = 0; i < local_domain.ncells_active; i++) {
-        soil_con[i].avg_temp = (double) dvar[i];
+        soil_con[i].avg_temp = (double) dblock[i];
     }
 
     // dp: damping depth
-    get_scatter_nc_field_double(filenames.params, "dp",
-                                d2start, d2count, dvar);
+    get_scatter_nc_block_double(nc_id, "dp", 2, d2start, d2count, dblock);
     for (i = 0; i < local_domain.ncells_active; i++) {
-        soil_con[i].dp = (double) dvar[i];
+        soil_con[i].dp = (double) dblock[i];
     }
 
     // bubble: bubbling pressure for each soil layer
+    d3count[0] = options.Nlayer;
+    get_scatter_nc_block_double(nc_id, "bubble", 3, d3start, d3count, dblock);
     for (j = 0; j < options.Nlayer; j++) {
-        d3start[0] = j;
-        get_scatter_nc_field_double(filenames.params, "bubble",
-                                    d3start, d3count, dvar);
+        dvar = dblock + j * local_domain.ncells_active;
         for (i = 0; i < local_domain.ncells_active; i++) {
             soil_con[i].bubble[j] = (double) dvar[i];
         }
     }
 
     // quartz: quartz content for each soil layer
+    d3count[0] = options.Nlayer;
+    get_scatter_nc_block_double(nc_id, "quartz", 3, d3start, d3count, dblock);
     for (j = 0; j < options.Nlayer; j++) {
-        d3start[0] = j;
-        get_scatter_nc_field_double(filenames.params, "quartz",
-                                    d3start, d3count, dvar);
+        dvar = dblock + j * local_domain.ncells_active;
         for (i = 0; i < local_domain.ncells_active; i++) {
             soil_con[i].quartz[j] = (double) dvar[i];
         }
     }
 
     // bulk_dens_min: mineral bulk density for each soil layer
+    d3count[0] = options.Nlayer;
+    get_scatter_nc_block_double(nc_id, "bulk_density", 3, d3start, d3count,
+                                dblock);
     for (j = 0; j < options.Nlayer; j++) {
-        d3start[0] = j;
-        get_scatter_nc_field_double(filenames.params, "bulk_density",
-                                    d3start, d3count, dvar);
+        dvar = dblock + j * local_domain.ncells_active;
         for (i = 0; i < local_domain.ncells_active; i++) {
             soil_con[i].bulk_dens_min[j] = (double) dvar[i];
         }
     }
 
     // soil_dens_min: mineral soil density for each soil layer
+    d3count[0] = options.Nlayer;
+    get_scatter_nc_block_double(nc_id, "soil_density", 3, d3start, d3count,
+                                dblock);
     for (j = 0; j < options.Nlayer; j++) {
-        d3start[0] = j;
-        get_scatter_nc_field_double(filenames.params, "soil_density",
-                                    d3start, d3count, dvar);
+        dvar = dblock + j * local_domain.ncells_active;
         for (i = 0; i < local_domain.ncells_active; i++) {
             soil_con[i].soil_dens_min[j] = (double) dvar[i];
         }
@@ -578,30 +656,33 @@ vic_init(void)
     // organic soils
     if (options.ORGANIC_FRACT) {
         // organic
+        d3count[0] = options.Nlayer;
+        get_scatter_nc_block_double(nc_id, "organic", 3, d3start, d3count,
+                                    dblock);
         for (j = 0; j < options.Nlayer; j++) {
-            d3start[0] = j;
-            get_scatter_nc_field_double(filenames.params, "organic",
-                                        d3start, d3count, dvar);
+            dvar = dblock + j * local_domain.ncells_active;
             for (i = 0; i < local_domain.ncells_active; i++) {
                 soil_con[i].organic[j] = (double) dvar[i];
             }
         }
 
         // bulk_dens_org: organic bulk density for each soil layer
+        d3count[0] = options.Nlayer;
+        get_scatter_nc_block_double(nc_id, "bulk_density_org", 3, d3start,
+                                    d3count, dblock);
         for (j = 0; j < options.Nlayer; j++) {
-            d3start[0] = j;
-            get_scatter_nc_field_double(filenames.params, "bulk_density_org",
-                                        d3start, d3count, dvar);
+            dvar = dblock + j * local_domain.ncells_active;
             for (i = 0; i < local_domain.ncells_active; i++) {
                 soil_con[i].bulk_dens_org[j] = (double) dvar[i];
             }
         }
 
         // soil_dens_org: organic soil density for each soil layer
+        d3count[0] = options.Nlayer;
+        get_scatter_nc_block_double(nc_id, "soil_density_org", 3, d3start,
+                                    d3count, dblock);
         for (j = 0; j < options.Nlayer; j++) {
-            d3start[0] = j;
-            get_scatter_nc_field_double(filenames.params, "soil_density_org",
-                                        d3start, d3count, dvar);
+            dvar = dblock + j * local_domain.ncells_active;
             for (i = 0; i < local_domain.ncells_active; i++) {
                 soil_con[i].soil_dens_org[j] = (double) dvar[i];
             }
@@ -610,10 +691,11 @@ vic_init(void)
 
     // Wcr: critical point for each layer
     // Note this value is  multiplied with the maximum moisture in each layer
+    d3count[0] = options.Nlayer;
+    get_scatter_nc_block_double(nc_id, "Wcr_FRACT", 3, d3start, d3count,
+                                dblock);
     for (j = 0; j < options.Nlayer; j++) {
-        d3start[0] = j;
-        get_scatter_nc_field_double(filenames.params, "Wcr_FRACT",
-                                    d3start, d3count, dvar);
+        dvar = dblock + j * local_domain.ncells_active;
         for (i = 0; i < local_domain.ncells_active; i++) {
             soil_con[i].Wcr[j] = (double) dvar[i];
         }
@@ -621,70 +703,70 @@ vic_init(void)
 
     // Wpwp: wilting point for each layer
     // Note this value is  multiplied with the maximum moisture in each layer
+    d3count[0] = options.Nlayer;
+    get_scatter_nc_block_double(nc_id, "Wpwp_FRACT", 3, d3start, d3count,
+                                dblock);
     for (j = 0; j < options.Nlayer; j++) {
-        d3start[0] = j;
-        get_scatter_nc_field_double(filenames.params, "Wpwp_FRACT",
-                                    d3start, d3count, dvar);
+        dvar = dblock + j * local_domain.ncells_active;
         for (i = 0; i < local_domain.ncells_active; i++) {
             soil_con[i].Wpwp[j] = (double) dvar[i];
         }
     }
 
     // rough: soil roughness
-    get_scatter_nc_field_double(filenames.params, "rough",
-                                d2start, d2count, dvar);
+    get_scatter_nc_block_double(nc_id, "rough", 2, d2start, d2count, dblock);
     for (i = 0; i < local_domain.ncells_active; i++) {
-        soil_con[i].rough = (double) dvar[i];
+        soil_con[i].rough = (double) dblock[i];
     }
 
     // snow_rough: snow roughness
-    get_scatter_nc_field_double(filenames.params, "snow_rough",
-                                d2start, d2count, dvar);
+    get_scatter_nc_block_double(nc_id, "snow_rough", 2, d2start, d2count,
+                                dblock);
     for (i = 0; i < local_domain.ncells_active; i++) {
-        soil_con[i].snow_rough = (double) dvar[i];
+        soil_con[i].snow_rough = (double) dblock[i];
     }
 
     // annual_prec: annual precipitation
-    get_scatter_nc_field_double(filenames.params, "annual_prec",
-                                d2start, d2count, dvar);
+    get_scatter_nc_block_double(nc_id, "annual_prec", 2, d2start, d2count,
+                                dblock);
     for (i = 0; i < local_domain.ncells_active; i++) {
-        soil_con[i].annual_prec = (double) dvar[i];
+        soil_con[i].annual_prec = (double) dblock[i];
     }
 
     // resid_moist: residual moisture content for each layer
+    d3count[0] = options.Nlayer;
+    get_scatter_nc_block_double(nc_id, "resid_moist", 3, d3start, d3count,
+                                dblock);
     for (j = 0; j < options.Nlayer; j++) {
-        d3start[0] = j;
-        get_scatter_nc_field_double(filenames.params, "resid_moist",
-                                    d3start, d3count, dvar);
+        dvar = dblock + j * local_domain.ncells_active;
         for (i = 0; i < local_domain.ncells_active; i++) {
             soil_con[i].resid_moist[j] = (double) dvar[i];
         }
     }
 
     // fs_active: frozen soil active flag
-    get_scatter_nc_field_int(filenames.params, "fs_active",
-                             d2start, d2count, ivar);
+    get_scatter_nc_block_int(nc_id, "fs_active", 2, d2start, d2count, iblock);
     for (i = 0; i < local_domain.ncells_active; i++) {
-        soil_con[i].FS_ACTIVE = (char) ivar[i];
+        soil_con[i].FS_ACTIVE = (char) iblock[i];
     }
 
     // spatial snow
     if (options.SPATIAL_SNOW) {
         // max_snow_distrib_slope
-        get_scatter_nc_field_double(filenames.params, "max_snow_distrib_slope",
-                                    d2start, d2count, dvar);
+        get_scatter_nc_block_double(nc_id, "max_snow_distrib_slope", 2, d2start,
+                                    d2count, dblock);
         for (i = 0; i < local_domain.ncells_active; i++) {
-            soil_con[i].max_snow_distrib_slope = (double) dvar[i];
+            soil_con[i].max_snow_distrib_slope = (double) dblock[i];
         }
     }
 
     // spatial frost
     if (options.SPATIAL_FROST) {
         // frost_slope: slope of frozen soil distribution
-        get_scatter_nc_field_double(filenames.params, "frost_slope",
-                                    d2start, d2count, dvar);
+        get_scatter_nc_block_double(nc_id, "frost_slope", 2, d2start, d2count,
+                                    dblock);
         for (i = 0; i < local_domain.ncells_active; i++) {
-            soil_con[i].frost_slope = (double) dvar[i];
+            soil_con[i].frost_slope = (double) dblock[i];
         }
     }
     for (i = 0; i < local_domain.ncells_active; i++) {
@@ -946,28 +1028,31 @@ vic_init(void)
     }
     else {
         // AreaFract: fraction of grid cell in each snow band
+        d3count[0] = options.SNOW_BAND;
+        get_scatter_nc_block_double(nc_id, "AreaFract", 3, d3start, d3count,
+                                    dblock);
         for (j = 0; j < options.SNOW_BAND; j++) {
-            d3start[0] = j;
-            get_scatter_nc_field_double(filenames.params, "AreaFract",
-                                        d3start, d3count, dvar);
+            dvar = dblock + j * local_domain.ncells_active;
             for (i = 0; i < local_domain.ncells_active; i++) {
                 soil_con[i].AreaFract[j] = (double) dvar[i];
             }
         }
         // elevation: elevation of each snow band
+        d3count[0] = options.SNOW_BAND;
+        get_scatter_nc_block_double(nc_id, "elevation", 3, d3start, d3count,
+                                    dblock);
         for (j = 0; j < options.SNOW_BAND; j++) {
-            d3start[0] = j;
-            get_scatter_nc_field_double(filenames.params, "elevation",
-                                        d3start, d3count, dvar);
+            dvar = dblock + j * local_domain.ncells_active;
             for (i = 0; i < local_domain.ncells_active; i++) {
                 soil_con[i].BandElev[j] = (double) dvar[i];
             }
         }
         // Pfactor: precipitation multiplier for each snow band
+        d3count[0] = options.SNOW_BAND;
+        get_scatter_nc_block_double(nc_id, "Pfactor", 3, d3start, d3count,
+                                    dblock);
         for (j = 0; j < options.SNOW_BAND; j++) {
-            d3start[0] = j;
-            get_scatter_nc_field_double(filenames.params, "Pfactor",
-                                        d3start, d3count, dvar);
+            dvar = dblock + j * local_domain.ncells_active;
             for (i = 0; i < local_domain.ncells_active; i++) {
                 soil_con[i].Pfactor[j] = (double) dvar[i];
             }
@@ -1083,10 +1168,10 @@ vic_init(void)
     // structure. Then assign only the ones with a fraction greater than 0 to
     // the veg_con structure
 
+    d3count[0] = options.NVEGTYPES;
+    get_scatter_nc_block_double(nc_id, "Cv", 3, d3start, d3count, dblock);
     for (j = 0; j < options.NVEGTYPES; j++) {
-        d3start[0] = j;
-        get_scatter_nc_field_double(filenames.params, "Cv",
-                                    d3start, d3count, dvar);
+        dvar = dblock + j * local_domain.ncells_active;
         for (i = 0; i < local_domain.ncells_active; i++) {
             veg_con_map[i].Cv[j] = (double) dvar[i];
         }
@@ -1131,12 +1216,13 @@ vic_init(void)
     }
 
     // zone_depth: root zone depths
+    d4count[1] = options.ROOT_ZONES;
+    get_scatter_nc_block_double(nc_id, "root_depth", 4, d4start, d4count,
+                                dblock);
     for (j = 0; j < options.NVEGTYPES; j++) {
-        d4start[0] = j;
         for (k = 0; k < options.ROOT_ZONES; k++) {
-            d4start[1] = k;
-            get_scatter_nc_field_double(filenames.params, "root_depth",
-                                        d4start, d4count, dvar);
+            dvar = dblock + (j * options.ROOT_ZONES + k) *
+                   local_domain.ncells_active;
             for (i = 0; i < local_domain.ncells_active; i++) {
                 vidx = veg_con_map[i].vidx[j];
                 if (vidx != NODATA_VEG) {
@@ -1147,12 +1233,13 @@ vic_init(void)
     }
 
     // zone_fract: root fractions
+    d4count[1] = options.ROOT_ZONES;
+    get_scatter_nc_block_double(nc_id, "root_fract", 4, d4start, d4count,
+                                dblock);
     for (j = 0; j < options.NVEGTYPES; j++) {
-        d4start[0] = j;
         for (k = 0; k < options.ROOT_ZONES; k++) {
-            d4start[1] = k;
-            get_scatter_nc_field_double(filenames.params, "root_fract",
-                                        d4start, d4count, dvar);
+            dvar = dblock + (j * options.ROOT_ZONES + k) *
+                   local_domain.ncells_active;
             for (i = 0; i < local_domain.ncells_active; i++) {
                 vidx = veg_con_map[i].vidx[j];
                 if (vidx != NODATA_VEG) {
@@ -1238,10 +1325,11 @@ vic_init(void)
     // read blowing snow parameters
     if (options.BLOWING) {
         // sigma_slope
+        d3count[0] = options.NVEGTYPES;
+        get_scatter_nc_block_double(nc_id, "sigma_slope", 3, d3start, d3count,
+                                    dblock);
         for (j = 0; j < options.NVEGTYPES; j++) {
-            d3start[0] = j;
-            get_scatter_nc_field_double(filenames.params, "sigma_slope",
-                                        d3start, d3count, dvar);
+            dvar = dblock + j * local_domain.ncells_active;
             for (i = 0; i < local_domain.ncells_active; i++) {
                 vidx = veg_con_map[i].vidx[j];
                 if (vidx != NODATA_VEG) {
@@ -1255,10 +1343,11 @@ vic_init(void)
             }
         }
         // lag_one
+        d3count[0] = options.NVEGTYPES;
+        get_scatter_nc_block_double(nc_id, "lag_one", 3, d3start, d3count,
+                                    dblock);
         for (j = 0; j < options.NVEGTYPES; j++) {
-            d3start[0] = j;
-            get_scatter_nc_field_double(filenames.params, "lag_one",
-                                        d3start, d3count, dvar);
+            dvar = dblock + j * local_domain.ncells_active;
             for (i = 0; i < local_domain.ncells_active; i++) {
                 vidx = veg_con_map[i].vidx[j];
                 if (vidx != NODATA_VEG) {
@@ -1272,10 +1361,11 @@ vic_init(void)
             }
         }
         // fetch
+        d3count[0] = options.NVEGTYPES;
+        get_scatter_nc_block_double(nc_id, "fetch", 3, d3start, d3count,
+                                    dblock);
         for (j = 0; j < options.NVEGTYPES; j++) {
-            d3start[0] = j;
-            get_scatter_nc_field_double(filenames.params, "fetch",
-                                        d3start, d3count, dvar);
+            dvar = dblock + j * local_domain.ncells_active;
             for (i = 0; i < local_domain.ncells_active; i++) {
                 vidx = veg_con_map[i].vidx[j];
                 if (vidx != NODATA_VEG) {
@@ -1294,10 +1384,10 @@ vic_init(void)
     // read_lake parameters
     if (options.LAKES) {
         // lake_idx
-        get_scatter_nc_field_int(filenames.params, "lake_idx",
-                                 d2start, d2count, ivar);
+        get_scatter_nc_block_int(nc_id, "lake_idx", 2, d2start, d2count,
+                                 iblock);
         for (i = 0; i < local_domain.ncells_active; i++) {
-            lake_con[i].lake_idx = ivar[i];
+            lake_con[i].lake_idx = iblock[i];
             if (!(lake_con[i].lake_idx >= -1 &&
                   lake_con[i].lake_idx <
                   (int) veg_con[i][0].vegetat_type_num)) {
@@ -1311,11 +1401,10 @@ vic_init(void)
         }
 
         // numnod
-        get_scatter_nc_field_int(filenames.params, "numnod",
-                                 d2start, d2count, ivar);
+        get_scatter_nc_block_int(nc_id, "numnod", 2, d2start, d2count, iblock);
         max_numnod = 0;
         for (i = 0; i < local_domain.ncells_active; i++) {
-            lake_con[i].numnod = (size_t) ivar[i];
+            lake_con[i].numnod = (size_t) iblock[i];
             if (lake_con[i].lake_idx == -1) {
                 if (lake_con[i].numnod != 0) {
                     log_err("cell %zu lake_idx is %d (lake not present) "
@@ -1341,10 +1430,10 @@ vic_init(void)
         }
 
         // mindepth (minimum depth for which channel outflow occurs)
-        get_scatter_nc_field_double(filenames.params, "mindepth",
-                                    d2start, d2count, dvar);
+        get_scatter_nc_block_double(nc_id, "mindepth", 2, d2start, d2count,
+                                    dblock);
         for (i = 0; i < local_domain.ncells_active; i++) {
-            lake_con[i].mindepth = (double) dvar[i];
+            lake_con[i].mindepth = (double) dblock[i];
             if (lake_con[i].lake_idx == -1) {
                 if (lake_con[i].mindepth != 0) {
                     log_err("cell %zu lake_idx is %d (lake not present) "
@@ -1361,10 +1450,10 @@ vic_init(void)
         }
 
         // wfrac
-        get_scatter_nc_field_double(filenames.params, "wfrac",
-                                    d2start, d2count, dvar);
+        get_scatter_nc_block_double(nc_id, "wfrac", 2, d2start, d2count,
+                                    dblock);
         for (i = 0; i < local_domain.ncells_active; i++) {
-            lake_con[i].wfrac = (double) dvar[i];
+            lake_con[i].wfrac = (double) dblock[i];
             if (lake_con[i].lake_idx == -1) {
                 if (lake_con[i].wfrac != 0) {
                     log_err("cell %zu lake_idx is %d (lake not present) "
@@ -1380,10 +1469,10 @@ vic_init(void)
         }
 
         // depth_in (initial depth for a cold start)
-        get_scatter_nc_field_double(filenames.params, "depth_in",
-                                    d2start, d2count, dvar);
+        get_scatter_nc_block_double(nc_id, "depth_in", 2, d2start, d2count,
+                                    dblock);
         for (i = 0; i < local_domain.ncells_active; i++) {
-            lake_con[i].depth_in = (double) dvar[i];
+            lake_con[i].depth_in = (double) dblock[i];
             if (lake_con[i].lake_idx == -1) {
                 if (lake_con[i].depth_in != 0) {
                     log_err("cell %zu lake_idx is %d (lake not present) "
@@ -1400,10 +1489,10 @@ vic_init(void)
         }
 
         // rpercent
-        get_scatter_nc_field_double(filenames.params, "rpercent",
-                                    d2start, d2count, dvar);
+        get_scatter_nc_block_double(nc_id, "rpercent", 2, d2start, d2count,
+                                    dblock);
         for (i = 0; i < local_domain.ncells_active; i++) {
-            lake_con[i].rpercent = (double) dvar[i];
+            lake_con[i].rpercent = (double) dblock[i];
             if (lake_con[i].lake_idx == -1) {
                 if (lake_con[i].rpercent != 0) {
                     log_err("cell %zu lake_idx is %d (lake not present) "
@@ -1428,19 +1517,25 @@ vic_init(void)
             }
         }
         if (options.LAKE_PROFILE) {
-            for (j = 0; j < max_numnod; j++) {
-                d3start[0] = j;
+            // read the full lake_node dimension so that every process takes
+            // part in the same collective, regardless of its local numnod
+            d3count[0] = options.NLAKENODES;
 
-                // basin_depth
-                get_scatter_nc_field_double(filenames.params, "basin_depth",
-                                            d3start, d3count, dvar);
+            // basin_depth
+            get_scatter_nc_block_double(nc_id, "basin_depth", 3, d3start,
+                                        d3count, dblock);
+            for (j = 0; j < max_numnod; j++) {
+                dvar = dblock + j * local_domain.ncells_active;
                 for (i = 0; i < local_domain.ncells_active; i++) {
                     lake_con[i].z[j] = (double) dvar[i];
                 }
+            }
 
-                // basin_area
-                get_scatter_nc_field_double(filenames.params, "basin_area",
-                                            d3start, d3count, dvar);
+            // basin_area
+            get_scatter_nc_block_double(nc_id, "basin_area", 3, d3start,
+                                        d3count, dblock);
+            for (j = 0; j < max_numnod; j++) {
+                dvar = dblock + j * local_domain.ncells_active;
                 for (i = 0; i < local_domain.ncells_active; i++) {
                     lake_con[i].Cl[j] = (double) dvar[i];
                 }
@@ -1448,17 +1543,17 @@ vic_init(void)
         }
         else {
             // basin_depth
-            get_scatter_nc_field_double(filenames.params, "basin_depth",
-                                        d2start, d2count, dvar);
+            get_scatter_nc_block_double(nc_id, "basin_depth", 2, d2start,
+                                        d2count, dblock);
             for (i = 0; i < local_domain.ncells_active; i++) {
-                lake_con[i].z[0] = (double) dvar[i];
+                lake_con[i].z[0] = (double) dblock[i];
             }
 
             // basin_area
-            get_scatter_nc_field_double(filenames.params, "basin_area",
-                                        d2start, d2count, dvar);
+            get_scatter_nc_block_double(nc_id, "basin_area", 2, d2start,
+                                        d2count, dblock);
             for (i = 0; i < local_domain.ncells_active; i++) {
-                lake_con[i].Cl[0] = (double) dvar[i];
+                lake_con[i].Cl[0] = (double) dblock[i];
             }
         }
 
@@ -1534,29 +1629,14 @@ vic_init(void)
         }
     }
 
-    // initialize state variables with default values
-    for (i = 0; i < local_domain.ncells_active; i++) {
-        nveg = veg_con[i][0].vegetat_type_num;
-        initialize_snow(all_vars[i].snow, nveg);
-        initialize_soil(all_vars[i].cell, nveg);
-        initialize_veg(all_vars[i].veg_var, nveg);
-        if (options.LAKES) {
-            tmp_lake_idx = (int)lake_con[i].lake_idx;
-            if (tmp_lake_idx < 0) {
-                tmp_lake_idx = 0;
-            }
-            initialize_lake(&(all_vars[i].lake_var), lake_con[i],
-                            &(soil_con[i]),
-                            &(all_vars[i].cell[tmp_lake_idx][0]), false);
-        }
-        initialize_energy(all_vars[i].energy, nveg);
+    // close parameter file
+    if (mpi_rank == VIC_MPI_ROOT) {
+        status = nc_close(nc_id);
+        check_nc_status(status, "Error closing %s", filenames.params);
     }
 
-    // set state metadata structure
-    set_state_meta_data_info();
-
     // cleanup
-    free(dvar);
-    free(ivar);
+    free(dblock);
+    free(iblock);
     free(Cv_sum);
 }
@@ -52,6 +52,8 @@ vic_init_output(dmy_struct *dmy_current)
 
     int                       status;
     size_t                    i;
+    size_t                    c;
+    size_t                    nstates;
     size_t                    streamnum;
     size_t                    nstream_vars[MAX_OUTPUT_STREAMS];
     bool                      default_outputs = false;
@@ -60,13 +62,15 @@ vic_init_output(dmy_struct *dmy_current)
     // initialize the output data structures
     set_output_met_data_info();
 
-    // allocate out_data
-    alloc_out_data(local_domain.ncells_active, &out_data);
+    // allocate out_data, member m of cell c at m * ncells_active + c
+    nstates = local_domain.ncells_active * options.NMEMBERS;
+    alloc_out_data(nstates, &out_data);
 
     // initialize the save data structures
-    for (i = 0; i < local_domain.ncells_active; i++) {
-        initialize_save_data(&(all_vars[i]), &(force[i]), &(soil_con[i]),
-                             veg_con[i], veg_lib[i], &lake_con, out_data[i],
+    for (i = 0; i < nstates; i++) {
+        c = i % local_domain.ncells_active;
+        initialize_save_data(&(all_vars[i]), &(force[i]), &(soil_con[c]),
+                             veg_con[c], veg_lib[c], &lake_con, out_data[i],
                              &(save_data[i]), &timer);
     }
 
@@ -102,7 +106,7 @@ vic_init_output(dmy_struct *dmy_current)
     // allocate memory for streams, initialize to default/missing values
     for (streamnum = 0; streamnum < options.Noutstreams; streamnum++) {
         setup_stream(&(output_streams[streamnum]), nstream_vars[streamnum],
-                     local_domain.ncells_active);
+                     nstates);
     }
 
     if (mpi_rank == VIC_MPI_ROOT) {
@@ -140,6 +144,39 @@ vic_init_output(dmy_struct *dmy_current)
                            1, MPI_SHORT, VIC_MPI_ROOT, MPI_COMM_VIC);
         check_mpi_status(status, "MPI error.");
 
+        // shuffle
+        status = MPI_Bcast(&(output_streams[streamnum].shuffle),
+                           1, MPI_C_BOOL, VIC_MPI_ROOT, MPI_COMM_VIC);
+        check_mpi_status(status, "MPI error.");
+
+        // chunksizes
+        status = MPI_Bcast(output_streams[streamnum].chunksizes,
+                           3, MPI_AINT, VIC_MPI_ROOT, MPI_COMM_VIC);
+        check_mpi_status(status, "MPI error.");
+
+        // quantize
+        status = MPI_Bcast(&(output_streams[streamnum].quantize),
+                           1, MPI_UNSIGNED_SHORT, VIC_MPI_ROOT, MPI_COMM_VIC);
+        check_mpi_status(status, "MPI error.");
+        status = MPI_Bcast(&(output_streams[streamnum].quantize_nsd),
+                           1, MPI_INT, VIC_MPI_ROOT, MPI_COMM_VIC);
+        check_mpi_status(status, "MPI error.");
+
+        // gathered
+        status = MPI_Bcast(&(output_streams[streamnum].gathered),
+                           1, MPI_C_BOOL, VIC_MPI_ROOT, MPI_COMM_VIC);
+        check_mpi_status(status, "MPI error.");
+
+        // subset
+        status = MPI_Bcast(&(output_streams[streamnum].subset),
+                           1, MPI_UNSIGNED_SHORT, VIC_MPI_ROOT, MPI_COMM_VIC);
+        check_mpi_status(status, "MPI error.");
+
+        // region
+        status = MPI_Bcast(&(output_streams[streamnum].region),
+                           1, MPI_UNSIGNED_SHORT, VIC_MPI_ROOT, MPI_COMM_VIC);
+        check_mpi_status(status, "MPI error.");
+
         // type
         status = MPI_Bcast(output_streams[streamnum].type,
                            output_streams[streamnum].nvars,
@@ -167,6 +204,13 @@ vic_init_output(dmy_struct *dmy_current)
                            VIC_MPI_ROOT, MPI_COMM_VIC);
         check_mpi_status(status, "MPI error.");
 
+        // aggparam
+        status = MPI_Bcast(output_streams[streamnum].aggparam,
+                           output_streams[streamnum].nvars *
+                           sizeof(*(output_streams[streamnum].aggparam)),
+                           MPI_BYTE, VIC_MPI_ROOT, MPI_COMM_VIC);
+        check_mpi_status(status, "MPI error.");
+
         // skip agg data
 
         // Now brodcast the alarms
@@ -177,19 +221,561 @@ vic_init_output(dmy_struct *dmy_current)
                            mpi_alarm_struct_type, VIC_MPI_ROOT, MPI_COMM_VIC);
         check_mpi_status(status, "MPI error.");
 
-        // allocate agg data
-        alloc_aggdata(&(output_streams[streamnum]));
-
         // setup netcdf files
         initialize_nc_file(&(nc_hist_files[streamnum]),
                            output_streams[streamnum].nvars,
                            output_streams[streamnum].varid,
                            output_streams[streamnum].type);
+        nc_hist_files[streamnum].gathered = output_streams[streamnum].gathered;
+        set_nc_var_bins(&(nc_hist_files[streamnum]),
+                        &(output_streams[streamnum]));
+
+        // select the cells of spatially subset streams
+        initialize_stream_subset(&(output_streams[streamnum]),
+                                 &(nc_hist_files[streamnum]));
+
+        // reduce region streams to area weighted values of each region
+        initialize_stream_region(&(output_streams[streamnum]),
+                                 &(nc_hist_files[streamnum]));
+
+        // allocate agg data
+        alloc_aggdata(&(output_streams[streamnum]));
+
+        // allocate buffers for history records that are written in the
+        // background
+        initialize_history_records(&(nc_hist_files[streamnum]),
+                                   &(output_streams[streamnum]));
     }
     // validate streams
     validate_streams(&output_streams);
 }
 
+/******************************************************************************
+ * @brief    Allocate the record buffers that are used to hand off history
+ *           records of an output stream to the background writer.
+ * @details  All buffers are allocated once and reused for every record: each
+ *           record is gathered with a single collective and each variable is
+ *           written with a single netcdf call.
+ *****************************************************************************/
+void
+initialize_history_records(nc_file_struct *nc,
+                           stream_struct  *stream)
+{
+    extern domain_struct   global_domain;
+    extern int             mpi_rank;
+    extern int             mpi_size;
+    extern metadata_struct out_metadata[N_OUTVAR_TYPES];
+
+    size_t                 i;
+    size_t                 k;
+    size_t                 nmembers;
+    size_t                 nelem;
+    size_t                 grid_size;
+    size_t                 nsend;
+    size_t                 nrecv;
+    size_t                 max_nelem = 0;
+    size_t                 d_nelem = 0;
+    size_t                 f_nelem = 0;
+    size_t                 i_nelem = 0;
+    size_t                 s_nelem = 0;
+    size_t                 c_nelem = 0;
+
+    // number of values per grid cell (and ensemble member) in a single
+    // record and the largest number of values (members times elements times
+    // bins) of a variable of each netcdf type
+    nmembers = nc->member_size;
+    nc->nvalues = 0;
+    for (k = 0; k < stream->nvars; k++) {
+        nelem = out_metadata[stream->varid[k]].nelem *
+                stream->aggparam[k].nbins;
+        nc->nvalues += nelem;
+        nelem *= nmembers;
+        max_nelem = max(max_nelem, nelem);
+        if (nc->nc_vars[k].nc_type == NC_DOUBLE) {
+            d_nelem = max(d_nelem, nelem);
+        }
+        else if (nc->nc_vars[k].nc_type == NC_FLOAT) {
+            f_nelem = max(f_nelem, nelem);
+        }
+        else if (nc->nc_vars[k].nc_type == NC_INT) {
+            i_nelem = max(i_nelem, nelem);
+        }
+        else if (nc->nc_vars[k].nc_type == NC_SHORT) {
+            s_nelem = max(s_nelem, nelem);
+        }
+        else if (nc->nc_vars[k].nc_type == NC_CHAR) {
+            c_nelem = max(c_nelem, nelem);
+        }
+        else {
+            log_err("Unsupported nc_type encountered");
+        }
+    }
+    if (stream->region != REGION_NONE) {
+        // area weighted sums and area of the valid values of each region,
+        // reduced over all processes
+        nsend = 2 * nc->nvalues * nc->cell_size;
+        nrecv = nsend;
+    }
+    else {
+        nsend = nc->nvalues * stream->ngridcells;
+        nrecv = nc->nvalues * nmembers * nc->cell_size;
+    }
+    if (nrecv > INT_MAX) {
+        log_err("History records of stream %s are too large to be gathered "
+                "in a single call (%zu values per grid cell)", stream->prefix,
+                nc->nvalues);
+    }
+    nc->next_record = 0;
+
+    nc->records = calloc(NHISTRECORDS, sizeof(*(nc->records)));
+    check_alloc_status(nc->records, "Memory allocation error.");
+
+    for (i = 0; i < NHISTRECORDS; i++) {
+        nc->records[i].pending = false;
+        nc->records[i].close_file = false;
+        nc->records[i].time_index = 0;
+        nc->records[i].request = MPI_REQUEST_NULL;
+
+        nc->records[i].send = malloc(nsend *
+                                     sizeof(*(nc->records[i].send)));
+        check_alloc_status(nc->records[i].send, "Memory allocation error.");
+
+        if (mpi_rank == VIC_MPI_ROOT) {
+            nc->records[i].recv = malloc(nrecv *
+                                         sizeof(*(nc->records[i].recv)));
+            check_alloc_status(nc->records[i].recv,
+                               "Memory allocation error.");
+        }
+        else {
+            nc->records[i].recv = NULL;
+        }
+    }
+
+    if (mpi_rank != VIC_MPI_ROOT) {
+        return;
+    }
+
+    // each process sends nvalues values for each member of its cells
+    if (stream->region == REGION_NONE) {
+        nc->gather_counts = malloc(mpi_size * sizeof(*(nc->gather_counts)));
+        check_alloc_status(nc->gather_counts, "Memory allocation error.");
+        nc->gather_offsets = malloc(mpi_size *
+                                    sizeof(*(nc->gather_offsets)));
+        check_alloc_status(nc->gather_offsets, "Memory allocation error.");
+        for (i = 0; i < (size_t) mpi_size; i++) {
+            nc->gather_counts[i] = (int) (nc->nvalues * nmembers) *
+                                   nc->cell_counts[i];
+            nc->gather_offsets[i] = (int) (nc->nvalues * nmembers) *
+                                    nc->cell_offsets[i];
+        }
+    }
+
+    nc->remapped = malloc(max_nelem * nc->cell_size *
+                          sizeof(*(nc->remapped)));
+    check_alloc_status(nc->remapped, "Memory allocation error.");
+
+    // full grid buffers, inactive cells keep the fill value. In the
+    // compressed (gathered cell) layout only the active cells are written.
+    if (nc->gathered) {
+        grid_size = nc->cell_size;
+    }
+    else {
+        grid_size = global_domain.n_nx * global_domain.n_ny;
+    }
+    if (d_nelem > 0) {
+        nc->d_grid = malloc(d_nelem * grid_size *
+                            sizeof(*(nc->d_grid)));
+        check_alloc_status(nc->d_grid, "Memory allocation error.");
+        for (i = 0; i < d_nelem * grid_size; i++) {
+            nc->d_grid[i] = nc->d_fillvalue;
+        }
+    }
+    if (f_nelem > 0) {
+        nc->f_grid = malloc(f_nelem * grid_size *
+                            sizeof(*(nc->f_grid)));
+        check_alloc_status(nc->f_grid, "Memory allocation error.");
+        for (i = 0; i < f_nelem * grid_size; i++) {
+            nc->f_grid[i] = nc->f_fillvalue;
+        }
+    }
+    if (i_nelem > 0) {
+        nc->i_grid = malloc(i_nelem * grid_size *
+                            sizeof(*(nc->i_grid)));
+        check_alloc_status(nc->i_grid, "Memory allocation error.");
+        for (i = 0; i < i_nelem * grid_size; i++) {
+            nc->i_grid[i] = nc->i_fillvalue;
+        }
+    }
+    if (s_nelem > 0) {
+        nc->s_grid = malloc(s_nelem * grid_size *
+                            sizeof(*(nc->s_grid)));
+        check_alloc_status(nc->s_grid, "Memory allocation error.");
+        for (i = 0; i < s_nelem * grid_size; i++) {
+            nc->s_grid[i] = nc->s_fillvalue;
+        }
+    }
+    if (c_nelem > 0) {
+        nc->c_grid = malloc(c_nelem * grid_size *
+                            sizeof(*(nc->c_grid)));
+        check_alloc_status(nc->c_grid, "Memory allocation error.");
+        for (i = 0; i < c_nelem * grid_size; i++) {
+            nc->c_grid[i] = (signed char) nc->d_fillvalue;
+        }
+    }
+}
+
+/******************************************************************************
+ * @brief    Select the grid cells of a spatially subset output stream.
+ * @details  The selection (a lat/lon box, a mask on the domain grid or a list
+ *           of grid cell indices) is resolved on the master node and
+ *           scattered, so that each process aggregates and sends only its
+ *           selected cells. The history file stores the selected cells along
+ *           the cell dimension in global cell order.
+ *****************************************************************************/
+void
+initialize_stream_subset(stream_struct  *stream,
+                         nc_file_struct *nc)
+{
+    extern MPI_Comm      MPI_COMM_VIC;
+    extern domain_struct global_domain;
+    extern domain_struct local_domain;
+    extern int           mpi_rank;
+    extern int           mpi_size;
+    extern int          *mpi_map_global_array_offsets;
+    extern int          *mpi_map_local_array_sizes;
+    extern option_struct options;
+    extern size_t       *filter_active_cells;
+    extern size_t       *mpi_map_mapping_array;
+
+    int                  status;
+    int                 *imask = NULL;
+    size_t               i;
+    size_t               j;
+    size_t               n;
+    size_t               idx;
+    size_t               start[2];
+    size_t               count[2];
+    size_t              *file_idx = NULL;
+    bool                *selected = NULL;
+    bool                *mpi_selected = NULL;
+    bool                *local_selected = NULL;
+    FILE                *fp;
+
+    if (stream->subset == SUBSET_NONE) {
+        return;
+    }
+
+    if (mpi_rank == VIC_MPI_ROOT) {
+        selected = calloc(global_domain.ncells_active, sizeof(*selected));
+        check_alloc_status(selected, "Memory allocation error.");
+
+        if (stream->subset == SUBSET_BBOX) {
+            for (i = 0; i < global_domain.ncells_active; i++) {
+                idx = filter_active_cells[i];
+                selected[i] =
+                    global_domain.locations[idx].latitude >=
+                    stream->subset_bounds[0] &&
+                    global_domain.locations[idx].latitude <=
+                    stream->subset_bounds[1] &&
+                    global_domain.locations[idx].longitude >=
+                    stream->subset_bounds[2] &&
+                    global_domain.locations[idx].longitude <=
+                    stream->subset_bounds[3];
+            }
+        }
+        else if (stream->subset == SUBSET_MASK) {
+            compare_ncdomain_with_global_domain(stream->subset_file);
+
+            imask = malloc(global_domain.ncells_total * sizeof(*imask));
+            check_alloc_status(imask, "Memory allocation error.");
+
+            start[0] = 0;
+            start[1] = 0;
+            count[0] = global_domain.n_ny;
+            count[1] = global_domain.n_nx;
+            get_nc_field_int(stream->subset_file, stream->subset_var, start,
+                             count, imask);
+            for (i = 0; i < global_domain.ncells_active; i++) {
+                selected[i] = imask[filter_active_cells[i]] != 0;
+            }
+            free(imask);
+        }
+        else if (stream->subset == SUBSET_CELLS) {
+            // grid cell indices in the flattened y, x grid, as stored in the
+            // cell variable of the gathered layout
+            fp = open_file(stream->subset_file, "r");
+            while (fscanf(fp, "%zu", &idx) == 1) {
+                if (idx >= global_domain.ncells_total ||
+                    !global_domain.locations[idx].run) {
+                    log_err("Grid cell %zu in %s is not an active cell of "
+                            "the domain", idx, stream->subset_file);
+                }
+                selected[global_domain.locations[idx].global_idx] = true;
+            }
+            fclose(fp);
+        }
+
+        // position of each selected cell in the file
+        file_idx = malloc(global_domain.ncells_active * sizeof(*file_idx));
+        check_alloc_status(file_idx, "Memory allocation error.");
+        nc->cell_size = 0;
+        for (i = 0; i < global_domain.ncells_active; i++) {
+            if (selected[i]) {
+                file_idx[i] = nc->cell_size++;
+            }
+        }
+        if (nc->cell_size == 0) {
+            log_err("SUBSET of stream %s does not select any active cell",
+                    stream->prefix);
+        }
+
+        nc->cell_grid_idx = malloc(nc->cell_size *
+                                   sizeof(*(nc->cell_grid_idx)));
+        check_alloc_status(nc->cell_grid_idx, "Memory allocation error.");
+        for (i = 0, j = 0; i < global_domain.ncells_active; i++) {
+            if (selected[i]) {
+                nc->cell_grid_idx[j++] = filter_active_cells[i];
+            }
+        }
+
+        // selection and file position of the cells of each process, in the
+        // order in which the cells are gathered
+        mpi_selected = malloc(global_domain.ncells_active *
+                              sizeof(*mpi_selected));
+        check_alloc_status(mpi_selected, "Memory allocation error.");
+        nc->cell_map = malloc(nc->cell_size * sizeof(*(nc->cell_map)));
+        check_alloc_status(nc->cell_map, "Memory allocation error.");
+        nc->cell_counts = malloc(mpi_size * sizeof(*(nc->cell_counts)));
+        check_alloc_status(nc->cell_counts, "Memory allocation error.");
+        nc->cell_offsets = malloc(mpi_size * sizeof(*(nc->cell_offsets)));
+        check_alloc_status(nc->cell_offsets, "Memory allocation error.");
+
+        for (n = 0, j = 0; n < (size_t) mpi_size; n++) {
+            nc->cell_offsets[n] = (int) j;
+            for (i = 0; i < (size_t) mpi_map_local_array_sizes[n]; i++) {
+                idx = mpi_map_mapping_array[mpi_map_global_array_offsets[n] +
+                                            i];
+                mpi_selected[mpi_map_global_array_offsets[n] + i] =
+                    selected[idx];
+                if (selected[idx]) {
+                    nc->cell_map[j++] = file_idx[idx];
+                }
+            }
+            nc->cell_counts[n] = (int) j - nc->cell_offsets[n];
+        }
+
+        free(selected);
+        free(file_idx);
+    }
+
+    local_selected = malloc(local_domain.ncells_active *
+                            sizeof(*local_selected));
+    check_alloc_status(local_selected, "Memory allocation error.");
+    status = MPI_Scatterv(mpi_selected, mpi_map_local_array_sizes,
+                          mpi_map_global_array_offsets, MPI_C_BOOL,
+                          local_selected, (int) local_domain.ncells_active,
+                          MPI_C_BOOL, VIC_MPI_ROOT, MPI_COMM_VIC);
+    check_mpi_status(status, "MPI error.");
+
+    // only the selected cells (of each ensemble member) are aggregated
+    stream->ngridcells = 0;
+    for (i = 0; i < local_domain.ncells_active; i++) {
+        if (local_selected[i]) {
+            stream->ngridcells++;
+        }
+    }
+    stream->ngridcells *= options.NMEMBERS;
+    if (stream->ngridcells > 0) {
+        stream->cell_idx = malloc(stream->ngridcells *
+                                  sizeof(*(stream->cell_idx)));
+        check_alloc_status(stream->cell_idx, "Memory allocation error.");
+        j = 0;
+        for (n = 0; n < options.NMEMBERS; n++) {
+            for (i = 0; i < local_domain.ncells_active; i++) {
+                if (local_selected[i]) {
+                    stream->cell_idx[j++] =
+                        n * local_domain.ncells_active + i;
+                }
+            }
+        }
+    }
+
+    free(local_selected);
+    free(mpi_selected);
+}
+
+/******************************************************************************
+ * @brief    Order region ids.
+ *****************************************************************************/
+int
+region_id_cmp(const void *a,
+              const void *b)
+{
+    const int *ia = a;
+    const int *ib = b;
+
+    return (*ia > *ib) - (*ia < *ib);
+}
+
+/******************************************************************************
+ * @brief    Set up the area weighted reduction of an output stream over
+ *           regions.
+ * @details  The regions are the distinct positive ids of an integer (y, x)
+ *           variable of a netCDF file on the domain grid; cells with an id of
+ *           zero or less do not belong to any region. The ids are resolved on
+ *           the master node and the region of each cell is scattered, so that
+ *           each process aggregates only the cells that belong to a region
+ *           and reduces them to area weighted sums per region. The history
+ *           file stores the regions along a single region dimension.
+ *****************************************************************************/
+void
+initialize_stream_region(stream_struct  *stream,
+                         nc_file_struct *nc)
+{
+    extern MPI_Comm      MPI_COMM_VIC;
+    extern domain_struct global_domain;
+    extern domain_struct local_domain;
+    extern int           mpi_rank;
+    extern int          *mpi_map_global_array_offsets;
+    extern int          *mpi_map_local_array_sizes;
+    extern size_t       *filter_active_cells;
+    extern size_t       *mpi_map_mapping_array;
+
+    int                  status;
+    int                 *ids = NULL;
+    int                 *cell_ids = NULL;
+    int                 *mpi_region = NULL;
+    int                 *local_region = NULL;
+    int                 *found;
+    size_t               i;
+    size_t               j;
+    size_t               nregions = 0;
+    size_t               start[2];
+    size_t               count[2];
+    double              *area = NULL;
+
+    if (stream->region == REGION_NONE) {
+        return;
+    }
+
+    if (mpi_rank == VIC_MPI_ROOT) {
+        compare_ncdomain_with_global_domain(stream->region_file);
+
+        ids = malloc(global_domain.ncells_total * sizeof(*ids));
+        check_alloc_status(ids, "Memory allocation error.");
+
+        start[0] = 0;
+        start[1] = 0;
+        count[0] = global_domain.n_ny;
+        count[1] = global_domain.n_nx;
+        get_nc_field_int(stream->region_file, stream->region_var, start,
+                         count, ids);
+
+        // distinct positive ids of the active cells
+        cell_ids = malloc(global_domain.ncells_active * sizeof(*cell_ids));
+        check_alloc_status(cell_ids, "Memory allocation error.");
+        for (i = 0; i < global_domain.ncells_active; i++) {
+            cell_ids[i] = ids[filter_active_cells[i]];
+        }
+        nc->region_ids = malloc(global_domain.ncells_active *
+                                sizeof(*(nc->region_ids)));
+        check_alloc_status(nc->region_ids, "Memory allocation error.");
+        for (i = 0; i < global_domain.ncells_active; i++) {
+            if (cell_ids[i] > 0) {
+                nc->region_ids[nregions++] = cell_ids[i];
+            }
+        }
+        qsort(nc->region_ids, nregions, sizeof(*(nc->region_ids)),
+              region_id_cmp);
+        for (i = 0, j = 0; i < nregions; i++) {
+            if (j == 0 || nc->region_ids[i] != nc->region_ids[j - 1]) {
+                nc->region_ids[j++] = nc->region_ids[i];
+            }
+        }
+        nregions = j;
+        if (nregions == 0) {
+            log_err("%s in %s does not assign any active cell of stream %s "
+                    "to a region", stream->region_var, stream->region_file,
+                    stream->prefix);
+        }
+
+        // region of each cell in the order in which the cells are scattered
+        mpi_region = malloc(global_domain.ncells_active *
+                            sizeof(*mpi_region));
+        check_alloc_status(mpi_region, "Memory allocation error.");
+        for (i = 0; i < global_domain.ncells_active; i++) {
+            found = NULL;
+            if (cell_ids[mpi_map_mapping_array[i]] > 0) {
+                found = bsearch(&(cell_ids[mpi_map_mapping_array[i]]),
+                                nc->region_ids, nregions,
+                                sizeof(*(nc->region_ids)), region_id_cmp);
+            }
+            mpi_region[i] = found ? (int) (found - nc->region_ids) : -1;
+        }
+
+        free(ids);
+        free(cell_ids);
+    }
+
+    status = MPI_Bcast(&nregions, 1, MPI_AINT, VIC_MPI_ROOT, MPI_COMM_VIC);
+    check_mpi_status(status, "MPI error.");
+
+    local_region = malloc(local_domain.ncells_active * sizeof(*local_region));
+    check_alloc_status(local_region, "Memory allocation error.");
+    status = MPI_Scatterv(mpi_region, mpi_map_local_array_sizes,
+                          mpi_map_global_array_offsets, MPI_INT,
+                          local_region, (int) local_domain.ncells_active,
+                          MPI_INT, VIC_MPI_ROOT, MPI_COMM_VIC);
+    check_mpi_status(status, "MPI error.");
+
+    // only the cells that belong to a region are aggregated
+    stream->ngridcells = 0;
+    for (i = 0; i < local_domain.ncells_active; i++) {
+        if (local_region[i] >= 0) {
+            stream->ngridcells++;
+        }
+    }
+    if (stream->ngridcells > 0) {
+        stream->cell_idx = malloc(stream->ngridcells *
+                                  sizeof(*(stream->cell_idx)));
+        check_alloc_status(stream->cell_idx, "Memory allocation error.");
+        nc->cell_region = malloc(stream->ngridcells *
+                                 sizeof(*(nc->cell_region)));
+        check_alloc_status(nc->cell_region, "Memory allocation error.");
+        nc->cell_area = malloc(stream->ngridcells * sizeof(*(nc->cell_area)));
+        check_alloc_status(nc->cell_area, "Memory allocation error.");
+        for (i = 0, j = 0; i < local_domain.ncells_active; i++) {
+            if (local_region[i] >= 0) {
+                stream->cell_idx[j] = i;
+                nc->cell_region[j] = (size_t) local_region[i];
+                nc->cell_area[j] = local_domain.locations[i].area;
+                j++;
+            }
+        }
+    }
+
+    // total area of each region
+    area = calloc(nregions, sizeof(*area));
+    check_alloc_status(area, "Memory allocation error.");
+    for (i = 0; i < stream->ngridcells; i++) {
+        area[nc->cell_region[i]] += nc->cell_area[i];
+    }
+    if (mpi_rank == VIC_MPI_ROOT) {
+        nc->region_area = malloc(nregions * sizeof(*(nc->region_area)));
+        check_alloc_status(nc->region_area, "Memory allocation error.");
+    }
+    status = MPI_Reduce(area, nc->region_area, (int) nregions, MPI_DOUBLE,
+                        MPI_SUM, VIC_MPI_ROOT, MPI_COMM_VIC);
+    check_mpi_status(status, "MPI error.");
+
+    // the regions are the cells of the file
+    nc->cell_size = nregions;
+
+    free(area);
+    free(local_region);
+    free(mpi_region);
+}
+
 /******************************************************************************
  * @brief    Initialize history file
  *****************************************************************************/
@@ -432,30 +1018,40 @@ initialize_history_file(nc_file_struct *nc,
                     "Error adding latitude standard_name attribute in %s",
                     stream->filename);
 
+    // regions or land-only layout: regions or active cells along a single
+    // dimension
+    if (stream->region != REGION_NONE) {
+        def_nc_region_dim(nc, stream);
+    }
+    else if (nc->gathered) {
+        def_nc_cell_dim(nc, stream->filename);
+    }
+    if (nc->member_size > 1) {
+        def_nc_member_dim(nc, stream->filename);
+    }
+
     // create output variables
     for (j = 0; j < stream->nvars; j++) {
         varid = stream->varid[j];
 
         set_nc_var_dimids(varid, nc, &(nc->nc_vars[j]));
+        def_nc_var_bin_dim(nc, stream, j);
+        ndims = get_nc_var_file_dimids(nc, &(nc->nc_vars[j]), dimids);
 
         // define the variable
         status = nc_def_var(nc->nc_id,
                             out_metadata[varid].varname,
                             nc->nc_vars[j].nc_type,
-                            nc->nc_vars[j].nc_dims,
-                            nc->nc_vars[j].nc_dimids,
+                            ndims, dimids,
                             &(nc->nc_vars[j].nc_varid));
         check_nc_status(status, "Error defining variable %s in %s.  Status: %d",
                         out_metadata[varid].varname, stream->filename, status);
 
-        // Add compression (only works for netCDF4 filetype)
-        if (stream->compress) {
-            status = nc_def_var_deflate(nc->nc_id, nc->nc_vars[j].nc_varid,
-                                        true, true, stream->compress);
-            check_nc_status(
-                status,
-                "Error setting compression level in %s for variable: %s",
-                stream->filename, out_metadata[varid].varname);
+        // chunking, filters and quantization (only work for netCDF4 filetype)
+        if (stream->file_format == NETCDF4_CLASSIC ||
+            stream->file_format == NETCDF4) {
+            set_nc_var_storage(stream, nc, &(nc->nc_vars[j]),
+                               out_metadata[varid].varname);
         }
 
         // set the fill value attribute
@@ -497,16 +1093,47 @@ initialize_history_file(nc_file_struct *nc,
                     out_metadata[varid].long_name);
         put_nc_attr(nc->nc_id, nc->nc_vars[j].nc_varid, "standard_name",
                     out_metadata[varid].standard_name);
-        put_nc_attr(nc->nc_id, nc->nc_vars[j].nc_varid, "units",
-                    out_metadata[varid].units);
+        // histograms hold the fraction of the period in each bin
+        if (stream->aggtype[j] == AGG_TYPE_HIST) {
+            strcpy(unit_str, "1");
+        }
+        else {
+            strcpy(unit_str, out_metadata[varid].units);
+        }
+        // region sums are integrated over the area of the region
+        if (stream->region == REGION_SUM) {
+            strncat(unit_str, " m2", MAXSTRING - strlen(unit_str) - 1);
+        }
+        put_nc_attr(nc->nc_id, nc->nc_vars[j].nc_varid, "units", unit_str);
         put_nc_attr(nc->nc_id, nc->nc_vars[j].nc_varid, "description",
                     out_metadata[varid].description);
 
-        if (cell_method_from_agg_type(stream->aggtype[j], cell_method)) {
+        if (!cell_method_from_agg_type(stream->aggtype[j], cell_method)) {
+            cell_method[0] = '\0';
+        }
+        if (stream->region != REGION_NONE) {
+            if (snprintf(str, MAXSTRING, "%s%sarea: %s", cell_method,
+                         cell_method[0] ? " " : "",
+                         stream->region == REGION_SUM ? "sum" : "mean") >=
+                MAXSTRING) {
+                log_err("The cell_methods attribute of %s is too long",
+                        out_metadata[varid].varname);
+            }
+            strcpy(cell_method, str);
+        }
+        if (cell_method[0]) {
             put_nc_attr(nc->nc_id, nc->nc_vars[j].nc_varid, "cell_methods",
                         cell_method);
             // NOTE: if cell_methods == variance, units should be ^2
         }
+        if (stream->aggtype[j] == AGG_TYPE_QUANTILE) {
+            status = nc_put_att_double(nc->nc_id, nc->nc_vars[j].nc_varid,
+                                       "quantile", NC_DOUBLE, 1,
+                                       &(stream->aggparam[j].quantile));
+            check_nc_status(status, "Error adding quantile attribute to %s "
+                            "in %s", out_metadata[varid].varname,
+                            stream->filename);
+        }
     }
 
     // leave define mode
@@ -568,6 +1195,18 @@ initialize_history_file(nc_file_struct *nc,
     else {
         log_err("n_coord_dims should be 1 or 2");
     }
+
+    if (stream->region != REGION_NONE) {
+        put_nc_region_coords(nc, stream->filename);
+    }
+    else if (nc->gathered) {
+        put_nc_cell_index(nc, stream->filename);
+    }
+    if (nc->member_size > 1) {
+        put_nc_member_index(nc, stream->filename);
+    }
+
+    put_nc_bin_coords(nc, stream);
 }
 
 /******************************************************************************
@@ -661,10 +1300,36 @@ initialize_nc_file(nc_file_struct     *nc_file,
 {
     extern option_struct options;
     extern domain_struct global_domain;
+    extern size_t       *filter_active_cells;
+    extern size_t       *mpi_map_mapping_array;
+    extern int          *mpi_map_global_array_offsets;
+    extern int          *mpi_map_local_array_sizes;
 
     size_t               i;
 
     nc_file->open = false;
+    nc_file->nvalues = 0;
+    nc_file->next_record = 0;
+    nc_file->records = NULL;
+    nc_file->gather_counts = NULL;
+    nc_file->gather_offsets = NULL;
+    nc_file->remapped = NULL;
+    nc_file->d_grid = NULL;
+    nc_file->f_grid = NULL;
+    nc_file->i_grid = NULL;
+    nc_file->s_grid = NULL;
+    nc_file->c_grid = NULL;
+    nc_file->gathered = false;
+
+    // by default a file holds all active cells (only set on the master node)
+    nc_file->cell_grid_idx = filter_active_cells;
+    nc_file->cell_map = mpi_map_mapping_array;
+    nc_file->cell_counts = mpi_map_local_array_sizes;
+    nc_file->cell_offsets = mpi_map_global_array_offsets;
+    nc_file->cell_region = NULL;
+    nc_file->cell_area = NULL;
+    nc_file->region_ids = NULL;
+    nc_file->region_area = NULL;
 
     // Set fill values
     nc_file->c_fillvalue = NC_FILL_CHAR;
@@ -680,24 +1345,30 @@ initialize_nc_file(nc_file_struct     *nc_file,
     nc_file->frost_dimid = MISSING;
     nc_file->lake_node_dimid = MISSING;
     nc_file->layer_dimid = MISSING;
+    nc_file->member_dimid = MISSING;
     nc_file->ni_dimid = MISSING;
     nc_file->nj_dimid = MISSING;
     nc_file->node_dimid = MISSING;
     nc_file->root_zone_dimid = MISSING;
     nc_file->time_dimid = MISSING;
     nc_file->veg_dimid = MISSING;
+    nc_file->cell_dimid = MISSING;
+    nc_file->cell_varid = MISSING;
+    nc_file->member_varid = MISSING;
 
     // Set dimension sizes
     nc_file->band_size = options.SNOW_BAND;
     nc_file->front_size = MAX_FRONTS;
     nc_file->frost_size = options.Nfrost;
     nc_file->layer_size = options.Nlayer;
+    nc_file->member_size = options.NMEMBERS;
     nc_file->ni_size = global_domain.n_nx;
     nc_file->nj_size = global_domain.n_ny;
     nc_file->node_size = options.Nnode;
     nc_file->root_zone_size = options.ROOT_ZONES;
     nc_file->time_size = NC_UNLIMITED;
     nc_file->veg_size = options.NVEGTYPES;
+    nc_file->cell_size = global_domain.ncells_active;
 
     // allocate memory for nc_vars
     nc_file->nc_vars = calloc(nvars, sizeof(*(nc_file->nc_vars)));
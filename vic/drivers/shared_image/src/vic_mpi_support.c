@@ -100,7 +100,7 @@ create_MPI_global_struct_type(MPI_Datatype *mpi_type)
     MPI_Datatype   *mpi_types;
 
     // nitems has to equal the number of elements in global_param_struct
-    nitems = 32;
+    nitems = 40;
     blocklengths = malloc(nitems * sizeof(*blocklengths));
     check_alloc_status(blocklengths, "Memory allocation error.");
 
@@ -237,6 +237,38 @@ create_MPI_global_struct_type(MPI_Datatype *mpi_type)
     offsets[i] = offsetof(global_param_struct, stateyear);
     mpi_types[i++] = MPI_UNSIGNED_SHORT;
 
+    // unsigned short int statefreq;
+    offsets[i] = offsetof(global_param_struct, statefreq);
+    mpi_types[i++] = MPI_UNSIGNED_SHORT;
+
+    // int staten;
+    offsets[i] = offsetof(global_param_struct, staten);
+    mpi_types[i++] = MPI_INT;
+
+    // size_t spinup_cycles;
+    offsets[i] = offsetof(global_param_struct, spinup_cycles);
+    mpi_types[i++] = MPI_AINT;
+
+    // double spinup_tol_moist;
+    offsets[i] = offsetof(global_param_struct, spinup_tol_moist);
+    mpi_types[i++] = MPI_DOUBLE;
+
+    // double spinup_tol_temp;
+    offsets[i] = offsetof(global_param_struct, spinup_tol_temp);
+    mpi_types[i++] = MPI_DOUBLE;
+
+    // double spinup_tol_carbon;
+    offsets[i] = offsetof(global_param_struct, spinup_tol_carbon);
+    mpi_types[i++] = MPI_DOUBLE;
+
+    // double rout_velocity;
+    offsets[i] = offsetof(global_param_struct, rout_velocity);
+    mpi_types[i++] = MPI_DOUBLE;
+
+    // double rout_diffusion;
+    offsets[i] = offsetof(global_param_struct, rout_diffusion);
+    mpi_types[i++] = MPI_DOUBLE;
+
     // unsigned short int calendar;
     offsets[i] = offsetof(global_param_struct, calendar);
     mpi_types[i++] = MPI_UNSIGNED_SHORT;
@@ -293,7 +325,7 @@ create_MPI_filenames_struct_type(MPI_Datatype *mpi_type)
     MPI_Datatype   *mpi_types;
 
     // nitems has to equal the number of elements in filenames_struct
-    nitems = 10;
+    nitems = 12;
     blocklengths = malloc(nitems * sizeof(*blocklengths));
     check_alloc_status(blocklengths, "Memory allocation error.");
 
@@ -342,6 +374,14 @@ create_MPI_filenames_struct_type(MPI_Datatype *mpi_type)
     offsets[i] = offsetof(filenames_struct, params);
     mpi_types[i++] = MPI_CHAR;
 
+    // char param_cache[MAXSTRING];
+    offsets[i] = offsetof(filenames_struct, param_cache);
+    mpi_types[i++] = MPI_CHAR;
+
+    // char routing[MAXSTRING];
+    offsets[i] = offsetof(filenames_struct, routing);
+    mpi_types[i++] = MPI_CHAR;
+
     // char result_dir[MAXSTRING];
     offsets[i] = offsetof(filenames_struct, result_dir);
     mpi_types[i++] = MPI_CHAR;
@@ -488,7 +528,7 @@ create_MPI_option_struct_type(MPI_Datatype *mpi_type)
     MPI_Datatype   *mpi_types;
 
     // nitems has to equal the number of elements in option_struct
-    nitems = 53;
+    nitems = 59;
     blocklengths = malloc(nitems * sizeof(*blocklengths));
     check_alloc_status(blocklengths, "Memory allocation error.");
 
@@ -626,6 +666,10 @@ create_MPI_option_struct_type(MPI_Datatype *mpi_type)
     offsets[i] = offsetof(option_struct, ROOT_ZONES);
     mpi_types[i++] = MPI_AINT; // note there is no MPI_SIZE_T equivalent
 
+    // bool RUNOFF_ADAPTIVE;
+    offsets[i] = offsetof(option_struct, RUNOFF_ADAPTIVE);
+    mpi_types[i++] = MPI_C_BOOL;
+
     // bool QUICK_FLUX;
     offsets[i] = offsetof(option_struct, QUICK_FLUX);
     mpi_types[i++] = MPI_C_BOOL;
@@ -718,6 +762,26 @@ create_MPI_option_struct_type(MPI_Datatype *mpi_type)
     offsets[i] = offsetof(option_struct, SAVE_STATE);
     mpi_types[i++] = MPI_C_BOOL;
 
+    // bool STATE_GATHERED;
+    offsets[i] = offsetof(option_struct, STATE_GATHERED);
+    mpi_types[i++] = MPI_C_BOOL;
+
+    // bool STATE_ASYNC;
+    offsets[i] = offsetof(option_struct, STATE_ASYNC);
+    mpi_types[i++] = MPI_C_BOOL;
+
+    // bool ROUTING;
+    offsets[i] = offsetof(option_struct, ROUTING);
+    mpi_types[i++] = MPI_C_BOOL;
+
+    // bool IO_SERVER;
+    offsets[i] = offsetof(option_struct, IO_SERVER);
+    mpi_types[i++] = MPI_C_BOOL;
+
+    // size_t NMEMBERS;
+    offsets[i] = offsetof(option_struct, NMEMBERS);
+    mpi_types[i++] = MPI_AINT;
+
     // make sure that the we have the right number of elements
     if (i != (size_t) nitems) {
         log_err("Miscount: %zd not equal to %d.", i, nitems);
@@ -755,7 +819,7 @@ create_MPI_param_struct_type(MPI_Datatype *mpi_type)
     MPI_Datatype   *mpi_types;
 
     // nitems has to equal the number of elements in parameters_struct
-    nitems = 153;
+    nitems = 154;
     blocklengths = malloc(nitems * sizeof(*blocklengths));
     check_alloc_status(blocklengths, "Memory allocation error.");
 
@@ -817,6 +881,10 @@ create_MPI_param_struct_type(MPI_Datatype *mpi_type)
     offsets[i] = offsetof(parameters_struct, SOIL_RESID_MOIST);
     mpi_types[i++] = MPI_DOUBLE;
 
+    // double SOIL_RUNOFF_FLUX_FRACT
+    offsets[i] = offsetof(parameters_struct, SOIL_RUNOFF_FLUX_FRACT);
+    mpi_types[i++] = MPI_DOUBLE;
+
     // double SOIL_SLAB_MOIST_FRACT
     offsets[i] = offsetof(parameters_struct, SOIL_SLAB_MOIST_FRACT);
     mpi_types[i++] = MPI_DOUBLE;
@@ -1595,7 +1663,7 @@ map(size_t  size,
                    (void *)((char *)from + i * size), size);
         }
     }
-    if (to_map == NULL) {
+    else if (to_map == NULL) {
         for (i = 0; i < n; i++) {
             // type-agnostic version of to[i] = from[from_map[i]];
             memcpy((void *)((char *)to + i * size),
@@ -1626,6 +1694,8 @@ map(size_t  size,
  *
  * @param ncells total number of cells
  * @param mpi_size number of mpi processes
+ * @param first_rank cells are dealt out to processes first_rank through
+ *        mpi_size - 1; processes before first_rank get no cells
  * @param mpi_map_local_array_sizes address of integer array with number of
  *        cells assigned to each node (MPI_Scatterv:sendcounts and
  *        MPI_Gatherv:recvcounts)
@@ -1639,6 +1709,7 @@ map(size_t  size,
 void
 mpi_map_decomp_domain(size_t   ncells,
                       size_t   mpi_size,
+                      size_t   first_rank,
                       int    **mpi_map_local_array_sizes,
                       int    **mpi_map_global_array_offsets,
                       size_t **mpi_map_mapping_array)
@@ -1647,6 +1718,13 @@ mpi_map_decomp_domain(size_t   ncells,
     size_t j;
     size_t k;
     size_t n;
+    size_t nranks;
+
+    if (first_rank >= mpi_size) {
+        log_err("Cannot decompose the domain over %zu processes starting at "
+                "process %zu", mpi_size, first_rank);
+    }
+    nranks = mpi_size - first_rank;
 
     *mpi_map_local_array_sizes = calloc(mpi_size,
                                         sizeof(*(*mpi_map_local_array_sizes)));
@@ -1656,9 +1734,9 @@ mpi_map_decomp_domain(size_t   ncells,
     *mpi_map_mapping_array = calloc(ncells, sizeof(*(*mpi_map_mapping_array)));
 
     // determine number of cells per node
-    for (n = ncells, i = 0; n > 0; n--, i++) {
+    for (n = ncells, i = first_rank; n > 0; n--, i++) {
         if (i >= mpi_size) {
-            i = 0;
+            i = first_rank;
         }
         (*mpi_map_local_array_sizes)[i] += 1;
     }
@@ -1672,9 +1750,10 @@ mpi_map_decomp_domain(size_t   ncells,
     }
 
     // set mapping array
-    for (i = 0, k = 0; i < (size_t) mpi_size; i++) {
+    for (i = first_rank, k = 0; i < (size_t) mpi_size; i++) {
         for (j = 0; j < (size_t) (*mpi_map_local_array_sizes)[i]; j++) {
-            (*mpi_map_mapping_array)[k++] = (size_t) (i + j * mpi_size);
+            (*mpi_map_mapping_array)[k++] =
+                (size_t) (i - first_rank + j * nranks);
         }
     }
 }
@@ -1698,30 +1777,20 @@ gather_put_nc_field_double(int     nc_id,
     extern int           mpi_rank;
     extern int          *mpi_map_global_array_offsets;
     extern int          *mpi_map_local_array_sizes;
-    extern size_t       *filter_active_cells;
-    extern size_t       *mpi_map_mapping_array;
     int                  status;
     double              *dvar = NULL;
     double              *dvar_gathered = NULL;
-    double              *dvar_remapped = NULL;
     size_t               grid_size;
     size_t               i;
 
     if (mpi_rank == VIC_MPI_ROOT) {
         grid_size = global_domain.n_nx * global_domain.n_ny;
-        dvar = malloc(grid_size * sizeof(*dvar));
-        check_alloc_status(dvar, "Memory allocation error.");
-
+        dvar = mpi_map_grid_buffer(grid_size * sizeof(*dvar));
         for (i = 0; i < grid_size; i++) {
             dvar[i] = fillval;
         }
-        dvar_gathered =
-            malloc(global_domain.ncells_active * sizeof(*dvar_gathered));
-        check_alloc_status(dvar_gathered, "Memory allocation error.");
-
-        dvar_remapped =
-            malloc(global_domain.ncells_active * sizeof(*dvar_remapped));
-        check_alloc_status(dvar_remapped, "Memory allocation error.");
+        dvar_gathered = mpi_map_cells_buffer(global_domain.ncells_active *
+                                             sizeof(*dvar_gathered));
     }
     // Gather the results from the nodes, result for the local node is in the
     // array *var (which is a function argument)
@@ -1730,20 +1799,14 @@ gather_put_nc_field_double(int     nc_id,
                          mpi_map_global_array_offsets, MPI_DOUBLE,
                          VIC_MPI_ROOT, MPI_COMM_VIC);
     check_mpi_status(status, "MPI error.");
+
     if (mpi_rank == VIC_MPI_ROOT) {
-        // remap the array
-        map(sizeof(double), global_domain.ncells_active, NULL,
-            mpi_map_mapping_array, dvar_gathered, dvar_remapped);
-        // expand to full grid size
-        map(sizeof(double), global_domain.ncells_active, NULL,
-            filter_active_cells, dvar_remapped, dvar);
+        // remap and expand to full grid size
+        map_block(sizeof(*dvar), 1, grid_size, dvar, dvar_gathered, true);
 
+        // write to file
         status = nc_put_vara_double(nc_id, var_id, start, count, dvar);
         check_nc_status(status, "Error writing values.");
-        // cleanup
-        free(dvar);
-        free(dvar_gathered);
-        free(dvar_remapped);
     }
 }
 
@@ -1766,29 +1829,20 @@ gather_put_nc_field_float(int     nc_id,
     extern int           mpi_rank;
     extern int          *mpi_map_global_array_offsets;
     extern int          *mpi_map_local_array_sizes;
-    extern size_t       *filter_active_cells;
-    extern size_t       *mpi_map_mapping_array;
     int                  status;
     float               *fvar = NULL;
     float               *fvar_gathered = NULL;
-    float               *fvar_remapped = NULL;
     size_t               grid_size;
     size_t               i;
 
     if (mpi_rank == VIC_MPI_ROOT) {
         grid_size = global_domain.n_nx * global_domain.n_ny;
-        fvar = malloc(grid_size * sizeof(*fvar));
-        check_alloc_status(fvar, "Memory allocation error.");
+        fvar = mpi_map_grid_buffer(grid_size * sizeof(*fvar));
         for (i = 0; i < grid_size; i++) {
             fvar[i] = fillval;
         }
-        fvar_gathered =
-            malloc(global_domain.ncells_active * sizeof(*fvar_gathered));
-        check_alloc_status(fvar_gathered, "Memory allocation error.");
-
-        fvar_remapped =
-            malloc(global_domain.ncells_active * sizeof(*fvar_remapped));
-        check_alloc_status(fvar_remapped, "Memory allocation error.");
+        fvar_gathered = mpi_map_cells_buffer(global_domain.ncells_active *
+                                             sizeof(*fvar_gathered));
     }
     // Gather the results from the nodes, result for the local node is in the
     // array *var (which is a function argument)
@@ -1796,24 +1850,15 @@ gather_put_nc_field_float(int     nc_id,
                          fvar_gathered, mpi_map_local_array_sizes,
                          mpi_map_global_array_offsets, MPI_FLOAT,
                          VIC_MPI_ROOT, MPI_COMM_VIC);
-    check_mpi_status(status, "Error with gather of floats");
+    check_mpi_status(status, "MPI error.");
 
     if (mpi_rank == VIC_MPI_ROOT) {
-        // remap the array
-        map(sizeof(float), global_domain.ncells_active, NULL,
-            mpi_map_mapping_array, fvar_gathered, fvar_remapped);
-        // expand to full grid size
-        map(sizeof(float), global_domain.ncells_active, NULL,
-            filter_active_cells, fvar_remapped, fvar);
+        // remap and expand to full grid size
+        map_block(sizeof(*fvar), 1, grid_size, fvar, fvar_gathered, true);
 
         // write to file
         status = nc_put_vara_float(nc_id, var_id, start, count, fvar);
-        check_nc_status(status, "Error writing values");
-
-        // cleanup
-        free(fvar);
-        free(fvar_gathered);
-        free(fvar_remapped);
+        check_nc_status(status, "Error writing values.");
     }
 }
 
@@ -1836,32 +1881,20 @@ gather_put_nc_field_int(int     nc_id,
     extern int           mpi_rank;
     extern int          *mpi_map_global_array_offsets;
     extern int          *mpi_map_local_array_sizes;
-    extern size_t       *filter_active_cells;
-    extern size_t       *mpi_map_mapping_array;
     int                  status;
     int                 *ivar = NULL;
     int                 *ivar_gathered = NULL;
-    int                 *ivar_remapped = NULL;
     size_t               grid_size;
     size_t               i;
 
     if (mpi_rank == VIC_MPI_ROOT) {
         grid_size = global_domain.n_nx * global_domain.n_ny;
-        ivar = malloc(grid_size * sizeof(*ivar));
-        check_alloc_status(ivar, "Memory allocation error.");
-
+        ivar = mpi_map_grid_buffer(grid_size * sizeof(*ivar));
         for (i = 0; i < grid_size; i++) {
             ivar[i] = fillval;
         }
-
-        ivar_gathered =
-            malloc(global_domain.ncells_active * sizeof(*ivar_gathered));
-        check_alloc_status(ivar_gathered, "Memory allocation error.");
-
-
-        ivar_remapped =
-            malloc(global_domain.ncells_active * sizeof(*ivar_remapped));
-        check_alloc_status(ivar_remapped, "Memory allocation error.");
+        ivar_gathered = mpi_map_cells_buffer(global_domain.ncells_active *
+                                             sizeof(*ivar_gathered));
     }
     // Gather the results from the nodes, result for the local node is in the
     // array *var (which is a function argument)
@@ -1872,21 +1905,12 @@ gather_put_nc_field_int(int     nc_id,
     check_mpi_status(status, "MPI error.");
 
     if (mpi_rank == VIC_MPI_ROOT) {
-        // remap the array
-        map(sizeof(int), global_domain.ncells_active, NULL,
-            mpi_map_mapping_array,
-            ivar_gathered, ivar_remapped);
-        // expand to full grid size
-        map(sizeof(int), global_domain.ncells_active, NULL, filter_active_cells,
-            ivar_remapped, ivar);
+        // remap and expand to full grid size
+        map_block(sizeof(*ivar), 1, grid_size, ivar, ivar_gathered, true);
+
         // write to file
         status = nc_put_vara_int(nc_id, var_id, start, count, ivar);
-        check_nc_status(status, "Error writing values");
-
-        // cleanup
-        free(ivar);
-        free(ivar_gathered);
-        free(ivar_remapped);
+        check_nc_status(status, "Error writing values.");
     }
 }
 
@@ -1909,32 +1933,20 @@ gather_put_nc_field_short(int        nc_id,
     extern int           mpi_rank;
     extern int          *mpi_map_global_array_offsets;
     extern int          *mpi_map_local_array_sizes;
-    extern size_t       *filter_active_cells;
-    extern size_t       *mpi_map_mapping_array;
     int                  status;
     short int           *svar = NULL;
     short int           *svar_gathered = NULL;
-    short int           *svar_remapped = NULL;
     size_t               grid_size;
     size_t               i;
 
     if (mpi_rank == VIC_MPI_ROOT) {
         grid_size = global_domain.n_nx * global_domain.n_ny;
-        svar = malloc(grid_size * sizeof(*svar));
-        check_alloc_status(svar, "Memory allocation error.");
-
+        svar = mpi_map_grid_buffer(grid_size * sizeof(*svar));
         for (i = 0; i < grid_size; i++) {
             svar[i] = fillval;
         }
-
-        svar_gathered =
-            malloc(global_domain.ncells_active * sizeof(*svar_gathered));
-        check_alloc_status(svar_gathered, "Memory allocation error.");
-
-
-        svar_remapped =
-            malloc(global_domain.ncells_active * sizeof(*svar_remapped));
-        check_alloc_status(svar_remapped, "Memory allocation error.");
+        svar_gathered = mpi_map_cells_buffer(global_domain.ncells_active *
+                                             sizeof(*svar_gathered));
     }
     // Gather the results from the nodes, result for the local node is in the
     // array *var (which is a function argument)
@@ -1945,21 +1957,12 @@ gather_put_nc_field_short(int        nc_id,
     check_mpi_status(status, "MPI error.");
 
     if (mpi_rank == VIC_MPI_ROOT) {
-        // remap the array
-        map(sizeof(short int), global_domain.ncells_active, NULL,
-            mpi_map_mapping_array,
-            svar_gathered, svar_remapped);
-        // expand to full grid size
-        map(sizeof(short int), global_domain.ncells_active, NULL,
-            filter_active_cells, svar_remapped, svar);
+        // remap and expand to full grid size
+        map_block(sizeof(*svar), 1, grid_size, svar, svar_gathered, true);
+
         // write to file
         status = nc_put_vara_short(nc_id, var_id, start, count, svar);
-        check_nc_status(status, "Error writing values");
-
-        // cleanup
-        free(svar);
-        free(svar_gathered);
-        free(svar_remapped);
+        check_nc_status(status, "Error writing values.");
     }
 }
 
@@ -1982,32 +1985,20 @@ gather_put_nc_field_schar(int     nc_id,
     extern int           mpi_rank;
     extern int          *mpi_map_global_array_offsets;
     extern int          *mpi_map_local_array_sizes;
-    extern size_t       *filter_active_cells;
-    extern size_t       *mpi_map_mapping_array;
     int                  status;
     signed char         *cvar = NULL;
     signed char         *cvar_gathered = NULL;
-    signed char         *cvar_remapped = NULL;
     size_t               grid_size;
     size_t               i;
 
     if (mpi_rank == VIC_MPI_ROOT) {
         grid_size = global_domain.n_nx * global_domain.n_ny;
-        cvar = malloc(grid_size * sizeof(*cvar));
-        check_alloc_status(cvar, "Memory allocation error.");
-
+        cvar = mpi_map_grid_buffer(grid_size * sizeof(*cvar));
         for (i = 0; i < grid_size; i++) {
             cvar[i] = fillval;
         }
-
-        cvar_gathered =
-            malloc(global_domain.ncells_active * sizeof(*cvar_gathered));
-        check_alloc_status(cvar_gathered, "Memory allocation error.");
-
-
-        cvar_remapped =
-            malloc(global_domain.ncells_active * sizeof(*cvar_remapped));
-        check_alloc_status(cvar_remapped, "Memory allocation error.");
+        cvar_gathered = mpi_map_cells_buffer(global_domain.ncells_active *
+                                             sizeof(*cvar_gathered));
     }
     // Gather the results from the nodes, result for the local node is in the
     // array *var (which is a function argument)
@@ -2018,24 +2009,495 @@ gather_put_nc_field_schar(int     nc_id,
     check_mpi_status(status, "MPI error.");
 
     if (mpi_rank == VIC_MPI_ROOT) {
-        // remap the array
-        map(sizeof(char), global_domain.ncells_active, NULL,
-            mpi_map_mapping_array,
-            cvar_gathered, cvar_remapped);
-        // expand to full grid size
-        map(sizeof(char), global_domain.ncells_active, NULL,
-            filter_active_cells, cvar_remapped, cvar);
+        // remap and expand to full grid size
+        map_block(sizeof(*cvar), 1, grid_size, cvar, cvar_gathered, true);
+
         // write to file
         status = nc_put_vara_schar(nc_id, var_id, start, count, cvar);
-        check_nc_status(status, "Error writing values");
+        check_nc_status(status, "Error writing values.");
+    }
+}
+
+/******************************************************************************
+ * @brief   Map a block of values between the full grid and the order in which
+ *          they are gathered and scattered.
+ * @details The block consists of nblock slices. On the grid side the values
+ *          are stored as [nblock][grid_size]. In MPI order they are stored as
+ *          [process][nblock][ncells of process], so that each process sends
+ *          or receives a single contiguous piece. Only the active cells of
+ *          the grid are mapped.
+ *
+ * @param size size of the datatype, e.g. sizeof(double)
+ * @param nblock number of slices in the block
+ * @param grid_size size of a single slice of the full grid
+ * @param grid array of [nblock][grid_size] values
+ * @param mpi_vals array of [nblock][global ncells_active] values in MPI order
+ * @param to_grid if true, copy from mpi_vals to grid, else from grid to
+ *        mpi_vals
+ *****************************************************************************/
+void
+map_block(size_t size,
+          size_t nblock,
+          size_t grid_size,
+          void  *grid,
+          void  *mpi_vals,
+          bool   to_grid)
+{
+    extern int                    *mpi_map_global_array_offsets;
+    extern int                    *mpi_map_local_array_sizes;
+    extern int                     mpi_size;
+    extern mpi_map_buffers_struct  mpi_map_buffers;
+
+    size_t                         b;
+    size_t                         n;
+    size_t                         ncells;
+    size_t                         offset;
+
+    for (n = 0; n < (size_t) mpi_size; n++) {
+        ncells = (size_t) mpi_map_local_array_sizes[n];
+        offset = (size_t) mpi_map_global_array_offsets[n];
+        for (b = 0; b < nblock; b++) {
+            map_indexed(size, ncells, mpi_map_buffers.grid_idx + offset,
+                        (char *)grid + b * grid_size * size,
+                        (char *)mpi_vals + (nblock * offset + b * ncells) *
+                        size, to_grid);
+        }
+    }
+}
+
+/******************************************************************************
+ * @brief   Copy values between a grid slice and a list of cells through an
+ *          index array.
+ * @details Equivalent to mpi_vals[i] = grid[grid_idx[i]] or, if to_grid is
+ *          true, grid[grid_idx[i]] = mpi_vals[i]. The common element sizes
+ *          are copied with a fixed width, so that the compiler can turn each
+ *          copy into a single load and store instead of a call to memcpy.
+ *
+ * @param size size of the datatype, e.g. sizeof(double)
+ * @param n number of values to copy
+ * @param grid_idx array of length n with the grid index of each value
+ * @param grid grid slice
+ * @param mpi_vals array of n values
+ * @param to_grid if true, copy from mpi_vals to grid, else from grid to
+ *        mpi_vals
+ *****************************************************************************/
+void
+map_indexed(size_t  size,
+            size_t  n,
+            size_t *grid_idx,
+            void   *grid,
+            void   *mpi_vals,
+            bool    to_grid)
+{
+    char  *g = (char *) grid;
+    char  *v = (char *) mpi_vals;
+    size_t i;
+
+    switch (size) {
+    case sizeof(uint64_t):
+        if (to_grid) {
+            for (i = 0; i < n; i++) {
+                memcpy(g + grid_idx[i] * sizeof(uint64_t),
+                       v + i * sizeof(uint64_t), sizeof(uint64_t));
+            }
+        }
+        else {
+            for (i = 0; i < n; i++) {
+                memcpy(v + i * sizeof(uint64_t),
+                       g + grid_idx[i] * sizeof(uint64_t), sizeof(uint64_t));
+            }
+        }
+        break;
+    case sizeof(uint32_t):
+        if (to_grid) {
+            for (i = 0; i < n; i++) {
+                memcpy(g + grid_idx[i] * sizeof(uint32_t),
+                       v + i * sizeof(uint32_t), sizeof(uint32_t));
+            }
+        }
+        else {
+            for (i = 0; i < n; i++) {
+                memcpy(v + i * sizeof(uint32_t),
+                       g + grid_idx[i] * sizeof(uint32_t), sizeof(uint32_t));
+            }
+        }
+        break;
+    case sizeof(uint16_t):
+        if (to_grid) {
+            for (i = 0; i < n; i++) {
+                memcpy(g + grid_idx[i] * sizeof(uint16_t),
+                       v + i * sizeof(uint16_t), sizeof(uint16_t));
+            }
+        }
+        else {
+            for (i = 0; i < n; i++) {
+                memcpy(v + i * sizeof(uint16_t),
+                       g + grid_idx[i] * sizeof(uint16_t), sizeof(uint16_t));
+            }
+        }
+        break;
+    case sizeof(uint8_t):
+        if (to_grid) {
+            for (i = 0; i < n; i++) {
+                g[grid_idx[i]] = v[i];
+            }
+        }
+        else {
+            for (i = 0; i < n; i++) {
+                v[i] = g[grid_idx[i]];
+            }
+        }
+        break;
+    default:
+        if (to_grid) {
+            for (i = 0; i < n; i++) {
+                memcpy(g + grid_idx[i] * size, v + i * size, size);
+            }
+        }
+        else {
+            for (i = 0; i < n; i++) {
+                memcpy(v + i * size, g + grid_idx[i] * size, size);
+            }
+        }
+        break;
+    }
+}
+
+/******************************************************************************
+ * @brief   Number of values in a block of nblock values for each of ncells
+ *          cells, as an MPI count or displacement.
+ * @details MPI counts and displacements are int. A block that does not fit
+ *          is an error instead of a silent overflow.
+ *****************************************************************************/
+int
+mpi_map_block_count(size_t nblock,
+                    size_t ncells)
+{
+    if (ncells > 0 && nblock > (size_t) INT_MAX / ncells) {
+        log_err("A block of %zu values for each of %zu cells is too large "
+                "to be gathered or scattered in a single MPI call", nblock,
+                ncells);
+    }
+
+    return (int) (nblock * ncells);
+}
+
+/******************************************************************************
+ * @brief   Set the counts and displacements for gathering or scattering a
+ *          block of nblock values per grid cell.
+ * @details The counts and displacements are stored in the persistent buffers
+ *          of the master process and must not be freed by the caller.
+ *****************************************************************************/
+void
+mpi_map_block_counts(size_t nblock,
+                     int  **counts,
+                     int  **displs)
+{
+    extern int                    *mpi_map_global_array_offsets;
+    extern int                    *mpi_map_local_array_sizes;
+    extern int                     mpi_size;
+    extern mpi_map_buffers_struct  mpi_map_buffers;
+
+    size_t                         n;
+
+    for (n = 0; n < (size_t) mpi_size; n++) {
+        mpi_map_buffers.counts[n] =
+            mpi_map_block_count(nblock,
+                                (size_t) mpi_map_local_array_sizes[n]);
+        mpi_map_buffers.displs[n] =
+            mpi_map_block_count(nblock,
+                                (size_t) mpi_map_global_array_offsets[n]);
+    }
+    *counts = mpi_map_buffers.counts;
+    *displs = mpi_map_buffers.displs;
+}
+
+/******************************************************************************
+ * @brief   Set up the persistent work space of the gather and scatter
+ *          routines on the master process.
+ * @details Must be called after the domain has been decomposed and
+ *          filter_active_cells has been set. The index of each cell on the
+ *          grid is composed once here, so that remapping a field takes a
+ *          single pass. The buffers are sized for a single double precision
+ *          field and grow when a larger block is requested.
+ *****************************************************************************/
+void
+mpi_map_init_buffers(void)
+{
+    extern domain_struct           global_domain;
+    extern int                     mpi_size;
+    extern size_t                 *filter_active_cells;
+    extern size_t                 *mpi_map_mapping_array;
+    extern mpi_map_buffers_struct  mpi_map_buffers;
+
+    size_t                         i;
+
+    mpi_map_buffers.grid_idx = malloc(global_domain.ncells_active *
+                                      sizeof(*mpi_map_buffers.grid_idx));
+    check_alloc_status(mpi_map_buffers.grid_idx, "Memory allocation error.");
+    for (i = 0; i < global_domain.ncells_active; i++) {
+        mpi_map_buffers.grid_idx[i] =
+            filter_active_cells[mpi_map_mapping_array[i]];
+    }
+
+    mpi_map_buffers.counts = malloc(mpi_size *
+                                    sizeof(*mpi_map_buffers.counts));
+    check_alloc_status(mpi_map_buffers.counts, "Memory allocation error.");
+    mpi_map_buffers.displs = malloc(mpi_size *
+                                    sizeof(*mpi_map_buffers.displs));
+    check_alloc_status(mpi_map_buffers.displs, "Memory allocation error.");
+
+    mpi_map_buffers.grid = NULL;
+    mpi_map_buffers.grid_bytes = 0;
+    mpi_map_buffers.cells = NULL;
+    mpi_map_buffers.cells_bytes = 0;
+    mpi_map_grid_buffer(global_domain.ncells_total * sizeof(double));
+    mpi_map_cells_buffer(global_domain.ncells_active * sizeof(double));
+}
+
+/******************************************************************************
+ * @brief   Free the persistent work space of the gather and scatter routines.
+ *****************************************************************************/
+void
+mpi_map_free_buffers(void)
+{
+    extern mpi_map_buffers_struct mpi_map_buffers;
+
+    free(mpi_map_buffers.grid_idx);
+    free(mpi_map_buffers.counts);
+    free(mpi_map_buffers.displs);
+    free(mpi_map_buffers.grid);
+    free(mpi_map_buffers.cells);
+    mpi_map_buffers.grid_bytes = 0;
+    mpi_map_buffers.cells_bytes = 0;
+}
 
-        // cleanup
-        free(cvar);
-        free(cvar_gathered);
-        free(cvar_remapped);
+/******************************************************************************
+ * @brief   Get the persistent buffer for full grid slices with room for at
+ *          least nbytes.
+ * @details The contents are not preserved when the buffer has to grow.
+ *****************************************************************************/
+void *
+mpi_map_grid_buffer(size_t nbytes)
+{
+    extern mpi_map_buffers_struct mpi_map_buffers;
+
+    if (nbytes > mpi_map_buffers.grid_bytes) {
+        free(mpi_map_buffers.grid);
+        mpi_map_buffers.grid = malloc(nbytes);
+        check_alloc_status(mpi_map_buffers.grid, "Memory allocation error.");
+        mpi_map_buffers.grid_bytes = nbytes;
+    }
+
+    return mpi_map_buffers.grid;
+}
+
+/******************************************************************************
+ * @brief   Get the persistent buffer for active cells in MPI order with room
+ *          for at least nbytes.
+ * @details The contents are not preserved when the buffer has to grow.
+ *****************************************************************************/
+void *
+mpi_map_cells_buffer(size_t nbytes)
+{
+    extern mpi_map_buffers_struct mpi_map_buffers;
+
+    if (nbytes > mpi_map_buffers.cells_bytes) {
+        free(mpi_map_buffers.cells);
+        mpi_map_buffers.cells = malloc(nbytes);
+        check_alloc_status(mpi_map_buffers.cells, "Memory allocation error.");
+        mpi_map_buffers.cells_bytes = nbytes;
+    }
+
+    return mpi_map_buffers.cells;
+}
+
+/******************************************************************************
+ * @brief   Number of grid slices in a netcdf hyperslab, i.e. the product of
+ *          all counts except for the last two (the grid) dimensions.
+ *****************************************************************************/
+size_t
+get_nc_block_size(size_t  ndims,
+                  size_t *count)
+{
+    size_t i;
+    size_t nblock = 1;
+
+    for (i = 0; i + 2 < ndims; i++) {
+        nblock *= count[i];
+    }
+
+    return nblock;
+}
+
+/******************************************************************************
+ * @brief   Gather and write a block of double precision NetCDF fields
+ * @details The local values are stored as [nblock][ncells_active], where
+ *          nblock is the number of grid slices in the hyperslab described by
+ *          start and count. The block is gathered to the master node with a
+ *          single collective and written with a single call.
+ *****************************************************************************/
+void
+gather_put_nc_block_double(int     nc_id,
+                           int     var_id,
+                           double  fillval,
+                           size_t  ndims,
+                           size_t *start,
+                           size_t *count,
+                           double *var)
+{
+    extern MPI_Comm      MPI_COMM_VIC;
+    extern domain_struct global_domain;
+    extern domain_struct local_domain;
+    extern int           mpi_rank;
+    int                  status;
+    int                 *counts = NULL;
+    int                 *displs = NULL;
+    double              *dvar_gathered = NULL;
+    size_t               nblock;
+
+    nblock = get_nc_block_size(ndims, count);
+
+    if (mpi_rank == VIC_MPI_ROOT) {
+        dvar_gathered = mpi_map_cells_buffer(nblock *
+                                             global_domain.ncells_active *
+                                             sizeof(*dvar_gathered));
+
+        mpi_map_block_counts(nblock, &counts, &displs);
+    }
+    // Gather the results from the nodes, result for the local node is in the
+    // array *var (which is a function argument)
+    status = MPI_Gatherv(var,
+                         mpi_map_block_count(nblock,
+                                             local_domain.ncells_active),
+                         MPI_DOUBLE, dvar_gathered, counts, displs,
+                         MPI_DOUBLE, VIC_MPI_ROOT, MPI_COMM_VIC);
+    check_mpi_status(status, "MPI error.");
+    if (mpi_rank == VIC_MPI_ROOT) {
+        put_nc_block_double_mapped(nc_id, var_id, fillval, ndims, start,
+                                   count, dvar_gathered);
+    }
+}
+
+/******************************************************************************
+ * @brief   Write a block of double precision NetCDF fields that has been
+ *          gathered in MPI order
+ * @details Only called on the master process. mapped holds the active cells
+ *          as [process][nblock][ncells of process], as gathered by
+ *          gather_put_nc_block_double. The values are remapped and expanded
+ *          to the full grid and written with a single call.
+ *****************************************************************************/
+void
+put_nc_block_double_mapped(int     nc_id,
+                           int     var_id,
+                           double  fillval,
+                           size_t  ndims,
+                           size_t *start,
+                           size_t *count,
+                           double *mapped)
+{
+    extern domain_struct global_domain;
+    int                  status;
+    double              *dvar = NULL;
+    size_t               grid_size;
+    size_t               nblock;
+    size_t               i;
+
+    nblock = get_nc_block_size(ndims, count);
+    grid_size = global_domain.n_nx * global_domain.n_ny;
+
+    dvar = mpi_map_grid_buffer(nblock * grid_size * sizeof(*dvar));
+    for (i = 0; i < nblock * grid_size; i++) {
+        dvar[i] = fillval;
+    }
+    // remap and expand to full grid size
+    map_block(sizeof(double), nblock, grid_size, dvar, mapped, true);
+
+    status = nc_put_vara_double(nc_id, var_id, start, count, dvar);
+    check_nc_status(status, "Error writing values.");
+}
+
+/******************************************************************************
+ * @brief   Gather and write a block of integer NetCDF fields
+ * @details See gather_put_nc_block_double.
+ *****************************************************************************/
+void
+gather_put_nc_block_int(int     nc_id,
+                        int     var_id,
+                        int     fillval,
+                        size_t  ndims,
+                        size_t *start,
+                        size_t *count,
+                        int    *var)
+{
+    extern MPI_Comm      MPI_COMM_VIC;
+    extern domain_struct global_domain;
+    extern domain_struct local_domain;
+    extern int           mpi_rank;
+    int                  status;
+    int                 *counts = NULL;
+    int                 *displs = NULL;
+    int                 *ivar_gathered = NULL;
+    size_t               nblock;
+
+    nblock = get_nc_block_size(ndims, count);
+
+    if (mpi_rank == VIC_MPI_ROOT) {
+        ivar_gathered = mpi_map_cells_buffer(nblock *
+                                             global_domain.ncells_active *
+                                             sizeof(*ivar_gathered));
+
+        mpi_map_block_counts(nblock, &counts, &displs);
+    }
+    // Gather the results from the nodes, result for the local node is in the
+    // array *var (which is a function argument)
+    status = MPI_Gatherv(var,
+                         mpi_map_block_count(nblock,
+                                             local_domain.ncells_active),
+                         MPI_INT, ivar_gathered, counts, displs,
+                         MPI_INT, VIC_MPI_ROOT, MPI_COMM_VIC);
+    check_mpi_status(status, "MPI error.");
+    if (mpi_rank == VIC_MPI_ROOT) {
+        put_nc_block_int_mapped(nc_id, var_id, fillval, ndims, start, count,
+                                ivar_gathered);
     }
 }
 
+/******************************************************************************
+ * @brief   Write a block of integer NetCDF fields that has been gathered in
+ *          MPI order
+ * @details See put_nc_block_double_mapped.
+ *****************************************************************************/
+void
+put_nc_block_int_mapped(int     nc_id,
+                        int     var_id,
+                        int     fillval,
+                        size_t  ndims,
+                        size_t *start,
+                        size_t *count,
+                        int    *mapped)
+{
+    extern domain_struct global_domain;
+    int                  status;
+    int                 *ivar = NULL;
+    size_t               grid_size;
+    size_t               nblock;
+    size_t               i;
+
+    nblock = get_nc_block_size(ndims, count);
+    grid_size = global_domain.n_nx * global_domain.n_ny;
+
+    ivar = mpi_map_grid_buffer(nblock * grid_size * sizeof(*ivar));
+    for (i = 0; i < nblock * grid_size; i++) {
+        ivar[i] = fillval;
+    }
+    // remap and expand to full grid size
+    map_block(sizeof(int), nblock, grid_size, ivar, mapped, true);
+
+    status = nc_put_vara_int(nc_id, var_id, start, count, ivar);
+    check_nc_status(status, "Error writing values.");
+}
+
 /******************************************************************************
  * @brief   Read double precision NetCDF field from file and scatter
  * @details Read happens on the master node and is then scattered to the local
@@ -2054,34 +2516,20 @@ get_scatter_nc_field_double(char   *nc_name,
     extern int           mpi_rank;
     extern int          *mpi_map_global_array_offsets;
     extern int          *mpi_map_local_array_sizes;
-    extern size_t       *filter_active_cells;
-    extern size_t       *mpi_map_mapping_array;
     int                  status;
     double              *dvar = NULL;
-    double              *dvar_filtered = NULL;
     double              *dvar_mapped = NULL;
 
     if (mpi_rank == VIC_MPI_ROOT) {
-        dvar = malloc(global_domain.ncells_total * sizeof(*dvar));
-        check_alloc_status(dvar, "Memory allocation error.");
-
-        dvar_filtered =
-            malloc(global_domain.ncells_active * sizeof(*dvar_filtered));
-        check_alloc_status(dvar_filtered, "Memory allocation error.");
-
-        dvar_mapped =
-            malloc(global_domain.ncells_active * sizeof(*dvar_mapped));
-        check_alloc_status(dvar_mapped, "Memory allocation error.");
+        dvar = mpi_map_grid_buffer(global_domain.ncells_total *
+                                   sizeof(*dvar));
+        dvar_mapped = mpi_map_cells_buffer(global_domain.ncells_active *
+                                           sizeof(*dvar_mapped));
 
         get_nc_field_double(nc_name, var_name, start, count, dvar);
-        // filter the active cells only
-        map(sizeof(double), global_domain.ncells_active, filter_active_cells,
-            NULL, dvar, dvar_filtered);
-        // map to prepare for MPI_Scatterv
-        map(sizeof(double), global_domain.ncells_active, mpi_map_mapping_array,
-            NULL, dvar_filtered, dvar_mapped);
-        free(dvar);
-        free(dvar_filtered);
+        // filter the active cells and map to prepare for MPI_Scatterv
+        map_block(sizeof(*dvar), 1, global_domain.ncells_total, dvar,
+                  dvar_mapped, false);
     }
 
     // Scatter the results to the nodes, result for the local node is in the
@@ -2091,10 +2539,6 @@ get_scatter_nc_field_double(char   *nc_name,
                           var, local_domain.ncells_active, MPI_DOUBLE,
                           VIC_MPI_ROOT, MPI_COMM_VIC);
     check_mpi_status(status, "MPI error.");
-
-    if (mpi_rank == VIC_MPI_ROOT) {
-        free(dvar_mapped);
-    }
 }
 
 /******************************************************************************
@@ -2115,36 +2559,20 @@ get_scatter_nc_field_float(char   *nc_name,
     extern int           mpi_rank;
     extern int          *mpi_map_global_array_offsets;
     extern int          *mpi_map_local_array_sizes;
-    extern size_t       *filter_active_cells;
-    extern size_t       *mpi_map_mapping_array;
     int                  status;
     float               *fvar = NULL;
-    float               *fvar_filtered = NULL;
     float               *fvar_mapped = NULL;
 
     if (mpi_rank == VIC_MPI_ROOT) {
-        fvar = malloc(global_domain.ncells_total * sizeof(*fvar));
-        check_alloc_status(fvar, "Memory allocation error.");
-
-        fvar_filtered =
-            malloc(global_domain.ncells_active * sizeof(*fvar_filtered));
-        check_alloc_status(fvar_filtered, "Memory allocation error.");
-
-        fvar_mapped =
-            malloc(global_domain.ncells_active * sizeof(*fvar_mapped));
-        check_alloc_status(fvar_mapped, "Memory allocation error.");
+        fvar = mpi_map_grid_buffer(global_domain.ncells_total *
+                                   sizeof(*fvar));
+        fvar_mapped = mpi_map_cells_buffer(global_domain.ncells_active *
+                                           sizeof(*fvar_mapped));
 
         get_nc_field_float(nc_name, var_name, start, count, fvar);
-        // filter the active cells only
-        map(sizeof(float), global_domain.ncells_active, filter_active_cells,
-            NULL,
-            fvar, fvar_filtered);
-        // map to prepare for MPI_Scatterv
-        map(sizeof(float), global_domain.ncells_active, mpi_map_mapping_array,
-            NULL,
-            fvar_filtered, fvar_mapped);
-        free(fvar);
-        free(fvar_filtered);
+        // filter the active cells and map to prepare for MPI_Scatterv
+        map_block(sizeof(*fvar), 1, global_domain.ncells_total, fvar,
+                  fvar_mapped, false);
     }
 
     // Scatter the results to the nodes, result for the local node is in the
@@ -2154,10 +2582,6 @@ get_scatter_nc_field_float(char   *nc_name,
                           var, local_domain.ncells_active, MPI_FLOAT,
                           VIC_MPI_ROOT, MPI_COMM_VIC);
     check_mpi_status(status, "MPI error.");
-
-    if (mpi_rank == VIC_MPI_ROOT) {
-        free(fvar_mapped);
-    }
 }
 
 /******************************************************************************
@@ -2178,34 +2602,20 @@ get_scatter_nc_field_int(char   *nc_name,
     extern int           mpi_rank;
     extern int          *mpi_map_global_array_offsets;
     extern int          *mpi_map_local_array_sizes;
-    extern size_t       *filter_active_cells;
-    extern size_t       *mpi_map_mapping_array;
     int                  status;
     int                 *ivar = NULL;
-    int                 *ivar_filtered = NULL;
     int                 *ivar_mapped = NULL;
 
     if (mpi_rank == VIC_MPI_ROOT) {
-        ivar = malloc(global_domain.ncells_total * sizeof(*ivar));
-        check_alloc_status(ivar, "Memory allocation error.");
-        ivar_filtered =
-            malloc(global_domain.ncells_active * sizeof(*ivar_filtered));
-        check_alloc_status(ivar_filtered, "Memory allocation error.");
-
-        ivar_mapped =
-            malloc(global_domain.ncells_active * sizeof(*ivar_mapped));
-        check_alloc_status(ivar_mapped, "Memory allocation error.");
+        ivar = mpi_map_grid_buffer(global_domain.ncells_total *
+                                   sizeof(*ivar));
+        ivar_mapped = mpi_map_cells_buffer(global_domain.ncells_active *
+                                           sizeof(*ivar_mapped));
 
         get_nc_field_int(nc_name, var_name, start, count, ivar);
-        // filter the active cells only
-        map(sizeof(int), global_domain.ncells_active, filter_active_cells, NULL,
-            ivar, ivar_filtered);
-        // map to prepare for MPI_Scatterv
-        map(sizeof(int), global_domain.ncells_active, mpi_map_mapping_array,
-            NULL,
-            ivar_filtered, ivar_mapped);
-        free(ivar);
-        free(ivar_filtered);
+        // filter the active cells and map to prepare for MPI_Scatterv
+        map_block(sizeof(*ivar), 1, global_domain.ncells_total, ivar,
+                  ivar_mapped, false);
     }
 
     // Scatter the results to the nodes, result for the local node is in the
@@ -2215,10 +2625,579 @@ get_scatter_nc_field_int(char   *nc_name,
                           var, local_domain.ncells_active, MPI_INT,
                           VIC_MPI_ROOT, MPI_COMM_VIC);
     check_mpi_status(status, "MPI error.");
+}
+
+/******************************************************************************
+ * @brief   Read a block of double precision NetCDF fields from an open file
+ *          and scatter
+ * @details The hyperslab described by start and count is read with a single
+ *          call on the master node and scattered with a single collective.
+ *          The local values are stored as [nblock][ncells_active], where
+ *          nblock is the number of grid slices in the hyperslab.
+ *****************************************************************************/
+void
+get_scatter_nc_block_double(int     nc_id,
+                            char   *var_name,
+                            size_t  ndims,
+                            size_t *start,
+                            size_t *count,
+                            double *var)
+{
+    extern MPI_Comm      MPI_COMM_VIC;
+    extern domain_struct global_domain;
+    extern domain_struct local_domain;
+    extern int           mpi_rank;
+    int                  status;
+    int                  var_id;
+    int                 *counts = NULL;
+    int                 *displs = NULL;
+    double              *dvar = NULL;
+    double              *dvar_mapped = NULL;
+    size_t               grid_size;
+    size_t               nblock;
+
+    nblock = get_nc_block_size(ndims, count);
+    grid_size = global_domain.n_nx * global_domain.n_ny;
+
+    if (mpi_rank == VIC_MPI_ROOT) {
+        dvar = mpi_map_grid_buffer(nblock * grid_size * sizeof(*dvar));
+        dvar_mapped = mpi_map_cells_buffer(nblock *
+                                           global_domain.ncells_active *
+                                           sizeof(*dvar_mapped));
+
+        mpi_map_block_counts(nblock, &counts, &displs);
+
+        status = nc_inq_varid(nc_id, var_name, &var_id);
+        check_nc_status(status, "Error getting variable id for %s", var_name);
+        status = nc_get_vara_double(nc_id, var_id, start, count, dvar);
+        check_nc_status(status, "Error getting values for %s", var_name);
+
+        // filter the active cells and map to prepare for MPI_Scatterv
+        map_block(sizeof(double), nblock, grid_size, dvar, dvar_mapped,
+                  false);
+    }
+
+    // Scatter the results to the nodes, result for the local node is in the
+    // array *var (which is a function argument)
+    status = MPI_Scatterv(dvar_mapped, counts, displs, MPI_DOUBLE, var,
+                          mpi_map_block_count(nblock,
+                                              local_domain.ncells_active),
+                          MPI_DOUBLE, VIC_MPI_ROOT, MPI_COMM_VIC);
+    check_mpi_status(status, "MPI error.");
+}
+
+/******************************************************************************
+ * @brief   Read a block of double precision NetCDF fields from an open file
+ *          and map the active cells to the order in which they are scattered
+ * @details Only called on the master process. The hyperslab described by
+ *          start and count is read with a single call and the active cells
+ *          are stored in mapped as [process][nblock][ncells of process], so
+ *          that mapped can be passed to scatter_block_double_interleaved,
+ *          either right away or at a later time.
+ *****************************************************************************/
+void
+get_nc_block_double_mapped(int     nc_id,
+                           char   *var_name,
+                           size_t  ndims,
+                           size_t *start,
+                           size_t *count,
+                           double *mapped)
+{
+    extern domain_struct global_domain;
+    int                  status;
+    int                  var_id;
+    double              *dvar = NULL;
+    size_t               grid_size;
+    size_t               nblock;
+
+    nblock = get_nc_block_size(ndims, count);
+    grid_size = global_domain.n_nx * global_domain.n_ny;
+
+    dvar = mpi_map_grid_buffer(nblock * grid_size * sizeof(*dvar));
+
+    status = nc_inq_varid(nc_id, var_name, &var_id);
+    check_nc_status(status, "Error getting variable id for %s", var_name);
+    status = nc_get_vara_double(nc_id, var_id, start, count, dvar);
+    check_nc_status(status, "Error getting values for %s", var_name);
+
+    // filter the active cells and map to prepare for MPI_Scatterv
+    map_block(sizeof(double), nblock, grid_size, dvar, mapped, false);
+}
+
+/******************************************************************************
+ * @brief   Scatter a block of double precision values into interleaved
+ *          per-cell storage
+ * @details mapped holds [process][nblock][nmembers][ncells of process]
+ *          values on the master process, as set by
+ *          get_nc_block_double_mapped. The local values are stored as
+ *          [nmembers][ncells_active][stride]: slice b of member m of cell i
+ *          ends up in var[(m * ncells_active + i) * stride + b]. The
+ *          transposition is done by the receive datatype of the scatter, so
+ *          no intermediate copy is needed. stride must be at least nblock.
+ *****************************************************************************/
+void
+scatter_block_double_interleaved(size_t  nblock,
+                                 size_t  nmembers,
+                                 size_t  stride,
+                                 double *mapped,
+                                 double *var)
+{
+    extern MPI_Comm      MPI_COMM_VIC;
+    extern domain_struct local_domain;
+    extern int           mpi_rank;
+    int                  status;
+    int                 *counts = NULL;
+    int                 *displs = NULL;
+    MPI_Datatype         cell_type;
+    MPI_Datatype         slice_type;
+    MPI_Datatype         member_type;
+    MPI_Datatype         members_type;
+    MPI_Datatype         block_type;
+
+    if (nblock > stride) {
+        log_err("Block of %zu slices does not fit in a stride of %zu",
+                nblock, stride);
+    }
+
+    if (mpi_rank == VIC_MPI_ROOT) {
+        mpi_map_block_counts(nblock * nmembers, &counts, &displs);
+    }
+
+    // one slice is a strided vector over the local cells. Resizing it to a
+    // single double makes consecutive slices start at consecutive offsets
+    status = MPI_Type_vector((int) local_domain.ncells_active, 1, (int) stride,
+                             MPI_DOUBLE, &cell_type);
+    check_mpi_status(status, "MPI error.");
+    status = MPI_Type_create_resized(cell_type, 0, sizeof(double),
+                                     &slice_type);
+    check_mpi_status(status, "MPI error.");
+    // the same slice of all members, which are ncells_active * stride
+    // values apart
+    status = MPI_Type_create_hvector((int) nmembers, 1,
+                                     (MPI_Aint) (local_domain.ncells_active *
+                                                 stride * sizeof(double)),
+                                     slice_type, &member_type);
+    check_mpi_status(status, "MPI error.");
+    status = MPI_Type_create_resized(member_type, 0, sizeof(double),
+                                     &members_type);
+    check_mpi_status(status, "MPI error.");
+    status = MPI_Type_contiguous((int) nblock, members_type, &block_type);
+    check_mpi_status(status, "MPI error.");
+    status = MPI_Type_commit(&block_type);
+    check_mpi_status(status, "MPI error.");
+
+    // a process without active cells receives nothing; the zero sized
+    // datatype is not passed to the scatter
+    status = MPI_Scatterv(mapped, counts, displs, MPI_DOUBLE,
+                          var, local_domain.ncells_active > 0 ? 1 : 0,
+                          block_type, VIC_MPI_ROOT, MPI_COMM_VIC);
+    check_mpi_status(status, "MPI error.");
+
+    status = MPI_Type_free(&block_type);
+    check_mpi_status(status, "MPI error.");
+    status = MPI_Type_free(&members_type);
+    check_mpi_status(status, "MPI error.");
+    status = MPI_Type_free(&member_type);
+    check_mpi_status(status, "MPI error.");
+    status = MPI_Type_free(&slice_type);
+    check_mpi_status(status, "MPI error.");
+    status = MPI_Type_free(&cell_type);
+    check_mpi_status(status, "MPI error.");
+}
+
+/******************************************************************************
+ * @brief   Read a block of integer NetCDF fields from an open file and
+ *          scatter
+ * @details See get_scatter_nc_block_double.
+ *****************************************************************************/
+void
+get_scatter_nc_block_int(int     nc_id,
+                         char   *var_name,
+                         size_t  ndims,
+                         size_t *start,
+                         size_t *count,
+                         int    *var)
+{
+    extern MPI_Comm      MPI_COMM_VIC;
+    extern domain_struct global_domain;
+    extern domain_struct local_domain;
+    extern int           mpi_rank;
+    int                  status;
+    int                  var_id;
+    int                 *counts = NULL;
+    int                 *displs = NULL;
+    int                 *ivar = NULL;
+    int                 *ivar_mapped = NULL;
+    size_t               grid_size;
+    size_t               nblock;
+
+    nblock = get_nc_block_size(ndims, count);
+    grid_size = global_domain.n_nx * global_domain.n_ny;
 
     if (mpi_rank == VIC_MPI_ROOT) {
-        free(ivar_mapped);
+        ivar = mpi_map_grid_buffer(nblock * grid_size * sizeof(*ivar));
+        ivar_mapped = mpi_map_cells_buffer(nblock *
+                                           global_domain.ncells_active *
+                                           sizeof(*ivar_mapped));
+
+        mpi_map_block_counts(nblock, &counts, &displs);
+
+        status = nc_inq_varid(nc_id, var_name, &var_id);
+        check_nc_status(status, "Error getting variable id for %s", var_name);
+        status = nc_get_vara_int(nc_id, var_id, start, count, ivar);
+        check_nc_status(status, "Error getting values for %s", var_name);
+
+        // filter the active cells and map to prepare for MPI_Scatterv
+        map_block(sizeof(int), nblock, grid_size, ivar, ivar_mapped, false);
     }
+
+    // Scatter the results to the nodes, result for the local node is in the
+    // array *var (which is a function argument)
+    status = MPI_Scatterv(ivar_mapped, counts, displs, MPI_INT, var,
+                          mpi_map_block_count(nblock,
+                                              local_domain.ncells_active),
+                          MPI_INT, VIC_MPI_ROOT, MPI_COMM_VIC);
+    check_mpi_status(status, "MPI error.");
+}
+
+/******************************************************************************
+ * @brief   Map a block of values between the active cells in the order of
+ *          the domain file and the order in which they are gathered and
+ *          scattered.
+ * @details Same as map_block, but on the file side each slice holds the
+ *          global ncells_active values of the compressed (gathered cell)
+ *          layout instead of the full grid.
+ *
+ * @param size size of the datatype, e.g. sizeof(double)
+ * @param nblock number of slices in the block
+ * @param cells array of [nblock][global ncells_active] values
+ * @param mpi_vals array of [nblock][global ncells_active] values in MPI order
+ * @param to_cells if true, copy from mpi_vals to cells, else from cells to
+ *        mpi_vals
+ *****************************************************************************/
+void
+map_cells_block(size_t size,
+                size_t nblock,
+                void  *cells,
+                void  *mpi_vals,
+                bool   to_cells)
+{
+    extern domain_struct  global_domain;
+    extern int           *mpi_map_global_array_offsets;
+    extern int           *mpi_map_local_array_sizes;
+    extern size_t        *mpi_map_mapping_array;
+    extern int            mpi_size;
+
+    size_t                b;
+    size_t                n;
+    size_t                ncells;
+    size_t                offset;
+
+    for (n = 0; n < (size_t) mpi_size; n++) {
+        ncells = (size_t) mpi_map_local_array_sizes[n];
+        offset = (size_t) mpi_map_global_array_offsets[n];
+        for (b = 0; b < nblock; b++) {
+            map_indexed(size, ncells, mpi_map_mapping_array + offset,
+                        (char *)cells + b * global_domain.ncells_active * size,
+                        (char *)mpi_vals + (nblock * offset + b * ncells) *
+                        size, to_cells);
+        }
+    }
+}
+
+/******************************************************************************
+ * @brief   Translate a hyperslab of the full grid to the compressed (gathered
+ *          cell) layout.
+ * @details The trailing y and x dimensions are replaced by a single cell
+ *          dimension that holds all active cells.
+ *
+ * @return number of dimensions in the compressed layout
+ *****************************************************************************/
+size_t
+get_nc_cells_hyperslab(size_t  ndims,
+                       size_t *start,
+                       size_t *count,
+                       size_t *cells_start,
+                       size_t *cells_count)
+{
+    extern domain_struct global_domain;
+
+    size_t               i;
+
+    for (i = 0; i + 2 < ndims; i++) {
+        cells_start[i] = start[i];
+        cells_count[i] = count[i];
+    }
+    cells_start[ndims - 2] = 0;
+    cells_count[ndims - 2] = global_domain.ncells_active;
+
+    return ndims - 1;
+}
+
+/******************************************************************************
+ * @brief   Gather and write a block of double precision NetCDF fields in the
+ *          compressed (gathered cell) layout
+ * @details Same as gather_put_nc_block_double, but the variable stores the
+ *          active cells along a single cell dimension instead of the full
+ *          grid. start and count describe the hyperslab on the full grid.
+ *          The gathered values are only reordered, no grid is filled.
+ *****************************************************************************/
+void
+gather_put_nc_cells_double(int     nc_id,
+                           int     var_id,
+                           size_t  ndims,
+                           size_t *start,
+                           size_t *count,
+                           double *var)
+{
+    extern MPI_Comm      MPI_COMM_VIC;
+    extern domain_struct global_domain;
+    extern domain_struct local_domain;
+    extern int           mpi_rank;
+    int                  status;
+    int                 *counts = NULL;
+    int                 *displs = NULL;
+    double              *dvar_gathered = NULL;
+    size_t               nblock;
+
+    nblock = get_nc_block_size(ndims, count);
+
+    if (mpi_rank == VIC_MPI_ROOT) {
+        dvar_gathered = mpi_map_cells_buffer(nblock *
+                                             global_domain.ncells_active *
+                                             sizeof(*dvar_gathered));
+
+        mpi_map_block_counts(nblock, &counts, &displs);
+    }
+    status = MPI_Gatherv(var,
+                         mpi_map_block_count(nblock,
+                                             local_domain.ncells_active),
+                         MPI_DOUBLE, dvar_gathered, counts, displs,
+                         MPI_DOUBLE, VIC_MPI_ROOT, MPI_COMM_VIC);
+    check_mpi_status(status, "MPI error.");
+    if (mpi_rank == VIC_MPI_ROOT) {
+        put_nc_cells_double_mapped(nc_id, var_id, ndims, start, count,
+                                   dvar_gathered);
+    }
+}
+
+/******************************************************************************
+ * @brief   Write a block of double precision NetCDF fields in the compressed
+ *          (gathered cell) layout that has been gathered in MPI order
+ * @details See put_nc_block_double_mapped. start and count describe the
+ *          hyperslab on the full grid.
+ *****************************************************************************/
+void
+put_nc_cells_double_mapped(int     nc_id,
+                           int     var_id,
+                           size_t  ndims,
+                           size_t *start,
+                           size_t *count,
+                           double *mapped)
+{
+    extern domain_struct global_domain;
+    int                  status;
+    double              *dvar = NULL;
+    size_t               nblock;
+    size_t               cells_start[MAXDIMS];
+    size_t               cells_count[MAXDIMS];
+
+    nblock = get_nc_block_size(ndims, count);
+
+    dvar = mpi_map_grid_buffer(nblock * global_domain.ncells_active *
+                               sizeof(*dvar));
+    map_cells_block(sizeof(double), nblock, dvar, mapped, true);
+
+    get_nc_cells_hyperslab(ndims, start, count, cells_start, cells_count);
+    status = nc_put_vara_double(nc_id, var_id, cells_start, cells_count,
+                                dvar);
+    check_nc_status(status, "Error writing values.");
+}
+
+/******************************************************************************
+ * @brief   Gather and write a block of integer NetCDF fields in the
+ *          compressed (gathered cell) layout
+ * @details See gather_put_nc_cells_double.
+ *****************************************************************************/
+void
+gather_put_nc_cells_int(int     nc_id,
+                        int     var_id,
+                        size_t  ndims,
+                        size_t *start,
+                        size_t *count,
+                        int    *var)
+{
+    extern MPI_Comm      MPI_COMM_VIC;
+    extern domain_struct global_domain;
+    extern domain_struct local_domain;
+    extern int           mpi_rank;
+    int                  status;
+    int                 *counts = NULL;
+    int                 *displs = NULL;
+    int                 *ivar_gathered = NULL;
+    size_t               nblock;
+
+    nblock = get_nc_block_size(ndims, count);
+
+    if (mpi_rank == VIC_MPI_ROOT) {
+        ivar_gathered = mpi_map_cells_buffer(nblock *
+                                             global_domain.ncells_active *
+                                             sizeof(*ivar_gathered));
+
+        mpi_map_block_counts(nblock, &counts, &displs);
+    }
+    status = MPI_Gatherv(var,
+                         mpi_map_block_count(nblock,
+                                             local_domain.ncells_active),
+                         MPI_INT, ivar_gathered, counts, displs,
+                         MPI_INT, VIC_MPI_ROOT, MPI_COMM_VIC);
+    check_mpi_status(status, "MPI error.");
+    if (mpi_rank == VIC_MPI_ROOT) {
+        put_nc_cells_int_mapped(nc_id, var_id, ndims, start, count,
+                                ivar_gathered);
+    }
+}
+
+/******************************************************************************
+ * @brief   Write a block of integer NetCDF fields in the compressed (gathered
+ *          cell) layout that has been gathered in MPI order
+ * @details See put_nc_cells_double_mapped.
+ *****************************************************************************/
+void
+put_nc_cells_int_mapped(int     nc_id,
+                        int     var_id,
+                        size_t  ndims,
+                        size_t *start,
+                        size_t *count,
+                        int    *mapped)
+{
+    extern domain_struct global_domain;
+    int                  status;
+    int                 *ivar = NULL;
+    size_t               nblock;
+    size_t               cells_start[MAXDIMS];
+    size_t               cells_count[MAXDIMS];
+
+    nblock = get_nc_block_size(ndims, count);
+
+    ivar = mpi_map_grid_buffer(nblock * global_domain.ncells_active *
+                               sizeof(*ivar));
+    map_cells_block(sizeof(int), nblock, ivar, mapped, true);
+
+    get_nc_cells_hyperslab(ndims, start, count, cells_start, cells_count);
+    status = nc_put_vara_int(nc_id, var_id, cells_start, cells_count, ivar);
+    check_nc_status(status, "Error writing values.");
+}
+
+/******************************************************************************
+ * @brief   Read a block of double precision NetCDF fields in the compressed
+ *          (gathered cell) layout from an open file and scatter
+ * @details See get_scatter_nc_block_double. start and count describe the
+ *          hyperslab on the full grid.
+ *****************************************************************************/
+void
+get_scatter_nc_cells_double(int     nc_id,
+                            char   *var_name,
+                            size_t  ndims,
+                            size_t *start,
+                            size_t *count,
+                            double *var)
+{
+    extern MPI_Comm      MPI_COMM_VIC;
+    extern domain_struct global_domain;
+    extern domain_struct local_domain;
+    extern int           mpi_rank;
+    int                  status;
+    int                  var_id;
+    int                 *counts = NULL;
+    int                 *displs = NULL;
+    double              *dvar = NULL;
+    double              *dvar_mapped = NULL;
+    size_t               nblock;
+    size_t               cells_start[MAXDIMS];
+    size_t               cells_count[MAXDIMS];
+
+    nblock = get_nc_block_size(ndims, count);
+
+    if (mpi_rank == VIC_MPI_ROOT) {
+        dvar = mpi_map_grid_buffer(nblock * global_domain.ncells_active *
+                                   sizeof(*dvar));
+        dvar_mapped = mpi_map_cells_buffer(nblock *
+                                           global_domain.ncells_active *
+                                           sizeof(*dvar_mapped));
+
+        mpi_map_block_counts(nblock, &counts, &displs);
+
+        get_nc_cells_hyperslab(ndims, start, count, cells_start, cells_count);
+        status = nc_inq_varid(nc_id, var_name, &var_id);
+        check_nc_status(status, "Error getting variable id for %s", var_name);
+        status = nc_get_vara_double(nc_id, var_id, cells_start, cells_count,
+                                    dvar);
+        check_nc_status(status, "Error getting values for %s", var_name);
+
+        map_cells_block(sizeof(double), nblock, dvar, dvar_mapped, false);
+    }
+
+    status = MPI_Scatterv(dvar_mapped, counts, displs, MPI_DOUBLE, var,
+                          mpi_map_block_count(nblock,
+                                              local_domain.ncells_active),
+                          MPI_DOUBLE, VIC_MPI_ROOT, MPI_COMM_VIC);
+    check_mpi_status(status, "MPI error.");
+}
+
+/******************************************************************************
+ * @brief   Read a block of integer NetCDF fields in the compressed (gathered
+ *          cell) layout from an open file and scatter
+ * @details See get_scatter_nc_cells_double.
+ *****************************************************************************/
+void
+get_scatter_nc_cells_int(int     nc_id,
+                         char   *var_name,
+                         size_t  ndims,
+                         size_t *start,
+                         size_t *count,
+                         int    *var)
+{
+    extern MPI_Comm      MPI_COMM_VIC;
+    extern domain_struct global_domain;
+    extern domain_struct local_domain;
+    extern int           mpi_rank;
+    int                  status;
+    int                  var_id;
+    int                 *counts = NULL;
+    int                 *displs = NULL;
+    int                 *ivar = NULL;
+    int                 *ivar_mapped = NULL;
+    size_t               nblock;
+    size_t               cells_start[MAXDIMS];
+    size_t               cells_count[MAXDIMS];
+
+    nblock = get_nc_block_size(ndims, count);
+
+    if (mpi_rank == VIC_MPI_ROOT) {
+        ivar = mpi_map_grid_buffer(nblock * global_domain.ncells_active *
+                                   sizeof(*ivar));
+        ivar_mapped = mpi_map_cells_buffer(nblock *
+                                           global_domain.ncells_active *
+                                           sizeof(*ivar_mapped));
+
+        mpi_map_block_counts(nblock, &counts, &displs);
+
+        get_nc_cells_hyperslab(ndims, start, count, cells_start, cells_count);
+        status = nc_inq_varid(nc_id, var_name, &var_id);
+        check_nc_status(status, "Error getting variable id for %s", var_name);
+        status = nc_get_vara_int(nc_id, var_id, cells_start, cells_count,
+                                 ivar);
+        check_nc_status(status, "Error getting values for %s", var_name);
+
+        map_cells_block(sizeof(int), nblock, ivar, ivar_mapped, false);
+    }
+
+    status = MPI_Scatterv(ivar_mapped, counts, displs, MPI_INT, var,
+                          mpi_map_block_count(nblock,
+                                              local_domain.ncells_active),
+                          MPI_INT, VIC_MPI_ROOT, MPI_COMM_VIC);
+    check_mpi_status(status, "MPI error.");
 }
 
 #ifdef VIC_MPI_SUPPORT_TEST
@@ -2230,6 +3209,7 @@ get_scatter_nc_field_int(char   *nc_name,
 // size_t              current;
 size_t *filter_active_cells = NULL;
 size_t *mpi_map_mapping_array = NULL;
+mpi_map_buffers_struct mpi_map_buffers;
 // all_vars_struct    *all_vars = NULL;
 // force_data_struct  *force = NULL;
 // dmy_struct         *dmy = NULL;
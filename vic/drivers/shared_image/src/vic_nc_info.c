@@ -106,6 +106,15 @@ set_nc_var_info(unsigned int       varid,
         nc_var->nc_counts[1] = nc_hist_file->nj_size;
         nc_var->nc_counts[2] = nc_hist_file->ni_size;
     }
+
+    // ensemble members go right after time
+    if (nc_hist_file->member_size > 1) {
+        for (i = nc_var->nc_dims; i > 1; i--) {
+            nc_var->nc_counts[i] = nc_var->nc_counts[i - 1];
+        }
+        nc_var->nc_counts[1] = nc_hist_file->member_size;
+        nc_var->nc_dims++;
+    }
 }
 
 /******************************************************************************
@@ -183,6 +192,124 @@ set_nc_var_dimids(unsigned int    varid,
         nc_var->nc_dimids[1] = nc_hist_file->nj_dimid;
         nc_var->nc_dimids[2] = nc_hist_file->ni_dimid;
     }
+
+    // ensemble members go right after time. nc_dims already counts the
+    // member dimension (see set_nc_var_info).
+    if (nc_hist_file->member_size > 1) {
+        for (i = nc_var->nc_dims - 1; i > 1; i--) {
+            nc_var->nc_dimids[i] = nc_var->nc_dimids[i - 1];
+        }
+        nc_var->nc_dimids[1] = nc_hist_file->member_dimid;
+    }
+}
+
+/******************************************************************************
+ * @brief    Set chunking, filters and quantization of a netCDF-4 history
+ *           variable.
+ * @details  Must be called in define mode, after nc_def_var. By default the
+ *           netCDF library picks the chunk shape and shuffle is applied
+ *           together with deflate. CHUNKSIZES sets the chunk lengths along
+ *           time, y and x; any level, layer or band dimension is stored in
+ *           one chunk. Long time chunks over small tiles favour reading time
+ *           series at a point, one time step over the full grid favours
+ *           reading maps. In the compressed (gathered cell) layout a chunk
+ *           covers the same number of cells as a y by x tile.
+ *****************************************************************************/
+void
+set_nc_var_storage(stream_struct  *stream,
+                   nc_file_struct *nc,
+                   nc_var_struct  *nc_var,
+                   char           *varname)
+{
+    size_t i;
+    size_t ndims;
+    size_t counts[MAXDIMS];
+    size_t chunks[MAXDIMS];
+    size_t nchunks;
+    size_t chunk_bytes;
+    int    status;
+#ifdef NC_QUANTIZE_BITROUND
+    int    quantize_mode;
+#endif
+
+    // chunk shape: time first, y and x (or cell) last
+    if (stream->chunksizes[0] > 0) {
+        ndims = nc_var->nc_dims;
+        for (i = 0; i < ndims; i++) {
+            counts[i] = nc_var->nc_counts[i];
+        }
+        chunks[0] = stream->chunksizes[0];
+        if (nc->gathered) {
+            ndims--;
+            counts[ndims - 1] = nc->cell_size;
+            for (i = 1; i < ndims - 1; i++) {
+                chunks[i] = counts[i];
+            }
+            chunks[ndims - 1] = min(stream->chunksizes[1] *
+                                    stream->chunksizes[2], nc->cell_size);
+        }
+        else {
+            for (i = 1; i < ndims - 2; i++) {
+                chunks[i] = counts[i];
+            }
+            chunks[ndims - 2] = min(stream->chunksizes[1], nc->nj_size);
+            chunks[ndims - 1] = min(stream->chunksizes[2], nc->ni_size);
+        }
+        status = nc_def_var_chunking(nc->nc_id, nc_var->nc_varid, NC_CHUNKED,
+                                     chunks);
+        check_nc_status(status, "Error setting chunk sizes in %s for "
+                        "variable: %s", stream->filename, varname);
+
+        // history records are written one time step at a time, so the chunk
+        // cache has to hold all chunks of a time slab or every record
+        // evicts, recompresses and rereads chunks
+        status = nc_inq_type(nc->nc_id, nc_var->nc_type, NULL, &chunk_bytes);
+        check_nc_status(status, "Error getting size of type of variable %s",
+                        varname);
+        nchunks = 1;
+        chunk_bytes *= chunks[0];
+        for (i = 1; i < ndims; i++) {
+            chunk_bytes *= chunks[i];
+            nchunks *= (counts[i] + chunks[i] - 1) / chunks[i];
+        }
+        status = nc_set_var_chunk_cache(nc->nc_id, nc_var->nc_varid,
+                                        nchunks * chunk_bytes,
+                                        2 * nchunks + 1, 0.75);
+        check_nc_status(status, "Error setting chunk cache in %s for "
+                        "variable: %s", stream->filename, varname);
+    }
+
+    // shuffle and deflate
+    if (stream->compress) {
+        status = nc_def_var_deflate(nc->nc_id, nc_var->nc_varid,
+                                    stream->shuffle, true, stream->compress);
+        check_nc_status(status,
+                        "Error setting compression level in %s for "
+                        "variable: %s", stream->filename, varname);
+    }
+
+    // quantization only applies to floating point variables
+    if (stream->quantize != QUANTIZE_NONE &&
+        (nc_var->nc_type == NC_FLOAT || nc_var->nc_type == NC_DOUBLE)) {
+#ifdef NC_QUANTIZE_BITROUND
+        switch (stream->quantize) {
+        case QUANTIZE_BITGROOM:
+            quantize_mode = NC_QUANTIZE_BITGROOM;
+            break;
+        case QUANTIZE_GRANULARBR:
+            quantize_mode = NC_QUANTIZE_GRANULARBR;
+            break;
+        default:
+            quantize_mode = NC_QUANTIZE_BITROUND;
+        }
+        status = nc_def_var_quantize(nc->nc_id, nc_var->nc_varid,
+                                     quantize_mode, stream->quantize_nsd);
+        check_nc_status(status, "Error setting quantization in %s for "
+                        "variable: %s", stream->filename, varname);
+#else
+        log_err("QUANTIZE requires netCDF 4.9.0 or later");
+#endif
+    }
 }
 
 /******************************************************************************
@@ -247,3 +374,613 @@ get_nc_dtype(unsigned short int dtype)
     }
     return type;
 }
+
+/******************************************************************************
+ * @brief    Define the cell dimension and the cell index variable of a file
+ *           in the compressed (gathered cell) layout.
+ * @details  Follows the CF convention for compression by gathering: the
+ *           cell variable holds the zero-based index of each active cell in
+ *           the y and x dimensions named by its compress attribute. The y
+ *           and x dimensions and the coordinate variables are kept in the
+ *           file, so that the full grid can be restored from it.
+ *****************************************************************************/
+void
+def_nc_cell_dim(nc_file_struct *nc,
+                char           *filename)
+{
+    extern domain_struct global_domain;
+
+    int                  status;
+    char                 compress[2 * MAXSTRING];
+
+    status = nc_def_dim(nc->nc_id, "cell", nc->cell_size, &(nc->cell_dimid));
+    check_nc_status(status, "Error defining cell dimension in %s", filename);
+
+    status = nc_def_var(nc->nc_id, "cell", NC_INT, 1, &(nc->cell_dimid),
+                        &(nc->cell_varid));
+    check_nc_status(status, "Error defining cell variable in %s", filename);
+
+    snprintf(compress, sizeof(compress), "%s %s", global_domain.info.y_dim,
+             global_domain.info.x_dim);
+    put_nc_attr(nc->nc_id, nc->cell_varid, "compress", compress);
+    put_nc_attr(nc->nc_id, nc->cell_varid, "long_name",
+                "index of active grid cell");
+}
+
+/******************************************************************************
+ * @brief    Write the cell index variable of a file in the compressed
+ *           (gathered cell) layout. Must be called in data mode.
+ *****************************************************************************/
+void
+put_nc_cell_index(nc_file_struct *nc,
+                  char           *filename)
+{
+    int    status;
+    int   *ivar;
+    size_t i;
+    size_t start = 0;
+
+    ivar = malloc(nc->cell_size * sizeof(*ivar));
+    check_alloc_status(ivar, "Memory allocation error.");
+
+    for (i = 0; i < nc->cell_size; i++) {
+        ivar[i] = (int) nc->cell_grid_idx[i];
+    }
+    status = nc_put_vara_int(nc->nc_id, nc->cell_varid, &start,
+                             &(nc->cell_size), ivar);
+    check_nc_status(status, "Error writing cell index in %s", filename);
+
+    free(ivar);
+}
+
+/******************************************************************************
+ * @brief    Define the member dimension and member variable of a history file
+ *           in ensemble mode.
+ *****************************************************************************/
+void
+def_nc_member_dim(nc_file_struct *nc,
+                  char           *filename)
+{
+    int status;
+
+    status = nc_def_dim(nc->nc_id, "member", nc->member_size,
+                        &(nc->member_dimid));
+    check_nc_status(status, "Error defining member dimension in %s",
+                    filename);
+
+    status = nc_def_var(nc->nc_id, "member", NC_INT, 1, &(nc->member_dimid),
+                        &(nc->member_varid));
+    check_nc_status(status, "Error defining member variable in %s", filename);
+
+    put_nc_attr(nc->nc_id, nc->member_varid, "long_name",
+                "index of ensemble member in the member dimension of the "
+                "forcing file");
+}
+
+/******************************************************************************
+ * @brief    Write the member variable of a history file in ensemble mode.
+ *           Must be called in data mode.
+ *****************************************************************************/
+void
+put_nc_member_index(nc_file_struct *nc,
+                    char           *filename)
+{
+    int    status;
+    int   *ivar;
+    size_t i;
+    size_t start = 0;
+
+    ivar = malloc(nc->member_size * sizeof(*ivar));
+    check_alloc_status(ivar, "Memory allocation error.");
+
+    for (i = 0; i < nc->member_size; i++) {
+        ivar[i] = (int) i;
+    }
+    status = nc_put_vara_int(nc->nc_id, nc->member_varid, &start,
+                             &(nc->member_size), ivar);
+    check_nc_status(status, "Error writing member index in %s", filename);
+
+    free(ivar);
+}
+
+/******************************************************************************
+ * @brief    Define the region dimension, the region id variable and the
+ *           region area variable of a file of a region stream.
+ * @details  The regions take the place of the cells of the compressed
+ *           (gathered cell) layout, so the region dimension id is stored as
+ *           the cell dimension id.
+ *****************************************************************************/
+void
+def_nc_region_dim(nc_file_struct *nc,
+                  stream_struct  *stream)
+{
+    int  status;
+    int  varid;
+    char str[MAXSTRING];
+
+    status = nc_def_dim(nc->nc_id, "region", nc->cell_size,
+                        &(nc->cell_dimid));
+    check_nc_status(status, "Error defining region dimension in %s",
+                    stream->filename);
+
+    status = nc_def_var(nc->nc_id, "region", NC_INT, 1, &(nc->cell_dimid),
+                        &(nc->cell_varid));
+    check_nc_status(status, "Error defining region variable in %s",
+                    stream->filename);
+    put_nc_attr(nc->nc_id, nc->cell_varid, "long_name", "region id");
+    if (snprintf(str, MAXSTRING, "%s in %s", stream->region_var,
+                 stream->region_file) >= MAXSTRING) {
+        log_err("The source attribute of the region variable in %s is too "
+                "long", stream->filename);
+    }
+    put_nc_attr(nc->nc_id, nc->cell_varid, "source", str);
+
+    status = nc_def_var(nc->nc_id, "region_area", NC_DOUBLE, 1,
+                        &(nc->cell_dimid), &varid);
+    check_nc_status(status, "Error defining region_area variable in %s",
+                    stream->filename);
+    put_nc_attr(nc->nc_id, varid, "long_name",
+                "area of the active cells of the region");
+    put_nc_attr(nc->nc_id, varid, "units", "m2");
+}
+
+/******************************************************************************
+ * @brief    Write the region id and region area variables of a file of a
+ *           region stream. Must be called in data mode.
+ *****************************************************************************/
+void
+put_nc_region_coords(nc_file_struct *nc,
+                     char           *filename)
+{
+    int    status;
+    int    varid;
+    size_t start = 0;
+
+    status = nc_put_vara_int(nc->nc_id, nc->cell_varid, &start,
+                             &(nc->cell_size), nc->region_ids);
+    check_nc_status(status, "Error writing region ids in %s", filename);
+
+    status = nc_inq_varid(nc->nc_id, "region_area", &varid);
+    check_nc_status(status, "Error getting region_area id in %s", filename);
+    status = nc_put_vara_double(nc->nc_id, varid, &start, &(nc->cell_size),
+                                nc->region_area);
+    check_nc_status(status, "Error writing region area in %s", filename);
+}
+
+/******************************************************************************
+ * @brief    Get the name of the bin dimension of a history variable that
+ *           writes more than one value per element (histograms and
+ *           climatologies).
+ *****************************************************************************/
+void
+get_nc_bin_dim_name(stream_struct *stream,
+                    size_t         varnum,
+                    char          *name)
+{
+    extern metadata_struct out_metadata[N_OUTVAR_TYPES];
+
+    if (stream->aggtype[varnum] == AGG_TYPE_CLIM_MON) {
+        strcpy(name, "month");
+    }
+    else if (stream->aggtype[varnum] == AGG_TYPE_CLIM_DOY) {
+        strcpy(name, "dayofyear");
+    }
+    else {
+        if (snprintf(name, MAXSTRING, "%s_bin",
+                     out_metadata[stream->varid[varnum]].varname) >=
+            MAXSTRING) {
+            log_err("The name of the bin dimension of %s is too long",
+                    out_metadata[stream->varid[varnum]].varname);
+        }
+    }
+}
+
+/******************************************************************************
+ * @brief    Add the bin dimension to the counts of the history variables
+ *           that write more than one value per element.
+ * @details  The bin dimension is placed right before the y and x dimensions,
+ *           so that the values of a variable are ordered by element and then
+ *           by bin, as they are in aggdata.
+ *****************************************************************************/
+void
+set_nc_var_bins(nc_file_struct *nc,
+                stream_struct  *stream)
+{
+    size_t         i;
+    size_t         j;
+    size_t         pos;
+    nc_var_struct *nc_var;
+
+    for (j = 0; j < stream->nvars; j++) {
+        if (stream->aggparam[j].nbins == 1) {
+            continue;
+        }
+        nc_var = &(nc->nc_vars[j]);
+        pos = nc_var->nc_dims - 2;
+        for (i = nc_var->nc_dims; i > pos; i--) {
+            nc_var->nc_counts[i] = nc_var->nc_counts[i - 1];
+        }
+        nc_var->nc_counts[pos] = stream->aggparam[j].nbins;
+        nc_var->nc_dims++;
+    }
+}
+
+/******************************************************************************
+ * @brief    Define the bin dimension and coordinate variable of a history
+ *           variable and add the dimension to its dimension ids. Must be
+ *           called in define mode, after set_nc_var_dimids.
+ *****************************************************************************/
+void
+def_nc_var_bin_dim(nc_file_struct *nc,
+                   stream_struct  *stream,
+                   size_t          varnum)
+{
+    size_t         i;
+    size_t         pos;
+    int            status;
+    int            dimid;
+    int            varid;
+    int            dimids[2];
+    char           name[MAXSTRING];
+    char           bnds_name[MAXSTRING + 5];
+    nc_var_struct *nc_var;
+
+    if (stream->aggparam[varnum].nbins == 1) {
+        return;
+    }
+
+    get_nc_bin_dim_name(stream, varnum, name);
+
+    // climatologies of several variables share the dimension
+    status = nc_inq_dimid(nc->nc_id, name, &dimid);
+    if (status != NC_NOERR) {
+        status = nc_def_dim(nc->nc_id, name, stream->aggparam[varnum].nbins,
+                            &dimid);
+        check_nc_status(status, "Error defining %s dimension in %s", name,
+                        stream->filename);
+
+        status = nc_def_var(nc->nc_id, name, NC_DOUBLE, 1, &dimid, &varid);
+        check_nc_status(status, "Error defining %s variable in %s", name,
+                        stream->filename);
+        if (stream->aggtype[varnum] == AGG_TYPE_CLIM_MON) {
+            put_nc_attr(nc->nc_id, varid, "long_name", "month of the year");
+        }
+        else if (stream->aggtype[varnum] == AGG_TYPE_CLIM_DOY) {
+            put_nc_attr(nc->nc_id, varid, "long_name", "day of the year");
+        }
+        else {
+            put_nc_attr(nc->nc_id, varid, "long_name",
+                        "center of histogram bin");
+            snprintf(bnds_name, sizeof(bnds_name), "%s_bnds", name);
+            put_nc_attr(nc->nc_id, varid, "bounds", bnds_name);
+
+            dimids[0] = dimid;
+            dimids[1] = nc->time_bounds_dimid;
+            status = nc_def_var(nc->nc_id, bnds_name, NC_DOUBLE, 2, dimids,
+                                &varid);
+            check_nc_status(status, "Error defining %s variable in %s",
+                            bnds_name, stream->filename);
+        }
+    }
+
+    // the bin dimension goes right before the y and x dimensions
+    nc_var = &(nc->nc_vars[varnum]);
+    pos = nc_var->nc_dims - 3;
+    for (i = nc_var->nc_dims - 1; i > pos; i--) {
+        nc_var->nc_dimids[i] = nc_var->nc_dimids[i - 1];
+    }
+    nc_var->nc_dimids[pos] = dimid;
+}
+
+/******************************************************************************
+ * @brief    Write the coordinate variables of the bin dimensions of a history
+ *           file. Must be called in data mode.
+ *****************************************************************************/
+void
+put_nc_bin_coords(nc_file_struct *nc,
+                  stream_struct  *stream)
+{
+    size_t            i;
+    size_t            j;
+    size_t            nbins;
+    size_t            start[2] = {0, 0};
+    size_t            count[2];
+    int               status;
+    int               varid;
+    double            width;
+    double           *dvar;
+    char              name[MAXSTRING];
+    char              bnds_name[MAXSTRING + 5];
+    agg_param_struct *param;
+
+    for (j = 0; j < stream->nvars; j++) {
+        param = &(stream->aggparam[j]);
+        nbins = param->nbins;
+        if (nbins == 1) {
+            continue;
+        }
+        get_nc_bin_dim_name(stream, j, name);
+
+        dvar = malloc(2 * nbins * sizeof(*dvar));
+        check_alloc_status(dvar, "Memory allocation error.");
+
+        count[0] = nbins;
+        count[1] = 2;
+        if (stream->aggtype[j] == AGG_TYPE_HIST) {
+            width = (param->upper - param->lower) / (double) nbins;
+            for (i = 0; i < nbins; i++) {
+                dvar[2 * i] = param->lower + (double) i * width;
+                dvar[2 * i + 1] = param->lower + (double) (i + 1) * width;
+            }
+            snprintf(bnds_name, sizeof(bnds_name), "%s_bnds", name);
+            status = nc_inq_varid(nc->nc_id, bnds_name, &varid);
+            check_nc_status(status, "Error getting %s variable id in %s",
+                            bnds_name, stream->filename);
+            status = nc_put_vara_double(nc->nc_id, varid, start, count, dvar);
+            check_nc_status(status, "Error writing %s in %s", bnds_name,
+                            stream->filename);
+            for (i = 0; i < nbins; i++) {
+                dvar[i] = (dvar[2 * i] + dvar[2 * i + 1]) / 2.;
+            }
+        }
+        else {
+            for (i = 0; i < nbins; i++) {
+                dvar[i] = (double) (i + 1);
+            }
+        }
+        status = nc_inq_varid(nc->nc_id, name, &varid);
+        check_nc_status(status, "Error getting %s variable id in %s", name,
+                        stream->filename);
+        status = nc_put_vara_double(nc->nc_id, varid, start, count, dvar);
+        check_nc_status(status, "Error writing %s in %s", name,
+                        stream->filename);
+
+        free(dvar);
+    }
+}
+
+/******************************************************************************
+ * @brief    Determine whether an open file uses the compressed (gathered
+ *           cell) layout and, if so, check that its cell index matches the
+ *           active cells of the domain.
+ *****************************************************************************/
+void
+get_nc_cell_layout(nc_file_struct *nc,
+                   char           *filename)
+{
+    int    status;
+    int   *ivar;
+    size_t i;
+    size_t start = 0;
+    size_t dimlen;
+
+    status = nc_inq_dimid(nc->nc_id, "cell", &(nc->cell_dimid));
+    if (status != NC_NOERR) {
+        nc->gathered = false;
+        return;
+    }
+    nc->gathered = true;
+
+    status = nc_inq_dimlen(nc->nc_id, nc->cell_dimid, &dimlen);
+    check_nc_status(status, "Error reading cell dimension in %s", filename);
+    if (dimlen != nc->cell_size) {
+        log_err("Number of cells in %s (%zu) does not match the number of "
+                "active cells in the domain (%zu)", filename, dimlen,
+                nc->cell_size);
+    }
+
+    status = nc_inq_varid(nc->nc_id, "cell", &(nc->cell_varid));
+    check_nc_status(status, "Error reading cell variable id in %s", filename);
+
+    ivar = malloc(nc->cell_size * sizeof(*ivar));
+    check_alloc_status(ivar, "Memory allocation error.");
+
+    status = nc_get_vara_int(nc->nc_id, nc->cell_varid, &start,
+                             &(nc->cell_size), ivar);
+    check_nc_status(status, "Error reading cell index in %s", filename);
+
+    for (i = 0; i < nc->cell_size; i++) {
+        if (ivar[i] != (int) nc->cell_grid_idx[i]) {
+            log_err("Cell index in %s does not match the active cells of "
+                    "the domain (cell %zu)", filename, i);
+        }
+    }
+
+    free(ivar);
+}
+
+/******************************************************************************
+ * @brief    Get the dimension ids of a variable as stored in the file.
+ * @details  The variable information always describes the full grid. In the
+ *           compressed (gathered cell) layout the trailing y and x dimensions
+ *           are replaced by the cell dimension.
+ *
+ * @return number of dimensions of the variable in the file
+ *****************************************************************************/
+size_t
+get_nc_var_file_dimids(nc_file_struct *nc,
+                       nc_var_struct  *nc_var,
+                       int            *dimids)
+{
+    size_t i;
+
+    for (i = 0; i < nc_var->nc_dims; i++) {
+        dimids[i] = nc_var->nc_dimids[i];
+    }
+    if (!nc->gathered) {
+        return nc_var->nc_dims;
+    }
+
+    dimids[nc_var->nc_dims - 2] = nc->cell_dimid;
+
+    return nc_var->nc_dims - 1;
+}
+
+/******************************************************************************
+ * @brief    Gather and write all values of a double precision variable in
+ *           the layout of the file.
+ *****************************************************************************/
+void
+gather_put_nc_var_double(nc_file_struct *nc,
+                         nc_var_struct  *nc_var,
+                         double         *var)
+{
+    size_t i;
+    size_t start[MAXDIMS];
+
+    for (i = 0; i < MAXDIMS; i++) {
+        start[i] = 0;
+    }
+
+    if (nc->gathered) {
+        gather_put_nc_cells_double(nc->nc_id, nc_var->nc_varid,
+                                   nc_var->nc_dims, start, nc_var->nc_counts,
+                                   var);
+    }
+    else {
+        gather_put_nc_block_double(nc->nc_id, nc_var->nc_varid,
+                                   nc->d_fillvalue, nc_var->nc_dims, start,
+                                   nc_var->nc_counts, var);
+    }
+}
+
+/******************************************************************************
+ * @brief    Gather and write all values of an integer variable in the layout
+ *           of the file.
+ *****************************************************************************/
+void
+gather_put_nc_var_int(nc_file_struct *nc,
+                      nc_var_struct  *nc_var,
+                      int            *var)
+{
+    size_t i;
+    size_t start[MAXDIMS];
+
+    for (i = 0; i < MAXDIMS; i++) {
+        start[i] = 0;
+    }
+
+    if (nc->gathered) {
+        gather_put_nc_cells_int(nc->nc_id, nc_var->nc_varid, nc_var->nc_dims,
+                                start, nc_var->nc_counts, var);
+    }
+    else {
+        gather_put_nc_block_int(nc->nc_id, nc_var->nc_varid, nc->i_fillvalue,
+                                nc_var->nc_dims, start, nc_var->nc_counts,
+                                var);
+    }
+}
+
+/******************************************************************************
+ * @brief    Write all values of a double precision variable in the layout of
+ *           the file, from values that have already been gathered in MPI
+ *           order.
+ * @details  Only called on the master process.
+ *****************************************************************************/
+void
+put_nc_var_double_mapped(nc_file_struct *nc,
+                         nc_var_struct  *nc_var,
+                         double         *mapped)
+{
+    size_t i;
+    size_t start[MAXDIMS];
+
+    for (i = 0; i < MAXDIMS; i++) {
+        start[i] = 0;
+    }
+
+    if (nc->gathered) {
+        put_nc_cells_double_mapped(nc->nc_id, nc_var->nc_varid,
+                                   nc_var->nc_dims, start, nc_var->nc_counts,
+                                   mapped);
+    }
+    else {
+        put_nc_block_double_mapped(nc->nc_id, nc_var->nc_varid,
+                                   nc->d_fillvalue, nc_var->nc_dims, start,
+                                   nc_var->nc_counts, mapped);
+    }
+}
+
+/******************************************************************************
+ * @brief    Write all values of an integer variable in the layout of the
+ *           file, from values that have already been gathered in MPI order.
+ * @details  Only called on the master process.
+ *****************************************************************************/
+void
+put_nc_var_int_mapped(nc_file_struct *nc,
+                      nc_var_struct  *nc_var,
+                      int            *mapped)
+{
+    size_t i;
+    size_t start[MAXDIMS];
+
+    for (i = 0; i < MAXDIMS; i++) {
+        start[i] = 0;
+    }
+
+    if (nc->gathered) {
+        put_nc_cells_int_mapped(nc->nc_id, nc_var->nc_varid, nc_var->nc_dims,
+                                start, nc_var->nc_counts, mapped);
+    }
+    else {
+        put_nc_block_int_mapped(nc->nc_id, nc_var->nc_varid, nc->i_fillvalue,
+                                nc_var->nc_dims, start, nc_var->nc_counts,
+                                mapped);
+    }
+}
+
+/******************************************************************************
+ * @brief    Read and scatter all values of a double precision variable in
+ *           the layout of the file.
+ * @details  The layout only needs to be known on the master process.
+ *****************************************************************************/
+void
+get_scatter_nc_var_double(nc_file_struct *nc,
+                          char           *var_name,
+                          nc_var_struct  *nc_var,
+                          double         *var)
+{
+    size_t i;
+    size_t start[MAXDIMS];
+
+    for (i = 0; i < MAXDIMS; i++) {
+        start[i] = 0;
+    }
+
+    if (nc->gathered) {
+        get_scatter_nc_cells_double(nc->nc_id, var_name, nc_var->nc_dims,
+                                    start, nc_var->nc_counts, var);
+    }
+    else {
+        get_scatter_nc_block_double(nc->nc_id, var_name, nc_var->nc_dims,
+                                    start, nc_var->nc_counts, var);
+    }
+}
+
+/******************************************************************************
+ * @brief    Read and scatter all values of an integer variable in the layout
+ *           of the file.
+ * @details  The layout only needs to be known on the master process.
+ *****************************************************************************/
+void
+get_scatter_nc_var_int(nc_file_struct *nc,
+                       char           *var_name,
+                       nc_var_struct  *nc_var,
+                       int            *var)
+{
+    size_t i;
+    size_t start[MAXDIMS];
+
+    for (i = 0; i < MAXDIMS; i++) {
+        start[i] = 0;
+    }
+
+    if (nc->gathered) {
+        get_scatter_nc_cells_int(nc->nc_id, var_name, nc_var->nc_dims, start,
+                                 nc_var->nc_counts, var);
+    }
+    else {
+        get_scatter_nc_block_int(nc->nc_id, var_name, nc_var->nc_dims, start,
+                                 nc_var->nc_counts, var);
+    }
+}
@@ -0,0 +1,354 @@
+/******************************************************************************
+ * @section DESCRIPTION
+ *
+ * Per-process cache of the initialized model parameters.
+ *
+ * @section LICENSE
+ *
+ * The Variable Infiltration Capacity (VIC) macroscale hydrological model
+ * Copyright (C) 2016 The Computational Hydrology Group, Department of Civil
+ * and Environmental Engineering, University of Washington.
+ *
+ * The VIC model is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *****************************************************************************/
+
+#include <vic_driver_shared_image.h>
+
+/******************************************************************************
+ * @brief    Fold a block of bytes into a 64-bit FNV-1a hash.
+ *****************************************************************************/
+uint64_t
+hash_bytes(const void *data,
+           size_t      nbytes,
+           uint64_t    hash)
+{
+    const unsigned char *bytes = data;
+    size_t               i;
+
+    for (i = 0; i < nbytes; i++) {
+        hash ^= (uint64_t) bytes[i];
+        hash *= FNV_PRIME;
+    }
+
+    return hash;
+}
+
+/******************************************************************************
+ * @brief    Compute the 64-bit FNV-1a hash of the contents of a file.
+ *****************************************************************************/
+uint64_t
+hash_file(char *filename)
+{
+    FILE          *fp;
+    unsigned char *buffer = NULL;
+    size_t         nbytes;
+    uint64_t       hash;
+
+    fp = fopen(filename, "rb");
+    if (fp == NULL) {
+        log_err("Unable to open %s for hashing", filename);
+    }
+
+    buffer = malloc(MAXSTRING * MAXSTRING * sizeof(*buffer));
+    check_alloc_status(buffer, "Memory allocation error.");
+
+    hash = FNV_OFFSET_BASIS;
+    while ((nbytes = fread(buffer, 1, MAXSTRING * MAXSTRING, fp)) > 0) {
+        hash = hash_bytes(buffer, nbytes, hash);
+    }
+    if (ferror(fp)) {
+        log_err("Error reading %s for hashing", filename);
+    }
+
+    fclose(fp);
+    free(buffer);
+
+    return hash;
+}
+
+/******************************************************************************
+ * @brief    Fill the parameter cache header that describes the current run.
+ * @details  The file and setup hashes are computed once on the root process
+ *           and broadcast; the decomposition fields are filled per process.
+ *****************************************************************************/
+void
+get_param_cache_header(param_cache_header_struct *header)
+{
+    extern MPI_Comm          MPI_COMM_VIC;
+    extern domain_struct     global_domain;
+    extern domain_struct     local_domain;
+    extern filenames_struct  filenames;
+    extern option_struct     options;
+    extern parameters_struct param;
+    extern int               mpi_rank;
+    extern int               mpi_size;
+
+    int                      status;
+    size_t                   sizes[5];
+    uint64_t                 hashes[3];
+
+    if (mpi_rank == VIC_MPI_ROOT) {
+        // the cached structures are raw memory images, so a change in their
+        // layout must invalidate the cache as well
+        sizes[0] = sizeof(soil_con_struct);
+        sizes[1] = sizeof(veg_con_map_struct);
+        sizes[2] = sizeof(veg_con_struct);
+        sizes[3] = sizeof(veg_lib_struct);
+        sizes[4] = sizeof(lake_con_struct);
+
+        hashes[0] = hash_file(filenames.params);
+        hashes[1] = hash_file(filenames.domain);
+        hashes[2] = hash_bytes(&options, sizeof(options), FNV_OFFSET_BASIS);
+        hashes[2] = hash_bytes(&param, sizeof(param), hashes[2]);
+        hashes[2] = hash_bytes(sizes, sizeof(sizes), hashes[2]);
+    }
+    status = MPI_Bcast(hashes, 3, MPI_UINT64_T, VIC_MPI_ROOT, MPI_COMM_VIC);
+    check_mpi_status(status, "MPI error.");
+
+    // zero the padding so that headers can be compared bytewise
+    memset(header, 0, sizeof(*header));
+    memcpy(header->magic, PARAM_CACHE_MAGIC, sizeof(header->magic));
+    header->version = PARAM_CACHE_VERSION;
+    header->mpi_size = mpi_size;
+    header->mpi_rank = mpi_rank;
+    header->ncells_active = local_domain.ncells_active;
+    header->global_ncells_active = global_domain.ncells_active;
+    header->params_hash = hashes[0];
+    header->domain_hash = hashes[1];
+    header->setup_hash = hashes[2];
+}
+
+/******************************************************************************
+ * @brief    Read or write one block of the parameter cache.
+ *****************************************************************************/
+bool
+param_cache_block(void   *data,
+                  size_t  size,
+                  size_t  nitems,
+                  FILE   *fp,
+                  bool    to_file)
+{
+    if (to_file) {
+        return fwrite(data, size, nitems, fp) == nitems;
+    }
+    return fread(data, size, nitems, fp) == nitems;
+}
+
+/******************************************************************************
+ * @brief    Read or write the parameter structures of all local cells.
+ * @details  The structures are transferred as raw memory images followed by
+ *           the arrays they point to. When reading, the pointers set up by
+ *           vic_alloc are kept and only the array contents are restored.
+ *****************************************************************************/
+bool
+param_cache_cells(FILE *fp,
+                  bool  to_file)
+{
+    extern domain_struct       local_domain;
+    extern option_struct       options;
+    extern soil_con_struct    *soil_con;
+    extern veg_con_map_struct *veg_con_map;
+    extern veg_con_struct    **veg_con;
+    extern veg_lib_struct    **veg_lib;
+    extern lake_con_struct    *lake_con;
+
+    bool                       ok = true;
+    size_t                     i;
+    size_t                     j;
+    soil_con_struct            soil;
+    veg_con_map_struct         vmap;
+    veg_con_struct             veg;
+
+    for (i = 0; ok && i < local_domain.ncells_active; i++) {
+        // soil parameters and snow bands
+        soil = soil_con[i];
+        ok = param_cache_block(&(soil_con[i]), sizeof(soil_con[i]), 1, fp,
+                               to_file);
+        soil_con[i].BandElev = soil.BandElev;
+        soil_con[i].AreaFract = soil.AreaFract;
+        soil_con[i].Pfactor = soil.Pfactor;
+        soil_con[i].Tfactor = soil.Tfactor;
+        soil_con[i].AboveTreeLine = soil.AboveTreeLine;
+        ok = ok && param_cache_block(soil_con[i].BandElev, sizeof(double),
+                                     options.SNOW_BAND, fp, to_file);
+        ok = ok && param_cache_block(soil_con[i].AreaFract, sizeof(double),
+                                     options.SNOW_BAND, fp, to_file);
+        ok = ok && param_cache_block(soil_con[i].Pfactor, sizeof(double),
+                                     options.SNOW_BAND, fp, to_file);
+        ok = ok && param_cache_block(soil_con[i].Tfactor, sizeof(double),
+                                     options.SNOW_BAND, fp, to_file);
+        ok = ok && param_cache_block(soil_con[i].AboveTreeLine, sizeof(bool),
+                                     options.SNOW_BAND, fp, to_file);
+
+        // vegetation mapping
+        vmap = veg_con_map[i];
+        ok = ok && param_cache_block(&(veg_con_map[i]), sizeof(veg_con_map[i]),
+                                     1, fp, to_file);
+        veg_con_map[i].vidx = vmap.vidx;
+        veg_con_map[i].Cv = vmap.Cv;
+        ok = ok && param_cache_block(veg_con_map[i].vidx, sizeof(int),
+                                     veg_con_map[i].nv_types, fp, to_file);
+        ok = ok && param_cache_block(veg_con_map[i].Cv, sizeof(double),
+                                     veg_con_map[i].nv_types, fp, to_file);
+
+        // vegetation tiles
+        for (j = 0; ok && j < veg_con_map[i].nv_active; j++) {
+            veg = veg_con[i][j];
+            ok = param_cache_block(&(veg_con[i][j]), sizeof(veg_con[i][j]),
+                                   1, fp, to_file);
+            veg_con[i][j].CanopLayerBnd = veg.CanopLayerBnd;
+            veg_con[i][j].zone_depth = veg.zone_depth;
+            veg_con[i][j].zone_fract = veg.zone_fract;
+            ok = ok && param_cache_block(veg_con[i][j].zone_depth,
+                                         sizeof(double), options.ROOT_ZONES,
+                                         fp, to_file);
+            ok = ok && param_cache_block(veg_con[i][j].zone_fract,
+                                         sizeof(double), options.ROOT_ZONES,
+                                         fp, to_file);
+            if (options.CARBON) {
+                ok = ok && param_cache_block(veg_con[i][j].CanopLayerBnd,
+                                             sizeof(double), options.Ncanopy,
+                                             fp, to_file);
+            }
+        }
+
+        // vegetation library
+        ok = ok && param_cache_block(veg_lib[i], sizeof(*(veg_lib[i])),
+                                     options.NVEGTYPES, fp, to_file);
+
+        // lake parameters
+        if (options.LAKES) {
+            ok = ok && param_cache_block(&(lake_con[i]), sizeof(lake_con[i]),
+                                         1, fp, to_file);
+        }
+    }
+
+    return ok;
+}
+
+/******************************************************************************
+ * @brief    Load the model parameters from the parameter cache.
+ * @details  Each process reads its own cache file. The cache is only used if
+ *           the files of all processes match the current parameter file,
+ *           domain file, options and decomposition, so that either every
+ *           process or none takes the collective path through
+ *           vic_init_params.
+ * @return   true if the parameters were loaded from the cache
+ *****************************************************************************/
+bool
+read_param_cache(void)
+{
+    extern MPI_Comm           MPI_COMM_VIC;
+    extern filenames_struct   filenames;
+    extern int                mpi_rank;
+
+    char                      filename[MAXSTRING];
+    FILE                     *fp = NULL;
+    int                       local_ok;
+    int                       global_ok;
+    int                       status;
+    param_cache_header_struct cached;
+    param_cache_header_struct header;
+
+    if (strcmp(filenames.param_cache, "MISSING") == 0) {
+        return false;
+    }
+
+    get_param_cache_header(&header);
+
+    if (snprintf(filename, MAXSTRING, "%s.%d.bin", filenames.param_cache,
+                 mpi_rank) >= MAXSTRING) {
+        log_err("The name of the parameter cache %s is too long",
+                filenames.param_cache);
+    }
+    fp = fopen(filename, "rb");
+    local_ok = fp != NULL &&
+               fread(&cached, sizeof(cached), 1, fp) == 1 &&
+               memcmp(&cached, &header, sizeof(header)) == 0;
+
+    status = MPI_Allreduce(&local_ok, &global_ok, 1, MPI_INT, MPI_MIN,
+                           MPI_COMM_VIC);
+    check_mpi_status(status, "MPI error.");
+
+    if (global_ok) {
+        local_ok = param_cache_cells(fp, false);
+        status = MPI_Allreduce(&local_ok, &global_ok, 1, MPI_INT, MPI_MIN,
+                               MPI_COMM_VIC);
+        check_mpi_status(status, "MPI error.");
+    }
+
+    if (fp != NULL) {
+        fclose(fp);
+    }
+
+    if (global_ok) {
+        log_info("Model parameters read from cache %s", filename);
+    }
+    else {
+        log_info("Parameter cache %s does not match this run, reading "
+                 "parameters from %s", filename, filenames.params);
+    }
+
+    return global_ok;
+}
+
+/******************************************************************************
+ * @brief    Write the model parameters of the local cells to the parameter
+ *           cache.
+ * @details  The cache is written to a temporary file that is renamed once it
+ *           is complete, so a failed write never leaves a truncated cache
+ *           behind. Failing to write the cache is not fatal.
+ *****************************************************************************/
+void
+write_param_cache(void)
+{
+    extern filenames_struct   filenames;
+    extern int                mpi_rank;
+
+    bool                      ok;
+    char                      filename[MAXSTRING];
+    char                      tmpname[MAXSTRING];
+    FILE                     *fp = NULL;
+    param_cache_header_struct header;
+
+    if (strcmp(filenames.param_cache, "MISSING") == 0) {
+        return;
+    }
+
+    get_param_cache_header(&header);
+
+    if (snprintf(filename, MAXSTRING, "%s.%d.bin", filenames.param_cache,
+                 mpi_rank) >= MAXSTRING ||
+        snprintf(tmpname, MAXSTRING, "%s.tmp", filename) >= MAXSTRING) {
+        log_warn("The name of the parameter cache %s is too long, the "
+                 "cache is not written", filenames.param_cache);
+        return;
+    }
+    fp = fopen(tmpname, "wb");
+    if (fp == NULL) {
+        log_warn("Unable to open parameter cache %s for writing", tmpname);
+        return;
+    }
+
+    ok = fwrite(&header, sizeof(header), 1, fp) == 1;
+    ok = ok && param_cache_cells(fp, true);
+    ok = (fclose(fp) == 0) && ok;
+    ok = ok && rename(tmpname, filename) == 0;
+
+    if (!ok) {
+        log_warn("Unable to write parameter cache %s", filename);
+        remove(tmpname);
+    }
+}
@@ -33,12 +33,12 @@ void
 vic_restore(void)
 {
     extern all_vars_struct    *all_vars;
-    extern domain_struct       global_domain;
     extern domain_struct       local_domain;
     extern option_struct       options;
     extern veg_con_map_struct *veg_con_map;
     extern filenames_struct    filenames;
     extern metadata_struct     state_metadata[N_STATE_VARS];
+    extern int                 mpi_rank;
 
     int                        v;
     size_t                     i;
@@ -46,87 +46,60 @@ vic_restore(void)
     size_t                     k;
     size_t                     m;
     size_t                     p;
+    size_t                     nblock;
+    size_t                     max_nblock;
+    int                        status;
     int                       *ivar = NULL;
+    int                       *iblock = NULL;
     double                    *dvar = NULL;
-    size_t                     d2count[2];
-    size_t                     d2start[2];
-    size_t                     d3count[3];
-    size_t                     d3start[3];
-    size_t                     d4count[4];
-    size_t                     d4start[4];
-    size_t                     d5count[5];
-    size_t                     d5start[5];
-    size_t                     d6count[6];
-    size_t                     d6start[6];
+    double                    *dblock = NULL;
+    nc_file_struct             nc_state_file;
+    nc_var_struct             *nc_var;
 
     // validate state file dimensions and coordinate variables
     check_init_state_file();
 
-    // read state variables
+    // read state variables. Each state variable is read with a single call
+    // and scattered as a single block of [nblock][ncells_active], where
+    // nblock is the product of the non-spatial dimensions
+    set_nc_state_file_info(&nc_state_file);
+    set_nc_state_var_info(&nc_state_file);
+
+    // open the state file once for all variables
+    if (mpi_rank == VIC_MPI_ROOT) {
+        status = nc_open(filenames.init_state, NC_NOWRITE,
+                         &(nc_state_file.nc_id));
+        check_nc_status(status, "Error opening %s", filenames.init_state);
+        // the layout of the state file is only needed on the master process
+        get_nc_cell_layout(&nc_state_file, filenames.init_state);
+    }
 
-    // allocate memory for variables to be stored
-    ivar = malloc(local_domain.ncells_active * sizeof(*ivar));
-    check_alloc_status(ivar, "Memory allocation error");
+    // allocate memory for the largest block to be read
+    max_nblock = 1;
+    for (i = 0; i < N_STATE_VARS; i++) {
+        nblock = get_nc_block_size(nc_state_file.nc_vars[i].nc_dims,
+                                   nc_state_file.nc_vars[i].nc_counts);
+        if (nblock > max_nblock) {
+            max_nblock = nblock;
+        }
+    }
 
-    dvar = malloc(local_domain.ncells_active * sizeof(*dvar));
-    check_alloc_status(dvar, "Memory allocation error");
+    iblock = malloc(max_nblock * local_domain.ncells_active * sizeof(*iblock));
+    check_alloc_status(iblock, "Memory allocation error");
 
-    // initialize starts and counts
-    d2start[0] = 0;
-    d2start[1] = 0;
-    d2count[0] = global_domain.n_ny;
-    d2count[1] = global_domain.n_nx;
-
-    d3start[0] = 0;
-    d3start[1] = 0;
-    d3start[2] = 0;
-    d3count[0] = 1;
-    d3count[1] = global_domain.n_ny;
-    d3count[2] = global_domain.n_nx;
-
-    d4start[0] = 0;
-    d4start[1] = 0;
-    d4start[2] = 0;
-    d4start[3] = 0;
-    d4count[0] = 1;
-    d4count[1] = 1;
-    d4count[2] = global_domain.n_ny;
-    d4count[3] = global_domain.n_nx;
-
-    d5start[0] = 0;
-    d5start[1] = 0;
-    d5start[2] = 0;
-    d5start[3] = 0;
-    d5start[4] = 0;
-    d5count[0] = 1;
-    d5count[1] = 1;
-    d5count[2] = 1;
-    d5count[3] = global_domain.n_ny;
-    d5count[4] = global_domain.n_nx;
-
-    d6start[0] = 0;
-    d6start[1] = 0;
-    d6start[2] = 0;
-    d6start[3] = 0;
-    d6start[4] = 0;
-    d6start[5] = 0;
-    d6count[0] = 1;
-    d6count[1] = 1;
-    d6count[2] = 1;
-    d6count[3] = 1;
-    d6count[4] = global_domain.n_ny;
-    d6count[5] = global_domain.n_nx;
+    dblock = malloc(max_nblock * local_domain.ncells_active * sizeof(*dblock));
+    check_alloc_status(dblock, "Memory allocation error");
 
     // total soil moisture
+    nc_var = &(nc_state_file.nc_vars[STATE_SOIL_MOISTURE]);
+    get_scatter_nc_var_double(&nc_state_file,
+                              state_metadata[STATE_SOIL_MOISTURE].varname,
+                              nc_var, dblock);
+    nblock = 0;
     for (m = 0; m < options.NVEGTYPES; m++) {
-        d5start[0] = m;
         for (k = 0; k < options.SNOW_BAND; k++) {
-            d5start[1] = k;
             for (j = 0; j < options.Nlayer; j++) {
-                d5start[2] = j;
-                get_scatter_nc_field_double(filenames.init_state,
-                                            state_metadata[STATE_SOIL_MOISTURE].varname,
-                                            d5start, d5count, dvar);
+                dvar = dblock + nblock++ * local_domain.ncells_active;
                 for (i = 0; i < local_domain.ncells_active; i++) {
                     v = veg_con_map[i].vidx[m];
                     if (v >= 0) {
@@ -138,17 +111,16 @@ vic_restore(void)
     }
 
     // ice content
+    nc_var = &(nc_state_file.nc_vars[STATE_SOIL_ICE]);
+    get_scatter_nc_var_double(&nc_state_file,
+                              state_metadata[STATE_SOIL_ICE].varname, nc_var,
+                              dblock);
+    nblock = 0;
     for (m = 0; m < options.NVEGTYPES; m++) {
-        d6start[0] = m;
         for (k = 0; k < options.SNOW_BAND; k++) {
-            d6start[1] = k;
             for (j = 0; j < options.Nlayer; j++) {
-                d6start[2] = j;
                 for (p = 0; p < options.Nfrost; p++) {
-                    d6start[3] = p;
-                    get_scatter_nc_field_double(filenames.init_state,
-                                                state_metadata[STATE_SOIL_ICE].varname,
-                                                d6start, d6count, dvar);
+                    dvar = dblock + nblock++ * local_domain.ncells_active;
                     for (i = 0; i < local_domain.ncells_active; i++) {
                         v = veg_con_map[i].vidx[m];
                         if (v >= 0) {
@@ -161,13 +133,14 @@ vic_restore(void)
     }
 
     // dew storage: tmpval = veg_var[veg][band].Wdew;
+    nc_var = &(nc_state_file.nc_vars[STATE_CANOPY_WATER]);
+    get_scatter_nc_var_double(&nc_state_file,
+                              state_metadata[STATE_CANOPY_WATER].varname,
+                              nc_var, dblock);
+    nblock = 0;
     for (m = 0; m < options.NVEGTYPES; m++) {
-        d4start[0] = m;
         for (k = 0; k < options.SNOW_BAND; k++) {
-            d4start[1] = k;
-            get_scatter_nc_field_double(filenames.init_state,
-                                        state_metadata[STATE_CANOPY_WATER].varname,
-                                        d4start, d4count, dvar);
+            dvar = dblock + nblock++ * local_domain.ncells_active;
             for (i = 0; i < local_domain.ncells_active; i++) {
                 v = veg_con_map[i].vidx[m];
                 if (v >= 0) {
@@ -179,13 +152,14 @@ vic_restore(void)
 
     if (options.CARBON) {
         // cumulative NPP: tmpval = veg_var[veg][band].AnnualNPP;
+        nc_var = &(nc_state_file.nc_vars[STATE_ANNUALNPP]);
+        get_scatter_nc_var_double(&nc_state_file,
+                                  state_metadata[STATE_ANNUALNPP].varname,
+                                  nc_var, dblock);
+        nblock = 0;
         for (m = 0; m < options.NVEGTYPES; m++) {
-            d4start[0] = m;
             for (k = 0; k < options.SNOW_BAND; k++) {
-                d4start[1] = k;
-                get_scatter_nc_field_double(filenames.init_state,
-                                            state_metadata[STATE_ANNUALNPP].varname,
-                                            d4start, d4count, dvar);
+                dvar = dblock + nblock++ * local_domain.ncells_active;
                 for (i = 0; i < local_domain.ncells_active; i++) {
                     v = veg_con_map[i].vidx[m];
                     if (v >= 0) {
@@ -196,13 +170,14 @@ vic_restore(void)
         }
 
         // previous NPP: tmpval = veg_var[veg][band].AnnualNPPPrev;
+        nc_var = &(nc_state_file.nc_vars[STATE_ANNUALNPPPREV]);
+        get_scatter_nc_var_double(&nc_state_file,
+                                  state_metadata[STATE_ANNUALNPPPREV].varname,
+                                  nc_var, dblock);
+        nblock = 0;
         for (m = 0; m < options.NVEGTYPES; m++) {
-            d4start[0] = m;
             for (k = 0; k < options.SNOW_BAND; k++) {
-                d4start[1] = k;
-                get_scatter_nc_field_double(filenames.init_state,
-                                            state_metadata[STATE_ANNUALNPPPREV].varname,
-                                            d4start, d4count, dvar);
+                dvar = dblock + nblock++ * local_domain.ncells_active;
                 for (i = 0; i < local_domain.ncells_active; i++) {
                     v = veg_con_map[i].vidx[m];
                     if (v >= 0) {
@@ -213,13 +188,14 @@ vic_restore(void)
         }
 
         // litter carbon: tmpval = cell[veg][band].CLitter;
+        nc_var = &(nc_state_file.nc_vars[STATE_CLITTER]);
+        get_scatter_nc_var_double(&nc_state_file,
+                                  state_metadata[STATE_CLITTER].varname, nc_var,
+                                  dblock);
+        nblock = 0;
         for (m = 0; m < options.NVEGTYPES; m++) {
-            d4start[0] = m;
             for (k = 0; k < options.SNOW_BAND; k++) {
-                d4start[1] = k;
-                get_scatter_nc_field_double(filenames.init_state,
-                                            state_metadata[STATE_CLITTER].varname,
-                                            d4start, d4count, dvar);
+                dvar = dblock + nblock++ * local_domain.ncells_active;
                 for (i = 0; i < local_domain.ncells_active; i++) {
                     v = veg_con_map[i].vidx[m];
                     if (v >= 0) {
@@ -230,13 +206,14 @@ vic_restore(void)
         }
 
         // intermediate carbon: tmpval = cell[veg][band].CInter;
+        nc_var = &(nc_state_file.nc_vars[STATE_CINTER]);
+        get_scatter_nc_var_double(&nc_state_file,
+                                  state_metadata[STATE_CINTER].varname, nc_var,
+                                  dblock);
+        nblock = 0;
         for (m = 0; m < options.NVEGTYPES; m++) {
-            d4start[0] = m;
             for (k = 0; k < options.SNOW_BAND; k++) {
-                d4start[1] = k;
-                get_scatter_nc_field_double(filenames.init_state,
-                                            state_metadata[STATE_CINTER].varname,
-                                            d4start, d4count, dvar);
+                dvar = dblock + nblock++ * local_domain.ncells_active;
                 for (i = 0; i < local_domain.ncells_active; i++) {
                     v = veg_con_map[i].vidx[m];
                     if (v >= 0) {
@@ -247,13 +224,14 @@ vic_restore(void)
         }
 
         // slow carbon: tmpval = cell[veg][band].CSlow;
+        nc_var = &(nc_state_file.nc_vars[STATE_CSLOW]);
+        get_scatter_nc_var_double(&nc_state_file,
+                                  state_metadata[STATE_CSLOW].varname, nc_var,
+                                  dblock);
+        nblock = 0;
         for (m = 0; m < options.NVEGTYPES; m++) {
-            d4start[0] = m;
             for (k = 0; k < options.SNOW_BAND; k++) {
-                d4start[1] = k;
-                get_scatter_nc_field_double(filenames.init_state,
-                                            state_metadata[STATE_CSLOW].varname,
-                                            d4start, d4count, dvar);
+                dvar = dblock + nblock++ * local_domain.ncells_active;
                 for (i = 0; i < local_domain.ncells_active; i++) {
                     v = veg_con_map[i].vidx[m];
                     if (v >= 0) {
@@ -265,13 +243,14 @@ vic_restore(void)
     }
 
     // snow age: snow[veg][band].last_snow
+    nc_var = &(nc_state_file.nc_vars[STATE_SNOW_AGE]);
+    get_scatter_nc_var_int(&nc_state_file,
+                           state_metadata[STATE_SNOW_AGE].varname, nc_var,
+                           iblock);
+    nblock = 0;
     for (m = 0; m < options.NVEGTYPES; m++) {
-        d4start[0] = m;
         for (k = 0; k < options.SNOW_BAND; k++) {
-            d4start[1] = k;
-            get_scatter_nc_field_int(filenames.init_state,
-                                     state_metadata[STATE_SNOW_AGE].varname,
-                                     d4start, d4count, ivar);
+            ivar = iblock + nblock++ * local_domain.ncells_active;
             for (i = 0; i < local_domain.ncells_active; i++) {
                 v = veg_con_map[i].vidx[m];
                 if (v >= 0) {
@@ -282,13 +261,14 @@ vic_restore(void)
     }
 
     // melting state: (int)snow[veg][band].MELTING
+    nc_var = &(nc_state_file.nc_vars[STATE_SNOW_MELT_STATE]);
+    get_scatter_nc_var_int(&nc_state_file,
+                           state_metadata[STATE_SNOW_MELT_STATE].varname,
+                           nc_var, iblock);
+    nblock = 0;
     for (m = 0; m < options.NVEGTYPES; m++) {
-        d4start[0] = m;
         for (k = 0; k < options.SNOW_BAND; k++) {
-            d4start[1] = k;
-            get_scatter_nc_field_int(filenames.init_state,
-                                     state_metadata[STATE_SNOW_MELT_STATE].varname,
-                                     d4start, d4count, ivar);
+            ivar = iblock + nblock++ * local_domain.ncells_active;
             for (i = 0; i < local_domain.ncells_active; i++) {
                 v = veg_con_map[i].vidx[m];
                 if (v >= 0) {
@@ -299,13 +279,14 @@ vic_restore(void)
     }
 
     // snow covered fraction: snow[veg][band].coverage
+    nc_var = &(nc_state_file.nc_vars[STATE_SNOW_COVERAGE]);
+    get_scatter_nc_var_double(&nc_state_file,
+                              state_metadata[STATE_SNOW_COVERAGE].varname,
+                              nc_var, dblock);
+    nblock = 0;
     for (m = 0; m < options.NVEGTYPES; m++) {
-        d4start[0] = m;
         for (k = 0; k < options.SNOW_BAND; k++) {
-            d4start[1] = k;
-            get_scatter_nc_field_double(filenames.init_state,
-                                        state_metadata[STATE_SNOW_COVERAGE].varname,
-                                        d4start, d4count, dvar);
+            dvar = dblock + nblock++ * local_domain.ncells_active;
             for (i = 0; i < local_domain.ncells_active; i++) {
                 v = veg_con_map[i].vidx[m];
                 if (v >= 0) {
@@ -316,14 +297,15 @@ vic_restore(void)
     }
 
     // snow water equivalent: snow[veg][band].swq
+    nc_var = &(nc_state_file.nc_vars[STATE_SNOW_WATER_EQUIVALENT]);
+    get_scatter_nc_var_double(&nc_state_file,
+                              state_metadata[
+                                  STATE_SNOW_WATER_EQUIVALENT].varname,
+                              nc_var, dblock);
+    nblock = 0;
     for (m = 0; m < options.NVEGTYPES; m++) {
-        d4start[0] = m;
         for (k = 0; k < options.SNOW_BAND; k++) {
-            d4start[1] = k;
-            get_scatter_nc_field_double(filenames.init_state,
-                                        state_metadata[
-                                            STATE_SNOW_WATER_EQUIVALENT].varname,
-                                        d4start, d4count, dvar);
+            dvar = dblock + nblock++ * local_domain.ncells_active;
             for (i = 0; i < local_domain.ncells_active; i++) {
                 v = veg_con_map[i].vidx[m];
                 if (v >= 0) {
@@ -334,13 +316,14 @@ vic_restore(void)
     }
 
     // snow surface temperature: snow[veg][band].surf_temp
+    nc_var = &(nc_state_file.nc_vars[STATE_SNOW_SURF_TEMP]);
+    get_scatter_nc_var_double(&nc_state_file,
+                              state_metadata[STATE_SNOW_SURF_TEMP].varname,
+                              nc_var, dblock);
+    nblock = 0;
     for (m = 0; m < options.NVEGTYPES; m++) {
-        d4start[0] = m;
         for (k = 0; k < options.SNOW_BAND; k++) {
-            d4start[1] = k;
-            get_scatter_nc_field_double(filenames.init_state,
-                                        state_metadata[STATE_SNOW_SURF_TEMP].varname,
-                                        d4start, d4count, dvar);
+            dvar = dblock + nblock++ * local_domain.ncells_active;
             for (i = 0; i < local_domain.ncells_active; i++) {
                 v = veg_con_map[i].vidx[m];
                 if (v >= 0) {
@@ -351,13 +334,14 @@ vic_restore(void)
     }
 
     // snow surface water: snow[veg][band].surf_water
+    nc_var = &(nc_state_file.nc_vars[STATE_SNOW_SURF_WATER]);
+    get_scatter_nc_var_double(&nc_state_file,
+                              state_metadata[STATE_SNOW_SURF_WATER].varname,
+                              nc_var, dblock);
+    nblock = 0;
     for (m = 0; m < options.NVEGTYPES; m++) {
-        d4start[0] = m;
         for (k = 0; k < options.SNOW_BAND; k++) {
-            d4start[1] = k;
-            get_scatter_nc_field_double(filenames.init_state,
-                                        state_metadata[STATE_SNOW_SURF_WATER].varname,
-                                        d4start, d4count, dvar);
+            dvar = dblock + nblock++ * local_domain.ncells_active;
             for (i = 0; i < local_domain.ncells_active; i++) {
                 v = veg_con_map[i].vidx[m];
                 if (v >= 0) {
@@ -368,13 +352,14 @@ vic_restore(void)
     }
 
     // snow pack temperature: snow[veg][band].pack_temp
+    nc_var = &(nc_state_file.nc_vars[STATE_SNOW_PACK_TEMP]);
+    get_scatter_nc_var_double(&nc_state_file,
+                              state_metadata[STATE_SNOW_PACK_TEMP].varname,
+                              nc_var, dblock);
+    nblock = 0;
     for (m = 0; m < options.NVEGTYPES; m++) {
-        d4start[0] = m;
         for (k = 0; k < options.SNOW_BAND; k++) {
-            d4start[1] = k;
-            get_scatter_nc_field_double(filenames.init_state,
-                                        state_metadata[STATE_SNOW_PACK_TEMP].varname,
-                                        d4start, d4count, dvar);
+            dvar = dblock + nblock++ * local_domain.ncells_active;
             for (i = 0; i < local_domain.ncells_active; i++) {
                 v = veg_con_map[i].vidx[m];
                 if (v >= 0) {
@@ -385,13 +370,14 @@ vic_restore(void)
     }
 
     // snow pack water: snow[veg][band].pack_water
+    nc_var = &(nc_state_file.nc_vars[STATE_SNOW_PACK_WATER]);
+    get_scatter_nc_var_double(&nc_state_file,
+                              state_metadata[STATE_SNOW_PACK_WATER].varname,
+                              nc_var, dblock);
+    nblock = 0;
     for (m = 0; m < options.NVEGTYPES; m++) {
-        d4start[0] = m;
         for (k = 0; k < options.SNOW_BAND; k++) {
-            d4start[1] = k;
-            get_scatter_nc_field_double(filenames.init_state,
-                                        state_metadata[STATE_SNOW_PACK_WATER].varname,
-                                        d4start, d4count, dvar);
+            dvar = dblock + nblock++ * local_domain.ncells_active;
             for (i = 0; i < local_domain.ncells_active; i++) {
                 v = veg_con_map[i].vidx[m];
                 if (v >= 0) {
@@ -402,13 +388,14 @@ vic_restore(void)
     }
 
     // snow density: snow[veg][band].density
+    nc_var = &(nc_state_file.nc_vars[STATE_SNOW_DENSITY]);
+    get_scatter_nc_var_double(&nc_state_file,
+                              state_metadata[STATE_SNOW_DENSITY].varname,
+                              nc_var, dblock);
+    nblock = 0;
     for (m = 0; m < options.NVEGTYPES; m++) {
-        d4start[0] = m;
         for (k = 0; k < options.SNOW_BAND; k++) {
-            d4start[1] = k;
-            get_scatter_nc_field_double(filenames.init_state,
-                                        state_metadata[STATE_SNOW_DENSITY].varname,
-                                        d4start, d4count, dvar);
+            dvar = dblock + nblock++ * local_domain.ncells_active;
             for (i = 0; i < local_domain.ncells_active; i++) {
                 v = veg_con_map[i].vidx[m];
                 if (v >= 0) {
@@ -419,13 +406,14 @@ vic_restore(void)
     }
 
     // snow cold content: snow[veg][band].coldcontent
+    nc_var = &(nc_state_file.nc_vars[STATE_SNOW_COLD_CONTENT]);
+    get_scatter_nc_var_double(&nc_state_file,
+                              state_metadata[STATE_SNOW_COLD_CONTENT].varname,
+                              nc_var, dblock);
+    nblock = 0;
     for (m = 0; m < options.NVEGTYPES; m++) {
-        d4start[0] = m;
         for (k = 0; k < options.SNOW_BAND; k++) {
-            d4start[1] = k;
-            get_scatter_nc_field_double(filenames.init_state,
-                                        state_metadata[STATE_SNOW_COLD_CONTENT].varname,
-                                        d4start, d4count, dvar);
+            dvar = dblock + nblock++ * local_domain.ncells_active;
             for (i = 0; i < local_domain.ncells_active; i++) {
                 v = veg_con_map[i].vidx[m];
                 if (v >= 0) {
@@ -436,13 +424,14 @@ vic_restore(void)
     }
 
     // snow canopy storage: snow[veg][band].snow_canopy
+    nc_var = &(nc_state_file.nc_vars[STATE_SNOW_CANOPY]);
+    get_scatter_nc_var_double(&nc_state_file,
+                              state_metadata[STATE_SNOW_CANOPY].varname, nc_var,
+                              dblock);
+    nblock = 0;
     for (m = 0; m < options.NVEGTYPES; m++) {
-        d4start[0] = m;
         for (k = 0; k < options.SNOW_BAND; k++) {
-            d4start[1] = k;
-            get_scatter_nc_field_double(filenames.init_state,
-                                        state_metadata[STATE_SNOW_CANOPY].varname,
-                                        d4start, d4count, dvar);
+            dvar = dblock + nblock++ * local_domain.ncells_active;
             for (i = 0; i < local_domain.ncells_active; i++) {
                 v = veg_con_map[i].vidx[m];
                 if (v >= 0) {
@@ -453,15 +442,15 @@ vic_restore(void)
     }
 
     // soil node temperatures: energy[veg][band].T[nidx]
+    nc_var = &(nc_state_file.nc_vars[STATE_SOIL_NODE_TEMP]);
+    get_scatter_nc_var_double(&nc_state_file,
+                              state_metadata[STATE_SOIL_NODE_TEMP].varname,
+                              nc_var, dblock);
+    nblock = 0;
     for (m = 0; m < options.NVEGTYPES; m++) {
-        d5start[0] = m;
         for (k = 0; k < options.SNOW_BAND; k++) {
-            d5start[1] = k;
             for (j = 0; j < options.Nnode; j++) {
-                d5start[2] = j;
-                get_scatter_nc_field_double(filenames.init_state,
-                                            state_metadata[STATE_SOIL_NODE_TEMP].varname,
-                                            d5start, d5count, dvar);
+                dvar = dblock + nblock++ * local_domain.ncells_active;
                 for (i = 0; i < local_domain.ncells_active; i++) {
                     v = veg_con_map[i].vidx[m];
                     if (v >= 0) {
@@ -473,13 +462,14 @@ vic_restore(void)
     }
 
     // Foliage temperature: energy[veg][band].Tfoliage
+    nc_var = &(nc_state_file.nc_vars[STATE_FOLIAGE_TEMPERATURE]);
+    get_scatter_nc_var_double(&nc_state_file,
+                              state_metadata[STATE_FOLIAGE_TEMPERATURE].varname,
+                              nc_var, dblock);
+    nblock = 0;
     for (m = 0; m < options.NVEGTYPES; m++) {
-        d4start[0] = m;
         for (k = 0; k < options.SNOW_BAND; k++) {
-            d4start[1] = k;
-            get_scatter_nc_field_double(filenames.init_state,
-                                        state_metadata[STATE_FOLIAGE_TEMPERATURE].varname,
-                                        d4start, d4count, dvar);
+            dvar = dblock + nblock++ * local_domain.ncells_active;
             for (i = 0; i < local_domain.ncells_active; i++) {
                 v = veg_con_map[i].vidx[m];
                 if (v >= 0) {
@@ -491,13 +481,14 @@ vic_restore(void)
 
     // Outgoing longwave from understory: energy[veg][band].LongUnderOut
     // This is a flux. Saving it to state file is a temporary solution!!
+    nc_var = &(nc_state_file.nc_vars[STATE_ENERGY_LONGUNDEROUT]);
+    get_scatter_nc_var_double(&nc_state_file,
+                              state_metadata[STATE_ENERGY_LONGUNDEROUT].varname,
+                              nc_var, dblock);
+    nblock = 0;
     for (m = 0; m < options.NVEGTYPES; m++) {
-        d4start[0] = m;
         for (k = 0; k < options.SNOW_BAND; k++) {
-            d4start[1] = k;
-            get_scatter_nc_field_double(filenames.init_state,
-                                        state_metadata[STATE_ENERGY_LONGUNDEROUT].varname,
-                                        d4start, d4count, dvar);
+            dvar = dblock + nblock++ * local_domain.ncells_active;
             for (i = 0; i < local_domain.ncells_active; i++) {
                 v = veg_con_map[i].vidx[m];
                 if (v >= 0) {
@@ -509,13 +500,14 @@ vic_restore(void)
 
     // Thermal flux through the snow pack: energy[veg][band].snow_flux
     // This is a flux. Saving it to state file is a temporary solution!!
+    nc_var = &(nc_state_file.nc_vars[STATE_ENERGY_SNOW_FLUX]);
+    get_scatter_nc_var_double(&nc_state_file,
+                              state_metadata[STATE_ENERGY_SNOW_FLUX].varname,
+                              nc_var, dblock);
+    nblock = 0;
     for (m = 0; m < options.NVEGTYPES; m++) {
-        d4start[0] = m;
         for (k = 0; k < options.SNOW_BAND; k++) {
-            d4start[1] = k;
-            get_scatter_nc_field_double(filenames.init_state,
-                                        state_metadata[STATE_ENERGY_SNOW_FLUX].varname,
-                                        d4start, d4count, dvar);
+            dvar = dblock + nblock++ * local_domain.ncells_active;
             for (i = 0; i < local_domain.ncells_active; i++) {
                 v = veg_con_map[i].vidx[m];
                 if (v >= 0) {
@@ -527,24 +519,28 @@ vic_restore(void)
 
     if (options.LAKES) {
         // total soil moisture
+        nc_var = &(nc_state_file.nc_vars[STATE_LAKE_SOIL_MOISTURE]);
+        get_scatter_nc_var_double(&nc_state_file,
+                                  state_metadata[
+                                      STATE_LAKE_SOIL_MOISTURE].varname,
+                                  nc_var, dblock);
+        nblock = 0;
         for (j = 0; j < options.Nlayer; j++) {
-            d3start[0] = j;
-            get_scatter_nc_field_double(filenames.init_state,
-                                        state_metadata[STATE_LAKE_SOIL_MOISTURE].varname,
-                                        d3start, d3count, dvar);
+            dvar = dblock + nblock++ * local_domain.ncells_active;
             for (i = 0; i < local_domain.ncells_active; i++) {
                 all_vars[i].lake_var.soil.layer[j].moist = dvar[i];
             }
         }
 
         // ice content
+        nc_var = &(nc_state_file.nc_vars[STATE_LAKE_SOIL_ICE]);
+        get_scatter_nc_var_double(&nc_state_file,
+                                  state_metadata[STATE_LAKE_SOIL_ICE].varname,
+                                  nc_var, dblock);
+        nblock = 0;
         for (j = 0; j < options.Nlayer; j++) {
-            d4start[0] = j;
             for (p = 0; p < options.Nfrost; p++) {
-                d4start[1] = p;
-                get_scatter_nc_field_double(filenames.init_state,
-                                            state_metadata[STATE_LAKE_SOIL_ICE].varname,
-                                            d4start, d4count, dvar);
+                dvar = dblock + nblock++ * local_domain.ncells_active;
                 for (i = 0; i < local_domain.ncells_active; i++) {
                     all_vars[i].lake_var.soil.layer[j].ice[p] = dvar[i];
                 }
@@ -553,320 +549,385 @@ vic_restore(void)
 
         if (options.CARBON) {
             // litter carbon: tmpval = lake_var.soil.CLitter;
-            get_scatter_nc_field_double(filenames.init_state,
-                                        state_metadata[STATE_LAKE_CLITTER].varname,
-                                        d2start, d2count, dvar);
+            nc_var = &(nc_state_file.nc_vars[STATE_LAKE_CLITTER]);
+            get_scatter_nc_var_double(&nc_state_file,
+                                      state_metadata[
+                                          STATE_LAKE_CLITTER].varname,
+                                      nc_var, dblock);
             for (i = 0; i < local_domain.ncells_active; i++) {
-                all_vars[i].lake_var.soil.CLitter = dvar[i];
+                all_vars[i].lake_var.soil.CLitter = dblock[i];
             }
 
             // intermediate carbon: tmpval = lake_var.soil.CInter;
-            get_scatter_nc_field_double(filenames.init_state,
-                                        state_metadata[STATE_LAKE_CINTER].varname,
-                                        d2start, d2count, dvar);
+            nc_var = &(nc_state_file.nc_vars[STATE_LAKE_CINTER]);
+            get_scatter_nc_var_double(&nc_state_file,
+                                      state_metadata[STATE_LAKE_CINTER].varname,
+                                      nc_var, dblock);
             for (i = 0; i < local_domain.ncells_active; i++) {
-                all_vars[i].lake_var.soil.CInter = dvar[i];
+                all_vars[i].lake_var.soil.CInter = dblock[i];
             }
 
             // slow carbon: tmpval = lake_var.soil.CSlow;
-            get_scatter_nc_field_double(filenames.init_state,
-                                        state_metadata[STATE_LAKE_CSLOW].varname,
-                                        d2start, d2count, dvar);
+            nc_var = &(nc_state_file.nc_vars[STATE_LAKE_CSLOW]);
+            get_scatter_nc_var_double(&nc_state_file,
+                                      state_metadata[STATE_LAKE_CSLOW].varname,
+                                      nc_var, dblock);
             for (i = 0; i < local_domain.ncells_active; i++) {
-                all_vars[i].lake_var.soil.CSlow = dvar[i];
+                all_vars[i].lake_var.soil.CSlow = dblock[i];
             }
         }
 
         // snow age: lake_var.snow.last_snow
-        get_scatter_nc_field_int(filenames.init_state,
-                                 state_metadata[STATE_LAKE_SNOW_AGE].varname,
-                                 d2start, d2count, ivar);
+        nc_var = &(nc_state_file.nc_vars[STATE_LAKE_SNOW_AGE]);
+        get_scatter_nc_var_int(&nc_state_file,
+                               state_metadata[STATE_LAKE_SNOW_AGE].varname,
+                               nc_var, iblock);
         for (i = 0; i < local_domain.ncells_active; i++) {
-            all_vars[i].lake_var.snow.last_snow = ivar[i];
+            all_vars[i].lake_var.snow.last_snow = iblock[i];
         }
 
         // melting state: (int)lake_var.snow.MELTING
-        get_scatter_nc_field_int(filenames.init_state,
-                                 state_metadata[STATE_LAKE_SNOW_MELT_STATE].varname,
-                                 d2start, d2count, ivar);
+        nc_var = &(nc_state_file.nc_vars[STATE_LAKE_SNOW_MELT_STATE]);
+        get_scatter_nc_var_int(&nc_state_file,
+                               state_metadata[
+                                   STATE_LAKE_SNOW_MELT_STATE].varname,
+                               nc_var, iblock);
         for (i = 0; i < local_domain.ncells_active; i++) {
-            all_vars[i].lake_var.snow.MELTING = ivar[i];
+            all_vars[i].lake_var.snow.MELTING = iblock[i];
         }
 
         // snow covered fraction: lake_var.snow.coverage
-        get_scatter_nc_field_double(filenames.init_state,
-                                    state_metadata[STATE_LAKE_SNOW_COVERAGE].varname,
-                                    d2start, d2count, dvar);
+        nc_var = &(nc_state_file.nc_vars[STATE_LAKE_SNOW_COVERAGE]);
+        get_scatter_nc_var_double(&nc_state_file,
+                                  state_metadata[
+                                      STATE_LAKE_SNOW_COVERAGE].varname,
+                                  nc_var, dblock);
         for (i = 0; i < local_domain.ncells_active; i++) {
-            all_vars[i].lake_var.snow.coverage = dvar[i];
+            all_vars[i].lake_var.snow.coverage = dblock[i];
         }
 
         // snow water equivalent: lake_var.snow.swq
-        get_scatter_nc_field_double(filenames.init_state,
-                                    state_metadata[
-                                        STATE_LAKE_SNOW_WATER_EQUIVALENT].varname,
-                                    d2start, d2count, dvar);
+        nc_var = &(nc_state_file.nc_vars[STATE_LAKE_SNOW_WATER_EQUIVALENT]);
+        get_scatter_nc_var_double(&nc_state_file,
+                                  state_metadata[
+                                      STATE_LAKE_SNOW_WATER_EQUIVALENT].varname,
+                                  nc_var, dblock);
         for (i = 0; i < local_domain.ncells_active; i++) {
-            all_vars[i].lake_var.snow.swq = dvar[i];
+            all_vars[i].lake_var.snow.swq = dblock[i];
         }
 
         // snow surface temperature: lake_var.snow.surf_temp
-        get_scatter_nc_field_double(filenames.init_state,
-                                    state_metadata[STATE_LAKE_SNOW_SURF_TEMP].varname,
-                                    d2start, d2count, dvar);
+        nc_var = &(nc_state_file.nc_vars[STATE_LAKE_SNOW_SURF_TEMP]);
+        get_scatter_nc_var_double(&nc_state_file,
+                                  state_metadata[
+                                      STATE_LAKE_SNOW_SURF_TEMP].varname,
+                                  nc_var, dblock);
         for (i = 0; i < local_domain.ncells_active; i++) {
-            all_vars[i].lake_var.snow.surf_temp = dvar[i];
+            all_vars[i].lake_var.snow.surf_temp = dblock[i];
         }
 
         // snow surface water: lake_var.snow.surf_water
-        get_scatter_nc_field_double(filenames.init_state,
-                                    state_metadata[STATE_LAKE_SNOW_SURF_WATER].varname,
-                                    d2start, d2count, dvar);
+        nc_var = &(nc_state_file.nc_vars[STATE_LAKE_SNOW_SURF_WATER]);
+        get_scatter_nc_var_double(&nc_state_file,
+                                  state_metadata[
+                                      STATE_LAKE_SNOW_SURF_WATER].varname,
+                                  nc_var, dblock);
         for (i = 0; i < local_domain.ncells_active; i++) {
-            all_vars[i].lake_var.snow.surf_water = dvar[i];
+            all_vars[i].lake_var.snow.surf_water = dblock[i];
         }
 
         // snow pack temperature: lake_var.snow.pack_temp
-        get_scatter_nc_field_double(filenames.init_state,
-                                    state_metadata[STATE_LAKE_SNOW_PACK_TEMP].varname,
-                                    d2start, d2count, dvar);
+        nc_var = &(nc_state_file.nc_vars[STATE_LAKE_SNOW_PACK_TEMP]);
+        get_scatter_nc_var_double(&nc_state_file,
+                                  state_metadata[
+                                      STATE_LAKE_SNOW_PACK_TEMP].varname,
+                                  nc_var, dblock);
         for (i = 0; i < local_domain.ncells_active; i++) {
-            all_vars[i].lake_var.snow.pack_temp = dvar[i];
+            all_vars[i].lake_var.snow.pack_temp = dblock[i];
         }
 
         // snow pack water: lake_var.snow.pack_water
-        get_scatter_nc_field_double(filenames.init_state,
-                                    state_metadata[STATE_LAKE_SNOW_PACK_WATER].varname,
-                                    d2start, d2count, dvar);
+        nc_var = &(nc_state_file.nc_vars[STATE_LAKE_SNOW_PACK_WATER]);
+        get_scatter_nc_var_double(&nc_state_file,
+                                  state_metadata[
+                                      STATE_LAKE_SNOW_PACK_WATER].varname,
+                                  nc_var, dblock);
         for (i = 0; i < local_domain.ncells_active; i++) {
-            all_vars[i].lake_var.snow.pack_water = dvar[i];
+            all_vars[i].lake_var.snow.pack_water = dblock[i];
         }
 
         // snow density: lake_var.snow.density
-        get_scatter_nc_field_double(filenames.init_state,
-                                    state_metadata[STATE_LAKE_SNOW_SURF_TEMP].varname,
-                                    d2start, d2count, dvar);
+        nc_var = &(nc_state_file.nc_vars[STATE_LAKE_SNOW_SURF_TEMP]);
+        get_scatter_nc_var_double(&nc_state_file,
+                                  state_metadata[
+                                      STATE_LAKE_SNOW_SURF_TEMP].varname,
+                                  nc_var, dblock);
         for (i = 0; i < local_domain.ncells_active; i++) {
-            all_vars[i].lake_var.snow.density = dvar[i];
+            all_vars[i].lake_var.snow.density = dblock[i];
         }
 
         // snow cold content: lake_var.snow.coldcontent
-        get_scatter_nc_field_double(filenames.init_state,
-                                    state_metadata[STATE_LAKE_SNOW_COLD_CONTENT].varname,
-                                    d2start, d2count, dvar);
+        nc_var = &(nc_state_file.nc_vars[STATE_LAKE_SNOW_COLD_CONTENT]);
+        get_scatter_nc_var_double(&nc_state_file,
+                                  state_metadata[
+                                      STATE_LAKE_SNOW_COLD_CONTENT].varname,
+                                  nc_var, dblock);
         for (i = 0; i < local_domain.ncells_active; i++) {
-            all_vars[i].lake_var.snow.coldcontent = dvar[i];
+            all_vars[i].lake_var.snow.coldcontent = dblock[i];
         }
 
         // snow canopy storage: lake_var.snow.snow_canopy
-        get_scatter_nc_field_double(filenames.init_state,
-                                    state_metadata[STATE_LAKE_SNOW_CANOPY].varname,
-                                    d2start, d2count, dvar);
+        nc_var = &(nc_state_file.nc_vars[STATE_LAKE_SNOW_CANOPY]);
+        get_scatter_nc_var_double(&nc_state_file,
+                                  state_metadata[
+                                      STATE_LAKE_SNOW_CANOPY].varname,
+                                  nc_var, dblock);
         for (i = 0; i < local_domain.ncells_active; i++) {
-            all_vars[i].lake_var.snow.snow_canopy = dvar[i];
+            all_vars[i].lake_var.snow.snow_canopy = dblock[i];
         }
 
         // soil node temperatures: lake_var.energy.T[nidx]
+        nc_var = &(nc_state_file.nc_vars[STATE_LAKE_SOIL_NODE_TEMP]);
+        get_scatter_nc_var_double(&nc_state_file,
+                                  state_metadata[
+                                      STATE_LAKE_SOIL_NODE_TEMP].varname,
+                                  nc_var, dblock);
+        nblock = 0;
         for (j = 0; j < options.Nnode; j++) {
-            d3start[0] = j;
-            get_scatter_nc_field_double(filenames.init_state,
-                                        state_metadata[STATE_LAKE_SOIL_NODE_TEMP].varname,
-                                        d3start, d3count, dvar);
+            dvar = dblock + nblock++ * local_domain.ncells_active;
             for (i = 0; i < local_domain.ncells_active; i++) {
                 all_vars[i].lake_var.soil.layer[j].moist = dvar[i];
             }
         }
 
         // lake active layers: lake_var.activenod
-        get_scatter_nc_field_int(filenames.init_state,
-                                 state_metadata[STATE_LAKE_ACTIVE_LAYERS].varname,
-                                 d2start, d2count, ivar);
+        nc_var = &(nc_state_file.nc_vars[STATE_LAKE_ACTIVE_LAYERS]);
+        get_scatter_nc_var_int(&nc_state_file,
+                               state_metadata[STATE_LAKE_ACTIVE_LAYERS].varname,
+                               nc_var, iblock);
         for (i = 0; i < local_domain.ncells_active; i++) {
-            all_vars[i].lake_var.activenod = ivar[i];
+            all_vars[i].lake_var.activenod = iblock[i];
         }
 
         // lake layer thickness: lake_var.dz
-        get_scatter_nc_field_double(filenames.init_state,
-                                    state_metadata[STATE_LAKE_LAYER_DZ].varname,
-                                    d2start, d2count, dvar);
+        nc_var = &(nc_state_file.nc_vars[STATE_LAKE_LAYER_DZ]);
+        get_scatter_nc_var_double(&nc_state_file,
+                                  state_metadata[STATE_LAKE_LAYER_DZ].varname,
+                                  nc_var, dblock);
         for (i = 0; i < local_domain.ncells_active; i++) {
-            all_vars[i].lake_var.dz = dvar[i];
+            all_vars[i].lake_var.dz = dblock[i];
         }
 
         // lake surface layer thickness: lake_var.surfdz
-        get_scatter_nc_field_double(filenames.init_state,
-                                    state_metadata[STATE_LAKE_SURF_LAYER_DZ].varname,
-                                    d2start, d2count, dvar);
+        nc_var = &(nc_state_file.nc_vars[STATE_LAKE_SURF_LAYER_DZ]);
+        get_scatter_nc_var_double(&nc_state_file,
+                                  state_metadata[
+                                      STATE_LAKE_SURF_LAYER_DZ].varname,
+                                  nc_var, dblock);
         for (i = 0; i < local_domain.ncells_active; i++) {
-            all_vars[i].lake_var.surfdz = dvar[i];
+            all_vars[i].lake_var.surfdz = dblock[i];
         }
 
         // lake depth: lake_var.ldepth
-        get_scatter_nc_field_double(filenames.init_state,
-                                    state_metadata[STATE_LAKE_DEPTH].varname,
-                                    d2start, d2count, dvar);
+        nc_var = &(nc_state_file.nc_vars[STATE_LAKE_DEPTH]);
+        get_scatter_nc_var_double(&nc_state_file,
+                                  state_metadata[STATE_LAKE_DEPTH].varname,
+                                  nc_var, dblock);
         for (i = 0; i < local_domain.ncells_active; i++) {
-            all_vars[i].lake_var.ldepth = dvar[i];
+            all_vars[i].lake_var.ldepth = dblock[i];
         }
 
         // lake layer surface areas: lake_var.surface[ndix]
+        nc_var = &(nc_state_file.nc_vars[STATE_LAKE_LAYER_SURF_AREA]);
+        get_scatter_nc_var_double(&nc_state_file,
+                                  state_metadata[
+                                      STATE_LAKE_LAYER_SURF_AREA].varname,
+                                  nc_var, dblock);
+        nblock = 0;
         for (j = 0; j < options.NLAKENODES; j++) {
-            d3start[0] = j;
-            get_scatter_nc_field_double(filenames.init_state,
-                                        state_metadata[
-                                            STATE_LAKE_LAYER_SURF_AREA].varname,
-                                        d3start, d3count, dvar);
+            dvar = dblock + nblock++ * local_domain.ncells_active;
             for (i = 0; i < local_domain.ncells_active; i++) {
                 all_vars[i].lake_var.surface[j] = dvar[i];
             }
         }
 
         // lake surface area: lake_var.sarea
-        get_scatter_nc_field_double(filenames.init_state,
-                                    state_metadata[STATE_LAKE_SURF_AREA].varname,
-                                    d2start, d2count, dvar);
+        nc_var = &(nc_state_file.nc_vars[STATE_LAKE_SURF_AREA]);
+        get_scatter_nc_var_double(&nc_state_file,
+                                  state_metadata[STATE_LAKE_SURF_AREA].varname,
+                                  nc_var, dblock);
         for (i = 0; i < local_domain.ncells_active; i++) {
-            all_vars[i].lake_var.sarea = dvar[i];
+            all_vars[i].lake_var.sarea = dblock[i];
         }
 
         // lake volume: lake_var.volume
-        get_scatter_nc_field_double(filenames.init_state,
-                                    state_metadata[STATE_LAKE_VOLUME].varname,
-                                    d2start, d2count, dvar);
+        nc_var = &(nc_state_file.nc_vars[STATE_LAKE_VOLUME]);
+        get_scatter_nc_var_double(&nc_state_file,
+                                  state_metadata[STATE_LAKE_VOLUME].varname,
+                                  nc_var, dblock);
         for (i = 0; i < local_domain.ncells_active; i++) {
-            all_vars[i].lake_var.volume = dvar[i];
+            all_vars[i].lake_var.volume = dblock[i];
         }
 
         // lake layer temperatures: lake_var.temp[nidx]
+        nc_var = &(nc_state_file.nc_vars[STATE_LAKE_LAYER_TEMP]);
+        get_scatter_nc_var_double(&nc_state_file,
+                                  state_metadata[STATE_LAKE_LAYER_TEMP].varname,
+                                  nc_var, dblock);
+        nblock = 0;
         for (j = 0; j < options.NLAKENODES; j++) {
-            d3start[0] = j;
-            get_scatter_nc_field_double(filenames.init_state,
-                                        state_metadata[STATE_LAKE_LAYER_TEMP].varname,
-                                        d3start, d3count, dvar);
+            dvar = dblock + nblock++ * local_domain.ncells_active;
             for (i = 0; i < local_domain.ncells_active; i++) {
                 all_vars[i].lake_var.temp[j] = dvar[i];
             }
         }
 
         // vertical average lake temperature: lake_var.tempavg
-        get_scatter_nc_field_double(filenames.init_state,
-                                    state_metadata[STATE_LAKE_AVERAGE_TEMP].varname,
-                                    d2start, d2count, dvar);
+        nc_var = &(nc_state_file.nc_vars[STATE_LAKE_AVERAGE_TEMP]);
+        get_scatter_nc_var_double(&nc_state_file,
+                                  state_metadata[
+                                      STATE_LAKE_AVERAGE_TEMP].varname,
+                                  nc_var, dblock);
         for (i = 0; i < local_domain.ncells_active; i++) {
-            all_vars[i].lake_var.tempavg = dvar[i];
+            all_vars[i].lake_var.tempavg = dblock[i];
         }
 
         // lake ice area fraction: lake_var.areai
-        get_scatter_nc_field_double(filenames.init_state,
-                                    state_metadata[STATE_LAKE_ICE_AREA_FRAC].varname,
-                                    d2start, d2count, dvar);
+        nc_var = &(nc_state_file.nc_vars[STATE_LAKE_ICE_AREA_FRAC]);
+        get_scatter_nc_var_double(&nc_state_file,
+                                  state_metadata[
+                                      STATE_LAKE_ICE_AREA_FRAC].varname,
+                                  nc_var, dblock);
         for (i = 0; i < local_domain.ncells_active; i++) {
-            all_vars[i].lake_var.areai = dvar[i];
+            all_vars[i].lake_var.areai = dblock[i];
         }
 
         // new lake ice area fraction: lake_var.new_ice_area
-        get_scatter_nc_field_double(filenames.init_state,
-                                    state_metadata[STATE_LAKE_ICE_AREA_FRAC_NEW].varname,
-                                    d2start, d2count, dvar);
+        nc_var = &(nc_state_file.nc_vars[STATE_LAKE_ICE_AREA_FRAC_NEW]);
+        get_scatter_nc_var_double(&nc_state_file,
+                                  state_metadata[
+                                      STATE_LAKE_ICE_AREA_FRAC_NEW].varname,
+                                  nc_var, dblock);
         for (i = 0; i < local_domain.ncells_active; i++) {
-            all_vars[i].lake_var.new_ice_area = dvar[i];
+            all_vars[i].lake_var.new_ice_area = dblock[i];
         }
 
         // lake ice water equivalent: lake_var.ice_water_eq
-        get_scatter_nc_field_double(filenames.init_state,
-                                    state_metadata[
-                                        STATE_LAKE_ICE_WATER_EQUIVALENT].varname,
-                                    d2start, d2count, dvar);
+        nc_var = &(nc_state_file.nc_vars[STATE_LAKE_ICE_WATER_EQUIVALENT]);
+        get_scatter_nc_var_double(&nc_state_file,
+                                  state_metadata[
+                                      STATE_LAKE_ICE_WATER_EQUIVALENT].varname,
+                                  nc_var, dblock);
         for (i = 0; i < local_domain.ncells_active; i++) {
-            all_vars[i].lake_var.ice_water_eq = dvar[i];
+            all_vars[i].lake_var.ice_water_eq = dblock[i];
         }
 
         // lake ice height: lake_var.hice
-        get_scatter_nc_field_double(filenames.init_state,
-                                    state_metadata[STATE_LAKE_ICE_HEIGHT].varname,
-                                    d2start, d2count, dvar);
+        nc_var = &(nc_state_file.nc_vars[STATE_LAKE_ICE_HEIGHT]);
+        get_scatter_nc_var_double(&nc_state_file,
+                                  state_metadata[STATE_LAKE_ICE_HEIGHT].varname,
+                                  nc_var, dblock);
         for (i = 0; i < local_domain.ncells_active; i++) {
-            all_vars[i].lake_var.hice = dvar[i];
+            all_vars[i].lake_var.hice = dblock[i];
         }
 
         // lake ice temperature: lake_var.tempi
-        get_scatter_nc_field_double(filenames.init_state,
-                                    state_metadata[STATE_LAKE_ICE_TEMP].varname,
-                                    d2start, d2count, dvar);
+        nc_var = &(nc_state_file.nc_vars[STATE_LAKE_ICE_TEMP]);
+        get_scatter_nc_var_double(&nc_state_file,
+                                  state_metadata[STATE_LAKE_ICE_TEMP].varname,
+                                  nc_var, dblock);
         for (i = 0; i < local_domain.ncells_active; i++) {
-            all_vars[i].lake_var.tempi = dvar[i];
+            all_vars[i].lake_var.tempi = dblock[i];
         }
 
         // lake ice snow water equivalent: lake_var.swe
-        get_scatter_nc_field_double(filenames.init_state,
-                                    state_metadata[STATE_LAKE_ICE_SWE].varname,
-                                    d2start, d2count, dvar);
+        nc_var = &(nc_state_file.nc_vars[STATE_LAKE_ICE_SWE]);
+        get_scatter_nc_var_double(&nc_state_file,
+                                  state_metadata[STATE_LAKE_ICE_SWE].varname,
+                                  nc_var, dblock);
         for (i = 0; i < local_domain.ncells_active; i++) {
-            all_vars[i].lake_var.swe = dvar[i];
+            all_vars[i].lake_var.swe = dblock[i];
         }
 
         // lake ice snow surface temperature: lake_var.surf_temp
-        get_scatter_nc_field_double(filenames.init_state,
-                                    state_metadata[STATE_LAKE_ICE_SNOW_SURF_TEMP].varname,
-                                    d2start, d2count, dvar);
+        nc_var = &(nc_state_file.nc_vars[STATE_LAKE_ICE_SNOW_SURF_TEMP]);
+        get_scatter_nc_var_double(&nc_state_file,
+                                  state_metadata[
+                                      STATE_LAKE_ICE_SNOW_SURF_TEMP].varname,
+                                  nc_var, dblock);
         for (i = 0; i < local_domain.ncells_active; i++) {
-            all_vars[i].lake_var.surf_temp = dvar[i];
+            all_vars[i].lake_var.surf_temp = dblock[i];
         }
 
         // lake ice snow pack temperature: lake_var.pack_temp
-        get_scatter_nc_field_double(filenames.init_state,
-                                    state_metadata[STATE_LAKE_ICE_SNOW_PACK_TEMP].varname,
-                                    d2start, d2count, dvar);
+        nc_var = &(nc_state_file.nc_vars[STATE_LAKE_ICE_SNOW_PACK_TEMP]);
+        get_scatter_nc_var_double(&nc_state_file,
+                                  state_metadata[
+                                      STATE_LAKE_ICE_SNOW_PACK_TEMP].varname,
+                                  nc_var, dblock);
         for (i = 0; i < local_domain.ncells_active; i++) {
-            all_vars[i].lake_var.pack_temp = dvar[i];
+            all_vars[i].lake_var.pack_temp = dblock[i];
         }
 
         // lake ice snow coldcontent: lake_var.coldcontent
-        get_scatter_nc_field_double(filenames.init_state,
-                                    state_metadata[
-                                        STATE_LAKE_ICE_SNOW_COLD_CONTENT].varname,
-                                    d2start, d2count, dvar);
+        nc_var = &(nc_state_file.nc_vars[STATE_LAKE_ICE_SNOW_COLD_CONTENT]);
+        get_scatter_nc_var_double(&nc_state_file,
+                                  state_metadata[
+                                      STATE_LAKE_ICE_SNOW_COLD_CONTENT].varname,
+                                  nc_var, dblock);
         for (i = 0; i < local_domain.ncells_active; i++) {
-            all_vars[i].lake_var.coldcontent = dvar[i];
+            all_vars[i].lake_var.coldcontent = dblock[i];
         }
 
         // lake ice snow surface water: lake_var.surf_water
-        get_scatter_nc_field_double(filenames.init_state,
-                                    state_metadata[
-                                        STATE_LAKE_ICE_SNOW_SURF_WATER].varname,
-                                    d2start, d2count, dvar);
+        nc_var = &(nc_state_file.nc_vars[STATE_LAKE_ICE_SNOW_SURF_WATER]);
+        get_scatter_nc_var_double(&nc_state_file,
+                                  state_metadata[
+                                      STATE_LAKE_ICE_SNOW_SURF_WATER].varname,
+                                  nc_var, dblock);
         for (i = 0; i < local_domain.ncells_active; i++) {
-            all_vars[i].lake_var.surf_water = dvar[i];
+            all_vars[i].lake_var.surf_water = dblock[i];
         }
 
         // lake ice snow pack water: lake_var.pack_water
-        get_scatter_nc_field_double(filenames.init_state,
-                                    state_metadata[
-                                        STATE_LAKE_ICE_SNOW_PACK_WATER].varname,
-                                    d2start, d2count, dvar);
+        nc_var = &(nc_state_file.nc_vars[STATE_LAKE_ICE_SNOW_PACK_WATER]);
+        get_scatter_nc_var_double(&nc_state_file,
+                                  state_metadata[
+                                      STATE_LAKE_ICE_SNOW_PACK_WATER].varname,
+                                  nc_var, dblock);
         for (i = 0; i < local_domain.ncells_active; i++) {
-            all_vars[i].lake_var.pack_water = dvar[i];
+            all_vars[i].lake_var.pack_water = dblock[i];
         }
 
         // lake ice snow albedo: lake_var.SAlbedo
-        get_scatter_nc_field_double(filenames.init_state,
-                                    state_metadata[STATE_LAKE_ICE_SNOW_ALBEDO].varname,
-                                    d2start, d2count, dvar);
+        nc_var = &(nc_state_file.nc_vars[STATE_LAKE_ICE_SNOW_ALBEDO]);
+        get_scatter_nc_var_double(&nc_state_file,
+                                  state_metadata[
+                                      STATE_LAKE_ICE_SNOW_ALBEDO].varname,
+                                  nc_var, dblock);
         for (i = 0; i < local_domain.ncells_active; i++) {
-            all_vars[i].lake_var.SAlbedo = dvar[i];
+            all_vars[i].lake_var.SAlbedo = dblock[i];
         }
 
         // lake ice snow depth: lake_var.sdepth
-        get_scatter_nc_field_double(filenames.init_state,
-                                    state_metadata[STATE_LAKE_ICE_SNOW_DEPTH].varname,
-                                    d2start, d2count, dvar);
+        nc_var = &(nc_state_file.nc_vars[STATE_LAKE_ICE_SNOW_DEPTH]);
+        get_scatter_nc_var_double(&nc_state_file,
+                                  state_metadata[
+                                      STATE_LAKE_ICE_SNOW_DEPTH].varname,
+                                  nc_var, dblock);
         for (i = 0; i < local_domain.ncells_active; i++) {
-            all_vars[i].lake_var.sdepth = dvar[i];
+            all_vars[i].lake_var.sdepth = dblock[i];
         }
     }
 
-    free(ivar);
-    free(dvar);
+    if (mpi_rank == VIC_MPI_ROOT) {
+        status = nc_close(nc_state_file.nc_id);
+        check_nc_status(status, "Error closing %s", filenames.init_state);
+    }
+
+    free(iblock);
+    free(dblock);
+    free(nc_state_file.nc_vars);
 }
 
 /******************************************************************************
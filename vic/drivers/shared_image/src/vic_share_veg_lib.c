@@ -0,0 +1,312 @@
+/******************************************************************************
+ * @section DESCRIPTION
+ *
+ * Store each distinct vegetation library once per node.
+ *
+ * @section LICENSE
+ *
+ * The Variable Infiltration Capacity (VIC) macroscale hydrological model
+ * Copyright (C) 2016 The Computational Hydrology Group, Department of Civil
+ * and Environmental Engineering, University of Washington.
+ *
+ * The VIC model is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *****************************************************************************/
+
+#include <vic_driver_shared_image.h>
+
+/******************************************************************************
+ * @brief    Order vegetation library keys by hash, then by node rank and
+ *           index, so that the first key of a group of equal hashes is the
+ *           copy that is kept.
+ *****************************************************************************/
+int
+veg_lib_key_cmp(const void *a,
+                const void *b)
+{
+    const veg_lib_key_struct *ka = a;
+    const veg_lib_key_struct *kb = b;
+
+    if (ka->hash != kb->hash) {
+        return (ka->hash < kb->hash) ? -1 : 1;
+    }
+    if (ka->rank != kb->rank) {
+        return (ka->rank < kb->rank) ? -1 : 1;
+    }
+    if (ka->idx != kb->idx) {
+        return (ka->idx < kb->idx) ? -1 : 1;
+    }
+    return 0;
+}
+
+/******************************************************************************
+ * @brief    Keep one copy of each distinct vegetation library.
+ * @details  In image mode every grid cell has a full library of NVEGTYPES
+ *           classes, which is read-only once the parameters are initialized
+ *           and is often identical for many cells. The cells of a process
+ *           that have the same library are first pointed to a single copy.
+ *           The distinct libraries of all processes on a node are then
+ *           placed in an MPI-3 shared memory window, so that a library that
+ *           is used on several processes of a node is stored once.
+ *           Libraries are matched by hash and compared byte by byte before
+ *           they are shared; on a hash collision the private copy is kept.
+ *           Must be called by all processes.
+ *****************************************************************************/
+void
+share_veg_lib(void)
+{
+    extern MPI_Comm             MPI_COMM_VIC;
+    extern domain_struct        local_domain;
+    extern option_struct        options;
+    extern veg_lib_struct     **veg_lib;
+    extern veg_lib_share_struct veg_lib_share;
+
+    int                         status;
+    int                         node_rank;
+    int                         node_size;
+    int                         nlocal;
+    int                         disp_unit;
+    int                         owner;
+    int                        *nlibs = NULL;
+    int                        *displs = NULL;
+    size_t                      i;
+    size_t                      j;
+    size_t                      n;
+    size_t                      nbytes;
+    size_t                      ncells;
+    size_t                      nkeys;
+    size_t                      ngroups;
+    size_t                      pos;
+    size_t                     *nowned = NULL;
+    size_t                     *lib_idx = NULL;
+    size_t                     *owner_pos = NULL;
+    int                        *owner_rank = NULL;
+    MPI_Aint                    win_bytes;
+    uint64_t                   *hashes = NULL;
+    uint64_t                   *node_hashes = NULL;
+    bool                        match;
+    veg_lib_struct            **libs = NULL;
+    veg_lib_struct            **shared = NULL;
+    veg_lib_struct            **bases = NULL;
+    veg_lib_key_struct         *keys = NULL;
+
+    veg_lib_share.node_comm = MPI_COMM_NULL;
+    veg_lib_share.win = MPI_WIN_NULL;
+    veg_lib_share.nlibs = 0;
+    veg_lib_share.libs = NULL;
+
+    ncells = local_domain.ncells_active;
+    nbytes = options.NVEGTYPES * sizeof(**veg_lib);
+
+    // a process may have no cells (IO_SERVER), the buffers are sized for at
+    // least one element so that they can always be allocated
+    keys = malloc((ncells + 1) * sizeof(*keys));
+    check_alloc_status(keys, "Memory allocation error.");
+    libs = malloc((ncells + 1) * sizeof(*libs));
+    check_alloc_status(libs, "Memory allocation error.");
+    hashes = malloc((ncells + 1) * sizeof(*hashes));
+    check_alloc_status(hashes, "Memory allocation error.");
+    lib_idx = malloc((ncells + 1) * sizeof(*lib_idx));
+    check_alloc_status(lib_idx, "Memory allocation error.");
+
+    // distinct libraries of this process: sort the cells by hash and compare
+    // each cell with the distinct libraries of the same hash found so far
+    for (i = 0; i < ncells; i++) {
+        keys[i].hash = hash_bytes(veg_lib[i], nbytes, FNV_OFFSET_BASIS);
+        keys[i].rank = 0;
+        keys[i].idx = i;
+    }
+    qsort(keys, ncells, sizeof(*keys), veg_lib_key_cmp);
+
+    nlocal = 0;
+    for (i = 0; i < ncells; i++) {
+        match = false;
+        for (j = nlocal; j > 0 && hashes[j - 1] == keys[i].hash; j--) {
+            if (memcmp(libs[j - 1], veg_lib[keys[i].idx], nbytes) == 0) {
+                match = true;
+                break;
+            }
+        }
+        if (match) {
+            lib_idx[keys[i].idx] = j - 1;
+            free(veg_lib[keys[i].idx]);
+        }
+        else {
+            libs[nlocal] = veg_lib[keys[i].idx];
+            hashes[nlocal] = keys[i].hash;
+            lib_idx[keys[i].idx] = nlocal;
+            nlocal++;
+        }
+    }
+    for (i = 0; i < ncells; i++) {
+        veg_lib[i] = libs[lib_idx[i]];
+    }
+    free(keys);
+
+    // hashes of the distinct libraries of all processes on this node
+    status = MPI_Comm_split_type(MPI_COMM_VIC, MPI_COMM_TYPE_SHARED, 0,
+                                 MPI_INFO_NULL, &(veg_lib_share.node_comm));
+    check_mpi_status(status, "MPI error.");
+    status = MPI_Comm_rank(veg_lib_share.node_comm, &node_rank);
+    check_mpi_status(status, "MPI error.");
+    status = MPI_Comm_size(veg_lib_share.node_comm, &node_size);
+    check_mpi_status(status, "MPI error.");
+
+    nlibs = malloc(node_size * sizeof(*nlibs));
+    check_alloc_status(nlibs, "Memory allocation error.");
+    displs = malloc(node_size * sizeof(*displs));
+    check_alloc_status(displs, "Memory allocation error.");
+    status = MPI_Allgather(&nlocal, 1, MPI_INT, nlibs, 1, MPI_INT,
+                           veg_lib_share.node_comm);
+    check_mpi_status(status, "MPI error.");
+    nkeys = 0;
+    for (n = 0; n < (size_t) node_size; n++) {
+        displs[n] = (int) nkeys;
+        nkeys += nlibs[n];
+    }
+
+    node_hashes = malloc((nkeys + 1) * sizeof(*node_hashes));
+    check_alloc_status(node_hashes, "Memory allocation error.");
+    status = MPI_Allgatherv(hashes, nlocal, MPI_UINT64_T, node_hashes, nlibs,
+                            displs, MPI_UINT64_T, veg_lib_share.node_comm);
+    check_mpi_status(status, "MPI error.");
+
+    // every process sorts the same keys. The first key of each group of equal
+    // hashes is stored in the window segment of its process, in key order.
+    keys = malloc((nkeys + 1) * sizeof(*keys));
+    check_alloc_status(keys, "Memory allocation error.");
+    for (n = 0; n < (size_t) node_size; n++) {
+        for (i = 0; i < (size_t) nlibs[n]; i++) {
+            keys[displs[n] + i].hash = node_hashes[displs[n] + i];
+            keys[displs[n] + i].rank = (int) n;
+            keys[displs[n] + i].idx = i;
+        }
+    }
+    qsort(keys, nkeys, sizeof(*keys), veg_lib_key_cmp);
+
+    nowned = calloc(node_size, sizeof(*nowned));
+    check_alloc_status(nowned, "Memory allocation error.");
+    owner_rank = malloc((nlocal + 1) * sizeof(*owner_rank));
+    check_alloc_status(owner_rank, "Memory allocation error.");
+    owner_pos = malloc((nlocal + 1) * sizeof(*owner_pos));
+    check_alloc_status(owner_pos, "Memory allocation error.");
+    owner = 0;
+    pos = 0;
+    ngroups = 0;
+    for (i = 0; i < nkeys; i++) {
+        if (i == 0 || keys[i].hash != keys[i - 1].hash) {
+            owner = keys[i].rank;
+            pos = nowned[owner]++;
+            ngroups++;
+        }
+        if (keys[i].rank == node_rank) {
+            owner_rank[keys[i].idx] = owner;
+            owner_pos[keys[i].idx] = pos;
+        }
+    }
+
+    win_bytes = (MPI_Aint) (nowned[node_rank] * nbytes);
+    status = MPI_Win_allocate_shared(win_bytes, (int) sizeof(**veg_lib),
+                                     MPI_INFO_NULL, veg_lib_share.node_comm,
+                                     &(veg_lib_share.base),
+                                     &(veg_lib_share.win));
+    check_mpi_status(status, "MPI error.");
+
+    status = MPI_Win_fence(0, veg_lib_share.win);
+    check_mpi_status(status, "MPI error.");
+    for (i = 0; i < (size_t) nlocal; i++) {
+        if (owner_rank[i] == node_rank) {
+            memcpy(veg_lib_share.base + owner_pos[i] * options.NVEGTYPES,
+                   libs[i], nbytes);
+        }
+    }
+    status = MPI_Win_fence(0, veg_lib_share.win);
+    check_mpi_status(status, "MPI error.");
+
+    // point the cells to the shared copies. The private copy is only kept
+    // if the shared copy differs (hash collision between processes).
+    bases = malloc(node_size * sizeof(*bases));
+    check_alloc_status(bases, "Memory allocation error.");
+    for (n = 0; n < (size_t) node_size; n++) {
+        status = MPI_Win_shared_query(veg_lib_share.win, (int) n, &win_bytes,
+                                      &disp_unit, &(bases[n]));
+        check_mpi_status(status, "MPI error.");
+    }
+
+    shared = malloc((nlocal + 1) * sizeof(*shared));
+    check_alloc_status(shared, "Memory allocation error.");
+    veg_lib_share.libs = malloc((nlocal + 1) *
+                                sizeof(*(veg_lib_share.libs)));
+    check_alloc_status(veg_lib_share.libs, "Memory allocation error.");
+    for (i = 0; i < (size_t) nlocal; i++) {
+        shared[i] = bases[owner_rank[i]] +
+                    owner_pos[i] * options.NVEGTYPES;
+        if (memcmp(shared[i], libs[i], nbytes) == 0) {
+            free(libs[i]);
+        }
+        else {
+            shared[i] = libs[i];
+            veg_lib_share.libs[veg_lib_share.nlibs++] = libs[i];
+        }
+    }
+    for (i = 0; i < ncells; i++) {
+        veg_lib[i] = shared[lib_idx[i]];
+    }
+
+    debug("%d distinct vegetation libraries for %zu cells, %zu distinct "
+          "libraries on this node", nlocal, ncells, ngroups);
+
+    free(keys);
+    free(nlibs);
+    free(displs);
+    free(nowned);
+    free(owner_rank);
+    free(owner_pos);
+    free(hashes);
+    free(node_hashes);
+    free(lib_idx);
+    free(libs);
+    free(shared);
+    free(bases);
+}
+
+/******************************************************************************
+ * @brief    Free the vegetation libraries.
+ *****************************************************************************/
+void
+free_veg_lib(void)
+{
+    extern MPI_Comm             MPI_COMM_VIC;
+    extern veg_lib_struct     **veg_lib;
+    extern veg_lib_share_struct veg_lib_share;
+
+    int                         status;
+    size_t                      i;
+
+    for (i = 0; i < veg_lib_share.nlibs; i++) {
+        free(veg_lib_share.libs[i]);
+    }
+    free(veg_lib_share.libs);
+
+    if (veg_lib_share.win != MPI_WIN_NULL) {
+        status = MPI_Win_free(&(veg_lib_share.win));
+        check_mpi_status(status, "MPI error.");
+    }
+    if (veg_lib_share.node_comm != MPI_COMM_NULL) {
+        status = MPI_Comm_free(&(veg_lib_share.node_comm));
+        check_mpi_status(status, "MPI error.");
+    }
+
+    free(veg_lib);
+}
@@ -0,0 +1,153 @@
+/******************************************************************************
+ * @section DESCRIPTION
+ *
+ * Take and restore in-memory snapshots of the model state of a process.
+ *
+ * @section LICENSE
+ *
+ * The Variable Infiltration Capacity (VIC) macroscale hydrological model
+ * Copyright (C) 2016 The Computational Hydrology Group, Department of Civil
+ * and Environmental Engineering, University of Washington.
+ *
+ * The VIC model is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *****************************************************************************/
+
+#include <vic_driver_shared_image.h>
+
+/******************************************************************************
+ * @brief    Number of bytes of a snapshot of this process.
+ *****************************************************************************/
+size_t
+vic_snapshot_size(void)
+{
+    extern domain_struct       local_domain;
+    extern global_param_struct global_param;
+    extern option_struct       options;
+    extern stream_struct      *output_streams;
+    extern veg_con_map_struct *veg_con_map;
+
+    size_t                     i;
+    size_t                     nbytes;
+
+    nbytes = sizeof(size_t) + sizeof(global_param.forceoffset);
+    for (i = 0; i < local_domain.ncells_active; i++) {
+        nbytes += options.NMEMBERS *
+                  (sizeof_all_vars(veg_con_map[i].nv_active) +
+                   sizeof(save_data_struct));
+    }
+    for (i = 0; i < options.Noutstreams; i++) {
+        nbytes += sizeof_stream_state(&(output_streams[i]));
+    }
+
+    return nbytes;
+}
+
+/******************************************************************************
+ * @brief    Copy the prognostic state of this process into a contiguous
+ *           memory buffer.
+ * @details  The snapshot holds the time step index, the position in the
+ *           forcing files, the states and fluxes of all cells and ensemble
+ *           members, the water balance storages of the previous step and the
+ *           aggregation state of the output streams. The buffer of an earlier
+ *           snapshot is reused. The parameters are not part of the snapshot,
+ *           nor are the history records already handed to vic_write.
+ *****************************************************************************/
+void
+vic_snapshot(snapshot_struct *snapshot)
+{
+    extern size_t              current;
+    extern all_vars_struct    *all_vars;
+    extern domain_struct       local_domain;
+    extern global_param_struct global_param;
+    extern option_struct       options;
+    extern save_data_struct   *save_data;
+    extern stream_struct      *output_streams;
+    extern veg_con_map_struct *veg_con_map;
+
+    size_t                     i;
+    size_t                     m;
+    size_t                     idx;
+    size_t                     nbytes;
+    char                      *pos;
+
+    nbytes = vic_snapshot_size();
+    if (snapshot->data == NULL || snapshot->nbytes != nbytes) {
+        free(snapshot->data);
+        snapshot->data = malloc(nbytes);
+        check_alloc_status(snapshot->data, "Memory allocation error.");
+        snapshot->nbytes = nbytes;
+    }
+
+    pos = snapshot->data;
+    pack_data(&pos, &current, sizeof(current));
+    pack_data(&pos, global_param.forceoffset,
+              sizeof(global_param.forceoffset));
+    for (m = 0; m < options.NMEMBERS; m++) {
+        for (i = 0; i < local_domain.ncells_active; i++) {
+            idx = m * local_domain.ncells_active + i;
+            pack_all_vars(&pos, &(all_vars[idx]), veg_con_map[i].nv_active);
+            pack_data(&pos, &(save_data[idx]), sizeof(save_data[idx]));
+        }
+    }
+    for (i = 0; i < options.Noutstreams; i++) {
+        pack_stream_state(&pos, &(output_streams[i]));
+    }
+}
+
+/******************************************************************************
+ * @brief    Restore the prognostic state of this process from a snapshot
+ *           taken with vic_snapshot.
+ * @details  The run continues at the time step of the snapshot. History
+ *           records that are written again overwrite the records of the
+ *           same time index.
+ *****************************************************************************/
+void
+vic_restore_snapshot(snapshot_struct *snapshot)
+{
+    extern size_t              current;
+    extern all_vars_struct    *all_vars;
+    extern domain_struct       local_domain;
+    extern global_param_struct global_param;
+    extern option_struct       options;
+    extern save_data_struct   *save_data;
+    extern stream_struct      *output_streams;
+    extern veg_con_map_struct *veg_con_map;
+
+    size_t                     i;
+    size_t                     m;
+    size_t                     idx;
+    char                      *pos;
+
+    if (snapshot->data == NULL || snapshot->nbytes != vic_snapshot_size()) {
+        log_err("The snapshot does not match the model state of this "
+                "process.");
+    }
+
+    pos = snapshot->data;
+    unpack_data(&pos, &current, sizeof(current));
+    unpack_data(&pos, global_param.forceoffset,
+                sizeof(global_param.forceoffset));
+    for (m = 0; m < options.NMEMBERS; m++) {
+        for (i = 0; i < local_domain.ncells_active; i++) {
+            idx = m * local_domain.ncells_active + i;
+            unpack_all_vars(&pos, &(all_vars[idx]),
+                            veg_con_map[i].nv_active);
+            unpack_data(&pos, &(save_data[idx]), sizeof(save_data[idx]));
+        }
+    }
+    for (i = 0; i < options.Noutstreams; i++) {
+        unpack_stream_state(&pos, &(output_streams[i]));
+    }
+}
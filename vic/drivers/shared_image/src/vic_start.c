@@ -80,8 +80,10 @@ vic_start(void)
         // global domain struct. This just makes life easier
         add_nveg_to_global_domain(filenames.params, &global_domain);
 
-        // decompose the mask
+        // decompose the mask. With an I/O server the master process does
+        // not get any cells
         mpi_map_decomp_domain(global_domain.ncells_active, mpi_size,
+                              options.IO_SERVER ? 1 : 0,
                               &mpi_map_local_array_sizes,
                               &mpi_map_global_array_offsets,
                               &mpi_map_mapping_array);
@@ -98,6 +100,9 @@ vic_start(void)
             }
         }
 
+        // set up the work space of the gather and scatter routines
+        mpi_map_init_buffers();
+
         // get dimensions (number of vegetation types, soil zones, etc)
         options.ROOT_ZONES = get_nc_dimension(filenames.params, "root_zone");
         options.Nlayer = get_nc_dimension(filenames.params, "nlayer");
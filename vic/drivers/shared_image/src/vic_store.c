@@ -28,10 +28,292 @@
 
 /******************************************************************************
  * @brief    Save model state.
+ * @details  In ensemble mode the state of each member is saved to its own
+ *           file, filename is set to the file of the last member.
  *****************************************************************************/
 void
 vic_store(dmy_struct *dmy_current,
           char       *filename)
+{
+    extern option_struct options;
+
+    size_t               member;
+
+    for (member = 0; member < options.NMEMBERS; member++) {
+        vic_store_member(dmy_current, member, filename, NULL);
+    }
+}
+
+/******************************************************************************
+ * @brief    Save model state in the background (STATE_ASYNC).
+ * @details  The state of each ensemble member is copied into a staging
+ *           buffer and gathered on the master node without blocking, after
+ *           which the model continues. The master writes the state file a
+ *           few variables per time step in vic_store_progress, spread over
+ *           as many time steps as have passed since the previous state file
+ *           (or the remaining time steps of the run if fewer). A state file
+ *           that is still pending when the next one is saved is completed
+ *           first, which is the only time the model waits for the writes.
+ *           netCDF is not thread safe and the master also writes the
+ *           history files, so the writes are interleaved with the time steps
+ *           instead of running on a separate thread.
+ *****************************************************************************/
+void
+vic_store_async(dmy_struct *dmy_current,
+                size_t      current,
+                char       *filename)
+{
+    extern global_param_struct global_param;
+    extern option_struct       options;
+    extern state_stage_struct *state_stages;
+
+    size_t                     member;
+    size_t                     nsteps;
+
+    if (state_stages == NULL) {
+        state_stages = calloc(options.NMEMBERS, sizeof(*state_stages));
+        check_alloc_status(state_stages, "Memory allocation error");
+        nsteps = current + 1;
+    }
+    else {
+        // complete the previous state files before the buffers are reused
+        vic_store_flush();
+        nsteps = current - state_stages[0].step;
+    }
+    if (nsteps > global_param.nrecs - current - 1) {
+        nsteps = global_param.nrecs - current - 1;
+    }
+    if (nsteps < 1) {
+        nsteps = 1;
+    }
+
+    for (member = 0; member < options.NMEMBERS; member++) {
+        vic_store_member(dmy_current, member, filename,
+                         &(state_stages[member]));
+        state_stages[member].step = current;
+        state_stages[member].nvars_step =
+            (state_stages[member].nvars + nsteps - 1) / nsteps;
+    }
+}
+
+/******************************************************************************
+ * @brief    Write part of the state files that are pending (STATE_ASYNC).
+ * @details  Called once per time step on all processes.
+ *****************************************************************************/
+void
+vic_store_progress(void)
+{
+    extern option_struct       options;
+    extern state_stage_struct *state_stages;
+    extern int                 mpi_rank;
+    extern MPI_Comm            MPI_COMM_VIC;
+
+    int                        flag;
+    int                        status;
+    size_t                     member;
+
+    if (state_stages == NULL) {
+        return;
+    }
+
+    for (member = 0; member < options.NMEMBERS; member++) {
+        if (!state_stages[member].pending) {
+            continue;
+        }
+        status = MPI_Test(&(state_stages[member].request), &flag,
+                          MPI_STATUS_IGNORE);
+        check_mpi_status(status, "MPI error.");
+        if (!flag) {
+            continue;
+        }
+        if (mpi_rank == VIC_MPI_ROOT) {
+            write_stage_vars(&(state_stages[member]),
+                             state_stages[member].nvars_step);
+        }
+        else {
+            state_stages[member].pending = false;
+        }
+    }
+}
+
+/******************************************************************************
+ * @brief    Complete the state files that are pending (STATE_ASYNC).
+ *****************************************************************************/
+void
+vic_store_flush(void)
+{
+    extern option_struct       options;
+    extern state_stage_struct *state_stages;
+    extern int                 mpi_rank;
+    extern MPI_Comm            MPI_COMM_VIC;
+
+    int                        status;
+    size_t                     member;
+
+    if (state_stages == NULL) {
+        return;
+    }
+
+    for (member = 0; member < options.NMEMBERS; member++) {
+        if (!state_stages[member].pending) {
+            continue;
+        }
+        status = MPI_Wait(&(state_stages[member].request), MPI_STATUS_IGNORE);
+        check_mpi_status(status, "MPI error.");
+        if (mpi_rank == VIC_MPI_ROOT) {
+            write_stage_vars(&(state_stages[member]),
+                             state_stages[member].nvars);
+        }
+        else {
+            state_stages[member].pending = false;
+        }
+    }
+}
+
+/******************************************************************************
+ * @brief    Write staged state variables to the state file.
+ * @details  Only called on the master process once the staged state has been
+ *           gathered. The state file is created by the first call and closed
+ *           once all nvars variables have been written.
+ *****************************************************************************/
+void
+write_stage_vars(state_stage_struct *stage,
+                 size_t              nvars)
+{
+    extern domain_struct global_domain;
+    extern int          *mpi_map_global_array_offsets;
+    extern int          *mpi_map_local_array_sizes;
+    extern int           mpi_size;
+
+    int                  status;
+    int                 *ivar = NULL;
+    double              *mapped = NULL;
+    size_t               i;
+    size_t               n;
+    size_t               nblock;
+    size_t               offset;
+    nc_var_struct       *nc_var;
+
+    if (!stage->nc.open) {
+        initialize_state_file(stage->filename, &(stage->nc), &(stage->dmy));
+        debug("writing state file: %s", stage->filename);
+    }
+
+    for (; nvars > 0 && stage->next_var < stage->nvars; nvars--) {
+        nc_var = &(stage->nc.nc_vars[stage->varid[stage->next_var]]);
+        nblock = get_nc_block_size(nc_var->nc_dims, nc_var->nc_counts);
+
+        // collect the blocks of the variable from the values of each process
+        mapped = mpi_map_cells_buffer(nblock * global_domain.ncells_active *
+                                      sizeof(*mapped));
+        for (n = 0; n < (size_t) mpi_size; n++) {
+            offset = stage->nblock * mpi_map_global_array_offsets[n] +
+                     stage->offset[stage->next_var] *
+                     mpi_map_local_array_sizes[n];
+            memcpy(mapped + nblock * mpi_map_global_array_offsets[n],
+                   stage->recv + offset,
+                   nblock * mpi_map_local_array_sizes[n] * sizeof(*mapped));
+        }
+
+        if (nc_var->nc_type == NC_INT) {
+            ivar = malloc(nblock * global_domain.ncells_active *
+                          sizeof(*ivar));
+            check_alloc_status(ivar, "Memory allocation error");
+            for (i = 0; i < nblock * global_domain.ncells_active; i++) {
+                ivar[i] = (int) mapped[i];
+            }
+            put_nc_var_int_mapped(&(stage->nc), nc_var, ivar);
+            free(ivar);
+        }
+        else {
+            put_nc_var_double_mapped(&(stage->nc), nc_var, mapped);
+        }
+        stage->next_var++;
+    }
+
+    if (stage->next_var == stage->nvars) {
+        status = nc_close(stage->nc.nc_id);
+        check_nc_status(status, "Error closing %s", stage->filename);
+        stage->nc.open = false;
+        free(stage->nc.nc_vars);
+        stage->nc.nc_vars = NULL;
+        stage->pending = false;
+        debug("finished storing state file: %s", stage->filename);
+    }
+}
+
+/******************************************************************************
+ * @brief    Write a double precision state variable, or add it to the staged
+ *           state when stage is not NULL.
+ *****************************************************************************/
+void
+store_nc_var_double(nc_file_struct     *nc,
+                    nc_var_struct      *nc_var,
+                    double             *var,
+                    state_stage_struct *stage)
+{
+    extern domain_struct local_domain;
+
+    size_t               nblock;
+
+    if (stage == NULL) {
+        gather_put_nc_var_double(nc, nc_var, var);
+        return;
+    }
+
+    nblock = get_nc_block_size(nc_var->nc_dims, nc_var->nc_counts);
+    stage->varid[stage->nvars] = (int) (nc_var - nc->nc_vars);
+    stage->offset[stage->nvars] = stage->nblock;
+    memcpy(stage->send + stage->nblock * local_domain.ncells_active, var,
+           nblock * local_domain.ncells_active * sizeof(*var));
+    stage->nblock += nblock;
+    stage->nvars++;
+}
+
+/******************************************************************************
+ * @brief    Write an integer state variable, or add it to the staged state
+ *           when stage is not NULL.
+ * @details  Staged integer values are stored as double, which represents
+ *           them exactly.
+ *****************************************************************************/
+void
+store_nc_var_int(nc_file_struct     *nc,
+                 nc_var_struct      *nc_var,
+                 int                *var,
+                 state_stage_struct *stage)
+{
+    extern domain_struct local_domain;
+
+    size_t               i;
+    size_t               nblock;
+    double              *dvar;
+
+    if (stage == NULL) {
+        gather_put_nc_var_int(nc, nc_var, var);
+        return;
+    }
+
+    nblock = get_nc_block_size(nc_var->nc_dims, nc_var->nc_counts);
+    stage->varid[stage->nvars] = (int) (nc_var - nc->nc_vars);
+    stage->offset[stage->nvars] = stage->nblock;
+    dvar = stage->send + stage->nblock * local_domain.ncells_active;
+    for (i = 0; i < nblock * local_domain.ncells_active; i++) {
+        dvar[i] = (double) var[i];
+    }
+    stage->nblock += nblock;
+    stage->nvars++;
+}
+
+/******************************************************************************
+ * @brief    Save the model state of one ensemble member.
+ * @details  If stage is not NULL the state is staged and gathered without
+ *           blocking, and written later by write_stage_vars.
+ *****************************************************************************/
+void
+vic_store_member(dmy_struct         *dmy_current,
+                 size_t              member,
+                 char               *filename,
+                 state_stage_struct *stage)
 {
     extern filenames_struct    filenames;
     extern all_vars_struct    *all_vars;
@@ -40,7 +322,13 @@ vic_store(dmy_struct *dmy_current,
     extern veg_con_map_struct *veg_con_map;
     extern int                 mpi_rank;
     extern global_param_struct global_param;
+    extern domain_struct       global_domain;
+    extern int                *mpi_map_global_array_offsets;
+    extern int                *mpi_map_local_array_sizes;
+    extern int                 mpi_size;
+    extern MPI_Comm            MPI_COMM_VIC;
 
+    all_vars_struct           *member_vars;
     int                        status;
     int                        v;
     size_t                     i;
@@ -48,1226 +336,907 @@ vic_store(dmy_struct *dmy_current,
     size_t                     k;
     size_t                     m;
     size_t                     p;
+    size_t                     nblock;
+    size_t                     max_nblock;
+    size_t                     sum_nblock;
     int                       *ivar = NULL;
+    int                       *iblock = NULL;
     double                    *dvar = NULL;
-    size_t                     d2start[2];
-    size_t                     d3start[3];
-    size_t                     d4start[4];
-    size_t                     d5start[5];
-    size_t                     d6start[6];
+    double                    *dblock = NULL;
     nc_file_struct             nc_state_file;
     nc_var_struct             *nc_var;
 
+    // the states of member m of all cells start at m * ncells_active
+    member_vars = all_vars + member * local_domain.ncells_active;
+
     set_nc_state_file_info(&nc_state_file);
+    // the dimensions of the state variables are needed on all processes to
+    // determine the size of the blocks that are gathered
+    set_nc_state_var_info(&nc_state_file);
 
     // only open and initialize the netcdf file on the first thread
     if (mpi_rank == VIC_MPI_ROOT) {
         // create netcdf file for storing model state
-        sprintf(filename, "%s.%04i%02i%02i_%05u.nc",
-                filenames.statefile, global_param.stateyear,
-                global_param.statemonth, global_param.stateday,
-                global_param.statesec);
+        if (options.NMEMBERS > 1) {
+            sprintf(filename, "%s.member%03zu.%04i%02i%02i_%05u.nc",
+                    filenames.statefile, member, global_param.stateyear,
+                    global_param.statemonth, global_param.stateday,
+                    global_param.statesec);
+        }
+        else {
+            sprintf(filename, "%s.%04i%02i%02i_%05u.nc",
+                    filenames.statefile, global_param.stateyear,
+                    global_param.statemonth, global_param.stateday,
+                    global_param.statesec);
+        }
 
-        initialize_state_file(filename, &nc_state_file, dmy_current);
+        if (stage == NULL) {
+            initialize_state_file(filename, &nc_state_file, dmy_current);
 
-        debug("writing state file: %s", filename);
+            debug("writing state file: %s", filename);
+        }
+        else {
+            // the file is created when the staged state is written
+            strcpy(stage->filename, filename);
+        }
     }
 
-    // write state variables
-
-    // allocate memory for variables to be stored
-    ivar = malloc(local_domain.ncells_active * sizeof(*ivar));
-    check_alloc_status(ivar, "Memory allocation error");
+    // write state variables. All values of a state variable are packed
+    // into a single block of [nblock][ncells_active], where nblock is the
+    // product of the non-spatial dimensions, and gathered and written at once
 
+    // allocate memory for the largest block to be stored
+    max_nblock = 1;
+    sum_nblock = 0;
+    for (i = 0; i < N_STATE_VARS; i++) {
+        nblock = get_nc_block_size(nc_state_file.nc_vars[i].nc_dims,
+                                   nc_state_file.nc_vars[i].nc_counts);
+        if (nblock > max_nblock) {
+            max_nblock = nblock;
+        }
+        sum_nblock += nblock;
+    }
 
-    dvar = malloc(local_domain.ncells_active * sizeof(*dvar));
-    check_alloc_status(dvar, "Memory allocation error");
-
-
-    // initialize starts and counts
-    d2start[0] = 0;
-    d2start[1] = 0;
-
-    d3start[0] = 0;
-    d3start[1] = 0;
-    d3start[2] = 0;
-
-    d4start[0] = 0;
-    d4start[1] = 0;
-    d4start[2] = 0;
-    d4start[3] = 0;
-
-    d5start[0] = 0;
-    d5start[1] = 0;
-    d5start[2] = 0;
-    d5start[3] = 0;
-    d5start[4] = 0;
+    if (stage != NULL) {
+        // the staging buffers are kept for the next state file
+        if (stage->send == NULL) {
+            stage->send = malloc(sum_nblock * local_domain.ncells_active *
+                                 sizeof(*(stage->send)));
+            check_alloc_status(stage->send, "Memory allocation error");
+            if (mpi_rank == VIC_MPI_ROOT) {
+                stage->recv = malloc(sum_nblock *
+                                     global_domain.ncells_active *
+                                     sizeof(*(stage->recv)));
+                check_alloc_status(stage->recv, "Memory allocation error");
+                stage->counts = malloc(mpi_size * sizeof(*(stage->counts)));
+                check_alloc_status(stage->counts, "Memory allocation error");
+                stage->displs = malloc(mpi_size * sizeof(*(stage->displs)));
+                check_alloc_status(stage->displs, "Memory allocation error");
+            }
+        }
+        stage->nvars = 0;
+        stage->next_var = 0;
+        stage->nblock = 0;
+    }
 
-    d6start[0] = 0;
-    d6start[1] = 0;
-    d6start[2] = 0;
-    d6start[3] = 0;
-    d6start[4] = 0;
-    d6start[5] = 0;
+    iblock = malloc(max_nblock * local_domain.ncells_active * sizeof(*iblock));
+    check_alloc_status(iblock, "Memory allocation error");
 
-    // set missing values
-    for (i = 0; i < local_domain.ncells_active; i++) {
-        ivar[i] = nc_state_file.i_fillvalue;
-        dvar[i] = nc_state_file.d_fillvalue;
-    }
+    dblock = malloc(max_nblock * local_domain.ncells_active * sizeof(*dblock));
+    check_alloc_status(dblock, "Memory allocation error");
 
     // total soil moisture
     nc_var = &(nc_state_file.nc_vars[STATE_SOIL_MOISTURE]);
+    nblock = 0;
     for (m = 0; m < options.NVEGTYPES; m++) {
-        d5start[0] = m;
         for (k = 0; k < options.SNOW_BAND; k++) {
-            d5start[1] = k;
             for (j = 0; j < options.Nlayer; j++) {
-                d5start[2] = j;
+                dvar = dblock + nblock++ * local_domain.ncells_active;
                 for (i = 0; i < local_domain.ncells_active; i++) {
                     v = veg_con_map[i].vidx[m];
                     if (v >= 0) {
                         dvar[i] =
-                            (double) all_vars[i].cell[v][k].layer[j].moist;
+                            (double) member_vars[i].cell[v][k].layer[j].moist;
                     }
                     else {
                         dvar[i] = nc_state_file.d_fillvalue;
                     }
                 }
-                gather_put_nc_field_double(nc_state_file.nc_id,
-                                           nc_var->nc_varid,
-                                           nc_state_file.d_fillvalue,
-                                           d5start, nc_var->nc_counts, dvar);
-                for (i = 0; i < local_domain.ncells_active; i++) {
-                    dvar[i] = nc_state_file.d_fillvalue;
-                }
             }
         }
     }
+    store_nc_var_double(&nc_state_file, nc_var, dblock, stage);
 
     // ice content
     nc_var = &(nc_state_file.nc_vars[STATE_SOIL_ICE]);
+    nblock = 0;
     for (m = 0; m < options.NVEGTYPES; m++) {
-        d6start[0] = m;
         for (k = 0; k < options.SNOW_BAND; k++) {
-            d6start[1] = k;
             for (j = 0; j < options.Nlayer; j++) {
-                d6start[2] = j;
                 for (p = 0; p < options.Nfrost; p++) {
-                    d6start[3] = p;
+                    dvar = dblock + nblock++ * local_domain.ncells_active;
                     for (i = 0; i < local_domain.ncells_active; i++) {
                         v = veg_con_map[i].vidx[m];
                         if (v >= 0) {
-                            dvar[i] =
-                                (double) all_vars[i].cell[v][k].layer[j].ice[p];
+                            dvar[i] = (double)
+                                      member_vars[i].cell[v][k].layer[j].ice[p];
                         }
                         else {
                             dvar[i] = nc_state_file.d_fillvalue;
                         }
                     }
-                    gather_put_nc_field_double(nc_state_file.nc_id,
-                                               nc_var->nc_varid,
-                                               nc_state_file.d_fillvalue,
-                                               d6start, nc_var->nc_counts,
-                                               dvar);
-                    for (i = 0; i < local_domain.ncells_active; i++) {
-                        dvar[i] = nc_state_file.d_fillvalue;
-                    }
                 }
             }
         }
     }
+    store_nc_var_double(&nc_state_file, nc_var, dblock, stage);
 
 
     // dew storage: tmpval = veg_var[veg][band].Wdew;
     nc_var = &(nc_state_file.nc_vars[STATE_CANOPY_WATER]);
+    nblock = 0;
     for (m = 0; m < options.NVEGTYPES; m++) {
-        d4start[0] = m;
         for (k = 0; k < options.SNOW_BAND; k++) {
-            d4start[1] = k;
+            dvar = dblock + nblock++ * local_domain.ncells_active;
             for (i = 0; i < local_domain.ncells_active; i++) {
                 v = veg_con_map[i].vidx[m];
                 if (v >= 0) {
-                    dvar[i] = (double) all_vars[i].veg_var[v][k].Wdew;
+                    dvar[i] = (double) member_vars[i].veg_var[v][k].Wdew;
                 }
                 else {
                     dvar[i] = nc_state_file.d_fillvalue;
                 }
             }
-            gather_put_nc_field_double(nc_state_file.nc_id,
-                                       nc_var->nc_varid,
-                                       nc_state_file.d_fillvalue,
-                                       d4start, nc_var->nc_counts, dvar);
-            for (i = 0; i < local_domain.ncells_active; i++) {
-                dvar[i] = nc_state_file.d_fillvalue;
-            }
         }
     }
+    store_nc_var_double(&nc_state_file, nc_var, dblock, stage);
 
 
     if (options.CARBON) {
         // cumulative NPP: tmpval = veg_var[veg][band].AnnualNPP;
         nc_var = &(nc_state_file.nc_vars[STATE_ANNUALNPP]);
+        nblock = 0;
         for (m = 0; m < options.NVEGTYPES; m++) {
-            d4start[0] = m;
             for (k = 0; k < options.SNOW_BAND; k++) {
-                d4start[1] = k;
+                dvar = dblock + nblock++ * local_domain.ncells_active;
                 for (i = 0; i < local_domain.ncells_active; i++) {
                     v = veg_con_map[i].vidx[m];
                     if (v >= 0) {
-                        dvar[i] = (double) all_vars[i].veg_var[v][k].AnnualNPP;
+                        dvar[i] =
+                            (double) member_vars[i].veg_var[v][k].AnnualNPP;
                     }
                     else {
                         dvar[i] = nc_state_file.d_fillvalue;
                     }
                 }
-                gather_put_nc_field_double(nc_state_file.nc_id,
-                                           nc_var->nc_varid,
-                                           nc_state_file.d_fillvalue,
-                                           d4start, nc_var->nc_counts, dvar);
-                for (i = 0; i < local_domain.ncells_active; i++) {
-                    dvar[i] = nc_state_file.d_fillvalue;
-                }
             }
         }
+        store_nc_var_double(&nc_state_file, nc_var, dblock, stage);
 
         // previous NPP: tmpval = veg_var[veg][band].AnnualNPPPrev;
         nc_var = &(nc_state_file.nc_vars[STATE_ANNUALNPPPREV]);
+        nblock = 0;
         for (m = 0; m < options.NVEGTYPES; m++) {
-            d4start[0] = m;
             for (k = 0; k < options.SNOW_BAND; k++) {
-                d4start[1] = k;
+                dvar = dblock + nblock++ * local_domain.ncells_active;
                 for (i = 0; i < local_domain.ncells_active; i++) {
                     v = veg_con_map[i].vidx[m];
                     if (v >= 0) {
                         dvar[i] =
-                            (double) all_vars[i].veg_var[v][k].AnnualNPPPrev;
+                            (double) member_vars[i].veg_var[v][k].AnnualNPPPrev;
                     }
                     else {
                         dvar[i] = nc_state_file.d_fillvalue;
                     }
                 }
-                gather_put_nc_field_double(nc_state_file.nc_id,
-                                           nc_var->nc_varid,
-                                           nc_state_file.d_fillvalue,
-                                           d4start, nc_var->nc_counts, dvar);
-                for (i = 0; i < local_domain.ncells_active; i++) {
-                    dvar[i] = nc_state_file.d_fillvalue;
-                }
             }
         }
+        store_nc_var_double(&nc_state_file, nc_var, dblock, stage);
 
         // litter carbon: tmpval = cell[veg][band].CLitter;
         nc_var = &(nc_state_file.nc_vars[STATE_CLITTER]);
+        nblock = 0;
         for (m = 0; m < options.NVEGTYPES; m++) {
-            d4start[0] = m;
             for (k = 0; k < options.SNOW_BAND; k++) {
-                d4start[1] = k;
+                dvar = dblock + nblock++ * local_domain.ncells_active;
                 for (i = 0; i < local_domain.ncells_active; i++) {
                     v = veg_con_map[i].vidx[m];
                     if (v >= 0) {
-                        dvar[i] = (double) all_vars[i].cell[v][k].CLitter;
+                        dvar[i] = (double) member_vars[i].cell[v][k].CLitter;
                     }
                     else {
                         dvar[i] = nc_state_file.d_fillvalue;
                     }
                 }
-                gather_put_nc_field_double(nc_state_file.nc_id,
-                                           nc_var->nc_varid,
-                                           nc_state_file.d_fillvalue,
-                                           d4start, nc_var->nc_counts, dvar);
-                for (i = 0; i < local_domain.ncells_active; i++) {
-                    dvar[i] = nc_state_file.d_fillvalue;
-                }
             }
         }
+        store_nc_var_double(&nc_state_file, nc_var, dblock, stage);
 
         // intermediate carbon: tmpval = tmpval = cell[veg][band].CInter;
         nc_var = &(nc_state_file.nc_vars[STATE_CINTER]);
+        nblock = 0;
         for (m = 0; m < options.NVEGTYPES; m++) {
-            d4start[0] = m;
             for (k = 0; k < options.SNOW_BAND; k++) {
-                d4start[1] = k;
+                dvar = dblock + nblock++ * local_domain.ncells_active;
                 for (i = 0; i < local_domain.ncells_active; i++) {
                     v = veg_con_map[i].vidx[m];
                     if (v >= 0) {
-                        dvar[i] = (double) all_vars[i].cell[v][k].CInter;
+                        dvar[i] = (double) member_vars[i].cell[v][k].CInter;
                     }
                     else {
                         dvar[i] = nc_state_file.d_fillvalue;
                     }
                 }
-                gather_put_nc_field_double(nc_state_file.nc_id,
-                                           nc_var->nc_varid,
-                                           nc_state_file.d_fillvalue,
-                                           d4start, nc_var->nc_counts, dvar);
-                for (i = 0; i < local_domain.ncells_active; i++) {
-                    dvar[i] = nc_state_file.d_fillvalue;
-                }
             }
         }
+        store_nc_var_double(&nc_state_file, nc_var, dblock, stage);
 
         // slow carbon: tmpval = cell[veg][band].CSlow;
         nc_var = &(nc_state_file.nc_vars[STATE_CSLOW]);
+        nblock = 0;
         for (m = 0; m < options.NVEGTYPES; m++) {
-            d4start[0] = m;
             for (k = 0; k < options.SNOW_BAND; k++) {
-                d4start[1] = k;
+                dvar = dblock + nblock++ * local_domain.ncells_active;
                 for (i = 0; i < local_domain.ncells_active; i++) {
                     v = veg_con_map[i].vidx[m];
                     if (v >= 0) {
-                        dvar[i] = (double) all_vars[i].cell[v][k].CSlow;
+                        dvar[i] = (double) member_vars[i].cell[v][k].CSlow;
                     }
                     else {
                         dvar[i] = nc_state_file.d_fillvalue;
                     }
                 }
-                gather_put_nc_field_double(nc_state_file.nc_id,
-                                           nc_var->nc_varid,
-                                           nc_state_file.d_fillvalue,
-                                           d4start, nc_var->nc_counts, dvar);
-                for (i = 0; i < local_domain.ncells_active; i++) {
-                    dvar[i] = nc_state_file.d_fillvalue;
-                }
             }
         }
+        store_nc_var_double(&nc_state_file, nc_var, dblock, stage);
     }
 
     // snow age: snow[veg][band].last_snow
     nc_var = &(nc_state_file.nc_vars[STATE_SNOW_AGE]);
+    nblock = 0;
     for (m = 0; m < options.NVEGTYPES; m++) {
-        d4start[0] = m;
         for (k = 0; k < options.SNOW_BAND; k++) {
-            d4start[1] = k;
+            ivar = iblock + nblock++ * local_domain.ncells_active;
             for (i = 0; i < local_domain.ncells_active; i++) {
                 v = veg_con_map[i].vidx[m];
                 if (v >= 0) {
-                    ivar[i] = (int) all_vars[i].snow[v][k].last_snow;
+                    ivar[i] = (int) member_vars[i].snow[v][k].last_snow;
                 }
                 else {
                     ivar[i] = nc_state_file.i_fillvalue;
                 }
             }
-            gather_put_nc_field_int(nc_state_file.nc_id,
-                                    nc_var->nc_varid,
-                                    nc_state_file.d_fillvalue,
-                                    d4start, nc_var->nc_counts, ivar);
-            for (i = 0; i < local_domain.ncells_active; i++) {
-                ivar[i] = nc_state_file.i_fillvalue;
-            }
         }
     }
+    store_nc_var_int(&nc_state_file, nc_var, iblock, stage);
 
 
     // melting state: (int)snow[veg][band].MELTING
     nc_var = &(nc_state_file.nc_vars[STATE_SNOW_MELT_STATE]);
+    nblock = 0;
     for (m = 0; m < options.NVEGTYPES; m++) {
-        d4start[0] = m;
         for (k = 0; k < options.SNOW_BAND; k++) {
-            d4start[1] = k;
+            ivar = iblock + nblock++ * local_domain.ncells_active;
             for (i = 0; i < local_domain.ncells_active; i++) {
                 v = veg_con_map[i].vidx[m];
                 if (v >= 0) {
-                    ivar[i] = (int) all_vars[i].snow[v][k].MELTING;
+                    ivar[i] = (int) member_vars[i].snow[v][k].MELTING;
                 }
                 else {
                     ivar[i] = nc_state_file.i_fillvalue;
                 }
             }
-            gather_put_nc_field_int(nc_state_file.nc_id,
-                                    nc_var->nc_varid,
-                                    nc_state_file.d_fillvalue,
-                                    d4start, nc_var->nc_counts, ivar);
-            for (i = 0; i < local_domain.ncells_active; i++) {
-                ivar[i] = nc_state_file.i_fillvalue;
-            }
         }
     }
+    store_nc_var_int(&nc_state_file, nc_var, iblock, stage);
 
 
     // snow covered fraction: snow[veg][band].coverage
     nc_var = &(nc_state_file.nc_vars[STATE_SNOW_COVERAGE]);
+    nblock = 0;
     for (m = 0; m < options.NVEGTYPES; m++) {
-        d4start[0] = m;
         for (k = 0; k < options.SNOW_BAND; k++) {
-            d4start[1] = k;
+            dvar = dblock + nblock++ * local_domain.ncells_active;
             for (i = 0; i < local_domain.ncells_active; i++) {
                 v = veg_con_map[i].vidx[m];
                 if (v >= 0) {
-                    dvar[i] = (double) all_vars[i].snow[v][k].coverage;
+                    dvar[i] = (double) member_vars[i].snow[v][k].coverage;
                 }
                 else {
                     dvar[i] = nc_state_file.d_fillvalue;
                 }
             }
-            gather_put_nc_field_double(nc_state_file.nc_id,
-                                       nc_var->nc_varid,
-                                       nc_state_file.d_fillvalue,
-                                       d4start, nc_var->nc_counts, dvar);
-            for (i = 0; i < local_domain.ncells_active; i++) {
-                dvar[i] = nc_state_file.d_fillvalue;
-            }
         }
     }
+    store_nc_var_double(&nc_state_file, nc_var, dblock, stage);
 
 
     // snow water equivalent: snow[veg][band].swq
     nc_var = &(nc_state_file.nc_vars[STATE_SNOW_WATER_EQUIVALENT]);
+    nblock = 0;
     for (m = 0; m < options.NVEGTYPES; m++) {
-        d4start[0] = m;
         for (k = 0; k < options.SNOW_BAND; k++) {
-            d4start[1] = k;
+            dvar = dblock + nblock++ * local_domain.ncells_active;
             for (i = 0; i < local_domain.ncells_active; i++) {
                 v = veg_con_map[i].vidx[m];
                 if (v >= 0) {
-                    dvar[i] = (double) all_vars[i].snow[v][k].swq;
+                    dvar[i] = (double) member_vars[i].snow[v][k].swq;
                 }
                 else {
                     dvar[i] = nc_state_file.d_fillvalue;
                 }
             }
-            gather_put_nc_field_double(nc_state_file.nc_id,
-                                       nc_var->nc_varid,
-                                       nc_state_file.d_fillvalue,
-                                       d4start, nc_var->nc_counts, dvar);
-            for (i = 0; i < local_domain.ncells_active; i++) {
-                dvar[i] = nc_state_file.d_fillvalue;
-            }
         }
     }
+    store_nc_var_double(&nc_state_file, nc_var, dblock, stage);
 
 
     // snow surface temperature: snow[veg][band].surf_temp
     nc_var = &(nc_state_file.nc_vars[STATE_SNOW_SURF_TEMP]);
+    nblock = 0;
     for (m = 0; m < options.NVEGTYPES; m++) {
-        d4start[0] = m;
         for (k = 0; k < options.SNOW_BAND; k++) {
-            d4start[1] = k;
+            dvar = dblock + nblock++ * local_domain.ncells_active;
             for (i = 0; i < local_domain.ncells_active; i++) {
                 v = veg_con_map[i].vidx[m];
                 if (v >= 0) {
-                    dvar[i] = (double) all_vars[i].snow[v][k].surf_temp;
+                    dvar[i] = (double) member_vars[i].snow[v][k].surf_temp;
                 }
                 else {
                     dvar[i] = nc_state_file.d_fillvalue;
                 }
             }
-            gather_put_nc_field_double(nc_state_file.nc_id,
-                                       nc_var->nc_varid,
-                                       nc_state_file.d_fillvalue,
-                                       d4start, nc_var->nc_counts, dvar);
-            for (i = 0; i < local_domain.ncells_active; i++) {
-                dvar[i] = nc_state_file.d_fillvalue;
-            }
         }
     }
+    store_nc_var_double(&nc_state_file, nc_var, dblock, stage);
 
 
     // snow surface water: snow[veg][band].surf_water
     nc_var = &(nc_state_file.nc_vars[STATE_SNOW_SURF_WATER]);
+    nblock = 0;
     for (m = 0; m < options.NVEGTYPES; m++) {
-        d4start[0] = m;
         for (k = 0; k < options.SNOW_BAND; k++) {
-            d4start[1] = k;
+            dvar = dblock + nblock++ * local_domain.ncells_active;
             for (i = 0; i < local_domain.ncells_active; i++) {
                 v = veg_con_map[i].vidx[m];
                 if (v >= 0) {
-                    dvar[i] = (double) all_vars[i].snow[v][k].surf_water;
+                    dvar[i] = (double) member_vars[i].snow[v][k].surf_water;
                 }
                 else {
                     dvar[i] = nc_state_file.d_fillvalue;
                 }
             }
-            gather_put_nc_field_double(nc_state_file.nc_id,
-                                       nc_var->nc_varid,
-                                       nc_state_file.d_fillvalue,
-                                       d4start, nc_var->nc_counts, dvar);
-            for (i = 0; i < local_domain.ncells_active; i++) {
-                dvar[i] = nc_state_file.d_fillvalue;
-            }
         }
     }
+    store_nc_var_double(&nc_state_file, nc_var, dblock, stage);
 
 
     // snow pack temperature: snow[veg][band].pack_temp
     nc_var = &(nc_state_file.nc_vars[STATE_SNOW_PACK_TEMP]);
+    nblock = 0;
     for (m = 0; m < options.NVEGTYPES; m++) {
-        d4start[0] = m;
         for (k = 0; k < options.SNOW_BAND; k++) {
-            d4start[1] = k;
+            dvar = dblock + nblock++ * local_domain.ncells_active;
             for (i = 0; i < local_domain.ncells_active; i++) {
                 v = veg_con_map[i].vidx[m];
                 if (v >= 0) {
-                    dvar[i] = (double) all_vars[i].snow[v][k].pack_temp;
+                    dvar[i] = (double) member_vars[i].snow[v][k].pack_temp;
                 }
                 else {
                     dvar[i] = nc_state_file.d_fillvalue;
                 }
             }
-            gather_put_nc_field_double(nc_state_file.nc_id,
-                                       nc_var->nc_varid,
-                                       nc_state_file.d_fillvalue,
-                                       d4start, nc_var->nc_counts, dvar);
-            for (i = 0; i < local_domain.ncells_active; i++) {
-                dvar[i] = nc_state_file.d_fillvalue;
-            }
         }
     }
+    store_nc_var_double(&nc_state_file, nc_var, dblock, stage);
 
 
     // snow pack water: snow[veg][band].pack_water
     nc_var = &(nc_state_file.nc_vars[STATE_SNOW_PACK_WATER]);
+    nblock = 0;
     for (m = 0; m < options.NVEGTYPES; m++) {
-        d4start[0] = m;
         for (k = 0; k < options.SNOW_BAND; k++) {
-            d4start[1] = k;
+            dvar = dblock + nblock++ * local_domain.ncells_active;
             for (i = 0; i < local_domain.ncells_active; i++) {
                 v = veg_con_map[i].vidx[m];
                 if (v >= 0) {
-                    dvar[i] = (double) all_vars[i].snow[v][k].pack_water;
+                    dvar[i] = (double) member_vars[i].snow[v][k].pack_water;
                 }
                 else {
                     dvar[i] = nc_state_file.d_fillvalue;
                 }
             }
-            gather_put_nc_field_double(nc_state_file.nc_id,
-                                       nc_var->nc_varid,
-                                       nc_state_file.d_fillvalue,
-                                       d4start, nc_var->nc_counts, dvar);
-            for (i = 0; i < local_domain.ncells_active; i++) {
-                dvar[i] = nc_state_file.d_fillvalue;
-            }
         }
     }
+    store_nc_var_double(&nc_state_file, nc_var, dblock, stage);
 
 
     // snow density: snow[veg][band].density
     nc_var = &(nc_state_file.nc_vars[STATE_SNOW_DENSITY]);
+    nblock = 0;
     for (m = 0; m < options.NVEGTYPES; m++) {
-        d4start[0] = m;
         for (k = 0; k < options.SNOW_BAND; k++) {
-            d4start[1] = k;
+            dvar = dblock + nblock++ * local_domain.ncells_active;
             for (i = 0; i < local_domain.ncells_active; i++) {
                 v = veg_con_map[i].vidx[m];
                 if (v >= 0) {
-                    dvar[i] = (double) all_vars[i].snow[v][k].density;
+                    dvar[i] = (double) member_vars[i].snow[v][k].density;
                 }
                 else {
                     dvar[i] = nc_state_file.d_fillvalue;
                 }
             }
-            gather_put_nc_field_double(nc_state_file.nc_id,
-                                       nc_var->nc_varid,
-                                       nc_state_file.d_fillvalue,
-                                       d4start, nc_var->nc_counts, dvar);
-            for (i = 0; i < local_domain.ncells_active; i++) {
-                dvar[i] = nc_state_file.d_fillvalue;
-            }
         }
     }
+    store_nc_var_double(&nc_state_file, nc_var, dblock, stage);
 
 
     // snow cold content: snow[veg][band].coldcontent
     nc_var = &(nc_state_file.nc_vars[STATE_SNOW_COLD_CONTENT]);
+    nblock = 0;
     for (m = 0; m < options.NVEGTYPES; m++) {
-        d4start[0] = m;
         for (k = 0; k < options.SNOW_BAND; k++) {
-            d4start[1] = k;
+            dvar = dblock + nblock++ * local_domain.ncells_active;
             for (i = 0; i < local_domain.ncells_active; i++) {
                 v = veg_con_map[i].vidx[m];
                 if (v >= 0) {
-                    dvar[i] = (double) all_vars[i].snow[v][k].coldcontent;
+                    dvar[i] = (double) member_vars[i].snow[v][k].coldcontent;
                 }
                 else {
                     dvar[i] = nc_state_file.d_fillvalue;
                 }
             }
-            gather_put_nc_field_double(nc_state_file.nc_id,
-                                       nc_var->nc_varid,
-                                       nc_state_file.d_fillvalue,
-                                       d4start, nc_var->nc_counts, dvar);
-            for (i = 0; i < local_domain.ncells_active; i++) {
-                dvar[i] = nc_state_file.d_fillvalue;
-            }
         }
     }
+    store_nc_var_double(&nc_state_file, nc_var, dblock, stage);
 
 
     // snow canopy storage: snow[veg][band].snow_canopy
     nc_var = &(nc_state_file.nc_vars[STATE_SNOW_CANOPY]);
+    nblock = 0;
     for (m = 0; m < options.NVEGTYPES; m++) {
-        d4start[0] = m;
         for (k = 0; k < options.SNOW_BAND; k++) {
-            d4start[1] = k;
+            dvar = dblock + nblock++ * local_domain.ncells_active;
             for (i = 0; i < local_domain.ncells_active; i++) {
                 v = veg_con_map[i].vidx[m];
                 if (v >= 0) {
-                    dvar[i] = (double) all_vars[i].snow[v][k].snow_canopy;
+                    dvar[i] = (double) member_vars[i].snow[v][k].snow_canopy;
                 }
                 else {
                     dvar[i] = nc_state_file.d_fillvalue;
                 }
             }
-            gather_put_nc_field_double(nc_state_file.nc_id,
-                                       nc_var->nc_varid,
-                                       nc_state_file.d_fillvalue,
-                                       d4start, nc_var->nc_counts, dvar);
-            for (i = 0; i < local_domain.ncells_active; i++) {
-                dvar[i] = nc_state_file.d_fillvalue;
-            }
         }
     }
+    store_nc_var_double(&nc_state_file, nc_var, dblock, stage);
 
 
     // soil node temperatures: energy[veg][band].T[nidx]
     nc_var = &(nc_state_file.nc_vars[STATE_SOIL_NODE_TEMP]);
+    nblock = 0;
     for (m = 0; m < options.NVEGTYPES; m++) {
-        d5start[0] = m;
         for (k = 0; k < options.SNOW_BAND; k++) {
-            d5start[1] = k;
             for (j = 0; j < options.Nnode; j++) {
-                d5start[2] = j;
+                dvar = dblock + nblock++ * local_domain.ncells_active;
                 for (i = 0; i < local_domain.ncells_active; i++) {
                     v = veg_con_map[i].vidx[m];
                     if (v >= 0) {
-                        dvar[i] = (double) all_vars[i].energy[v][k].T[j];
+                        dvar[i] = (double) member_vars[i].energy[v][k].T[j];
                     }
                     else {
                         dvar[i] = nc_state_file.d_fillvalue;
                     }
                 }
-                gather_put_nc_field_double(nc_state_file.nc_id,
-                                           nc_var->nc_varid,
-                                           nc_state_file.d_fillvalue,
-                                           d5start, nc_var->nc_counts, dvar);
-                for (i = 0; i < local_domain.ncells_active; i++) {
-                    dvar[i] = nc_state_file.d_fillvalue;
-                }
             }
         }
     }
+    store_nc_var_double(&nc_state_file, nc_var, dblock, stage);
 
 
     // Foliage temperature: energy[veg][band].Tfoliage
     nc_var = &(nc_state_file.nc_vars[STATE_FOLIAGE_TEMPERATURE]);
+    nblock = 0;
     for (m = 0; m < options.NVEGTYPES; m++) {
-        d4start[0] = m;
         for (k = 0; k < options.SNOW_BAND; k++) {
-            d4start[1] = k;
+            dvar = dblock + nblock++ * local_domain.ncells_active;
             for (i = 0; i < local_domain.ncells_active; i++) {
                 v = veg_con_map[i].vidx[m];
                 if (v >= 0) {
-                    dvar[i] = (double) all_vars[i].energy[v][k].Tfoliage;
+                    dvar[i] = (double) member_vars[i].energy[v][k].Tfoliage;
                 }
                 else {
                     dvar[i] = nc_state_file.d_fillvalue;
                 }
             }
-            gather_put_nc_field_double(nc_state_file.nc_id,
-                                       nc_var->nc_varid,
-                                       nc_state_file.d_fillvalue,
-                                       d4start, nc_var->nc_counts, dvar);
-            for (i = 0; i < local_domain.ncells_active; i++) {
-                dvar[i] = nc_state_file.d_fillvalue;
-            }
         }
     }
+    store_nc_var_double(&nc_state_file, nc_var, dblock, stage);
 
 
     // Outgoing longwave from understory: energy[veg][band].LongUnderOut
     // This is a flux, and saving it to state file is a temporary solution!!
     nc_var = &(nc_state_file.nc_vars[STATE_ENERGY_LONGUNDEROUT]);
+    nblock = 0;
     for (m = 0; m < options.NVEGTYPES; m++) {
-        d4start[0] = m;
         for (k = 0; k < options.SNOW_BAND; k++) {
-            d4start[1] = k;
+            dvar = dblock + nblock++ * local_domain.ncells_active;
             for (i = 0; i < local_domain.ncells_active; i++) {
                 v = veg_con_map[i].vidx[m];
                 if (v >= 0) {
-                    dvar[i] = (double) all_vars[i].energy[v][k].LongUnderOut;
+                    dvar[i] = (double) member_vars[i].energy[v][k].LongUnderOut;
                 }
                 else {
                     dvar[i] = nc_state_file.d_fillvalue;
                 }
             }
-            gather_put_nc_field_double(nc_state_file.nc_id,
-                                       nc_var->nc_varid,
-                                       nc_state_file.d_fillvalue,
-                                       d4start, nc_var->nc_counts, dvar);
-            for (i = 0; i < local_domain.ncells_active; i++) {
-                dvar[i] = nc_state_file.d_fillvalue;
-            }
         }
     }
+    store_nc_var_double(&nc_state_file, nc_var, dblock, stage);
 
 
     // Thermal flux through the snow pack: energy[veg][band].snow_flux
     // This is a flux, and saving it to state file is a temporary solution!!
     nc_var = &(nc_state_file.nc_vars[STATE_ENERGY_SNOW_FLUX]);
+    nblock = 0;
     for (m = 0; m < options.NVEGTYPES; m++) {
-        d4start[0] = m;
         for (k = 0; k < options.SNOW_BAND; k++) {
-            d4start[1] = k;
+            dvar = dblock + nblock++ * local_domain.ncells_active;
             for (i = 0; i < local_domain.ncells_active; i++) {
                 v = veg_con_map[i].vidx[m];
                 if (v >= 0) {
-                    dvar[i] = (double) all_vars[i].energy[v][k].snow_flux;
+                    dvar[i] = (double) member_vars[i].energy[v][k].snow_flux;
                 }
                 else {
                     dvar[i] = nc_state_file.d_fillvalue;
                 }
             }
-            gather_put_nc_field_double(nc_state_file.nc_id,
-                                       nc_var->nc_varid,
-                                       nc_state_file.d_fillvalue,
-                                       d4start, nc_var->nc_counts, dvar);
-            for (i = 0; i < local_domain.ncells_active; i++) {
-                dvar[i] = nc_state_file.d_fillvalue;
-            }
         }
     }
+    store_nc_var_double(&nc_state_file, nc_var, dblock, stage);
 
 
     if (options.LAKES) {
         // total soil moisture
         nc_var = &(nc_state_file.nc_vars[STATE_LAKE_SOIL_MOISTURE]);
+        nblock = 0;
         for (j = 0; j < options.Nlayer; j++) {
-            d3start[0] = j;
-            for (i = 0; i < local_domain.ncells_active; i++) {
-                dvar[i] = (double) all_vars[i].lake_var.soil.layer[j].moist;
-            }
-            gather_put_nc_field_double(nc_state_file.nc_id,
-                                       nc_var->nc_varid,
-                                       nc_state_file.d_fillvalue,
-                                       d3start, nc_var->nc_counts, dvar);
+            dvar = dblock + nblock++ * local_domain.ncells_active;
             for (i = 0; i < local_domain.ncells_active; i++) {
-                dvar[i] = nc_state_file.d_fillvalue;
+                dvar[i] = (double) member_vars[i].lake_var.soil.layer[j].moist;
             }
         }
+        store_nc_var_double(&nc_state_file, nc_var, dblock, stage);
 
         // ice content
         nc_var = &(nc_state_file.nc_vars[STATE_LAKE_SOIL_ICE]);
+        nblock = 0;
         for (j = 0; j < options.Nlayer; j++) {
-            d4start[0] = j;
             for (p = 0; p < options.Nfrost; p++) {
-                d4start[1] = p;
+                dvar = dblock + nblock++ * local_domain.ncells_active;
                 for (i = 0; i < local_domain.ncells_active; i++) {
                     dvar[i] =
-                        (double) all_vars[i].lake_var.soil.layer[j].ice[p];
-                }
-                gather_put_nc_field_double(nc_state_file.nc_id,
-                                           nc_var->nc_varid,
-                                           nc_state_file.d_fillvalue,
-                                           d4start, nc_var->nc_counts, dvar);
-                for (i = 0; i < local_domain.ncells_active; i++) {
-                    dvar[i] = nc_state_file.d_fillvalue;
+                        (double) member_vars[i].lake_var.soil.layer[j].ice[p];
                 }
             }
         }
+        store_nc_var_double(&nc_state_file, nc_var, dblock, stage);
 
         if (options.CARBON) {
             // litter carbon: tmpval = lake_var.soil.CLitter;
             nc_var = &(nc_state_file.nc_vars[STATE_LAKE_CLITTER]);
             for (i = 0; i < local_domain.ncells_active; i++) {
-                dvar[i] = (double) all_vars[i].lake_var.soil.CLitter;
-            }
-            gather_put_nc_field_double(nc_state_file.nc_id,
-                                       nc_var->nc_varid,
-                                       nc_state_file.d_fillvalue,
-                                       d2start, nc_var->nc_counts, dvar);
-            for (i = 0; i < local_domain.ncells_active; i++) {
-                dvar[i] = nc_state_file.d_fillvalue;
+                dblock[i] = (double) member_vars[i].lake_var.soil.CLitter;
             }
+            store_nc_var_double(&nc_state_file, nc_var, dblock, stage);
 
             // intermediate carbon: tmpval = lake_var.soil.CInter;
             nc_var = &(nc_state_file.nc_vars[STATE_LAKE_CINTER]);
             for (i = 0; i < local_domain.ncells_active; i++) {
-                dvar[i] = (double) all_vars[i].lake_var.soil.CInter;
-            }
-            gather_put_nc_field_double(nc_state_file.nc_id,
-                                       nc_var->nc_varid,
-                                       nc_state_file.d_fillvalue,
-                                       d2start, nc_var->nc_counts, dvar);
-            for (i = 0; i < local_domain.ncells_active; i++) {
-                dvar[i] = nc_state_file.d_fillvalue;
+                dblock[i] = (double) member_vars[i].lake_var.soil.CInter;
             }
+            store_nc_var_double(&nc_state_file, nc_var, dblock, stage);
 
             // slow carbon: tmpval = lake_var.soil.CSlow;
             nc_var = &(nc_state_file.nc_vars[STATE_LAKE_CSLOW]);
             for (i = 0; i < local_domain.ncells_active; i++) {
-                dvar[i] = (double) all_vars[i].lake_var.soil.CSlow;
-            }
-            gather_put_nc_field_double(nc_state_file.nc_id,
-                                       nc_var->nc_varid,
-                                       nc_state_file.d_fillvalue,
-                                       d2start, nc_var->nc_counts, dvar);
-            for (i = 0; i < local_domain.ncells_active; i++) {
-                dvar[i] = nc_state_file.d_fillvalue;
+                dblock[i] = (double) member_vars[i].lake_var.soil.CSlow;
             }
+            store_nc_var_double(&nc_state_file, nc_var, dblock, stage);
         }
 
         // snow age: lake_var.snow.last_snow
         nc_var = &(nc_state_file.nc_vars[STATE_LAKE_SNOW_AGE]);
         for (i = 0; i < local_domain.ncells_active; i++) {
-            ivar[i] = (int) all_vars[i].lake_var.snow.last_snow;
-        }
-        gather_put_nc_field_int(nc_state_file.nc_id,
-                                nc_var->nc_varid,
-                                nc_state_file.d_fillvalue,
-                                d2start, nc_var->nc_counts, ivar);
-        for (i = 0; i < local_domain.ncells_active; i++) {
-            ivar[i] = nc_state_file.i_fillvalue;
+            iblock[i] = (int) member_vars[i].lake_var.snow.last_snow;
         }
+        store_nc_var_int(&nc_state_file, nc_var, iblock, stage);
 
         // melting state: (int)lake_var.snow.MELTING
         nc_var = &(nc_state_file.nc_vars[STATE_LAKE_SNOW_MELT_STATE]);
         for (i = 0; i < local_domain.ncells_active; i++) {
-            ivar[i] = (int) all_vars[i].lake_var.snow.MELTING;
-        }
-        gather_put_nc_field_int(nc_state_file.nc_id,
-                                nc_var->nc_varid,
-                                nc_state_file.d_fillvalue,
-                                d2start, nc_var->nc_counts, ivar);
-        for (i = 0; i < local_domain.ncells_active; i++) {
-            ivar[i] = nc_state_file.i_fillvalue;
+            iblock[i] = (int) member_vars[i].lake_var.snow.MELTING;
         }
+        store_nc_var_int(&nc_state_file, nc_var, iblock, stage);
 
         // snow covered fraction: lake_var.snow.coverage
         nc_var = &(nc_state_file.nc_vars[STATE_LAKE_SNOW_COVERAGE]);
         for (i = 0; i < local_domain.ncells_active; i++) {
-            dvar[i] = (double) all_vars[i].lake_var.snow.coverage;
-        }
-        gather_put_nc_field_double(nc_state_file.nc_id,
-                                   nc_var->nc_varid,
-                                   nc_state_file.d_fillvalue,
-                                   d2start, nc_var->nc_counts, dvar);
-        for (i = 0; i < local_domain.ncells_active; i++) {
-            dvar[i] = nc_state_file.d_fillvalue;
+            dblock[i] = (double) member_vars[i].lake_var.snow.coverage;
         }
+        store_nc_var_double(&nc_state_file, nc_var, dblock, stage);
 
         // snow water equivalent: lake_var.snow.swq
         nc_var = &(nc_state_file.nc_vars[STATE_LAKE_SNOW_WATER_EQUIVALENT]);
         for (i = 0; i < local_domain.ncells_active; i++) {
-            dvar[i] = (double) all_vars[i].lake_var.snow.swq;
-        }
-        gather_put_nc_field_double(nc_state_file.nc_id,
-                                   nc_var->nc_varid,
-                                   nc_state_file.d_fillvalue,
-                                   d2start, nc_var->nc_counts, dvar);
-        for (i = 0; i < local_domain.ncells_active; i++) {
-            dvar[i] = nc_state_file.d_fillvalue;
+            dblock[i] = (double) member_vars[i].lake_var.snow.swq;
         }
+        store_nc_var_double(&nc_state_file, nc_var, dblock, stage);
 
         // snow surface temperature: lake_var.snow.surf_temp
         nc_var = &(nc_state_file.nc_vars[STATE_LAKE_SNOW_SURF_TEMP]);
         for (i = 0; i < local_domain.ncells_active; i++) {
-            dvar[i] = (double) all_vars[i].lake_var.snow.surf_temp;
-        }
-        gather_put_nc_field_double(nc_state_file.nc_id,
-                                   nc_var->nc_varid,
-                                   nc_state_file.d_fillvalue,
-                                   d2start, nc_var->nc_counts, dvar);
-        for (i = 0; i < local_domain.ncells_active; i++) {
-            dvar[i] = nc_state_file.d_fillvalue;
+            dblock[i] = (double) member_vars[i].lake_var.snow.surf_temp;
         }
+        store_nc_var_double(&nc_state_file, nc_var, dblock, stage);
 
         // snow surface water: lake_var.snow.surf_water
         nc_var = &(nc_state_file.nc_vars[STATE_LAKE_SNOW_SURF_WATER]);
         for (i = 0; i < local_domain.ncells_active; i++) {
-            dvar[i] = (double) all_vars[i].lake_var.snow.surf_water;
-        }
-        gather_put_nc_field_double(nc_state_file.nc_id,
-                                   nc_var->nc_varid,
-                                   nc_state_file.d_fillvalue,
-                                   d2start, nc_var->nc_counts, dvar);
-        for (i = 0; i < local_domain.ncells_active; i++) {
-            dvar[i] = nc_state_file.d_fillvalue;
+            dblock[i] = (double) member_vars[i].lake_var.snow.surf_water;
         }
+        store_nc_var_double(&nc_state_file, nc_var, dblock, stage);
 
         // snow pack temperature: lake_var.snow.pack_temp
         nc_var = &(nc_state_file.nc_vars[STATE_LAKE_SNOW_PACK_TEMP]);
         for (i = 0; i < local_domain.ncells_active; i++) {
-            dvar[i] = (double) all_vars[i].lake_var.snow.pack_temp;
-        }
-        gather_put_nc_field_double(nc_state_file.nc_id,
-                                   nc_var->nc_varid,
-                                   nc_state_file.d_fillvalue,
-                                   d2start, nc_var->nc_counts, dvar);
-        for (i = 0; i < local_domain.ncells_active; i++) {
-            dvar[i] = nc_state_file.d_fillvalue;
+            dblock[i] = (double) member_vars[i].lake_var.snow.pack_temp;
         }
+        store_nc_var_double(&nc_state_file, nc_var, dblock, stage);
 
         // snow pack water: lake_var.snow.pack_water
         nc_var = &(nc_state_file.nc_vars[STATE_LAKE_SNOW_PACK_WATER]);
         for (i = 0; i < local_domain.ncells_active; i++) {
-            dvar[i] = (double) all_vars[i].lake_var.snow.pack_water;
-        }
-        gather_put_nc_field_double(nc_state_file.nc_id,
-                                   nc_var->nc_varid,
-                                   nc_state_file.d_fillvalue,
-                                   d2start, nc_var->nc_counts, dvar);
-        for (i = 0; i < local_domain.ncells_active; i++) {
-            dvar[i] = nc_state_file.d_fillvalue;
+            dblock[i] = (double) member_vars[i].lake_var.snow.pack_water;
         }
+        store_nc_var_double(&nc_state_file, nc_var, dblock, stage);
 
         // snow density: lake_var.snow.density
         nc_var = &(nc_state_file.nc_vars[STATE_LAKE_SNOW_DENSITY]);
         for (i = 0; i < local_domain.ncells_active; i++) {
-            dvar[i] = (double) all_vars[i].lake_var.snow.density;
-        }
-        gather_put_nc_field_double(nc_state_file.nc_id,
-                                   nc_var->nc_varid,
-                                   nc_state_file.d_fillvalue,
-                                   d2start, nc_var->nc_counts, dvar);
-        for (i = 0; i < local_domain.ncells_active; i++) {
-            dvar[i] = nc_state_file.d_fillvalue;
+            dblock[i] = (double) member_vars[i].lake_var.snow.density;
         }
+        store_nc_var_double(&nc_state_file, nc_var, dblock, stage);
 
         // snow cold content: lake_var.snow.coldcontent
         nc_var = &(nc_state_file.nc_vars[STATE_LAKE_SNOW_COLD_CONTENT]);
         for (i = 0; i < local_domain.ncells_active; i++) {
-            dvar[i] = (double) all_vars[i].lake_var.snow.coldcontent;
-        }
-        gather_put_nc_field_double(nc_state_file.nc_id,
-                                   nc_var->nc_varid,
-                                   nc_state_file.d_fillvalue,
-                                   d2start, nc_var->nc_counts, dvar);
-        for (i = 0; i < local_domain.ncells_active; i++) {
-            dvar[i] = nc_state_file.d_fillvalue;
+            dblock[i] = (double) member_vars[i].lake_var.snow.coldcontent;
         }
+        store_nc_var_double(&nc_state_file, nc_var, dblock, stage);
 
         // snow canopy storage: lake_var.snow.snow_canopy
         nc_var = &(nc_state_file.nc_vars[STATE_LAKE_SNOW_CANOPY]);
         for (i = 0; i < local_domain.ncells_active; i++) {
-            dvar[i] = (double) all_vars[i].lake_var.snow.snow_canopy;
-        }
-        gather_put_nc_field_double(nc_state_file.nc_id,
-                                   nc_var->nc_varid,
-                                   nc_state_file.d_fillvalue,
-                                   d2start, nc_var->nc_counts, dvar);
-        for (i = 0; i < local_domain.ncells_active; i++) {
-            dvar[i] = nc_state_file.d_fillvalue;
+            dblock[i] = (double) member_vars[i].lake_var.snow.snow_canopy;
         }
+        store_nc_var_double(&nc_state_file, nc_var, dblock, stage);
 
         // soil node temperatures: lake_var.energy.T[nidx]
         nc_var = &(nc_state_file.nc_vars[STATE_LAKE_SOIL_NODE_TEMP]);
+        nblock = 0;
         for (j = 0; j < options.Nnode; j++) {
-            d3start[0] = j;
+            dvar = dblock + nblock++ * local_domain.ncells_active;
             for (i = 0; i < local_domain.ncells_active; i++) {
-                dvar[i] = (double) all_vars[i].lake_var.soil.layer[j].moist;
-            }
-            gather_put_nc_field_double(nc_state_file.nc_id,
-                                       nc_var->nc_varid,
-                                       nc_state_file.d_fillvalue,
-                                       d2start, nc_var->nc_counts, dvar);
-            for (i = 0; i < local_domain.ncells_active; i++) {
-                dvar[i] = nc_state_file.d_fillvalue;
+                dvar[i] = (double) member_vars[i].lake_var.soil.layer[j].moist;
             }
         }
+        store_nc_var_double(&nc_state_file, nc_var, dblock, stage);
 
         // lake active layers: lake_var.activenod
         nc_var = &(nc_state_file.nc_vars[STATE_LAKE_ACTIVE_LAYERS]);
         for (i = 0; i < local_domain.ncells_active; i++) {
-            ivar[i] = (int) all_vars[i].lake_var.activenod;
-        }
-        gather_put_nc_field_int(nc_state_file.nc_id,
-                                nc_var->nc_varid,
-                                nc_state_file.d_fillvalue,
-                                d2start, nc_var->nc_counts, ivar);
-        for (i = 0; i < local_domain.ncells_active; i++) {
-            ivar[i] = nc_state_file.i_fillvalue;
+            iblock[i] = (int) member_vars[i].lake_var.activenod;
         }
+        store_nc_var_int(&nc_state_file, nc_var, iblock, stage);
 
         // lake layer thickness: lake_var.dz
         nc_var = &(nc_state_file.nc_vars[STATE_LAKE_LAYER_DZ]);
         for (i = 0; i < local_domain.ncells_active; i++) {
-            dvar[i] = (double) all_vars[i].lake_var.dz;
-        }
-        gather_put_nc_field_double(nc_state_file.nc_id,
-                                   nc_var->nc_varid,
-                                   nc_state_file.d_fillvalue,
-                                   d2start, nc_var->nc_counts, dvar);
-        for (i = 0; i < local_domain.ncells_active; i++) {
-            dvar[i] = nc_state_file.d_fillvalue;
+            dblock[i] = (double) member_vars[i].lake_var.dz;
         }
+        store_nc_var_double(&nc_state_file, nc_var, dblock, stage);
 
         // lake surface layer thickness: lake_var.surfdz
         nc_var = &(nc_state_file.nc_vars[STATE_LAKE_SURF_LAYER_DZ]);
         for (i = 0; i < local_domain.ncells_active; i++) {
-            dvar[i] = (double) all_vars[i].lake_var.surfdz;
-        }
-        gather_put_nc_field_double(nc_state_file.nc_id,
-                                   nc_var->nc_varid,
-                                   nc_state_file.d_fillvalue,
-                                   d2start, nc_var->nc_counts, dvar);
-        for (i = 0; i < local_domain.ncells_active; i++) {
-            dvar[i] = nc_state_file.d_fillvalue;
+            dblock[i] = (double) member_vars[i].lake_var.surfdz;
         }
+        store_nc_var_double(&nc_state_file, nc_var, dblock, stage);
 
         // lake depth: lake_var.ldepth
         nc_var = &(nc_state_file.nc_vars[STATE_LAKE_DEPTH]);
         for (i = 0; i < local_domain.ncells_active; i++) {
-            dvar[i] = (double) all_vars[i].lake_var.ldepth;
-        }
-        gather_put_nc_field_double(nc_state_file.nc_id,
-                                   nc_var->nc_varid,
-                                   nc_state_file.d_fillvalue,
-                                   d2start, nc_var->nc_counts, dvar);
-        for (i = 0; i < local_domain.ncells_active; i++) {
-            dvar[i] = nc_state_file.d_fillvalue;
+            dblock[i] = (double) member_vars[i].lake_var.ldepth;
         }
+        store_nc_var_double(&nc_state_file, nc_var, dblock, stage);
 
         // lake layer surface areas: lake_var.surface[ndix]
         nc_var = &(nc_state_file.nc_vars[STATE_LAKE_LAYER_SURF_AREA]);
+        nblock = 0;
         for (j = 0; j < options.NLAKENODES; j++) {
-            d3start[0] = j;
-            for (i = 0; i < local_domain.ncells_active; i++) {
-                dvar[i] = (double) all_vars[i].lake_var.surface[j];
-            }
-            gather_put_nc_field_double(nc_state_file.nc_id,
-                                       nc_var->nc_varid,
-                                       nc_state_file.d_fillvalue,
-                                       d3start, nc_var->nc_counts, dvar);
+            dvar = dblock + nblock++ * local_domain.ncells_active;
             for (i = 0; i < local_domain.ncells_active; i++) {
-                dvar[i] = nc_state_file.d_fillvalue;
+                dvar[i] = (double) member_vars[i].lake_var.surface[j];
             }
         }
+        store_nc_var_double(&nc_state_file, nc_var, dblock, stage);
 
         // lake surface area: lake_var.sarea
         nc_var = &(nc_state_file.nc_vars[STATE_LAKE_SURF_AREA]);
         for (i = 0; i < local_domain.ncells_active; i++) {
-            dvar[i] = (double) all_vars[i].lake_var.sarea;
-        }
-        gather_put_nc_field_double(nc_state_file.nc_id,
-                                   nc_var->nc_varid,
-                                   nc_state_file.d_fillvalue,
-                                   d2start, nc_var->nc_counts, dvar);
-        for (i = 0; i < local_domain.ncells_active; i++) {
-            dvar[i] = nc_state_file.d_fillvalue;
+            dblock[i] = (double) member_vars[i].lake_var.sarea;
         }
+        store_nc_var_double(&nc_state_file, nc_var, dblock, stage);
 
         // lake volume: lake_var.volume
         nc_var = &(nc_state_file.nc_vars[STATE_LAKE_VOLUME]);
         for (i = 0; i < local_domain.ncells_active; i++) {
-            dvar[i] = (double) all_vars[i].lake_var.volume;
-        }
-        gather_put_nc_field_double(nc_state_file.nc_id,
-                                   nc_var->nc_varid,
-                                   nc_state_file.d_fillvalue,
-                                   d2start, nc_var->nc_counts, dvar);
-        for (i = 0; i < local_domain.ncells_active; i++) {
-            dvar[i] = nc_state_file.d_fillvalue;
+            dblock[i] = (double) member_vars[i].lake_var.volume;
         }
+        store_nc_var_double(&nc_state_file, nc_var, dblock, stage);
 
         // lake layer temperatures: lake_var.temp[nidx]
         nc_var = &(nc_state_file.nc_vars[STATE_LAKE_LAYER_TEMP]);
+        nblock = 0;
         for (j = 0; j < options.NLAKENODES; j++) {
-            d3start[0] = j;
-            for (i = 0; i < local_domain.ncells_active; i++) {
-                dvar[i] = (double) all_vars[i].lake_var.temp[j];
-            }
-            gather_put_nc_field_double(nc_state_file.nc_id,
-                                       nc_var->nc_varid,
-                                       nc_state_file.d_fillvalue,
-                                       d2start, nc_var->nc_counts, dvar);
+            dvar = dblock + nblock++ * local_domain.ncells_active;
             for (i = 0; i < local_domain.ncells_active; i++) {
-                dvar[i] = nc_state_file.d_fillvalue;
+                dvar[i] = (double) member_vars[i].lake_var.temp[j];
             }
         }
+        store_nc_var_double(&nc_state_file, nc_var, dblock, stage);
 
         // vertical average lake temperature: lake_var.tempavg
         nc_var = &(nc_state_file.nc_vars[STATE_LAKE_AVERAGE_TEMP]);
         for (i = 0; i < local_domain.ncells_active; i++) {
-            dvar[i] = (double) all_vars[i].lake_var.tempavg;
-        }
-        gather_put_nc_field_double(nc_state_file.nc_id,
-                                   nc_var->nc_varid,
-                                   nc_state_file.d_fillvalue,
-                                   d2start, nc_var->nc_counts, dvar);
-        for (i = 0; i < local_domain.ncells_active; i++) {
-            dvar[i] = nc_state_file.d_fillvalue;
+            dblock[i] = (double) member_vars[i].lake_var.tempavg;
         }
+        store_nc_var_double(&nc_state_file, nc_var, dblock, stage);
 
         // lake ice area fraction: lake_var.areai
         nc_var = &(nc_state_file.nc_vars[STATE_LAKE_ICE_AREA_FRAC]);
         for (i = 0; i < local_domain.ncells_active; i++) {
-            dvar[i] = (double) all_vars[i].lake_var.areai;
-        }
-        gather_put_nc_field_double(nc_state_file.nc_id,
-                                   nc_var->nc_varid,
-                                   nc_state_file.d_fillvalue,
-                                   d2start, nc_var->nc_counts, dvar);
-        for (i = 0; i < local_domain.ncells_active; i++) {
-            dvar[i] = nc_state_file.d_fillvalue;
+            dblock[i] = (double) member_vars[i].lake_var.areai;
         }
+        store_nc_var_double(&nc_state_file, nc_var, dblock, stage);
 
         // new lake ice area fraction: lake_var.new_ice_area
         nc_var = &(nc_state_file.nc_vars[STATE_LAKE_ICE_AREA_FRAC_NEW]);
         for (i = 0; i < local_domain.ncells_active; i++) {
-            dvar[i] = (double) all_vars[i].lake_var.new_ice_area;
-        }
-        gather_put_nc_field_double(nc_state_file.nc_id,
-                                   nc_var->nc_varid,
-                                   nc_state_file.d_fillvalue,
-                                   d2start, nc_var->nc_counts, dvar);
-        for (i = 0; i < local_domain.ncells_active; i++) {
-            dvar[i] = nc_state_file.d_fillvalue;
+            dblock[i] = (double) member_vars[i].lake_var.new_ice_area;
         }
+        store_nc_var_double(&nc_state_file, nc_var, dblock, stage);
 
         // lake ice water equivalent: lake_var.ice_water_eq
         nc_var = &(nc_state_file.nc_vars[STATE_LAKE_ICE_WATER_EQUIVALENT]);
         for (i = 0; i < local_domain.ncells_active; i++) {
-            dvar[i] = (double) all_vars[i].lake_var.ice_water_eq;
-        }
-        gather_put_nc_field_double(nc_state_file.nc_id,
-                                   nc_var->nc_varid,
-                                   nc_state_file.d_fillvalue,
-                                   d2start, nc_var->nc_counts, dvar);
-        for (i = 0; i < local_domain.ncells_active; i++) {
-            dvar[i] = nc_state_file.d_fillvalue;
+            dblock[i] = (double) member_vars[i].lake_var.ice_water_eq;
         }
+        store_nc_var_double(&nc_state_file, nc_var, dblock, stage);
 
         // lake ice height: lake_var.hice
         nc_var = &(nc_state_file.nc_vars[STATE_LAKE_ICE_HEIGHT]);
         for (i = 0; i < local_domain.ncells_active; i++) {
-            dvar[i] = (double) all_vars[i].lake_var.hice;
-        }
-        gather_put_nc_field_double(nc_state_file.nc_id,
-                                   nc_var->nc_varid,
-                                   nc_state_file.d_fillvalue,
-                                   d2start, nc_var->nc_counts, dvar);
-        for (i = 0; i < local_domain.ncells_active; i++) {
-            dvar[i] = nc_state_file.d_fillvalue;
+            dblock[i] = (double) member_vars[i].lake_var.hice;
         }
+        store_nc_var_double(&nc_state_file, nc_var, dblock, stage);
 
         // lake ice temperature: lake_var.tempi
         nc_var = &(nc_state_file.nc_vars[STATE_LAKE_ICE_TEMP]);
         for (i = 0; i < local_domain.ncells_active; i++) {
-            dvar[i] = (double) all_vars[i].lake_var.tempi;
-        }
-        gather_put_nc_field_double(nc_state_file.nc_id,
-                                   nc_var->nc_varid,
-                                   nc_state_file.d_fillvalue,
-                                   d2start, nc_var->nc_counts, dvar);
-        for (i = 0; i < local_domain.ncells_active; i++) {
-            dvar[i] = nc_state_file.d_fillvalue;
+            dblock[i] = (double) member_vars[i].lake_var.tempi;
         }
+        store_nc_var_double(&nc_state_file, nc_var, dblock, stage);
 
         // lake ice snow water equivalent: lake_var.swe
         nc_var = &(nc_state_file.nc_vars[STATE_LAKE_ICE_SWE]);
         for (i = 0; i < local_domain.ncells_active; i++) {
-            dvar[i] = (double) all_vars[i].lake_var.swe;
-        }
-        gather_put_nc_field_double(nc_state_file.nc_id,
-                                   nc_var->nc_varid,
-                                   nc_state_file.d_fillvalue,
-                                   d2start, nc_var->nc_counts, dvar);
-        for (i = 0; i < local_domain.ncells_active; i++) {
-            dvar[i] = nc_state_file.d_fillvalue;
+            dblock[i] = (double) member_vars[i].lake_var.swe;
         }
+        store_nc_var_double(&nc_state_file, nc_var, dblock, stage);
 
         // lake ice snow surface temperature: lake_var.surf_temp
         nc_var = &(nc_state_file.nc_vars[STATE_LAKE_ICE_SNOW_SURF_TEMP]);
         for (i = 0; i < local_domain.ncells_active; i++) {
-            dvar[i] = (double) all_vars[i].lake_var.surf_temp;
-        }
-        gather_put_nc_field_double(nc_state_file.nc_id,
-                                   nc_var->nc_varid,
-                                   nc_state_file.d_fillvalue,
-                                   d2start, nc_var->nc_counts, dvar);
-        for (i = 0; i < local_domain.ncells_active; i++) {
-            dvar[i] = nc_state_file.d_fillvalue;
+            dblock[i] = (double) member_vars[i].lake_var.surf_temp;
         }
+        store_nc_var_double(&nc_state_file, nc_var, dblock, stage);
 
         // lake ice snow pack temperature: lake_var.pack_temp
         nc_var = &(nc_state_file.nc_vars[STATE_LAKE_ICE_SNOW_PACK_TEMP]);
         for (i = 0; i < local_domain.ncells_active; i++) {
-            dvar[i] = (double) all_vars[i].lake_var.pack_temp;
-        }
-        gather_put_nc_field_double(nc_state_file.nc_id,
-                                   nc_var->nc_varid,
-                                   nc_state_file.d_fillvalue,
-                                   d2start, nc_var->nc_counts, dvar);
-        for (i = 0; i < local_domain.ncells_active; i++) {
-            dvar[i] = nc_state_file.d_fillvalue;
+            dblock[i] = (double) member_vars[i].lake_var.pack_temp;
         }
+        store_nc_var_double(&nc_state_file, nc_var, dblock, stage);
 
         // lake ice snow coldcontent: lake_var.coldcontent
         nc_var = &(nc_state_file.nc_vars[STATE_LAKE_ICE_SNOW_COLD_CONTENT]);
         for (i = 0; i < local_domain.ncells_active; i++) {
-            dvar[i] = (double) all_vars[i].lake_var.coldcontent;
-        }
-        gather_put_nc_field_double(nc_state_file.nc_id,
-                                   nc_var->nc_varid,
-                                   nc_state_file.d_fillvalue,
-                                   d2start, nc_var->nc_counts, dvar);
-        for (i = 0; i < local_domain.ncells_active; i++) {
-            dvar[i] = nc_state_file.d_fillvalue;
+            dblock[i] = (double) member_vars[i].lake_var.coldcontent;
         }
+        store_nc_var_double(&nc_state_file, nc_var, dblock, stage);
 
         // lake ice snow surface water: lake_var.surf_water
         nc_var = &(nc_state_file.nc_vars[STATE_LAKE_ICE_SNOW_SURF_WATER]);
         for (i = 0; i < local_domain.ncells_active; i++) {
-            dvar[i] = (double) all_vars[i].lake_var.surf_water;
-        }
-        gather_put_nc_field_double(nc_state_file.nc_id,
-                                   nc_var->nc_varid,
-                                   nc_state_file.d_fillvalue,
-                                   d2start, nc_var->nc_counts, dvar);
-        for (i = 0; i < local_domain.ncells_active; i++) {
-            dvar[i] = nc_state_file.d_fillvalue;
+            dblock[i] = (double) member_vars[i].lake_var.surf_water;
         }
+        store_nc_var_double(&nc_state_file, nc_var, dblock, stage);
 
         // lake ice snow pack water: lake_var.pack_water
         nc_var = &(nc_state_file.nc_vars[STATE_LAKE_ICE_SNOW_PACK_WATER]);
         for (i = 0; i < local_domain.ncells_active; i++) {
-            dvar[i] = (double) all_vars[i].lake_var.pack_water;
-        }
-        gather_put_nc_field_double(nc_state_file.nc_id,
-                                   nc_var->nc_varid,
-                                   nc_state_file.d_fillvalue,
-                                   d2start, nc_var->nc_counts, dvar);
-        for (i = 0; i < local_domain.ncells_active; i++) {
-            dvar[i] = nc_state_file.d_fillvalue;
+            dblock[i] = (double) member_vars[i].lake_var.pack_water;
         }
+        store_nc_var_double(&nc_state_file, nc_var, dblock, stage);
 
         // lake ice snow albedo: lake_var.SAlbedo
         nc_var = &(nc_state_file.nc_vars[STATE_LAKE_ICE_SNOW_ALBEDO]);
         for (i = 0; i < local_domain.ncells_active; i++) {
-            dvar[i] = (double) all_vars[i].lake_var.SAlbedo;
-        }
-        gather_put_nc_field_double(nc_state_file.nc_id,
-                                   nc_var->nc_varid,
-                                   nc_state_file.d_fillvalue,
-                                   d2start, nc_var->nc_counts, dvar);
-        for (i = 0; i < local_domain.ncells_active; i++) {
-            dvar[i] = nc_state_file.d_fillvalue;
+            dblock[i] = (double) member_vars[i].lake_var.SAlbedo;
         }
+        store_nc_var_double(&nc_state_file, nc_var, dblock, stage);
 
         // lake ice snow depth: lake_var.sdepth
         nc_var = &(nc_state_file.nc_vars[STATE_LAKE_ICE_SNOW_DEPTH]);
         for (i = 0; i < local_domain.ncells_active; i++) {
-            dvar[i] = (double) all_vars[i].lake_var.sdepth;
-        }
-        gather_put_nc_field_double(nc_state_file.nc_id,
-                                   nc_var->nc_varid,
-                                   nc_state_file.d_fillvalue,
-                                   d2start, nc_var->nc_counts, dvar);
-        for (i = 0; i < local_domain.ncells_active; i++) {
-            dvar[i] = nc_state_file.d_fillvalue;
+            dblock[i] = (double) member_vars[i].lake_var.sdepth;
         }
+        store_nc_var_double(&nc_state_file, nc_var, dblock, stage);
     }
 
-    // close the netcdf file if it is still open
-    if (mpi_rank == VIC_MPI_ROOT) {
-        if (nc_state_file.open == true) {
-            status = nc_close(nc_state_file.nc_id);
-            check_nc_status(status, "Error closing %s", filename);
+    if (stage != NULL) {
+        // gather the staged state on the master node without blocking
+        if (mpi_rank == VIC_MPI_ROOT) {
+            for (i = 0; i < (size_t) mpi_size; i++) {
+                stage->counts[i] =
+                    mpi_map_block_count(stage->nblock,
+                                        (size_t) mpi_map_local_array_sizes[i]);
+                stage->displs[i] =
+                    mpi_map_block_count(stage->nblock,
+                                        (size_t)
+                                        mpi_map_global_array_offsets[i]);
+            }
+        }
+        status = MPI_Igatherv(stage->send,
+                              mpi_map_block_count(stage->nblock,
+                                                  local_domain.ncells_active),
+                              MPI_DOUBLE, stage->recv, stage->counts,
+                              stage->displs, MPI_DOUBLE, VIC_MPI_ROOT,
+                              MPI_COMM_VIC, &(stage->request));
+        check_mpi_status(status, "MPI error.");
+        if (mpi_rank == VIC_MPI_ROOT) {
+            stage->nc = nc_state_file;
         }
+        else {
+            free(nc_state_file.nc_vars);
+        }
+        stage->dmy = *dmy_current;
+        stage->pending = true;
+    }
+    else {
+        // close the netcdf file if it is still open
+        if (mpi_rank == VIC_MPI_ROOT) {
+            if (nc_state_file.open == true) {
+                status = nc_close(nc_state_file.nc_id);
+                check_nc_status(status, "Error closing %s", filename);
+            }
+        }
+        free(nc_state_file.nc_vars);
     }
 
-    free(ivar);
-    free(dvar);
+    free(iblock);
+    free(dblock);
 }
 
 /******************************************************************************
@@ -1278,6 +1247,9 @@ set_nc_state_file_info(nc_file_struct *nc_state_file)
 {
     extern option_struct options;
     extern domain_struct global_domain;
+    extern size_t       *filter_active_cells;
+
+    nc_state_file->open = false;
 
     // Set fill values
     nc_state_file->c_fillvalue = NC_FILL_CHAR;
@@ -1289,10 +1261,14 @@ set_nc_state_file_info(nc_file_struct *nc_state_file)
     // set ids to MISSING
     nc_state_file->nc_id = MISSING;
     nc_state_file->band_dimid = MISSING;
+    nc_state_file->cell_dimid = MISSING;
+    nc_state_file->cell_varid = MISSING;
     nc_state_file->front_dimid = MISSING;
     nc_state_file->frost_dimid = MISSING;
     nc_state_file->lake_node_dimid = MISSING;
     nc_state_file->layer_dimid = MISSING;
+    nc_state_file->member_dimid = MISSING;
+    nc_state_file->member_varid = MISSING;
     nc_state_file->ni_dimid = MISSING;
     nc_state_file->nj_dimid = MISSING;
     nc_state_file->node_dimid = MISSING;
@@ -1302,9 +1278,14 @@ set_nc_state_file_info(nc_file_struct *nc_state_file)
 
     // Set dimension sizes
     nc_state_file->band_size = options.SNOW_BAND;
+    nc_state_file->cell_size = global_domain.ncells_active;
+    nc_state_file->cell_grid_idx = filter_active_cells;
     nc_state_file->front_size = MAX_FRONTS;
     nc_state_file->frost_size = options.Nfrost;
+    nc_state_file->lake_node_size = options.NLAKENODES;
     nc_state_file->layer_size = options.Nlayer;
+    // a state file holds the state of a single ensemble member
+    nc_state_file->member_size = 1;
     nc_state_file->ni_size = global_domain.n_nx;
     nc_state_file->nj_size = global_domain.n_ny;
     nc_state_file->node_size = options.Nnode;
@@ -1312,6 +1293,9 @@ set_nc_state_file_info(nc_file_struct *nc_state_file)
     nc_state_file->time_size = NC_UNLIMITED;
     nc_state_file->veg_size = options.NVEGTYPES;
 
+    // the layout of an existing state file is determined when it is opened
+    nc_state_file->gathered = options.STATE_GATHERED;
+
     // allocate memory for nc_vars
     nc_state_file->nc_vars =
         calloc(N_STATE_VARS, sizeof(*(nc_state_file->nc_vars)));
@@ -1357,9 +1341,9 @@ set_nc_state_var_info(nc_file_struct *nc)
             nc->nc_vars[i].nc_dimids[2] = nc->layer_dimid;
             nc->nc_vars[i].nc_dimids[3] = nc->nj_dimid;
             nc->nc_vars[i].nc_dimids[4] = nc->ni_dimid;
-            nc->nc_vars[i].nc_counts[0] = 1;
-            nc->nc_vars[i].nc_counts[1] = 1;
-            nc->nc_vars[i].nc_counts[2] = 1;
+            nc->nc_vars[i].nc_counts[0] = nc->veg_size;
+            nc->nc_vars[i].nc_counts[1] = nc->band_size;
+            nc->nc_vars[i].nc_counts[2] = nc->layer_size;
             nc->nc_vars[i].nc_counts[3] = nc->nj_size;
             nc->nc_vars[i].nc_counts[4] = nc->ni_size;
             break;
@@ -1372,10 +1356,10 @@ set_nc_state_var_info(nc_file_struct *nc)
             nc->nc_vars[i].nc_dimids[3] = nc->frost_dimid;
             nc->nc_vars[i].nc_dimids[4] = nc->nj_dimid;
             nc->nc_vars[i].nc_dimids[5] = nc->ni_dimid;
-            nc->nc_vars[i].nc_counts[0] = 1;
-            nc->nc_vars[i].nc_counts[1] = 1;
-            nc->nc_vars[i].nc_counts[2] = 1;
-            nc->nc_vars[i].nc_counts[3] = 1;
+            nc->nc_vars[i].nc_counts[0] = nc->veg_size;
+            nc->nc_vars[i].nc_counts[1] = nc->band_size;
+            nc->nc_vars[i].nc_counts[2] = nc->layer_size;
+            nc->nc_vars[i].nc_counts[3] = nc->frost_size;
             nc->nc_vars[i].nc_counts[4] = nc->nj_size;
             nc->nc_vars[i].nc_counts[5] = nc->ni_size;
             break;
@@ -1405,8 +1389,8 @@ set_nc_state_var_info(nc_file_struct *nc)
             nc->nc_vars[i].nc_dimids[1] = nc->band_dimid;
             nc->nc_vars[i].nc_dimids[2] = nc->nj_dimid;
             nc->nc_vars[i].nc_dimids[3] = nc->ni_dimid;
-            nc->nc_vars[i].nc_counts[0] = 1;
-            nc->nc_vars[i].nc_counts[1] = 1;
+            nc->nc_vars[i].nc_counts[0] = nc->veg_size;
+            nc->nc_vars[i].nc_counts[1] = nc->band_size;
             nc->nc_vars[i].nc_counts[2] = nc->nj_size;
             nc->nc_vars[i].nc_counts[3] = nc->ni_size;
             break;
@@ -1418,9 +1402,9 @@ set_nc_state_var_info(nc_file_struct *nc)
             nc->nc_vars[i].nc_dimids[2] = nc->node_dimid;
             nc->nc_vars[i].nc_dimids[3] = nc->nj_dimid;
             nc->nc_vars[i].nc_dimids[4] = nc->ni_dimid;
-            nc->nc_vars[i].nc_counts[0] = 1;
-            nc->nc_vars[i].nc_counts[1] = 1;
-            nc->nc_vars[i].nc_counts[2] = 1;
+            nc->nc_vars[i].nc_counts[0] = nc->veg_size;
+            nc->nc_vars[i].nc_counts[1] = nc->band_size;
+            nc->nc_vars[i].nc_counts[2] = nc->node_size;
             nc->nc_vars[i].nc_counts[3] = nc->nj_size;
             nc->nc_vars[i].nc_counts[4] = nc->ni_size;
             break;
@@ -1430,6 +1414,9 @@ set_nc_state_var_info(nc_file_struct *nc)
             nc->nc_vars[i].nc_dimids[0] = nc->layer_dimid;
             nc->nc_vars[i].nc_dimids[1] = nc->nj_dimid;
             nc->nc_vars[i].nc_dimids[2] = nc->ni_dimid;
+            nc->nc_vars[i].nc_counts[0] = nc->layer_size;
+            nc->nc_vars[i].nc_counts[1] = nc->nj_size;
+            nc->nc_vars[i].nc_counts[2] = nc->ni_size;
             break;
         case STATE_LAKE_SOIL_ICE:
             // 4d vars [layer, frost, j, i]
@@ -1438,8 +1425,8 @@ set_nc_state_var_info(nc_file_struct *nc)
             nc->nc_vars[i].nc_dimids[1] = nc->frost_dimid;
             nc->nc_vars[i].nc_dimids[2] = nc->nj_dimid;
             nc->nc_vars[i].nc_dimids[3] = nc->ni_dimid;
-            nc->nc_vars[i].nc_counts[0] = 1;
-            nc->nc_vars[i].nc_counts[1] = 1;
+            nc->nc_vars[i].nc_counts[0] = nc->layer_size;
+            nc->nc_vars[i].nc_counts[1] = nc->frost_size;
             nc->nc_vars[i].nc_counts[2] = nc->nj_size;
             nc->nc_vars[i].nc_counts[3] = nc->ni_size;
             break;
@@ -1490,7 +1477,7 @@ set_nc_state_var_info(nc_file_struct *nc)
             nc->nc_vars[i].nc_dimids[0] = nc->node_dimid;
             nc->nc_vars[i].nc_dimids[1] = nc->nj_dimid;
             nc->nc_vars[i].nc_dimids[2] = nc->ni_dimid;
-            nc->nc_vars[i].nc_counts[0] = 1;
+            nc->nc_vars[i].nc_counts[0] = nc->node_size;
             nc->nc_vars[i].nc_counts[1] = nc->nj_size;
             nc->nc_vars[i].nc_counts[2] = nc->ni_size;
             break;
@@ -1501,7 +1488,7 @@ set_nc_state_var_info(nc_file_struct *nc)
             nc->nc_vars[i].nc_dimids[0] = nc->lake_node_dimid;
             nc->nc_vars[i].nc_dimids[1] = nc->nj_dimid;
             nc->nc_vars[i].nc_dimids[2] = nc->ni_dimid;
-            nc->nc_vars[i].nc_counts[0] = 1;
+            nc->nc_vars[i].nc_counts[0] = nc->lake_node_size;
             nc->nc_vars[i].nc_counts[1] = nc->nj_size;
             nc->nc_vars[i].nc_counts[2] = nc->ni_size;
             break;
@@ -1642,6 +1629,10 @@ initialize_state_file(char           *filename,
         check_nc_status(status, "Error defining lake_node in %s", filename);
     }
 
+    if (nc_state_file->gathered) {
+        def_nc_cell_dim(nc_state_file, filename);
+    }
+
     set_nc_state_var_info(nc_state_file);
 
     // initialize dimids to invalid values
@@ -1837,10 +1828,10 @@ initialize_state_file(char           *filename,
         }
 
         // create the variable
+        ndims = get_nc_var_file_dimids(nc_state_file,
+                                       &(nc_state_file->nc_vars[i]), dimids);
         status = nc_def_var(nc_state_file->nc_id, state_metadata[i].varname,
-                            nc_state_file->nc_vars[i].nc_type,
-                            nc_state_file->nc_vars[i].nc_dims,
-                            nc_state_file->nc_vars[i].nc_dimids,
+                            nc_state_file->nc_vars[i].nc_type, ndims, dimids,
                             &(nc_state_file->nc_vars[i].nc_varid));
         check_nc_status(status, "Error defining state variable %s in %s",
                         state_metadata[i].varname, filename);
@@ -1954,6 +1945,10 @@ initialize_state_file(char           *filename,
         log_err("COORD_DIMS_OUT should be 1 or 2");
     }
 
+    if (nc_state_file->gathered) {
+        put_nc_cell_index(nc_state_file, filename);
+    }
+
     // Variables for other dimensions (all 1-dimensional)
     ndims = 1;
 
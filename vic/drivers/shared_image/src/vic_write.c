@@ -50,157 +50,402 @@ vic_write_output(dmy_struct *dmy)
 }
 
 /******************************************************************************
- * @brief    Write output to netcdf file. Currently everything is cast to
- *           double
+ * @brief    Write all history records that are still pending. Must be called
+ *           by all processes before the history files are closed.
+ *****************************************************************************/
+void
+vic_write_flush(void)
+{
+    extern option_struct   options;
+    extern stream_struct  *output_streams;
+    extern nc_file_struct *nc_hist_files;
+
+    size_t                 stream_idx;
+    size_t                 i;
+    size_t                 rec_idx;
+
+    for (stream_idx = 0; stream_idx < options.Noutstreams; stream_idx++) {
+        // write the records in the order in which they were taken
+        for (i = 0; i < NHISTRECORDS; i++) {
+            rec_idx = (nc_hist_files[stream_idx].next_record + i) %
+                      NHISTRECORDS;
+            if (nc_hist_files[stream_idx].records[rec_idx].pending) {
+                vic_write_record(&(output_streams[stream_idx]),
+                                 &(nc_hist_files[stream_idx]),
+                                 &(nc_hist_files[stream_idx].records[rec_idx]));
+            }
+        }
+    }
+}
+
+/******************************************************************************
+ * @brief    Hand off the aggregated data of a stream to the history writer.
+ * @details  The aggregated data of all variables and elements are packed into
+ *           a record buffer and gathered to the master node with a single
+ *           non-blocking collective, so that aggdata can be reset right away.
+ *           Region streams are reduced to sums per region on each process and
+ *           added with a non-blocking reduction instead, so no cell values
+ *           are sent to the master node.
+ *           The record is written to the netcdf file when the next record of
+ *           the same stream is due (or when the writes are flushed at the end
+ *           of the run). Each stream alternates between NHISTRECORDS record
+ *           buffers, so that the new record is in flight while the previous
+ *           one is written.
  *****************************************************************************/
 void
 vic_write(stream_struct  *stream,
           nc_file_struct *nc_hist_file,
           dmy_struct     *dmy_current)
 {
+    extern MPI_Comm        MPI_COMM_VIC;
+    extern metadata_struct out_metadata[N_OUTVAR_TYPES];
+
+    size_t                 i;
+    size_t                 j;
+    size_t                 k;
+    size_t                 n;
+    size_t                 v;
+    size_t                 r;
+    size_t                 nregions;
+    int                    status;
+    double                 value;
+    double                *send;
+    double                *area;
+    hist_record_struct    *record;
+
+    record = &(nc_hist_file->records[nc_hist_file->next_record]);
+
+    // The buffer can only be reused once its previous record is written
+    if (record->pending) {
+        vic_write_record(stream, nc_hist_file, record);
+    }
+
+    if (stream->region != REGION_NONE) {
+        // Reduce aggdata to the area weighted sums of each region, followed
+        // by the area of the cells that contribute to each sum, both as
+        // [nvalues][nregions]. Missing values do not contribute. The sums of
+        // all processes are added on the master node.
+        nregions = nc_hist_file->cell_size;
+        for (i = 0; i < 2 * nc_hist_file->nvalues * nregions; i++) {
+            record->send[i] = 0.;
+        }
+        for (k = 0, v = 0; k < stream->nvars; k++) {
+            for (j = 0; j < out_metadata[stream->varid[k]].nelem; j++) {
+                for (n = 0; n < stream->aggparam[k].nbins; n++, v++) {
+                    send = record->send + v * nregions;
+                    area = record->send +
+                           (nc_hist_file->nvalues + v) * nregions;
+                    for (i = 0; i < stream->ngridcells; i++) {
+                        value = stream->aggdata[i][k][j][n];
+                        if (value != MISSING) {
+                            r = nc_hist_file->cell_region[i];
+                            send[r] += nc_hist_file->cell_area[i] * value;
+                            area[r] += nc_hist_file->cell_area[i];
+                        }
+                    }
+                }
+            }
+        }
+
+        status = MPI_Ireduce(record->send, record->recv,
+                             (int) (2 * nc_hist_file->nvalues * nregions),
+                             MPI_DOUBLE, MPI_SUM, VIC_MPI_ROOT, MPI_COMM_VIC,
+                             &(record->request));
+        check_mpi_status(status, "MPI error.");
+    }
+    else {
+        // Pack aggdata into the send buffer as [nvalues][ngridcells], with
+        // the values of a variable ordered by element and then by bin. In
+        // ensemble mode the grid cells of aggdata are ordered by member and
+        // then by cell.
+        // Values are sent as double and cast to the type of the netcdf
+        // variable on the master node.
+        for (k = 0, v = 0; k < stream->nvars; k++) {
+            for (j = 0; j < out_metadata[stream->varid[k]].nelem; j++) {
+                for (n = 0; n < stream->aggparam[k].nbins; n++, v++) {
+                    send = record->send + v * stream->ngridcells;
+                    for (i = 0; i < stream->ngridcells; i++) {
+                        send[i] = stream->aggdata[i][k][j][n];
+                    }
+                }
+            }
+        }
+
+        status = MPI_Igatherv(record->send,
+                              (int) (nc_hist_file->nvalues *
+                                     stream->ngridcells), MPI_DOUBLE,
+                              record->recv, nc_hist_file->gather_counts,
+                              nc_hist_file->gather_offsets, MPI_DOUBLE,
+                              VIC_MPI_ROOT, MPI_COMM_VIC, &(record->request));
+        check_mpi_status(status, "MPI error.");
+    }
+
+    record->time_index = stream->write_alarm.count;
+    record->dmy = *dmy_current;
+    record->time_bounds[0] = stream->time_bounds[0];
+    record->time_bounds[1] = stream->time_bounds[1];
+
+    // Advance the position in the history file
+    stream->write_alarm.count++;
+    if (raise_alarm(&(stream->write_alarm), dmy_current)) {
+        // close this history file once the record is written
+        record->close_file = true;
+        reset_alarm(&(stream->write_alarm), dmy_current);
+    }
+    else {
+        record->close_file = false;
+    }
+    record->pending = true;
+
+    nc_hist_file->next_record = (nc_hist_file->next_record + 1) % NHISTRECORDS;
+
+    // Write the previous record of this stream while the new one is in flight
+    record = &(nc_hist_file->records[nc_hist_file->next_record]);
+    if (record->pending) {
+        vic_write_record(stream, nc_hist_file, record);
+    }
+}
+
+/******************************************************************************
+ * @brief    Complete the gather (or reduction) of a history record and write
+ *           it to the netcdf file. Currently everything is cast to the netcdf
+ *           type of each variable on the master node.
+ * @details  All elements of a variable (e.g. soil layers or snow bands) are
+ *           written with a single call.
+ *****************************************************************************/
+void
+vic_write_record(stream_struct      *stream,
+                 nc_file_struct     *nc_hist_file,
+                 hist_record_struct *record)
+{
+    extern MPI_Comm            MPI_COMM_VIC;
     extern global_param_struct global_param;
-    extern domain_struct       local_domain;
+    extern domain_struct       global_domain;
     extern int                 mpi_rank;
+    extern int                 mpi_size;
     extern metadata_struct     out_metadata[N_OUTVAR_TYPES];
 
     size_t                     i;
     size_t                     j;
     size_t                     k;
+    size_t                     n;
+    size_t                     m;
+    size_t                     v;
+    size_t                     d;
+    size_t                     nelem;
+    size_t                     nbins;
+    size_t                     nmembers;
+    size_t                     nslices;
+    size_t                     ncells;
+    size_t                     ncells_rank;
+    size_t                     grid_size;
     size_t                     ndims;
     double                     dtime;
-    double                    *dvar = NULL;
-    float                     *fvar = NULL;
-    int                       *ivar = NULL;
-    short int                 *svar = NULL;
-    char                      *cvar = NULL;
+    double                    *recv;
+    double                    *area;
+    double                    *remapped;
+    size_t                    *cell_map;
+    size_t                    *grid_idx;
     size_t                     dcount[MAXDIMS];
     size_t                     dstart[MAXDIMS];
-    unsigned int               varid;
     int                        status;
     double                     offset;
     double                     bounds[2];
 
-    if (mpi_rank == VIC_MPI_ROOT) {
-        // If the output file is not open, initialize the history file now.
-        if (nc_hist_file->open == false) {
-            // open the netcdf history file
-            initialize_history_file(nc_hist_file, stream, dmy_current);
-        }
+    status = MPI_Wait(&(record->request), MPI_STATUS_IGNORE);
+    check_mpi_status(status, "MPI error.");
+    record->pending = false;
+
+    if (mpi_rank != VIC_MPI_ROOT) {
+        return;
     }
 
+    // If the output file is not open, initialize the history file now.
+    if (nc_hist_file->open == false) {
+        // open the netcdf history file
+        initialize_history_file(nc_hist_file, stream, &(record->dmy));
+    }
+
+    ncells = nc_hist_file->cell_size;
+    nmembers = nc_hist_file->member_size;
+    grid_size = global_domain.n_nx * global_domain.n_ny;
+    remapped = nc_hist_file->remapped;
+    grid_idx = nc_hist_file->cell_grid_idx;
+
     // initialize dimids to invalid values - helps debugging
     for (i = 0; i < MAXDIMS; i++) {
         dstart[i] = -1;
         dcount[i] = 0;
     }
 
-    for (k = 0; k < stream->nvars; k++) {
-        varid = stream->varid[k];
+    for (k = 0, v = 0; k < stream->nvars; k++) {
+        // all elements and bins of this variable, for all members
+        nbins = stream->aggparam[k].nbins;
+        nelem = out_metadata[stream->varid[k]].nelem * nbins;
+        nslices = nmembers * nelem;
 
-        if (nc_hist_file->nc_vars[k].nc_type == NC_DOUBLE) {
-            if (dvar == NULL) {
-                // allocate memory for variables to be stored
-                dvar = malloc(local_domain.ncells_active * sizeof(*dvar));
-                check_alloc_status(dvar, "Memory allocation error");
-            }
-        }
-        else if (nc_hist_file->nc_vars[k].nc_type == NC_FLOAT) {
-            if (fvar == NULL) {
-                // allocate memory for variables to be stored
-                fvar = malloc(local_domain.ncells_active * sizeof(*fvar));
-                check_alloc_status(fvar, "Memory allocation error");
-            }
-        }
-        else if (nc_hist_file->nc_vars[k].nc_type == NC_INT) {
-            if (ivar == NULL) {
-                // allocate memory for variables to be stored
-                ivar = malloc(local_domain.ncells_active * sizeof(*ivar));
-                check_alloc_status(ivar, "Memory allocation error");
-            }
-        }
-        else if (nc_hist_file->nc_vars[k].nc_type == NC_SHORT) {
-            if (svar == NULL) {
-                // allocate memory for variables to be stored
-                svar = malloc(local_domain.ncells_active * sizeof(*svar));
-                check_alloc_status(svar, "Memory allocation error");
-            }
-        }
-        else if (nc_hist_file->nc_vars[k].nc_type == NC_CHAR) {
-            if (cvar == NULL) {
-                // allocate memory for variables to be stored
-                cvar = malloc(local_domain.ncells_active * sizeof(*cvar));
-                check_alloc_status(cvar, "Memory allocation error");
+        if (stream->region != REGION_NONE) {
+            // The cells of the file are the regions. Each region gets the
+            // area weighted mean (or sum) of its valid values.
+            recv = record->recv + v * ncells;
+            area = record->recv + (nc_hist_file->nvalues + v) * ncells;
+            for (i = 0; i < nelem * ncells; i++) {
+                if (area[i] <= 0.) {
+                    remapped[i] = MISSING;
+                }
+                else if (stream->region == REGION_SUM) {
+                    remapped[i] = recv[i];
+                }
+                else {
+                    remapped[i] = recv[i] / area[i];
+                }
             }
         }
         else {
-            log_err("Unsupported nc_type encountered");
+            // The values of each process are stored as
+            // [nvalues][nmembers][ncells_rank]. Remap the elements of this
+            // variable to [nmembers][nelem] slices in the cell order of the
+            // file.
+            for (n = 0; n < (size_t) mpi_size; n++) {
+                ncells_rank = nc_hist_file->cell_counts[n];
+                recv = record->recv + nc_hist_file->gather_offsets[n] +
+                       v * nmembers * ncells_rank;
+                cell_map = nc_hist_file->cell_map +
+                           nc_hist_file->cell_offsets[n];
+                for (m = 0; m < nmembers; m++) {
+                    for (j = 0; j < nelem; j++) {
+                        for (i = 0; i < ncells_rank; i++) {
+                            remapped[(m * nelem + j) * ncells + cell_map[i]] =
+                                recv[(j * nmembers + m) * ncells_rank + i];
+                        }
+                    }
+                }
+            }
         }
+        v += nelem;
 
+        // expand to the full grid and write all elements at once
         ndims = nc_hist_file->nc_vars[k].nc_dims;
         for (j = 0; j < ndims; j++) {
             dstart[j] = 0;
-            dcount[j] = 1;
-        }
-        // The size of the last two dimensions are the grid size; files are
-        // written one slice at a time, so all counts are 1, except the last
-        // two
-        for (j = ndims - 2; j < ndims; j++) {
             dcount[j] = nc_hist_file->nc_vars[k].nc_counts[j];
         }
-        dstart[0] = stream->write_alarm.count;  // Position in the time dimensions
+        dstart[0] = record->time_index;  // Position in the time dimensions
+        dcount[0] = 1;
+        // the elements follow time (and the members in ensemble mode)
+        d = nmembers > 1 ? 2 : 1;
+        if ((nbins == 1 && ndims > d + 2) || ndims > d + 3) {
+            dcount[d] = nelem / nbins;
+        }
 
-        for (j = 0; j < out_metadata[varid].nelem; j++) {
-            // if there is more than one layer, then dstart needs to advance
-            dstart[1] = j;
+        // in the compressed (gathered cell) layout the remapped values are
+        // already in file order and only need to be converted
+        if (nc_hist_file->gathered) {
+            dcount[ndims - 2] = ncells;
             if (nc_hist_file->nc_vars[k].nc_type == NC_DOUBLE) {
-                for (i = 0; i < local_domain.ncells_active; i++) {
-                    dvar[i] = (double) stream->aggdata[i][k][j][0];
-                }
-                gather_put_nc_field_double(nc_hist_file->nc_id,
-                                           nc_hist_file->nc_vars[k].nc_varid,
-                                           nc_hist_file->d_fillvalue,
-                                           dstart, dcount, dvar);
+                status = nc_put_vara_double(nc_hist_file->nc_id,
+                                            nc_hist_file->nc_vars[k].nc_varid,
+                                            dstart, dcount, remapped);
             }
             else if (nc_hist_file->nc_vars[k].nc_type == NC_FLOAT) {
-                for (i = 0; i < local_domain.ncells_active; i++) {
-                    fvar[i] = (float) stream->aggdata[i][k][j][0];
+                for (i = 0; i < nslices * ncells; i++) {
+                    nc_hist_file->f_grid[i] = (float) remapped[i];
                 }
-                gather_put_nc_field_float(nc_hist_file->nc_id,
-                                          nc_hist_file->nc_vars[k].nc_varid,
-                                          nc_hist_file->f_fillvalue,
-                                          dstart, dcount, fvar);
+                status = nc_put_vara_float(nc_hist_file->nc_id,
+                                           nc_hist_file->nc_vars[k].nc_varid,
+                                           dstart, dcount,
+                                           nc_hist_file->f_grid);
             }
             else if (nc_hist_file->nc_vars[k].nc_type == NC_INT) {
-                for (i = 0; i < local_domain.ncells_active; i++) {
-                    ivar[i] = (int) stream->aggdata[i][k][j][0];
+                for (i = 0; i < nslices * ncells; i++) {
+                    nc_hist_file->i_grid[i] = (int) remapped[i];
                 }
-                gather_put_nc_field_int(nc_hist_file->nc_id,
-                                        nc_hist_file->nc_vars[k].nc_varid,
-                                        nc_hist_file->i_fillvalue,
-                                        dstart, dcount, ivar);
+                status = nc_put_vara_int(nc_hist_file->nc_id,
+                                         nc_hist_file->nc_vars[k].nc_varid,
+                                         dstart, dcount,
+                                         nc_hist_file->i_grid);
             }
             else if (nc_hist_file->nc_vars[k].nc_type == NC_SHORT) {
-                for (i = 0; i < local_domain.ncells_active; i++) {
-                    svar[i] = (short int) stream->aggdata[i][k][j][0];
+                for (i = 0; i < nslices * ncells; i++) {
+                    nc_hist_file->s_grid[i] = (short int) remapped[i];
                 }
-                gather_put_nc_field_short(nc_hist_file->nc_id,
-                                          nc_hist_file->nc_vars[k].nc_varid,
-                                          nc_hist_file->s_fillvalue,
-                                          dstart, dcount, svar);
+                status = nc_put_vara_short(nc_hist_file->nc_id,
+                                           nc_hist_file->nc_vars[k].nc_varid,
+                                           dstart, dcount,
+                                           nc_hist_file->s_grid);
             }
             else if (nc_hist_file->nc_vars[k].nc_type == NC_CHAR) {
-                for (i = 0; i < local_domain.ncells_active; i++) {
-                    cvar[i] = (char) stream->aggdata[i][k][j][0];
+                for (i = 0; i < nslices * ncells; i++) {
+                    nc_hist_file->c_grid[i] = (signed char) remapped[i];
                 }
-                gather_put_nc_field_schar(nc_hist_file->nc_id,
-                                          nc_hist_file->nc_vars[k].nc_varid,
-                                          nc_hist_file->d_fillvalue,
-                                          dstart, dcount, cvar);
+                status = nc_put_vara_schar(nc_hist_file->nc_id,
+                                           nc_hist_file->nc_vars[k].nc_varid,
+                                           dstart, dcount,
+                                           nc_hist_file->c_grid);
             }
             else {
                 log_err("Unsupported nc_type encountered");
             }
         }
+        else if (nc_hist_file->nc_vars[k].nc_type == NC_DOUBLE) {
+            for (j = 0; j < nslices; j++) {
+                for (i = 0; i < ncells; i++) {
+                    nc_hist_file->d_grid[j * grid_size + grid_idx[i]] =
+                        remapped[j * ncells + i];
+                }
+            }
+            status = nc_put_vara_double(nc_hist_file->nc_id,
+                                        nc_hist_file->nc_vars[k].nc_varid,
+                                        dstart, dcount, nc_hist_file->d_grid);
+        }
+        else if (nc_hist_file->nc_vars[k].nc_type == NC_FLOAT) {
+            for (j = 0; j < nslices; j++) {
+                for (i = 0; i < ncells; i++) {
+                    nc_hist_file->f_grid[j * grid_size + grid_idx[i]] =
+                        (float) remapped[j * ncells + i];
+                }
+            }
+            status = nc_put_vara_float(nc_hist_file->nc_id,
+                                       nc_hist_file->nc_vars[k].nc_varid,
+                                       dstart, dcount, nc_hist_file->f_grid);
+        }
+        else if (nc_hist_file->nc_vars[k].nc_type == NC_INT) {
+            for (j = 0; j < nslices; j++) {
+                for (i = 0; i < ncells; i++) {
+                    nc_hist_file->i_grid[j * grid_size + grid_idx[i]] =
+                        (int) remapped[j * ncells + i];
+                }
+            }
+            status = nc_put_vara_int(nc_hist_file->nc_id,
+                                     nc_hist_file->nc_vars[k].nc_varid,
+                                     dstart, dcount, nc_hist_file->i_grid);
+        }
+        else if (nc_hist_file->nc_vars[k].nc_type == NC_SHORT) {
+            for (j = 0; j < nslices; j++) {
+                for (i = 0; i < ncells; i++) {
+                    nc_hist_file->s_grid[j * grid_size + grid_idx[i]] =
+                        (short int) remapped[j * ncells + i];
+                }
+            }
+            status = nc_put_vara_short(nc_hist_file->nc_id,
+                                       nc_hist_file->nc_vars[k].nc_varid,
+                                       dstart, dcount, nc_hist_file->s_grid);
+        }
+        else if (nc_hist_file->nc_vars[k].nc_type == NC_CHAR) {
+            for (j = 0; j < nslices; j++) {
+                for (i = 0; i < ncells; i++) {
+                    nc_hist_file->c_grid[j * grid_size + grid_idx[i]] =
+                        (signed char) remapped[j * ncells + i];
+                }
+            }
+            status = nc_put_vara_schar(nc_hist_file->nc_id,
+                                       nc_hist_file->nc_vars[k].nc_varid,
+                                       dstart, dcount, nc_hist_file->c_grid);
+        }
+        else {
+            log_err("Unsupported nc_type encountered");
+        }
+        check_nc_status(status, "Error writing values.");
 
         // reset dimids to invalid values - helps debugging
         for (j = 0; j < MAXDIMS; j++) {
@@ -209,73 +454,46 @@ vic_write(stream_struct  *stream,
         }
     }
 
-    // write to file
-    if (mpi_rank == VIC_MPI_ROOT) {
-        // Add time variable
-        dstart[0] = stream->write_alarm.count;
+    // Add time variable
+    dstart[0] = record->time_index;
 
-        // timestamp is the beginning of the aggregation window
-        dtime = date2num(global_param.time_origin_num,
-                         &(stream->time_bounds[0]), 0.,
-                         global_param.calendar, global_param.time_units);
+    // timestamp is the beginning of the aggregation window
+    dtime = date2num(global_param.time_origin_num,
+                     &(record->time_bounds[0]), 0.,
+                     global_param.calendar, global_param.time_units);
 
-        status = nc_put_var1_double(nc_hist_file->nc_id,
-                                    nc_hist_file->time_varid,
-                                    dstart, &dtime);
-        check_nc_status(status, "Error writing time variable");
+    status = nc_put_var1_double(nc_hist_file->nc_id,
+                                nc_hist_file->time_varid,
+                                dstart, &dtime);
+    check_nc_status(status, "Error writing time variable");
 
-        // Add time bounds variable
-        dstart[1] = 0;
-        dcount[0] = 1;
-        dcount[1] = 2;
-        bounds[0] = dtime;
-        dt_seconds_to_time_units(global_param.time_units, global_param.dt,
-                                 &offset);
-        bounds[1] = offset + date2num(global_param.time_origin_num,
-                                      &(stream->time_bounds[1]), 0.,
-                                      global_param.calendar,
-                                      global_param.time_units);
-
-        status = nc_put_vara_double(nc_hist_file->nc_id,
-                                    nc_hist_file->time_bounds_varid,
-                                    dstart, dcount, bounds);
-        check_nc_status(status, "Error writing time bounds variable");
-    }
+    // Add time bounds variable
+    dstart[1] = 0;
+    dcount[0] = 1;
+    dcount[1] = 2;
+    bounds[0] = dtime;
+    dt_seconds_to_time_units(global_param.time_units, global_param.dt,
+                             &offset);
+    bounds[1] = offset + date2num(global_param.time_origin_num,
+                                  &(record->time_bounds[1]), 0.,
+                                  global_param.calendar,
+                                  global_param.time_units);
 
-    // Advance the position in the history file
-    stream->write_alarm.count++;
-    if (raise_alarm(&(stream->write_alarm), dmy_current)) {
+    status = nc_put_vara_double(nc_hist_file->nc_id,
+                                nc_hist_file->time_bounds_varid,
+                                dstart, dcount, bounds);
+    check_nc_status(status, "Error writing time bounds variable");
+
+    if (record->close_file) {
         // close this history file
-        if (mpi_rank == VIC_MPI_ROOT) {
-            status = nc_close(nc_hist_file->nc_id);
-            check_nc_status(status, "Error closing history file");
-            nc_hist_file->open = false;
-        }
-        reset_alarm(&(stream->write_alarm), dmy_current);
+        status = nc_close(nc_hist_file->nc_id);
+        check_nc_status(status, "Error closing history file");
+        nc_hist_file->open = false;
     }
     else {
         // Force sync with disk (GH:#596)
-        if (mpi_rank == VIC_MPI_ROOT) {
-            status = nc_sync(nc_hist_file->nc_id);
-            check_nc_status(status, "Error syncing netCDF file %s",
-                            stream->filename);
-        }
-    }
-
-    // free memory
-    if (dvar != NULL) {
-        free(dvar);
-    }
-    if (fvar != NULL) {
-        free(fvar);
-    }
-    if (ivar != NULL) {
-        free(ivar);
-    }
-    if (svar != NULL) {
-        free(svar);
-    }
-    if (cvar != NULL) {
-        free(cvar);
+        status = nc_sync(nc_hist_file->nc_id);
+        check_nc_status(status, "Error syncing netCDF file %s",
+                        stream->filename);
     }
 }
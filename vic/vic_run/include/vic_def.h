@@ -242,6 +242,10 @@ typedef struct {
     unsigned short int RC_MODE;        /**< RC_JARVIS = compute canopy resistance via Jarvis formulation (default)
                                           RC_PHOTO = compute canopy resistance based on photosynthetic activity */
     size_t ROOT_ZONES;   /**< Number of root zones used in simulation */
+    bool RUNOFF_ADAPTIVE; /**< TRUE = select the number of runoff sub-steps
+                             of each tile and time step from the drainage
+                             fluxes, with RUNOFF_STEPS_PER_DAY as the
+                             maximum */
     bool QUICK_FLUX;     /**< TRUE = Use Liang et al., 1999 formulation for
                             ground heat flux, if FALSE use explicit finite
                             difference method */
@@ -288,9 +292,25 @@ typedef struct {
     unsigned short int STATE_FORMAT;  /**< TRUE = model state file is binary (default) */
     bool INIT_STATE;     /**< TRUE = initialize model state from file */
     bool SAVE_STATE;     /**< TRUE = save state file */
+    bool STATE_GATHERED; /**< TRUE = store the active cells only along a
+                            single cell dimension (image driver) */
+    bool STATE_ASYNC;    /**< TRUE = state files are staged in memory and
+                            written over the following time steps (image
+                            driver) */
 
     // output options
     size_t Noutstreams;  /**< Number of output stream */
+    bool ROUTING;        /**< TRUE = route runoff and baseflow to the outlets
+                            of the routing file and write their
+                            hydrographs (image driver) */
+
+    // parallel options
+    bool IO_SERVER;      /**< TRUE = the master process is reserved for
+                            reading forcing and writing output and runs no
+                            grid cells (image driver) */
+    size_t NMEMBERS;     /**< Number of ensemble members that are run
+                            side by side on each grid cell (image
+                            driver) */
 } option_struct;
 
 /******************************************************************************
@@ -332,6 +352,22 @@ typedef struct {
     unsigned int statesec;          /**< Seconds since midnight at which to save state */
     unsigned short int stateyear;  /**< Year of the simulation at which to save
                                       model state */
+    unsigned short int statefreq;  /**< Frequency of periodic state files
+                                      (FREQ_NEVER = single state file) */
+    int staten;                    /**< Number of statefreq units between
+                                      periodic state files */
+    size_t spinup_cycles;          /**< Maximum number of spin-up cycles over
+                                      the simulation period (0 = no spin-up) */
+    double spinup_tol_moist;       /**< Spin-up tolerance of the change in soil
+                                      moisture and SWE over a cycle (mm) */
+    double spinup_tol_temp;        /**< Spin-up tolerance of the change in soil
+                                      node temperatures over a cycle (C) */
+    double spinup_tol_carbon;      /**< Spin-up tolerance of the change in the
+                                      carbon pools over a cycle (gC/m2) */
+    double rout_velocity;          /**< Channel flow velocity of the routing
+                                      unit hydrographs (m/s) */
+    double rout_diffusion;         /**< Channel diffusivity of the routing
+                                      unit hydrographs (m2/s) */
     unsigned short int calendar;  /**< Date/time calendar */
     unsigned short int time_units;  /**< Units for numeric times */
     double time_origin_num;        /**< Numeric date origin */
@@ -364,6 +400,7 @@ typedef struct {
     // Soil Constraints
     double SOIL_RARC;  /**< Architectural resistance (s/m) of soil when computing soil evaporation via Penman-Monteith eqn */
     double SOIL_RESID_MOIST;  /**< Default residual moisture content of soil colum */
+    double SOIL_RUNOFF_FLUX_FRACT;  /**< Largest fraction of the drainable moisture of a soil layer that may drain in one runoff sub-step (RUNOFF_ADAPTIVE) */
     double SOIL_SLAB_MOIST_FRACT;  /**< Volumetric moisture content (fraction of porosity) in the soil/rock below the bottom soil layer; this assumes that the soil below the bottom layer has the same texture as the bottom layer. */
     double SOIL_WINDH;  /**< Default wind measurement height over soil (m) */
 
@@ -806,6 +843,8 @@ typedef struct {
     double pot_evap;                   /**< potential evaporation (mm) */
     double baseflow;                   /**< baseflow from current cell (mm/TS) */
     double runoff;                     /**< runoff from current cell (mm/TS) */
+    double runoff_steps;               /**< number of runoff sub-steps of
+                                          the time step */
     double inflow;                     /**< moisture that reaches the top of
                                           the soil column (mm) */
     double RhLitter;                   /**< soil respiration from litter pool [gC/m2] */
@@ -1008,6 +1047,7 @@ typedef struct {
     double z[MAX_LAKE_NODES + 1]; /**< Elevation of each lake node (when lake storage is at maximum), relative to lake's deepest point (m) */
     double basin[MAX_LAKE_NODES + 1]; /**< Area of lake basin at each lake node (when lake storage is at maximum) (m^2) */
     double Cl[MAX_LAKE_NODES + 1]; /**< Fractional coverage of lake basin at each node (when lake storage is at maximum) (fraction of grid cell area) */
+    double volume[MAX_LAKE_NODES + 1]; /**< Cumulative lake volume below each lake node (m^3); derived from z and basin */
     double b;                     /**< Exponent in default lake depth-area profile (y=Ax^b) */
     double maxdepth;              /**< Maximum allowable depth of liquid portion of lake (m) */
     double mindepth;              /**< Minimum allowable depth of liquid portion of lake (m) */
@@ -35,7 +35,7 @@ void advect_snow_storage(double, double, double, snow_data_struct *);
 void advect_soil_veg_storage(double, double, double, double *,
                              soil_con_struct *, veg_con_struct *,
                              cell_data_struct *, veg_var_struct *,
-                             lake_con_struct);
+                             lake_con_struct *);
 double advected_sensible_heat(double, double, double, double, double);
 void alblake(double, double, double *, double *, double *, double *, double,
              double, double, unsigned int *, double, bool *, unsigned short int,
@@ -107,12 +107,15 @@ double canopy_evap(layer_data_struct *, veg_var_struct *, bool,
 void colavg(double *, double *, double *, double, double *, int, double,
             double);
 double compute_coszen(double, double, double, unsigned short int, unsigned int);
-void compute_derived_lake_dimensions(lake_var_struct *, lake_con_struct);
+void compute_derived_lake_dimensions(lake_var_struct *, lake_con_struct *);
+void compute_lake_volume_table(lake_con_struct *);
 void compute_pot_evap(size_t, double, double, double, double, double, double,
                       double, double, double, double *, char, double, double,
                       double, double *);
 void compute_runoff_and_asat(soil_con_struct *, double *, double, double *,
                              double *);
+unsigned short compute_runoff_steps(layer_data_struct *, soil_con_struct *,
+                                    double, unsigned short);
 void compute_soil_resp(int, double *, double, double, double *, double *,
                        double, double, double, double *, double *, double *);
 void compute_soil_layer_thermal_properties(layer_data_struct *, double *,
@@ -174,12 +177,13 @@ double (*funcd)(double z, double es, double Wind, double AirDens, double ZO,
                 double EactAir, double F, double hsalt, double phi_r,
                 double ushear,
                 double Zrh);
-int get_depth(lake_con_struct, double, double *);
+int get_depth(const lake_con_struct *, double, double *);
+size_t get_lake_layer(const lake_con_struct *, const double *, double);
 double get_prob(double Tair, double Age, double SurfaceLiquidWater, double U10);
-int get_sarea(lake_con_struct, double, double *);
+int get_sarea(const lake_con_struct *, double, double *);
 void get_shear(double x, double *f, double *df, double Ur, double Zr);
 double get_thresh(double Tair, double SurfaceLiquidWater, double Zo_salt);
-int get_volume(lake_con_struct, double, double *);
+int get_volume(const lake_con_struct *, double, double *);
 double hiTinhib(double);
 int ice_melt(double, double, double *, double, snow_data_struct *,
              lake_var_struct *, double, double, double, double, double, double,
@@ -190,7 +194,7 @@ double IceEnergyBalance(double, va_list);
 void iceform(double *, double *, double, double, double *, int, double, double,
              double, double *, double *, double *, double *, double);
 void icerad(double, double, double, double *, double *, double *);
-void initialize_lake(lake_var_struct *, lake_con_struct, soil_con_struct *,
+void initialize_lake(lake_var_struct *, lake_con_struct *, soil_con_struct *,
                      cell_data_struct *, bool);
 int lakeice(double, double, double, double, double, double *, double, double *,
             double *, double, double);
@@ -318,8 +322,9 @@ int vic_run(force_data_struct *, all_vars_struct *, dmy_struct *,
             global_param_struct *, lake_con_struct *, soil_con_struct *,
             veg_con_struct *, veg_lib_struct *);
 double volumetric_heat_capacity(double, double, double, double);
-int water_balance(lake_var_struct *, lake_con_struct, double, all_vars_struct *,
-                  int, int, double, soil_con_struct, veg_con_struct);
+int water_balance(lake_var_struct *, lake_con_struct *, double,
+                  all_vars_struct *, int, int, double, soil_con_struct,
+                  veg_con_struct);
 int water_energy_balance(int, double *, double *, double, double, double,
                          double, double, double, double, double, double, double,
                          double, double, double, double *, double *, double *,
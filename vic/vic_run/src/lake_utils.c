@@ -26,37 +26,81 @@
 
 #include <vic_run.h>
 
+/******************************************************************************
+ * @brief    Compute the cumulative lake volume below each lake node.  This
+ *           table is built once per grid cell (in compute_lake_params) so
+ *           that volume and depth lookups do not need to re-integrate the
+ *           basin profile every time step.
+ *****************************************************************************/
+void
+compute_lake_volume_table(lake_con_struct *lake_con)
+{
+    int i;
+
+    lake_con->volume[lake_con->numnod] = 0.0;
+    for (i = (int) lake_con->numnod - 1; i >= 0; i--) {
+        lake_con->volume[i] = lake_con->volume[i + 1] +
+                              (lake_con->basin[i] + lake_con->basin[i + 1]) *
+                              (lake_con->z[i] - lake_con->z[i + 1]) / 2.;
+    }
+}
+
+/******************************************************************************
+ * @brief    Binary search for the lake layer (between nodes k and k + 1)
+ *           that contains the given value of a monotonically non-increasing
+ *           node table (lake_con->z or lake_con->volume), i.e. the k for
+ *           which table[k + 1] < value <= table[k].  The caller must ensure
+ *           that table[numnod] < value <= table[0].
+ *****************************************************************************/
+size_t
+get_lake_layer(const lake_con_struct *lake_con,
+               const double          *table,
+               double                 value)
+{
+    size_t lo;
+    size_t hi;
+    size_t mid;
+
+    lo = 0;
+    hi = lake_con->numnod;
+    while (hi - lo > 1) {
+        mid = (lo + hi) / 2;
+        if (value <= table[mid]) {
+            lo = mid;
+        }
+        else {
+            hi = mid;
+        }
+    }
+
+    return lo;
+}
+
 /******************************************************************************
  * @brief    Function to compute surface area of liquid water in the lake,
  *           given the current depth of liquid water.
  *****************************************************************************/
 int
-get_sarea(lake_con_struct lake_con,
-          double          depth,
-          double         *sarea)
+get_sarea(const lake_con_struct *lake_con,
+          double                 depth,
+          double                *sarea)
 {
-    size_t i;
+    size_t k;
     int    status;
 
     status = 0;
     *sarea = 0.0;
 
-    if (depth > lake_con.z[0]) {
-        *sarea = lake_con.basin[0];
+    if (depth > lake_con->z[0]) {
+        *sarea = lake_con->basin[0];
     }
     else {
-        for (i = 0; i < lake_con.numnod; i++) {
-            if (depth <= lake_con.z[i] && depth > lake_con.z[i + 1]) {
-                *sarea =
-                    lake_con.basin[i +
-                                   1] +
-                    (depth -
-                     lake_con.z[i +
-                                1]) *
-                    (lake_con.basin[i] -
-                     lake_con.basin[i +
-                                    1]) / (lake_con.z[i] - lake_con.z[i + 1]);
-            }
+        if (depth > lake_con->z[lake_con->numnod]) {
+            k = get_lake_layer(lake_con, lake_con->z, depth);
+            *sarea = lake_con->basin[k + 1] +
+                     (depth - lake_con->z[k + 1]) *
+                     (lake_con->basin[k] - lake_con->basin[k + 1]) /
+                     (lake_con->z[k] - lake_con->z[k + 1]);
         }
         if (*sarea == 0.0 && depth != 0.0) {
             status = ERROR;
@@ -71,39 +115,31 @@ get_sarea(lake_con_struct lake_con,
  *           basin, given the current depth of liquid water.
  *****************************************************************************/
 int
-get_volume(lake_con_struct lake_con,
-           double          depth,
-           double         *volume)
+get_volume(const lake_con_struct *lake_con,
+           double                 depth,
+           double                *volume)
 {
-    int    i;
+    size_t k;
     int    status;
     double m;
 
     status = 0;
     *volume = 0.0;
 
-    if (depth > lake_con.z[0]) {
+    if (depth > lake_con->z[0]) {
+        // as in the original layer scan, the full basin is counted twice
         status = 1;
-        *volume = lake_con.maxvolume;
+        *volume = lake_con->maxvolume + lake_con->volume[0];
     }
-
-    for (i = lake_con.numnod - 1; i >= 0; i--) {
-        if (depth >= lake_con.z[i]) {
-            *volume +=
-                (lake_con.basin[i] +
-                 lake_con.basin[i +
-                                1]) * (lake_con.z[i] - lake_con.z[i + 1]) / 2.;
-        }
-        else if (depth < lake_con.z[i] && depth >= lake_con.z[i + 1]) {
-            m =
-                (lake_con.basin[i] -
-                 lake_con.basin[i + 1]) / (lake_con.z[i] - lake_con.z[i + 1]);
-            *volume +=
-                (depth -
-                 lake_con.z[i +
-                            1]) *
-                (m * (depth - lake_con.z[i + 1]) / 2. + lake_con.basin[i + 1]);
-        }
+    else if (depth > lake_con->z[lake_con->numnod]) {
+        // full layers below node k + 1 plus the partially filled layer k
+        k = get_lake_layer(lake_con, lake_con->z, depth);
+        m = (lake_con->basin[k] - lake_con->basin[k + 1]) /
+            (lake_con->z[k] - lake_con->z[k + 1]);
+        *volume = lake_con->volume[k + 1] +
+                  (depth - lake_con->z[k + 1]) *
+                  (m * (depth - lake_con->z[k + 1]) / 2. +
+                   lake_con->basin[k + 1]);
     }
 
     if (*volume == 0.0 && depth != 0.0) {
@@ -119,11 +155,11 @@ get_volume(lake_con_struct lake_con,
  *           liquid water currently stored in lake.
  *****************************************************************************/
 int
-get_depth(lake_con_struct lake_con,
-          double          volume,
-          double         *depth)
+get_depth(const lake_con_struct *lake_con,
+          double                 volume,
+          double                *depth)
 {
-    int    k;
+    size_t k;
     int    status;
     double m;
     double tempvolume;
@@ -135,53 +171,36 @@ get_depth(lake_con_struct lake_con,
         status = 1;
     }
 
-    if (volume >= lake_con.maxvolume) {
-        *depth = lake_con.maxdepth;
-        *depth += (volume - lake_con.maxvolume) / lake_con.basin[0];
+    if (volume >= lake_con->maxvolume) {
+        *depth = lake_con->maxdepth;
+        *depth += (volume - lake_con->maxvolume) / lake_con->basin[0];
     }
     else if (volume < DBL_EPSILON) {
         *depth = 0.0;
     }
+    else if (volume > lake_con->volume[0]) {
+        // all layers are filled, the volume that is left over is an error
+        *depth = lake_con->z[0];
+        tempvolume = volume - lake_con->volume[0];
+        if (tempvolume / lake_con->basin[0] > DBL_EPSILON) {
+            status = ERROR;
+        }
+    }
     else {
-        // Update lake depth
-        *depth = 0.0;
-        tempvolume = volume;
-        for (k = lake_con.numnod - 1; k >= 0; k--) {
-            if (tempvolume > ((lake_con.z[k] - lake_con.z[k + 1]) *
-                              (lake_con.basin[k] +
-                               lake_con.basin[k + 1]) / 2.)) {
-                // current layer completely filled
-                tempvolume -=
-                    (lake_con.z[k] -
-                     lake_con.z[k +
-                                1]) *
-                    (lake_con.basin[k] + lake_con.basin[k + 1]) / 2.;
-                *depth += lake_con.z[k] - lake_con.z[k + 1];
-            }
-            else if (tempvolume > 0.0) {
-                if (lake_con.basin[k] == lake_con.basin[k + 1]) {
-                    *depth += tempvolume / lake_con.basin[k + 1];
-                    tempvolume = 0.0;
-                }
-                else {
-                    m =
-                        (lake_con.basin[k] -
-                         lake_con.basin[k +
-                                        1]) /
-                        (lake_con.z[k] - lake_con.z[k + 1]);
-                    *depth +=
-                        ((-1 *
-                          lake_con.basin[k +
-                                         1]) +
-                         sqrt(lake_con.basin[k +
-                                             1] *
-                              lake_con.basin[k + 1] + 2. * m * tempvolume)) / m;
-                    tempvolume = 0.0;
-                }
-            }
+        // find the partially filled layer, then invert the trapezoid volume
+        // within that layer for the remaining depth
+        k = get_lake_layer(lake_con, lake_con->volume, volume);
+        tempvolume = volume - lake_con->volume[k + 1];
+        *depth = lake_con->z[k + 1];
+        if (lake_con->basin[k] == lake_con->basin[k + 1]) {
+            *depth += tempvolume / lake_con->basin[k + 1];
         }
-        if (tempvolume / lake_con.basin[0] > DBL_EPSILON) {
-            status = ERROR;
+        else {
+            m = (lake_con->basin[k] - lake_con->basin[k + 1]) /
+                (lake_con->z[k] - lake_con->z[k + 1]);
+            *depth += ((-1 * lake_con->basin[k + 1]) +
+                       sqrt(lake_con->basin[k + 1] * lake_con->basin[k + 1] +
+                            2. * m * tempvolume)) / m;
         }
     }
 
@@ -96,6 +96,12 @@ runoff(cell_data_struct  *cell,
 
     runoff_steps_per_dt = global_param.runoff_steps_per_day /
                           global_param.model_steps_per_day;
+    if (options.RUNOFF_ADAPTIVE) {
+        // RUNOFF_STEPS_PER_DAY is the largest number of sub-steps
+        runoff_steps_per_dt = compute_runoff_steps(layer, soil_con, ppt,
+                                                   runoff_steps_per_dt);
+    }
+    cell->runoff_steps = (double) runoff_steps_per_dt;
 
     for (fidx = 0; fidx < (int)options.Nfrost; fidx++) {
         baseflow[fidx] = 0;
@@ -149,7 +155,8 @@ runoff(cell_data_struct  *cell,
         **************************************************/
         for (lindex = 0; lindex < options.Nlayer; lindex++) {
             Ksat[lindex] = soil_con->Ksat[lindex] /
-                           global_param.runoff_steps_per_day;
+                           (global_param.model_steps_per_day *
+                            runoff_steps_per_dt);
 
             /** Set Layer Liquid Moisture Content **/
             liq[lindex] = org_moist[lindex] - layer[lindex].ice[fidx];
@@ -182,7 +189,8 @@ runoff(cell_data_struct  *cell,
 
         dt_inflow = inflow / (double) runoff_steps_per_dt;
 
-        Dsmax = soil_con->Dsmax / global_param.runoff_steps_per_day;
+        Dsmax = soil_con->Dsmax / (global_param.model_steps_per_day *
+                                   runoff_steps_per_dt);
 
         for (time_step = 0; time_step < runoff_steps_per_dt; time_step++) {
             inflow = dt_inflow;
@@ -487,3 +495,96 @@ compute_runoff_and_asat(soil_con_struct *soil_con,
         *runoff = 0.;
     }
 }
+
+/******************************************************************************
+* @brief    Select the number of runoff sub-steps of a time step
+* @details  Used with RUNOFF_ADAPTIVE. The drainage from each soil layer at
+*           its current moisture (Brooks & Corey conductivity), the baseflow
+*           from the bottom layer and the inflow at the surface may each
+*           move at most SOIL_RUNOFF_FLUX_FRACT of the drainable moisture
+*           (top layer capacity for the inflow) per sub-step. Dry or frozen
+*           layers with small fluxes thus need a single sub-step. The result
+*           is between 1 and max_steps. Mass is conserved for any number of
+*           sub-steps.
+******************************************************************************/
+unsigned short
+compute_runoff_steps(layer_data_struct *layer,
+                     soil_con_struct   *soil_con,
+                     double             ppt,
+                     unsigned short     max_steps)
+{
+    extern option_struct       options;
+    extern global_param_struct global_param;
+    extern parameters_struct   param;
+
+    size_t                     lindex;
+    size_t                     fidx;
+    double                     resid_moist;
+    double                     range;
+    double                     ice;
+    double                     liq;
+    double                     rel_moist;
+    double                     flux;
+    double                     frac;
+    double                     steps;
+    double                     nsteps;
+
+    nsteps = 1.;
+    for (lindex = 0; lindex < options.Nlayer; lindex++) {
+        resid_moist = soil_con->resid_moist[lindex] *
+                      soil_con->depth[lindex] * MM_PER_M;
+        range = soil_con->max_moist[lindex] - resid_moist;
+
+        // drainable liquid moisture of the least frozen frost area
+        ice = layer[lindex].ice[0];
+        for (fidx = 1; fidx < options.Nfrost; fidx++) {
+            if (layer[lindex].ice[fidx] < ice) {
+                ice = layer[lindex].ice[fidx];
+            }
+        }
+        liq = layer[lindex].moist - ice - resid_moist;
+        if (liq <= 0. || range <= 0.) {
+            continue;
+        }
+        rel_moist = liq / range;
+        if (rel_moist > 1.) {
+            rel_moist = 1.;
+        }
+
+        if (lindex < options.Nlayer - 1) {
+            /** drainage to the next layer **/
+            flux = soil_con->Ksat[lindex] *
+                   pow(rel_moist, soil_con->expt[lindex]);
+        }
+        else {
+            /** ARNO baseflow from the bottom layer **/
+            flux = soil_con->Dsmax * soil_con->Ds / soil_con->Ws * rel_moist;
+            if (rel_moist > soil_con->Ws) {
+                frac = (rel_moist - soil_con->Ws) / (1 - soil_con->Ws);
+                flux += soil_con->Dsmax * (1 - soil_con->Ds / soil_con->Ws) *
+                        pow(frac, soil_con->c);
+            }
+        }
+        flux /= (double) global_param.model_steps_per_day;
+
+        steps = ceil(flux / (param.SOIL_RUNOFF_FLUX_FRACT * liq));
+        if (steps > nsteps) {
+            nsteps = steps;
+        }
+    }
+
+    /** inflow relative to the capacity of the top layer **/
+    range = soil_con->max_moist[0] -
+            soil_con->resid_moist[0] * soil_con->depth[0] * MM_PER_M;
+    if (ppt > 0. && range > 0.) {
+        steps = ceil(ppt / (param.SOIL_RUNOFF_FLUX_FRACT * range));
+        if (steps > nsteps) {
+            nsteps = steps;
+        }
+    }
+
+    if (nsteps > (double) max_steps) {
+        return max_steps;
+    }
+    return (unsigned short) nsteps;
+}
@@ -475,7 +475,7 @@ vic_run(force_data_struct   *force,
            Solve the water budget for the lake.
         **********************************************************************/
 
-        ErrorFlag = water_balance(lake_var, *lake_con, gp->dt, all_vars,
+        ErrorFlag = water_balance(lake_var, lake_con, gp->dt, all_vars,
                                   iveg, band, lakefrac, *soil_con,
                                   veg_con[iveg]);
         if (ErrorFlag == ERROR) {